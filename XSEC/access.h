@@ -0,0 +1,297 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region One pass of DACL evaluation
+	//****************************************************************************************
+	// SIDs used by one pass of access check. "Allow" has only enabled SIDs and is used for
+	// "allowed" ACEs, "Deny" has enabled and deny-only SIDs and is used for "denied" ACEs.
+	// Conditional ACEs are evaluated with the same context as other ACEs of the same kind.
+	struct XACCESS_PASS
+	{
+		XACCESS_PASS() = delete;
+		~XACCESS_PASS() = default;
+
+		XACCESS_PASS(const XCONDITIONAL_CONTEXT& /*allow*/, const XCONDITIONAL_CONTEXT& /*deny*/);
+
+		// Returns granted bits from "desired", or all granted bits in case of "MAXIMUM_ALLOWED".
+		// "desired" must be already mapped, "all" is used for NULL DACL.
+		DWORD Evaluate(const XSD&, const DWORD& /*desired*/, const DWORD& /*all*/, const std::optional<GENERIC_MAPPING>& = std::nullopt) const;
+
+		static DWORD Map(const DWORD&, const std::optional<GENERIC_MAPPING>&); // Replace generic rights by specific ones
+
+		XCONDITIONAL_CONTEXT Allow;
+		XCONDITIONAL_CONTEXT Deny;
+
+	private:
+		static XCONDITIONAL_RESULT condition(const XCONDITIONAL_EXPRESSION&, const XCONDITIONAL_CONTEXT&);
+	};
+	//****************************************************************************************
+	XACCESS_PASS::XACCESS_PASS(const XCONDITIONAL_CONTEXT& allow, const XCONDITIONAL_CONTEXT& deny) : Allow(allow), Deny(deny)
+	{
+	}
+	//****************************************************************************************
+	DWORD XACCESS_PASS::Map(const DWORD& mask, const std::optional<GENERIC_MAPPING>& mapping)
+	{
+		if(false == mapping.has_value())
+			return mask;
+
+		DWORD result = mask & ~(GENERIC_READ | GENERIC_WRITE | GENERIC_EXECUTE | GENERIC_ALL);
+
+		if(mask & GENERIC_READ)
+			result |= mapping->GenericRead;
+
+		if(mask & GENERIC_WRITE)
+			result |= mapping->GenericWrite;
+
+		if(mask & GENERIC_EXECUTE)
+			result |= mapping->GenericExecute;
+
+		if(mask & GENERIC_ALL)
+			result |= mapping->GenericAll;
+
+		return result;
+	}
+	//****************************************************************************************
+	XCONDITIONAL_RESULT XACCESS_PASS::condition(const XCONDITIONAL_EXPRESSION& expression, const XCONDITIONAL_CONTEXT& context)
+	{
+		XCONDITIONAL_EVALUATOR evaluator(expression);
+
+		// Values of claims are not part of the model, such expressions could not be evaluated
+		const XCONDITIONAL_REFERENCES& references = evaluator.References;
+		if(references.Local.size() || references.User.size() || references.Resource.size() || references.Device.size())
+			return XCONDITIONAL_RESULT::Unknown;
+
+		return evaluator.Evaluate(context);
+	}
+	//****************************************************************************************
+	DWORD XACCESS_PASS::Evaluate(const XSD& sd, const DWORD& desired, const DWORD& all, const std::optional<GENERIC_MAPPING>& mapping) const
+	{
+		#pragma region Initial variables
+		bool maximum = (0 != (desired & MAXIMUM_ALLOWED));
+		DWORD required = desired & ~MAXIMUM_ALLOWED;
+
+		DWORD granted = 0;
+		DWORD denied = 0;
+
+		const bin_t ownerRights = (bin_t)XSID::OwnerRights;
+		#pragma endregion
+
+		#pragma region NULL DACL grants everything
+		if(nullptr == sd.Dacl)
+			return (maximum ? (all | required) : required);
+		#pragma endregion
+
+		#pragma region Implicit rights of owner
+		bool owner = (nullptr != sd.Owner) && Allow.UserSids.Contains(*sd.Owner);
+
+		if(owner)
+		{
+			// "OWNER RIGHTS" ACE replaces implicit rights of owner
+			bool rights = std::any_of(sd.Dacl->AceArray.begin(), sd.Dacl->AceArray.end(), [&ownerRights](auto&& element)
+			{
+				auto ace = dynamic_cast<const XACE_TYPE1*>(element->AceData.get());
+				return (nullptr != ace) && (ownerRights == (bin_t)*ace->Sid) && (false == element->AceFlags->get((size_t)3 /*INHERIT_ONLY_ACE*/));
+			});
+
+			if(false == rights)
+				granted |= (READ_CONTROL | WRITE_DAC);
+		}
+		#pragma endregion
+
+		#pragma region ACEs in order
+		for(auto&& element : sd.Dacl->AceArray)
+		{
+			#pragma region Initial check
+			if((nullptr == element->AceData) || element->AceFlags->get((size_t)3 /*INHERIT_ONLY_ACE*/))
+				continue;
+			#pragma endregion
+
+			#pragma region SID, mask and condition for all ACEs from DACL
+			const XSID* sid = nullptr;
+			const XBITSET<32>* mask = nullptr;
+			const XCONDITIONAL_EXPRESSION* expression = nullptr;
+			bool allowed = false;
+
+			switch(element->AceData->Type)
+			{
+				case ACCESS_ALLOWED_ACE_TYPE:
+				case ACCESS_DENIED_ACE_TYPE:
+					{
+						auto ace = dynamic_cast<const XACE_TYPE1*>(element->AceData.get());
+
+						sid = ace->Sid.get();
+						mask = ace->Mask.get();
+						allowed = (ACCESS_ALLOWED_ACE_TYPE == ace->Type);
+					}
+					break;
+				case ACCESS_ALLOWED_OBJECT_ACE_TYPE:
+				case ACCESS_DENIED_OBJECT_ACE_TYPE:
+					{
+						auto ace = dynamic_cast<const XACE_TYPE2*>(element->AceData.get());
+						if(nullptr != ace->ObjectType)
+							continue; // There is no list of object types in the model
+
+						sid = ace->Sid.get();
+						mask = ace->Mask.get();
+						allowed = (ACCESS_ALLOWED_OBJECT_ACE_TYPE == ace->Type);
+					}
+					break;
+				case ACCESS_ALLOWED_CALLBACK_ACE_TYPE:
+				case ACCESS_DENIED_CALLBACK_ACE_TYPE:
+					{
+						auto ace = dynamic_cast<const XACE_TYPE4*>(element->AceData.get());
+
+						sid = ace->Sid.get();
+						mask = ace->Mask.get();
+						expression = ace->ConditionalExpression.get();
+						allowed = (ACCESS_ALLOWED_CALLBACK_ACE_TYPE == ace->Type);
+					}
+					break;
+				case ACCESS_ALLOWED_CALLBACK_OBJECT_ACE_TYPE:
+				case ACCESS_DENIED_CALLBACK_OBJECT_ACE_TYPE:
+					{
+						auto ace = dynamic_cast<const XACE_TYPE3*>(element->AceData.get());
+						if(nullptr != ace->ObjectType)
+							continue;
+
+						sid = ace->Sid.get();
+						mask = ace->Mask.get();
+						expression = ace->ConditionalExpression.get();
+						allowed = (ACCESS_ALLOWED_CALLBACK_OBJECT_ACE_TYPE == ace->Type);
+					}
+					break;
+				default:
+					continue;
+			}
+			#pragma endregion
+
+			#pragma region Check that ACE applies to the token
+			const XCONDITIONAL_CONTEXT& context = allowed ? Allow : Deny;
+
+			bin_t value = (bin_t)*sid;
+			if((false == context.UserSids.Contains(value)) && ((false == owner) || (ownerRights != value)))
+				continue;
+
+			if(nullptr != expression)
+			{
+				// Unknown result: "allowed" ACE does not apply, "denied" ACE applies
+				XCONDITIONAL_RESULT result = condition(*expression, context);
+				if((XCONDITIONAL_RESULT::False == result) || (allowed && (XCONDITIONAL_RESULT::Unknown == result)))
+					continue;
+			}
+			#pragma endregion
+
+			#pragma region Apply mask, the first ACE which mentions a bit makes decision for the bit
+			DWORD bits = Map((DWORD)*mask, mapping);
+
+			if(allowed)
+				granted |= (bits & ~denied);
+			else
+				denied |= (bits & ~granted);
+
+			if(false == maximum)
+			{
+				if((required & granted) == required)
+					break;
+
+				if(required & denied)
+					return (required & granted);
+			}
+			#pragma endregion
+		}
+		#pragma endregion
+
+		return (maximum ? granted : (required & granted));
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Access check for normal and restricted tokens
+	//****************************************************************************************
+	// SID sets are built once per token and could be used for any number of checks. For a
+	// restricted token (with non-empty "RestrictedSids") DACL is evaluated twice: with normal
+	// SIDs and with restricted SIDs. Access is granted only if both passes grant it.
+	//
+	// The model evaluates DACL only: mandatory integrity policy, privileges, AppContainer
+	// capabilities and "write restricted" tokens are not taken into account.
+	struct XACCESS_TOKEN
+	{
+		XACCESS_TOKEN() = delete;
+		~XACCESS_TOKEN() = default;
+
+		XACCESS_TOKEN(const XTOKEN&);
+
+		// Returns granted access mask, zero if access is denied
+		DWORD Granted(const XSD&, const DWORD& /*desired*/, const std::optional<GENERIC_MAPPING>& = std::nullopt) const;
+		bool Check(const XSD&, const DWORD& /*desired*/, const std::optional<GENERIC_MAPPING>& = std::nullopt) const;
+
+		XACCESS_PASS Normal;
+		std::optional<XACCESS_PASS> Restricted; // Empty for a token without restricted SIDs
+	};
+	//****************************************************************************************
+	XACCESS_TOKEN::XACCESS_TOKEN(const XTOKEN& token) : Normal(XCONDITIONAL_CONTEXT(token, false), XCONDITIONAL_CONTEXT(token, true))
+	{
+		token.Require(XTOKEN::ClassAccess, "XACCESS_TOKEN");
+
+		if(token.RestrictedSids.size())
+		{
+			Restricted.emplace(
+				XCONDITIONAL_CONTEXT(XSID_SET(nullptr, token.RestrictedSids, false), XSID_SET(nullptr, token.RestrictedDeviceGroups, false)),
+				XCONDITIONAL_CONTEXT(XSID_SET(nullptr, token.RestrictedSids, true), XSID_SET(nullptr, token.RestrictedDeviceGroups, true))
+			);
+		}
+	}
+	//****************************************************************************************
+	DWORD XACCESS_TOKEN::Granted(const XSD& sd, const DWORD& desired, const std::optional<GENERIC_MAPPING>& mapping) const
+	{
+		#pragma region Initial variables
+		DWORD value = XACCESS_PASS::Map(desired, mapping);
+		DWORD required = value & ~MAXIMUM_ALLOWED;
+
+		DWORD all = mapping ? mapping->GenericAll : (GENERIC_ALL | STANDARD_RIGHTS_ALL | SPECIFIC_RIGHTS_ALL);
+		#pragma endregion
+
+		#pragma region Two passes
+		DWORD result = Normal.Evaluate(sd, value, all, mapping);
+
+		if(Restricted && result)
+			result &= Restricted->Evaluate(sd, value, all, mapping);
+		#pragma endregion
+
+		if((required & result) != required)
+			return 0;
+
+		return result;
+	}
+	//****************************************************************************************
+	bool XACCESS_TOKEN::Check(const XSD& sd, const DWORD& desired, const std::optional<GENERIC_MAPPING>& mapping) const
+	{
+		return (0 != Granted(sd, desired, mapping));
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
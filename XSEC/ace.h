@@ -63,6 +63,7 @@ namespace XSEC
 
 		virtual explicit operator bin_t() const = 0;
 		virtual explicit operator xml_t() const = 0;
+		virtual void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const = 0;
 
 		unsigned char Type = 0;
 		dword_meaning_t Meaning = DwordMeaningDefault;
@@ -93,9 +94,11 @@ namespace XSEC
 
 		XACE_TYPE1(const bin_t&, const unsigned char, const dword_meaning_t&);
 		XACE_TYPE1(const msxml_et&, const unsigned char, const dword_meaning_t&);
+		XACE_TYPE1(XXML_READER&, const unsigned char, const dword_meaning_t&);
 
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::shared_ptr<XBITSET<32>> Mask;
 		std::shared_ptr<XSID> Sid;
@@ -187,6 +190,30 @@ namespace XSEC
 		#pragma endregion
 	}
 	//********************************************************************************************
+	XACE_TYPE1::XACE_TYPE1(XXML_READER& xml, const unsigned char type, const dword_meaning_t& meaning) : XACE_TYPE(type, meaning)
+	{
+		#pragma region Check for a correct input type
+		CheckType();
+		#pragma endregion
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("AccessMask" == xml.Name())
+				Mask = std::make_shared<XBITSET<32>>(xml, Meaning);
+			else if("SID" == xml.Name())
+				Sid = std::make_shared<XSID>(xml);
+		}
+
+		#pragma region Additional check
+		if(nullptr == Mask)
+			throw std::exception("XACE_TYPE1: cannot find 'AccessMask' XML node");
+
+		if(nullptr == Sid)
+			throw std::exception("XACE_TYPE1: cannot find 'SID' XML node");
+		#pragma endregion
+	}
+	//********************************************************************************************
 	XACE_TYPE1::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -220,6 +247,19 @@ namespace XSEC
 		};
 	}
 	//********************************************************************************************
+	void XACE_TYPE1::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == Sid) || (nullptr == Mask))
+			throw std::exception("XACE_TYPE1: initialize data first");
+
+		xml.Start(root.value_or("AceData"));
+
+		Mask->Write(xml, "AccessMask");
+		Sid->Write(xml, "SID");
+
+		xml.End();
+	}
+	//********************************************************************************************
 	#pragma endregion
 	//********************************************************************************************
 	#pragma region Class for XACE_TYPE2
@@ -245,9 +285,11 @@ namespace XSEC
 
 		XACE_TYPE2(const bin_t&, const unsigned char, const dword_meaning_t&);
 		XACE_TYPE2(const msxml_et&, const unsigned char, const dword_meaning_t&);
+		XACE_TYPE2(XXML_READER&, const unsigned char, const dword_meaning_t&);
 
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::shared_ptr<XBITSET<32>> Mask;
 		std::shared_ptr<XBITSET<32>> Flags;
@@ -391,6 +433,49 @@ namespace XSEC
 		#pragma endregion
 	}
 	//********************************************************************************************
+	XACE_TYPE2::XACE_TYPE2(XXML_READER& xml, const unsigned char type, const dword_meaning_t& meaning) : XACE_TYPE(type, meaning)
+	{
+		#pragma region Check for a correct input type
+		CheckType();
+		#pragma endregion
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+
+			if("AccessMask" == name)
+				Mask = std::make_shared<XBITSET<32>>(xml, Meaning);
+			else if("Flags" == name)
+				Flags = std::make_shared<XBITSET<32>>(xml, DwordMeaningAceType2Flags);
+			else if("ObjectType" == name)
+				ObjectType = std::make_shared<XGUID>(xml);
+			else if("InheritedObjectType" == name)
+				InheritedObjectType = std::make_shared<XGUID>(xml);
+			else if("SID" == name)
+				Sid = std::make_shared<XSID>(xml);
+		}
+
+		#pragma region Additional check
+		if(nullptr == Mask)
+			throw std::exception("XACE_TYPE2: cannot find 'AccessMask' XML node");
+
+		if(nullptr == Sid)
+			throw std::exception("XACE_TYPE2: cannot find 'SID' XML node");
+		#pragma endregion
+
+		#pragma region Flags
+		if(nullptr == Flags)
+			Flags = std::make_shared<XBITSET<32>>(bin_t{ 0x00, 0x00, 0x00, 0x00 }, DwordMeaningAceType2Flags);
+
+		if(nullptr != ObjectType)
+			Flags->set(L"ACE_OBJECT_TYPE_PRESENT", true);
+
+		if(nullptr != InheritedObjectType)
+			Flags->set(L"ACE_INHERITED_OBJECT_TYPE_PRESENT", true);
+		#pragma endregion
+	}
+	//********************************************************************************************
 	XACE_TYPE2::operator bin_t() const
 	{
 		#pragma region Additional check
@@ -489,6 +574,27 @@ namespace XSEC
 		};
 	}
 	//********************************************************************************************
+	void XACE_TYPE2::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == Mask) || (nullptr == Flags) || (nullptr == Sid))
+			throw std::exception("XACE_TYPE2: initialize data first");
+
+		xml.Start(root.value_or("AceData"));
+
+		Mask->Write(xml, "AccessMask");
+		Flags->Write(xml, "Flags");
+
+		if(nullptr != ObjectType)
+			ObjectType->Write(xml, "ObjectType");
+
+		if(nullptr != InheritedObjectType)
+			InheritedObjectType->Write(xml, "InheritedObjectType");
+
+		Sid->Write(xml, "SID");
+
+		xml.End();
+	}
+	//********************************************************************************************
 	#pragma endregion
 	//********************************************************************************************
 	#pragma region Class for XACE_TYPE3
@@ -518,9 +624,11 @@ namespace XSEC
 
 		XACE_TYPE3(const bin_t&, const unsigned char, const dword_meaning_t&);
 		XACE_TYPE3(const msxml_et&, const unsigned char, const dword_meaning_t&);
+		XACE_TYPE3(XXML_READER&, const unsigned char, const dword_meaning_t&);
 
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::shared_ptr<XBITSET<32>> Mask;
 		std::shared_ptr<XBITSET<32>> Flags;
@@ -589,7 +697,7 @@ namespace XSEC
 			case ACCESS_DENIED_CALLBACK_OBJECT_ACE_TYPE:
 			case SYSTEM_AUDIT_CALLBACK_OBJECT_ACE_TYPE:
 				if(!conditionalExpression && applicationData)
-					ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(*ApplicationData);
+					ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(ApplicationData);
 				else
 				{
 					if(conditionalExpression)
@@ -654,7 +762,7 @@ namespace XSEC
 				case ACCESS_ALLOWED_CALLBACK_OBJECT_ACE_TYPE:
 				case ACCESS_DENIED_CALLBACK_OBJECT_ACE_TYPE:
 				case SYSTEM_AUDIT_CALLBACK_OBJECT_ACE_TYPE:
-					ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(*ApplicationData);
+					ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(ApplicationData);
 					break;
 				default:;
 			}
@@ -753,7 +861,87 @@ namespace XSEC
 					case ACCESS_ALLOWED_CALLBACK_OBJECT_ACE_TYPE:
 					case ACCESS_DENIED_CALLBACK_OBJECT_ACE_TYPE:
 					case SYSTEM_AUDIT_CALLBACK_OBJECT_ACE_TYPE:
-						ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(*ApplicationData);
+						ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(ApplicationData);
+						break;
+					default:;
+				}
+			}
+		}
+		#pragma endregion
+	}
+	//********************************************************************************************
+	XACE_TYPE3::XACE_TYPE3(XXML_READER& xml, const unsigned char type, const dword_meaning_t& meaning) : XACE_TYPE(type, meaning)
+	{
+		#pragma region Check for a correct input type
+		CheckType();
+		#pragma endregion
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+
+			if("AccessMask" == name)
+				Mask = std::make_shared<XBITSET<32>>(xml, Meaning);
+			else if("Flags" == name)
+				Flags = std::make_shared<XBITSET<32>>(xml, DwordMeaningAceType2Flags);
+			else if("ObjectType" == name)
+				ObjectType = std::make_shared<XGUID>(xml);
+			else if("InheritedObjectType" == name)
+				InheritedObjectType = std::make_shared<XGUID>(xml);
+			else if("SID" == name)
+				Sid = std::make_shared<XSID>(xml);
+			else if("ApplicationData" == name)
+				ApplicationData = std::make_shared<bin_t>(xml.Hex());
+			else if("ConditionalExpression" == name)
+			{
+				switch(Type)
+				{
+					case ACCESS_ALLOWED_CALLBACK_OBJECT_ACE_TYPE:
+					case ACCESS_DENIED_CALLBACK_OBJECT_ACE_TYPE:
+					case SYSTEM_AUDIT_CALLBACK_OBJECT_ACE_TYPE:
+						break;
+					default:
+						throw std::exception("XACE_TYPE3: usage of 'ConditionalExpression' with incorrect ACE type");
+				}
+
+				ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(xml);
+			}
+		}
+
+		#pragma region Additional check
+		if(nullptr == Mask)
+			throw std::exception("XACE_TYPE3: cannot find 'AccessMask' XML node");
+
+		if(nullptr == Sid)
+			throw std::exception("XACE_TYPE3: cannot find 'SID' XML node");
+		#pragma endregion
+
+		#pragma region Flags
+		if(nullptr == Flags)
+			Flags = std::make_shared<XBITSET<32>>(bin_t{ 0x00, 0x00, 0x00, 0x00 }, DwordMeaningAceType2Flags);
+
+		if(nullptr != ObjectType)
+			Flags->set(L"ACE_OBJECT_TYPE_PRESENT", true);
+
+		if(nullptr != InheritedObjectType)
+			Flags->set(L"ACE_INHERITED_OBJECT_TYPE_PRESENT", true);
+		#pragma endregion
+
+		#pragma region ConditionalExpression
+		// Expression from XML has priority over "ApplicationData", the same as for DOM
+		if(nullptr != ConditionalExpression)
+			ApplicationData = std::make_shared<bin_t>((bin_t)*ConditionalExpression);
+		else
+		{
+			if(nullptr != ApplicationData)
+			{
+				switch(Type)
+				{
+					case ACCESS_ALLOWED_CALLBACK_OBJECT_ACE_TYPE:
+					case ACCESS_DENIED_CALLBACK_OBJECT_ACE_TYPE:
+					case SYSTEM_AUDIT_CALLBACK_OBJECT_ACE_TYPE:
+						ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(ApplicationData);
 						break;
 					default:;
 				}
@@ -909,6 +1097,47 @@ namespace XSEC
 		};
 	}
 	//********************************************************************************************
+	void XACE_TYPE3::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == Mask) || (nullptr == Flags) || (nullptr == Sid))
+			throw std::exception("XACE_TYPE3: initialize data first");
+
+		xml.Start(root.value_or("AceData"));
+
+		Mask->Write(xml, "AccessMask");
+		Flags->Write(xml, "Flags");
+
+		if(nullptr != ObjectType)
+			ObjectType->Write(xml, "ObjectType");
+
+		if(nullptr != InheritedObjectType)
+			InheritedObjectType->Write(xml, "InheritedObjectType");
+
+		Sid->Write(xml, "SID");
+
+		if(nullptr != ApplicationData)
+		{
+			xml.Start("ApplicationData");
+			xml.Hex(*ApplicationData);
+			xml.End();
+		}
+
+		if(nullptr != ConditionalExpression)
+		{
+			switch(Type)
+			{
+				case ACCESS_ALLOWED_CALLBACK_OBJECT_ACE_TYPE:
+				case ACCESS_DENIED_CALLBACK_OBJECT_ACE_TYPE:
+				case SYSTEM_AUDIT_CALLBACK_OBJECT_ACE_TYPE:
+					ConditionalExpression->Write(xml, "ConditionalExpression");
+					break;
+				default:;
+			}
+		}
+
+		xml.End();
+	}
+	//********************************************************************************************
 	#pragma endregion
 	//********************************************************************************************
 	#pragma region Class for XACE_TYPE4
@@ -936,9 +1165,11 @@ namespace XSEC
 
 		XACE_TYPE4(const bin_t&, const unsigned char type, const dword_meaning_t&);
 		XACE_TYPE4(const msxml_et&, const unsigned char type, const dword_meaning_t&);
+		XACE_TYPE4(XXML_READER&, const unsigned char type, const dword_meaning_t&);
 
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::shared_ptr<XBITSET<32>> Mask;
 		std::shared_ptr<XSID> Sid;
@@ -946,6 +1177,9 @@ namespace XSEC
 
 		std::shared_ptr<XSECURITY_ATTRIBUTE_V1> ResourseClaims; // The property exists only in case of SYSTEM_RESOURCE_ATTRIBUTE_ACE_TYPE
 
+		// Reads resource claims in place, directly from "ApplicationData" (only for SYSTEM_RESOURCE_ATTRIBUTE_ACE_TYPE)
+		std::optional<XSECURITY_ATTRIBUTE_V1_READER> ResourseClaimsView() const;
+
 		std::shared_ptr<XCONDITIONAL_EXPRESSION> ConditionalExpression; // The property exists only in case of ACCESS_ALLOWED_CALLBACK_ACE, ACCESS_DENIED_CALLBACK_ACE and SYSTEM_AUDIT_CALLBACK_ACE
 
 	private:
@@ -987,7 +1221,7 @@ namespace XSEC
 			case ACCESS_DENIED_CALLBACK_ACE_TYPE:
 			case SYSTEM_AUDIT_CALLBACK_ACE_TYPE:
 				if(!conditionalExpression && applicationData)
-					ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(*ApplicationData);
+					ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(ApplicationData);
 				else
 				{
 					if(conditionalExpression)
@@ -1046,7 +1280,7 @@ namespace XSEC
 			case ACCESS_ALLOWED_CALLBACK_ACE_TYPE:
 			case ACCESS_DENIED_CALLBACK_ACE_TYPE:
 			case SYSTEM_AUDIT_CALLBACK_ACE_TYPE:
-				ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(*ApplicationData);
+				ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(ApplicationData);
 				break;
 			case SYSTEM_RESOURCE_ATTRIBUTE_ACE_TYPE:
 				ResourseClaims = std::make_shared<XSECURITY_ATTRIBUTE_V1>(*ApplicationData);
@@ -1117,7 +1351,7 @@ namespace XSEC
 					case ACCESS_ALLOWED_CALLBACK_ACE_TYPE:
 					case ACCESS_DENIED_CALLBACK_ACE_TYPE:
 					case SYSTEM_AUDIT_CALLBACK_ACE_TYPE:
-						ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(*ApplicationData);
+						ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(ApplicationData);
 						break;
 					default:;
 				}
@@ -1143,6 +1377,78 @@ namespace XSEC
 		#pragma endregion
 	}
 	//********************************************************************************************
+	XACE_TYPE4::XACE_TYPE4(XXML_READER& xml, const unsigned char type, const dword_meaning_t& meaning) : XACE_TYPE(type, meaning)
+	{
+		#pragma region Check for a correct input type
+		CheckType();
+		#pragma endregion
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+
+			if("AccessMask" == name)
+				Mask = std::make_shared<XBITSET<32>>(xml, Meaning);
+			else if("SID" == name)
+				Sid = std::make_shared<XSID>(xml);
+			else if("ApplicationData" == name)
+				ApplicationData = std::make_shared<bin_t>(xml.Hex());
+			else if("ConditionalExpression" == name)
+			{
+				switch(Type)
+				{
+					case ACCESS_ALLOWED_CALLBACK_ACE_TYPE:
+					case ACCESS_DENIED_CALLBACK_ACE_TYPE:
+					case SYSTEM_AUDIT_CALLBACK_ACE_TYPE:
+						break;
+					default:
+						throw std::exception("XACE_TYPE4: usage of 'ConditionalExpression' with incorrect ACE type");
+				}
+
+				ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(xml);
+			}
+			else if("ResourseClaims" == name)
+			{
+				if(SYSTEM_RESOURCE_ATTRIBUTE_ACE_TYPE != Type)
+					throw std::exception("XACE_TYPE4: usage of 'ResourseClaims' with incorrect ACE type");
+
+				ResourseClaims = std::make_shared<XSECURITY_ATTRIBUTE_V1>(xml);
+			}
+		}
+
+		#pragma region Additional check
+		if(nullptr == Mask)
+			throw std::exception("XACE_TYPE4: cannot find 'AccessMask' XML node");
+
+		if(nullptr == Sid)
+			throw std::exception("XACE_TYPE4: cannot find 'SID' XML node");
+		#pragma endregion
+
+		#pragma region ApplicationData
+		// Structures from XML have priority over "ApplicationData", the same as for DOM
+		if(nullptr != ConditionalExpression)
+			ApplicationData = std::make_shared<bin_t>((bin_t)*ConditionalExpression);
+		else if(nullptr != ResourseClaims)
+			ApplicationData = std::make_shared<bin_t>((bin_t)*ResourseClaims);
+		else if(nullptr != ApplicationData)
+		{
+			switch(Type)
+			{
+				case ACCESS_ALLOWED_CALLBACK_ACE_TYPE:
+				case ACCESS_DENIED_CALLBACK_ACE_TYPE:
+				case SYSTEM_AUDIT_CALLBACK_ACE_TYPE:
+					ConditionalExpression = std::make_shared<XCONDITIONAL_EXPRESSION>(ApplicationData);
+					break;
+				case SYSTEM_RESOURCE_ATTRIBUTE_ACE_TYPE:
+					ResourseClaims = std::make_shared<XSECURITY_ATTRIBUTE_V1>(*ApplicationData);
+					break;
+				default:;
+			}
+		}
+		#pragma endregion
+	}
+	//********************************************************************************************
 	XACE_TYPE4::operator bin_t() const
 	{
 		#pragma region Additional check
@@ -1257,6 +1563,50 @@ namespace XSEC
 		};
 	}
 	//********************************************************************************************
+	void XACE_TYPE4::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == Mask) || (nullptr == Sid))
+			throw std::exception("XACE_TYPE4: initialize data first");
+
+		xml.Start(root.value_or("AceData"));
+
+		Mask->Write(xml, "AccessMask");
+		Sid->Write(xml, "SID");
+
+		if(nullptr != ApplicationData)
+		{
+			xml.Start("ApplicationData");
+			xml.Hex(*ApplicationData);
+			xml.End();
+		}
+
+		if(nullptr != ConditionalExpression)
+		{
+			switch(Type)
+			{
+				case ACCESS_ALLOWED_CALLBACK_ACE_TYPE:
+				case ACCESS_DENIED_CALLBACK_ACE_TYPE:
+				case SYSTEM_AUDIT_CALLBACK_ACE_TYPE:
+					ConditionalExpression->Write(xml, "ConditionalExpression");
+					break;
+				default:;
+			}
+		}
+
+		if((nullptr != ResourseClaims) && (SYSTEM_RESOURCE_ATTRIBUTE_ACE_TYPE == Type))
+			ResourseClaims->Write(xml, "ResourseClaims");
+
+		xml.End();
+	}
+	//********************************************************************************************
+	std::optional<XSECURITY_ATTRIBUTE_V1_READER> XACE_TYPE4::ResourseClaimsView() const
+	{
+		if((SYSTEM_RESOURCE_ATTRIBUTE_ACE_TYPE != Type) || (nullptr == ApplicationData))
+			return std::nullopt;
+
+		return XSECURITY_ATTRIBUTE_V1_READER(ApplicationData);
+	}
+	//********************************************************************************************
 	#pragma endregion
 	//********************************************************************************************
 	#pragma region Major ACE class
@@ -1271,9 +1621,11 @@ namespace XSEC
 		XACE(const unsigned char*, const dword_meaning_t&);
 		XACE(const bin_t&, const dword_meaning_t&);
 		XACE(const msxml_et&, const dword_meaning_t&);
+		XACE(XXML_READER&, const dword_meaning_t&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		WORD AceSize = 0;
 		std::shared_ptr<XBITSET<8>> AceFlags;
@@ -1728,6 +2080,72 @@ namespace XSEC
 		#pragma endregion
 	}
 	//********************************************************************************************
+	XACE::XACE(XXML_READER& xml, const dword_meaning_t& meaning) : Meaning(meaning), AceSize(0)
+	{
+		// Type of "AceData" is known only after "AceType", the element is always written first
+		std::optional<unsigned char> aceType;
+		bool aceData = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+
+			if("AceType" == name)
+				aceType = xml.Number<unsigned char>();
+			else if("AceFlags" == name)
+				AceFlags = std::make_shared<XBITSET<8>>(xml, ByteBitsMeaningAceFlags);
+			else if("AceData" == name)
+			{
+				if(false == aceType.has_value())
+					throw std::exception("ACE: 'AceData' XML node must follow 'AceType' XML node");
+
+				aceData = true;
+
+				switch(aceType.value())
+				{
+					case ACCESS_ALLOWED_ACE_TYPE:
+					case ACCESS_DENIED_ACE_TYPE:
+					case SYSTEM_AUDIT_ACE_TYPE:
+					case SYSTEM_MANDATORY_LABEL_ACE_TYPE:
+					case SYSTEM_SCOPED_POLICY_ID_ACE_TYPE:
+						AceData = std::make_shared<XACE_TYPE1>(xml, aceType.value(), Meaning);
+						break;
+					case ACCESS_ALLOWED_OBJECT_ACE_TYPE:
+					case ACCESS_DENIED_OBJECT_ACE_TYPE:
+						AceData = std::make_shared<XACE_TYPE2>(xml, aceType.value(), Meaning);
+						break;
+					case SYSTEM_AUDIT_OBJECT_ACE_TYPE:
+					case ACCESS_ALLOWED_CALLBACK_OBJECT_ACE_TYPE:
+					case ACCESS_DENIED_CALLBACK_OBJECT_ACE_TYPE:
+					case SYSTEM_AUDIT_CALLBACK_OBJECT_ACE_TYPE:
+					case SYSTEM_ALARM_CALLBACK_OBJECT_ACE_TYPE:
+						AceData = std::make_shared<XACE_TYPE3>(xml, aceType.value(), Meaning);
+						break;
+					case ACCESS_ALLOWED_CALLBACK_ACE_TYPE:
+					case ACCESS_DENIED_CALLBACK_ACE_TYPE:
+					case SYSTEM_AUDIT_CALLBACK_ACE_TYPE:
+					case SYSTEM_ALARM_CALLBACK_ACE_TYPE:
+					case SYSTEM_RESOURCE_ATTRIBUTE_ACE_TYPE:
+						AceData = std::make_shared<XACE_TYPE4>(xml, aceType.value(), Meaning);
+						break;
+					default:; // SYSTEM_ALARM_ACE_TYPE, ACCESS_ALLOWED_COMPOUND_ACE_TYPE and SYSTEM_ALARM_OBJECT_ACE_TYPE are not supported
+				}
+			}
+		}
+
+		#pragma region Additional check
+		if(false == aceType.has_value())
+			throw std::exception("ACE: cannot find 'AceType' XML node");
+
+		if(nullptr == AceFlags)
+			throw std::exception("ACE: cannot find 'AceFlags' XML node");
+
+		if(false == aceData)
+			throw std::exception("ACE: cannot find 'AceData' XML node");
+		#pragma endregion
+	}
+	//********************************************************************************************
 	XACE::operator xml_t()
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -1775,6 +2193,24 @@ namespace XSEC
 		};
 	}
 	//********************************************************************************************
+	void XACE::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == AceData) || (nullptr == AceFlags))
+			throw std::exception("ACE: initialize data first");
+
+		xml.Start(root.value_or("ACE"));
+
+		xml.Start("AceType");
+		xml.Attribute("TypeName", typeNames[AceData->Type]);
+		xml.Number(AceData->Type);
+		xml.End();
+
+		AceFlags->Write(xml, "AceFlags");
+		AceData->Write(xml, "AceData");
+
+		xml.End();
+	}
+	//********************************************************************************************
 	#pragma endregion
 	//********************************************************************************************
 	#pragma region Aux functions for making ACE
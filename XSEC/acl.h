@@ -34,9 +34,11 @@ namespace XSEC
 		XACL(const unsigned char*, const dword_meaning_t& = DwordMeaningDefault);
 		XACL(const bin_t&, const dword_meaning_t& = DwordMeaningDefault);
 		XACL(const msxml_et&, const dword_meaning_t& = DwordMeaningDefault);
+		XACL(XXML_READER&, const dword_meaning_t& = DwordMeaningDefault);
 
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		// Values are pointers in order to be able to change them inside "const" functions
 		std::shared_ptr<unsigned char> AclRevision = std::make_shared<unsigned char>(2);
@@ -203,6 +205,28 @@ namespace XSEC
 		#pragma endregion
 	}
 	//********************************************************************************************
+	XACL::XACL(XXML_READER& xml, const dword_meaning_t& meaning) : Meaning(meaning)
+	{
+		bool aclRevision = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("AclRevision" == xml.Name())
+			{
+				*AclRevision = xml.Number<unsigned char>();
+				aclRevision = true;
+			}
+			else if("ACE" == xml.Name())
+				AceArray.push_back(std::make_shared<XACE>(xml, Meaning));
+		}
+
+		if(false == aclRevision)
+			throw std::exception("ACL: cannot find 'AclRevision' XML node");
+
+		SetCorrectRevision();
+	}
+	//********************************************************************************************
 	XACL::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -239,5 +263,18 @@ namespace XSEC
 		};
 	}
 	//********************************************************************************************
+	void XACL::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("ACL"));
+
+		SetCorrectRevision();
+		xml.Element("AclRevision", *AclRevision);
+
+		for(auto&& element : AceArray)
+			element->Write(xml);
+
+		xml.End();
+	}
+	//********************************************************************************************
 };
 //********************************************************************************************
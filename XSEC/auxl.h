@@ -97,8 +97,10 @@ namespace XSEC
 
 		XSID_AND_ATTRIBUTES(const SID_AND_ATTRIBUTES&, const dword_meaning_t& = SidAndAttributesMeaningDefault);
 		XSID_AND_ATTRIBUTES(const msxml_et&, const dword_meaning_t& = SidAndAttributesMeaningDefault);
+		XSID_AND_ATTRIBUTES(XXML_READER&, const dword_meaning_t& = SidAndAttributesMeaningDefault);
 
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 		explicit operator SID_AND_ATTRIBUTES() const;
 
 		std::shared_ptr<XSID> Sid;
@@ -152,6 +154,24 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XSID_AND_ATTRIBUTES::XSID_AND_ATTRIBUTES(XXML_READER& xml, const dword_meaning_t& meaning) : Meaning(meaning)
+	{
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("SID" == xml.Name())
+				Sid = std::make_shared<XSID>(xml);
+			else if("Attributes" == xml.Name())
+				Attributes = std::make_shared<XBITSET<32>>(xml, Meaning);
+		}
+
+		if(nullptr == Sid)
+			throw std::exception("SID_AND_ATTRIBUTES: cannot find 'SID' XML node");
+
+		if(nullptr == Attributes)
+			throw std::exception("SID_AND_ATTRIBUTES: cannot find 'Attributes' XML node");
+	}
+	//****************************************************************************************
 	XSID_AND_ATTRIBUTES::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -185,6 +205,19 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XSID_AND_ATTRIBUTES::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == Sid) || (nullptr == Attributes))
+			throw std::exception("SID_AND_ATTRIBUTES: initialize data first");
+
+		xml.Start(root.value_or("SID_AND_ATTRIBUTES"));
+
+		Sid->Write(xml);
+		Attributes->Write(xml, "Attributes");
+
+		xml.End();
+	}
+	//****************************************************************************************
 	XSID_AND_ATTRIBUTES::operator SID_AND_ATTRIBUTES() const
 	{
 		if((nullptr == Sid) || (nullptr == Attributes))
@@ -213,8 +246,10 @@ namespace XSEC
 
 		XSID_AND_ATTRIBUTES_HASH(const SID_AND_ATTRIBUTES_HASH&, const dword_meaning_t& = SidAndAttributesMeaningDefault);
 		XSID_AND_ATTRIBUTES_HASH(const msxml_et&, const dword_meaning_t& = SidAndAttributesMeaningDefault);
+		XSID_AND_ATTRIBUTES_HASH(XXML_READER&, const dword_meaning_t& = SidAndAttributesMeaningDefault);
 
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::vector<XSID_AND_ATTRIBUTES> Attributes;
 		std::vector<bin_t> Hashes;
@@ -268,6 +303,18 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XSID_AND_ATTRIBUTES_HASH::XSID_AND_ATTRIBUTES_HASH(XXML_READER& xml, const dword_meaning_t& meaning) : Meaning(meaning)
+	{
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("Attribute" == xml.Name())
+				Attributes.emplace_back(xml, meaning);
+			else if("Hash" == xml.Name())
+				Hashes.push_back(xml.Hex());
+		}
+	}
+	//****************************************************************************************
 	XSID_AND_ATTRIBUTES_HASH::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -305,6 +352,108 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XSID_AND_ATTRIBUTES_HASH::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("SID_AND_ATTRIBUTES_HASH"));
+
+		for(auto&& element : Attributes)
+			element.Write(xml, "Attribute");
+
+		for(auto&& element : Hashes)
+		{
+			xml.Start("Hash");
+			xml.Hex(element);
+			xml.End();
+		}
+
+		xml.End();
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Well-known privileges
+	//****************************************************************************************
+	// Same LUIDs, names and (English) display names as Windows has for well-known privileges,
+	// so names could be taken without calls to LSA. Unknown LUIDs are looked up in OS.
+	struct XPRIVILEGE_NAME
+	{
+		DWORD Luid; // LowPart, HighPart is zero for all well-known privileges
+		std::wstring_view Name;
+		std::wstring_view DisplayName;
+	};
+	//****************************************************************************************
+	constexpr DWORD XPRIVILEGE_FIRST = 2;  // SE_MIN_WELL_KNOWN_PRIVILEGE
+	constexpr DWORD XPRIVILEGE_LAST = 36;  // SE_DELEGATE_SESSION_USER_IMPERSONATE_PRIVILEGE
+
+	constexpr std::array<XPRIVILEGE_NAME, XPRIVILEGE_LAST - XPRIVILEGE_FIRST + 1> XPRIVILEGE_NAMES = { {
+		{ 2, L"SeCreateTokenPrivilege", L"Create a token object" },
+		{ 3, L"SeAssignPrimaryTokenPrivilege", L"Replace a process level token" },
+		{ 4, L"SeLockMemoryPrivilege", L"Lock pages in memory" },
+		{ 5, L"SeIncreaseQuotaPrivilege", L"Adjust memory quotas for a process" },
+		{ 6, L"SeMachineAccountPrivilege", L"Add workstations to domain" },
+		{ 7, L"SeTcbPrivilege", L"Act as part of the operating system" },
+		{ 8, L"SeSecurityPrivilege", L"Manage auditing and security log" },
+		{ 9, L"SeTakeOwnershipPrivilege", L"Take ownership of files or other objects" },
+		{ 10, L"SeLoadDriverPrivilege", L"Load and unload device drivers" },
+		{ 11, L"SeSystemProfilePrivilege", L"Profile system performance" },
+		{ 12, L"SeSystemtimePrivilege", L"Change the system time" },
+		{ 13, L"SeProfileSingleProcessPrivilege", L"Profile single process" },
+		{ 14, L"SeIncreaseBasePriorityPrivilege", L"Increase scheduling priority" },
+		{ 15, L"SeCreatePagefilePrivilege", L"Create a pagefile" },
+		{ 16, L"SeCreatePermanentPrivilege", L"Create permanent shared objects" },
+		{ 17, L"SeBackupPrivilege", L"Back up files and directories" },
+		{ 18, L"SeRestorePrivilege", L"Restore files and directories" },
+		{ 19, L"SeShutdownPrivilege", L"Shut down the system" },
+		{ 20, L"SeDebugPrivilege", L"Debug programs" },
+		{ 21, L"SeAuditPrivilege", L"Generate security audits" },
+		{ 22, L"SeSystemEnvironmentPrivilege", L"Modify firmware environment values" },
+		{ 23, L"SeChangeNotifyPrivilege", L"Bypass traverse checking" },
+		{ 24, L"SeRemoteShutdownPrivilege", L"Force shutdown from a remote system" },
+		{ 25, L"SeUndockPrivilege", L"Remove computer from docking station" },
+		{ 26, L"SeSyncAgentPrivilege", L"Synchronize directory service data" },
+		{ 27, L"SeEnableDelegationPrivilege", L"Enable computer and user accounts to be trusted for delegation" },
+		{ 28, L"SeManageVolumePrivilege", L"Perform volume maintenance tasks" },
+		{ 29, L"SeImpersonatePrivilege", L"Impersonate a client after authentication" },
+		{ 30, L"SeCreateGlobalPrivilege", L"Create global objects" },
+		{ 31, L"SeTrustedCredManAccessPrivilege", L"Access Credential Manager as a trusted caller" },
+		{ 32, L"SeRelabelPrivilege", L"Modify an object label" },
+		{ 33, L"SeIncreaseWorkingSetPrivilege", L"Increase a process working set" },
+		{ 34, L"SeTimeZonePrivilege", L"Change the time zone" },
+		{ 35, L"SeCreateSymbolicLinkPrivilege", L"Create symbolic links" },
+		{ 36, L"SeDelegateSessionUserImpersonatePrivilege", L"Obtain an impersonation token for another user in the same session" }
+	} };
+
+	static_assert([]()
+	{
+		for(DWORD i = 0; i < XPRIVILEGE_NAMES.size(); i++)
+		{
+			if(XPRIVILEGE_NAMES[i].Luid != (XPRIVILEGE_FIRST + i))
+				return false;
+		}
+
+		return true;
+	}(), "XPRIVILEGE_NAMES: table must be indexed by LUID");
+	//****************************************************************************************
+	const XPRIVILEGE_NAME* privilege_name(const LUID& luid)
+	{
+		if((0 != luid.HighPart) || (luid.LowPart < XPRIVILEGE_FIRST) || (luid.LowPart > XPRIVILEGE_LAST))
+			return nullptr;
+
+		return &XPRIVILEGE_NAMES[luid.LowPart - XPRIVILEGE_FIRST];
+	}
+	//****************************************************************************************
+	const XPRIVILEGE_NAME* privilege_name(std::wstring_view name)
+	{
+		// Names of privileges are case-insensitive
+		for(auto&& element : XPRIVILEGE_NAMES)
+		{
+			if(0 == compare_ordinal(element.Name, name, true))
+				return &element;
+		}
+
+		return nullptr;
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Class for working with LUID structure
@@ -319,10 +468,12 @@ namespace XSEC
 		XLUID(const LUID);
 		XLUID(const std::wstring);
 		XLUID(const msxml_et&);
+		XLUID(XXML_READER&);
 
 		bool operator==(XLUID) const;
 
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 		operator LUID() const;
 
 		std::pair<std::wstring, std::wstring> privilegeNames() const;
@@ -357,6 +508,12 @@ namespace XSEC
 	//****************************************************************************************
 	XLUID::XLUID(const std::wstring name)
 	{
+		if(const XPRIVILEGE_NAME* known = privilege_name(name))
+		{
+			LowPart = known->Luid;
+			return;
+		}
+
 		LUID luid;
 
 		if(!LookupPrivilegeValueW(nullptr, name.c_str(), &luid))
@@ -388,6 +545,33 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XLUID::XLUID(XXML_READER& xml)
+	{
+		bool highPart = false;
+		bool lowPart = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("HighPart" == xml.Name())
+			{
+				HighPart = dword_vec(xml.Hex());
+				highPart = true;
+			}
+			else if("LowPart" == xml.Name())
+			{
+				LowPart = dword_vec(xml.Hex());
+				lowPart = true;
+			}
+		}
+
+		if(false == highPart)
+			throw std::exception("LUID: cannot find 'HighPart' XML node");
+
+		if(false == lowPart)
+			throw std::exception("LUID: cannot find 'LowPart' XML node");
+	}
+	//****************************************************************************************
 	bool XLUID::operator ==(XLUID luid) const
 	{
 		return ((HighPart == luid.HighPart) && (LowPart == luid.LowPart));
@@ -470,6 +654,32 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XLUID::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("LUID"));
+
+		#pragma region Trying to get additional information specific for privileges
+		auto privilegeNames = this->privilegeNames();
+		if(!privilegeNames.first.empty())
+		{
+			xml.Attribute("PrivilegeName", privilegeNames.first);
+
+			if(!privilegeNames.second.empty())
+				xml.Attribute("PrivilegeDisplayName", privilegeNames.second);
+		}
+		#pragma endregion
+
+		xml.Start("HighPart");
+		xml.Hex(vec_dword(HighPart));
+		xml.End();
+
+		xml.Start("LowPart");
+		xml.Hex(vec_dword(LowPart));
+		xml.End();
+
+		xml.End();
+	}
+	//****************************************************************************************
 	std::pair<std::wstring, std::wstring> XLUID::privilegeNames() const
 	{
 		#pragma region Initialize common LUID structure
@@ -479,6 +689,9 @@ namespace XSEC
 		luid.LowPart = LowPart;
 		#pragma endregion
 
+		if(const XPRIVILEGE_NAME* known = privilege_name(luid))
+			return std::make_pair<std::wstring, std::wstring>(std::wstring(known->Name), std::wstring(known->DisplayName));
+
 		DWORD privilegeNameSize = 0;
 
 		if(!LookupPrivilegeNameW(nullptr, &luid, nullptr, &privilegeNameSize))
@@ -529,9 +742,11 @@ namespace XSEC
 
 		XLUID_AND_ATTRIBUTES(const LUID_AND_ATTRIBUTES&, const dword_meaning_t& = DwordMeaningPrivilege);
 		XLUID_AND_ATTRIBUTES(const msxml_et&, const dword_meaning_t & = DwordMeaningPrivilege);
+		XLUID_AND_ATTRIBUTES(XXML_READER&, const dword_meaning_t & = DwordMeaningPrivilege);
 
 		operator LUID_AND_ATTRIBUTES() const;
 		operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::shared_ptr<XLUID> Luid;
 		std::shared_ptr<XBITSET<32>> Attributes;
@@ -545,9 +760,15 @@ namespace XSEC
 	//****************************************************************************************
 	XLUID_AND_ATTRIBUTES::XLUID_AND_ATTRIBUTES(const std::wstring& privilege, const XBITSET<32>& attributes)
 	{
-		LUID luid;
-		if(!LookupPrivilegeValueW(NULL, privilege.c_str(), &luid))
-			throw std::exception("XLUID_AND_ATTRIBUTES: cannot find privilege LUID by name");
+		LUID luid{};
+
+		if(const XPRIVILEGE_NAME* known = privilege_name(privilege))
+			luid.LowPart = known->Luid;
+		else
+		{
+			if(!LookupPrivilegeValueW(NULL, privilege.c_str(), &luid))
+				throw std::exception("XLUID_AND_ATTRIBUTES: cannot find privilege LUID by name");
+		}
 
 		Luid = std::make_shared<XLUID>(luid);
 		Attributes = std::make_shared<XBITSET<32>>(attributes);
@@ -583,6 +804,24 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XLUID_AND_ATTRIBUTES::XLUID_AND_ATTRIBUTES(XXML_READER& xml, const dword_meaning_t& meaning)
+	{
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("LUID" == xml.Name())
+				Luid = std::make_shared<XLUID>(xml);
+			else if("Attributes" == xml.Name())
+				Attributes = std::make_shared<XBITSET<32>>(xml, meaning);
+		}
+
+		if(nullptr == Luid)
+			throw std::exception("LUID_AND_ATTRIBUTES: cannot find 'LUID' XML node");
+
+		if(nullptr == Attributes)
+			throw std::exception("LUID_AND_ATTRIBUTES: cannot find 'Attributes' XML node");
+	}
+	//****************************************************************************************
 	XLUID_AND_ATTRIBUTES::operator LUID_AND_ATTRIBUTES() const
 	{
 		if((nullptr == Luid) || (nullptr == Attributes))
@@ -631,6 +870,162 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XLUID_AND_ATTRIBUTES::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == Luid) || (nullptr == Attributes))
+			throw std::exception("LUID_AND_ATTRIBUTES: initialize data first");
+
+		xml.Start(root.value_or("LUID_AND_ATTRIBUTES"));
+
+		Luid->Write(xml, "LUID");
+		Attributes->Write(xml, "Attributes");
+
+		xml.End();
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Set of privileges as bitmasks
+	//****************************************************************************************
+	// Bit N of each mask is set for privilege with LUID { N, 0 }, so all well-known privileges are
+	// kept in masks. For these privileges attributes other than enabled, enabled by default,
+	// removed and used for access are not kept.
+	struct XPRIVILEGE_SET
+	{
+		XPRIVILEGE_SET() = default;
+		~XPRIVILEGE_SET() = default;
+
+		XPRIVILEGE_SET(const std::vector<XLUID_AND_ATTRIBUTES>&);
+
+		explicit operator std::vector<XLUID_AND_ATTRIBUTES>() const;
+
+		void Set(const LUID&, const DWORD& /*attributes*/);
+		void Remove(const LUID&);
+
+		bool Has(const LUID&) const;
+		std::optional<DWORD> Attributes(const LUID&) const;
+
+		std::vector<LUID_AND_ATTRIBUTES> Privileges() const; // Well-known privileges ordered by LUID, then all others
+
+		size_t size() const { return (size_t)std::popcount(Present) + Other.size(); }
+		bool empty() const { return (0 == size()); }
+
+		bool operator==(const XPRIVILEGE_SET&) const = default;
+
+		DWORD64 Present = 0;
+		DWORD64 Enabled = 0;
+		DWORD64 EnabledByDefault = 0;
+		DWORD64 Removed = 0;
+		DWORD64 UsedForAccess = 0;
+
+		std::vector<std::pair<DWORD64, DWORD>> Other; // Privileges outside of the well-known range, sorted by LUID
+
+	private:
+		static std::optional<DWORD64> bit(const LUID& luid) { return (0 == luid.HighPart) && (luid.LowPart < 64) ? std::optional<DWORD64>((DWORD64)1 << luid.LowPart) : std::nullopt; }
+		static DWORD64 key(const LUID& luid) { return ((DWORD64)(DWORD)luid.HighPart << 32) | luid.LowPart; }
+	};
+	//****************************************************************************************
+	XPRIVILEGE_SET::XPRIVILEGE_SET(const std::vector<XLUID_AND_ATTRIBUTES>& privileges)
+	{
+		for(auto&& element : privileges)
+			Set((LUID)*element.Luid, (DWORD)*element.Attributes);
+	}
+	//****************************************************************************************
+	void XPRIVILEGE_SET::Set(const LUID& luid, const DWORD& attributes)
+	{
+		if(std::optional<DWORD64> mask = bit(luid))
+		{
+			auto apply = [&mask](DWORD64& target, const bool& value){ target = (value) ? (target | mask.value()) : (target & ~mask.value()); };
+
+			apply(Present, true);
+			apply(Enabled, (0 != (attributes & SE_PRIVILEGE_ENABLED)));
+			apply(EnabledByDefault, (0 != (attributes & SE_PRIVILEGE_ENABLED_BY_DEFAULT)));
+			apply(Removed, (0 != (attributes & SE_PRIVILEGE_REMOVED)));
+			apply(UsedForAccess, (0 != (attributes & SE_PRIVILEGE_USED_FOR_ACCESS)));
+
+			return;
+		}
+
+		auto position = std::lower_bound(Other.begin(), Other.end(), key(luid), [](const std::pair<DWORD64, DWORD>& element, const DWORD64& value){ return (element.first < value); });
+		if((position != Other.end()) && (position->first == key(luid)))
+			position->second = attributes;
+		else
+			Other.emplace(position, key(luid), attributes);
+	}
+	//****************************************************************************************
+	void XPRIVILEGE_SET::Remove(const LUID& luid)
+	{
+		if(std::optional<DWORD64> mask = bit(luid))
+		{
+			for(DWORD64* element : { &Present, &Enabled, &EnabledByDefault, &Removed, &UsedForAccess })
+				*element &= ~mask.value();
+
+			return;
+		}
+
+		std::erase_if(Other, [value = key(luid)](const std::pair<DWORD64, DWORD>& element){ return (element.first == value); });
+	}
+	//****************************************************************************************
+	bool XPRIVILEGE_SET::Has(const LUID& luid) const
+	{
+		return Attributes(luid).has_value();
+	}
+	//****************************************************************************************
+	std::optional<DWORD> XPRIVILEGE_SET::Attributes(const LUID& luid) const
+	{
+		if(std::optional<DWORD64> mask = bit(luid))
+		{
+			if(0 == (Present & mask.value()))
+				return std::nullopt;
+
+			DWORD result = 0;
+
+			if(Enabled & mask.value())
+				result |= SE_PRIVILEGE_ENABLED;
+			if(EnabledByDefault & mask.value())
+				result |= SE_PRIVILEGE_ENABLED_BY_DEFAULT;
+			if(Removed & mask.value())
+				result |= SE_PRIVILEGE_REMOVED;
+			if(UsedForAccess & mask.value())
+				result |= SE_PRIVILEGE_USED_FOR_ACCESS;
+
+			return result;
+		}
+
+		auto position = std::lower_bound(Other.begin(), Other.end(), key(luid), [](const std::pair<DWORD64, DWORD>& element, const DWORD64& value){ return (element.first < value); });
+		if((position != Other.end()) && (position->first == key(luid)))
+			return position->second;
+
+		return std::nullopt;
+	}
+	//****************************************************************************************
+	std::vector<LUID_AND_ATTRIBUTES> XPRIVILEGE_SET::Privileges() const
+	{
+		std::vector<LUID_AND_ATTRIBUTES> result;
+		result.reserve(size());
+
+		for(DWORD64 present = Present; present; present &= (present - 1))
+		{
+			LUID luid{ (DWORD)std::countr_zero(present), 0 };
+			result.push_back({ luid, Attributes(luid).value() });
+		}
+
+		for(auto&& element : Other)
+			result.push_back({ { (DWORD)element.first, (LONG)(element.first >> 32) }, element.second });
+
+		return result;
+	}
+	//****************************************************************************************
+	XPRIVILEGE_SET::operator std::vector<XLUID_AND_ATTRIBUTES>() const
+	{
+		std::vector<XLUID_AND_ATTRIBUTES> result;
+
+		for(auto&& element : Privileges())
+			result.emplace_back(element);
+
+		return result;
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Class for working with GUID
@@ -767,6 +1162,7 @@ namespace XSEC
 		XGUID(const std::wstring&);
 		XGUID(const bin_t&);
 		XGUID(const msxml_et&);
+		XGUID(XXML_READER&);
 
 		static XGUID Create();
 
@@ -775,6 +1171,7 @@ namespace XSEC
 		explicit operator std::wstring() const;
 		explicit operator std::string() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		bin_t Value;
 
@@ -860,6 +1257,11 @@ namespace XSEC
 		FromString((wchar_t*)xml->text);
 	}
 	//****************************************************************************************
+	XGUID::XGUID(XXML_READER& xml)
+	{
+		FromString(xml.WText());
+	}
+	//****************************************************************************************
 	XGUID::operator bin_t() const
 	{
 		return Value;
@@ -982,6 +1384,20 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XGUID::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("GUID"));
+
+		auto string = (std::wstring)*this;
+
+		auto search = WellKnownGUIDs.find(string);
+		if(search != WellKnownGUIDs.end())
+			xml.Attribute("Name", search->second);
+
+		xml.Text(string);
+		xml.End();
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Class fo working with OBJECT_TYPE_LIST
@@ -0,0 +1,846 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	using bitmap_t = std::vector<uint64_t>;
+	//****************************************************************************************
+	#pragma region Views on values used in batch evaluation
+	//****************************************************************************************
+	// Non-owning view on a set of values with the same kind (values of an attribute for one row, or values of a literal)
+	struct XCLAIMS_VALUES_VIEW
+	{
+		XCLAIMS_VALUE_KIND Kind = XCLAIMS_VALUE_KIND::Invalid;
+
+		const LONG64* Integers = nullptr;
+		const std::wstring* Strings = nullptr;
+		const bin_t* Binaries = nullptr;
+
+		size_t Count = 0;
+		bool CaseSensitive = false;
+		bool Sorted = false; // Values are sorted without duplicates, strings are folded unless "CaseSensitive"
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Column with values of one attribute for all rows
+	//****************************************************************************************
+	struct XCLAIMS_COLUMN
+	{
+		XCLAIMS_COLUMN() = default;
+		~XCLAIMS_COLUMN() = default;
+
+		void Append(const XSECURITY_ATTRIBUTE_V1*); // "nullptr" for a row without the attribute
+
+		XCLAIMS_VALUES_VIEW Row(const size_t&) const;
+
+		DWORD NameId = 0; // Identifier of the attribute name in "XCLAIM_NAMES"
+		WORD ValueType = 0; // Type of the first appended attribute. Rows with attributes of other types are stored as missing.
+		bool CaseSensitive = false;
+		bool Sorted = true; // Values of each row are normalized, false if rows have strings with different case sensitivity
+
+		#pragma region Values for all rows (row "i" has values from "Offsets[i]" till "Offsets[i + 1]")
+		std::vector<size_t> Offsets{ 0 };
+
+		std::vector<LONG64> Integers;
+		std::vector<std::wstring> Strings;
+		std::vector<bin_t> Binaries;
+		#pragma endregion
+
+		#pragma region Dense representation for integer columns where each row has at most one value
+		bool SingleValued = true;
+
+		std::vector<LONG64> Dense; // One value per row, 0 for missing values
+		bitmap_t Present; // Bit is set if row has a value
+		#pragma endregion
+	};
+	//****************************************************************************************
+	void XCLAIMS_COLUMN::Append(const XSECURITY_ATTRIBUTE_V1* attribute)
+	{
+		#pragma region Initial variables
+		size_t row = Offsets.size() - 1;
+
+		if(0 == (row & 63))
+			Present.push_back(0);
+		#pragma endregion
+
+		#pragma region Check type of the attribute
+		if(nullptr != attribute)
+		{
+			if(0 == ValueType)
+				ValueType = attribute->ValueType;
+
+			if((value_kind(ValueType) != value_kind(attribute->ValueType)) || (XCLAIMS_VALUE_KIND::Invalid == value_kind(ValueType)))
+				attribute = nullptr;
+		}
+		#pragma endregion
+
+		#pragma region Put values
+		if(nullptr != attribute)
+		{
+			bool caseSensitive = attribute->Flags->get(L"CLAIM_SECURITY_ATTRIBUTE_VALUE_CASE_SENSITIVE");
+
+			if(Strings.size() && (caseSensitive != CaseSensitive))
+				Sorted = false;
+
+			if(caseSensitive)
+				CaseSensitive = true;
+
+			// Normalized set from the attribute is used if it was already built
+			std::optional<XSECURITY_ATTRIBUTE_VALUE_SET> local;
+
+			const XSECURITY_ATTRIBUTE_VALUE_SET* values = attribute->GetValueSet().get();
+			if(nullptr == values)
+				values = &local.emplace(attribute->GetValues(), attribute->ValueType, caseSensitive);
+
+			Integers.insert(Integers.end(), values->Integers.begin(), values->Integers.end());
+			Strings.insert(Strings.end(), values->Strings.begin(), values->Strings.end());
+			Binaries.insert(Binaries.end(), values->Binaries.begin(), values->Binaries.end());
+		}
+
+		Offsets.push_back(Integers.size() + Strings.size() + Binaries.size());
+		#pragma endregion
+
+		#pragma region Dense representation
+		size_t count = Offsets[row + 1] - Offsets[row];
+
+		if(count > 1)
+		{
+			SingleValued = false;
+			Dense.clear();
+		}
+
+		if(SingleValued)
+		{
+			Dense.push_back((1 == count) && (XCLAIMS_VALUE_KIND::Integer == value_kind(ValueType)) ? Integers.back() : 0);
+
+			if(1 == count)
+				Present[row >> 6] |= ((uint64_t)1 << (row & 63));
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	XCLAIMS_VALUES_VIEW XCLAIMS_COLUMN::Row(const size_t& row) const
+	{
+		XCLAIMS_VALUES_VIEW result;
+
+		result.Kind = value_kind(ValueType);
+		result.Count = Offsets[row + 1] - Offsets[row];
+		result.CaseSensitive = CaseSensitive && Sorted; // Rows with different case sensitivity are compared ignoring case
+		result.Sorted = Sorted;
+
+		switch(result.Kind)
+		{
+			case XCLAIMS_VALUE_KIND::Integer:
+				result.Integers = Integers.data() + Offsets[row];
+				break;
+			case XCLAIMS_VALUE_KIND::String:
+				result.Strings = Strings.data() + Offsets[row];
+				break;
+			case XCLAIMS_VALUE_KIND::Sid:
+			case XCLAIMS_VALUE_KIND::Octet:
+				result.Binaries = Binaries.data() + Offsets[row];
+				break;
+			default:;
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Columnar table of claims values
+	//****************************************************************************************
+	struct XCLAIMS_TABLE
+	{
+		XCLAIMS_TABLE() = delete;
+		~XCLAIMS_TABLE() = default;
+
+		XCLAIMS_TABLE(const XCONDITIONAL_REFERENCES&); // Only attributes referenced by an expression would be stored
+
+		void Append(
+			const XSECURITY_ATTRIBUTES_INFORMATION* /*User*/,
+			const XSECURITY_ATTRIBUTES_INFORMATION* /*Device*/ = nullptr,
+			const XSECURITY_ATTRIBUTES_INFORMATION* /*Resource*/ = nullptr,
+			const XSECURITY_ATTRIBUTES_INFORMATION* /*Local*/ = nullptr,
+			const std::optional<XCONDITIONAL_CONTEXT>& /*Groups*/ = std::nullopt
+		);
+
+		size_t Rows = 0;
+
+		std::map<std::wstring, XCLAIMS_COLUMN, wstring_iless> Local;
+		std::map<std::wstring, XCLAIMS_COLUMN, wstring_iless> User;
+		std::map<std::wstring, XCLAIMS_COLUMN, wstring_iless> Resource;
+		std::map<std::wstring, XCLAIMS_COLUMN, wstring_iless> Device;
+
+		std::vector<XCONDITIONAL_CONTEXT> Groups; // Filled only if the expression has "membership" operators
+
+	private:
+		bool groups = false;
+	};
+	//****************************************************************************************
+	XCLAIMS_TABLE::XCLAIMS_TABLE(const XCONDITIONAL_REFERENCES& references) : groups(references.UserGroups || references.DeviceGroups)
+	{
+		auto columns = [](std::map<std::wstring, XCLAIMS_COLUMN, wstring_iless>& columns, const std::set<std::wstring, wstring_iless>& names)
+		{
+			for(auto&& element : names)
+				columns[element].NameId = XCLAIM_NAMES::Intern(element);
+		};
+
+		columns(Local, references.Local);
+		columns(User, references.User);
+		columns(Resource, references.Resource);
+		columns(Device, references.Device);
+	}
+	//****************************************************************************************
+	void XCLAIMS_TABLE::Append(
+		const XSECURITY_ATTRIBUTES_INFORMATION* user,
+		const XSECURITY_ATTRIBUTES_INFORMATION* device,
+		const XSECURITY_ATTRIBUTES_INFORMATION* resource,
+		const XSECURITY_ATTRIBUTES_INFORMATION* local,
+		const std::optional<XCONDITIONAL_CONTEXT>& context
+	)
+	{
+		#pragma region Additional check
+		if(groups && (false == context.has_value()))
+			throw std::exception("XCLAIMS_TABLE: groups information is required for the expression");
+		#pragma endregion
+
+		#pragma region Put values for all columns
+		auto append = [](std::map<std::wstring, XCLAIMS_COLUMN, wstring_iless>& columns, const XSECURITY_ATTRIBUTES_INFORMATION* information)
+		{
+			for(auto&& [name, column] : columns)
+				column.Append((nullptr == information) ? nullptr : information->Find(column.NameId));
+		};
+
+		append(Local, local);
+		append(User, user);
+		append(Resource, resource);
+		append(Device, device);
+		#pragma endregion
+
+		if(groups)
+			Groups.push_back(context.value());
+
+		Rows++;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Result of batch evaluation
+	//****************************************************************************************
+	struct XCONDITIONAL_BATCH_RESULT
+	{
+		XCONDITIONAL_BATCH_RESULT() = delete;
+		~XCONDITIONAL_BATCH_RESULT() = default;
+
+		XCONDITIONAL_BATCH_RESULT(const size_t&);
+
+		XCONDITIONAL_RESULT operator[](const size_t&) const;
+
+		void Set(const size_t&, const XCONDITIONAL_RESULT&);
+
+		size_t Rows = 0;
+
+		bitmap_t True;  // Bit is set if result for the row is "TRUE"
+		bitmap_t False; // Bit is set if result for the row is "FALSE". If both bits are not set the result is "UNKNOWN".
+	};
+	//****************************************************************************************
+	XCONDITIONAL_BATCH_RESULT::XCONDITIONAL_BATCH_RESULT(const size_t& rows) : Rows(rows), True((rows + 63) >> 6, 0), False((rows + 63) >> 6, 0)
+	{
+	}
+	//****************************************************************************************
+	XCONDITIONAL_RESULT XCONDITIONAL_BATCH_RESULT::operator[](const size_t& row) const
+	{
+		uint64_t bit = (uint64_t)1 << (row & 63);
+
+		if(True[row >> 6] & bit)
+			return XCONDITIONAL_RESULT::True;
+
+		if(False[row >> 6] & bit)
+			return XCONDITIONAL_RESULT::False;
+
+		return XCONDITIONAL_RESULT::Unknown;
+	}
+	//****************************************************************************************
+	void XCONDITIONAL_BATCH_RESULT::Set(const size_t& row, const XCONDITIONAL_RESULT& value)
+	{
+		uint64_t bit = (uint64_t)1 << (row & 63);
+
+		True[row >> 6] &= ~bit;
+		False[row >> 6] &= ~bit;
+
+		if(XCONDITIONAL_RESULT::True == value)
+			True[row >> 6] |= bit;
+
+		if(XCONDITIONAL_RESULT::False == value)
+			False[row >> 6] |= bit;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Aux functions for batch evaluation
+	//****************************************************************************************
+	bool values_equal(const XCLAIMS_VALUES_VIEW& lhs, const size_t& i, const XCLAIMS_VALUES_VIEW& rhs, const size_t& j)
+	{
+		switch(lhs.Kind)
+		{
+			case XCLAIMS_VALUE_KIND::Integer:
+				return (lhs.Integers[i] == rhs.Integers[j]);
+			case XCLAIMS_VALUE_KIND::String:
+				return (0 == compare_ordinal(lhs.Strings[i], rhs.Strings[j], (false == lhs.CaseSensitive)));
+			case XCLAIMS_VALUE_KIND::Sid:
+			case XCLAIMS_VALUE_KIND::Octet:
+				return (lhs.Binaries[i] == rhs.Binaries[j]);
+			default:
+				return false;
+		}
+	}
+	//****************************************************************************************
+	bool values_contain(const XCLAIMS_VALUES_VIEW& lhs, const XCLAIMS_VALUES_VIEW& rhs, const size_t& j)
+	{
+		for(size_t i = 0; i < lhs.Count; i++)
+		{
+			if(values_equal(lhs, i, rhs, j))
+				return true;
+		}
+
+		return false;
+	}
+	//****************************************************************************************
+	// Set relations for two sorted views, see "sorted.h"
+	bool sorted_includes(const XCLAIMS_VALUES_VIEW& lhs, const XCLAIMS_VALUES_VIEW& rhs)
+	{
+		switch(lhs.Kind)
+		{
+			case XCLAIMS_VALUE_KIND::Integer:
+				return sorted_includes(lhs.Integers, lhs.Integers + lhs.Count, rhs.Integers, rhs.Integers + rhs.Count);
+			case XCLAIMS_VALUE_KIND::String:
+				return sorted_includes(lhs.Strings, lhs.Strings + lhs.Count, rhs.Strings, rhs.Strings + rhs.Count);
+			case XCLAIMS_VALUE_KIND::Sid:
+			case XCLAIMS_VALUE_KIND::Octet:
+				return sorted_includes(lhs.Binaries, lhs.Binaries + lhs.Count, rhs.Binaries, rhs.Binaries + rhs.Count);
+			default:
+				return false;
+		}
+	}
+	//****************************************************************************************
+	bool sorted_intersects(const XCLAIMS_VALUES_VIEW& lhs, const XCLAIMS_VALUES_VIEW& rhs)
+	{
+		switch(lhs.Kind)
+		{
+			case XCLAIMS_VALUE_KIND::Integer:
+				return sorted_intersects(lhs.Integers, lhs.Integers + lhs.Count, rhs.Integers, rhs.Integers + rhs.Count);
+			case XCLAIMS_VALUE_KIND::String:
+				return sorted_intersects(lhs.Strings, lhs.Strings + lhs.Count, rhs.Strings, rhs.Strings + rhs.Count);
+			case XCLAIMS_VALUE_KIND::Sid:
+			case XCLAIMS_VALUE_KIND::Octet:
+				return sorted_intersects(lhs.Binaries, lhs.Binaries + lhs.Count, rhs.Binaries, rhs.Binaries + rhs.Count);
+			default:
+				return false;
+		}
+	}
+	//****************************************************************************************
+	// Row-at-a-time comparison for all relational operators
+	XCONDITIONAL_RESULT compare_values(const XCLAIMS_VALUES_VIEW& lhs, const XCLAIMS_VALUES_VIEW& rhs, const unsigned char& code)
+	{
+		#pragma region Initial check
+		if((0 == lhs.Count) || (0 == rhs.Count) || (lhs.Kind != rhs.Kind) || (XCLAIMS_VALUE_KIND::Invalid == lhs.Kind))
+			return XCONDITIONAL_RESULT::Unknown;
+		#pragma endregion
+
+		bool result = false;
+
+		#pragma region Set operators over normalized values (single merge pass)
+		if(lhs.Sorted && rhs.Sorted && (lhs.CaseSensitive == rhs.CaseSensitive))
+		{
+			switch(code)
+			{
+				case 0x80: // ==
+				case 0x81: // !=
+					result = (lhs.Count == rhs.Count) && sorted_includes(lhs, rhs);
+					return ((result != (0x81 == code)) ? XCONDITIONAL_RESULT::True : XCONDITIONAL_RESULT::False);
+				case 0x86: // XContains
+				case 0x8E: // XNot_Contains
+					result = sorted_includes(lhs, rhs);
+					return ((result != (0x8E == code)) ? XCONDITIONAL_RESULT::True : XCONDITIONAL_RESULT::False);
+				case 0x88: // XAny_of
+				case 0x8F: // XNot_Any_of
+					result = sorted_intersects(lhs, rhs);
+					return ((result != (0x8F == code)) ? XCONDITIONAL_RESULT::True : XCONDITIONAL_RESULT::False);
+				default:;
+			}
+		}
+		#pragma endregion
+
+		switch(code)
+		{
+			#pragma region Set operators
+			case 0x80: // ==
+			case 0x81: // !=
+				result = true;
+
+				for(size_t j = 0; (j < rhs.Count) && result; j++)
+					result = values_contain(lhs, rhs, j);
+
+				for(size_t i = 0; (i < lhs.Count) && result; i++)
+					result = values_contain(rhs, lhs, i);
+
+				if(0x81 == code)
+					result = !result;
+
+				break;
+			case 0x86: // XContains
+			case 0x8E: // XNot_Contains
+				result = true;
+
+				for(size_t j = 0; (j < rhs.Count) && result; j++)
+					result = values_contain(lhs, rhs, j);
+
+				if(0x8E == code)
+					result = !result;
+
+				break;
+			case 0x88: // XAny_of
+			case 0x8F: // XNot_Any_of
+				for(size_t j = 0; (j < rhs.Count) && (false == result); j++)
+					result = values_contain(lhs, rhs, j);
+
+				if(0x8F == code)
+					result = !result;
+
+				break;
+			#pragma endregion
+
+			#pragma region Ordering operators (single values only)
+			default:
+				{
+					if((1 != lhs.Count) || (1 != rhs.Count))
+						return XCONDITIONAL_RESULT::Unknown;
+
+					int compare = 0;
+
+					switch(lhs.Kind)
+					{
+						case XCLAIMS_VALUE_KIND::Integer:
+							compare = (lhs.Integers[0] < rhs.Integers[0]) ? -1 : ((lhs.Integers[0] > rhs.Integers[0]) ? 1 : 0);
+							break;
+						case XCLAIMS_VALUE_KIND::String:
+							compare = compare_ordinal(lhs.Strings[0], rhs.Strings[0], (false == lhs.CaseSensitive));
+							break;
+						default:
+							return XCONDITIONAL_RESULT::Unknown;
+					}
+
+					switch(code)
+					{
+						case 0x82: // <
+							result = (compare < 0);
+							break;
+						case 0x83: // <=
+							result = (compare <= 0);
+							break;
+						case 0x84: // >
+							result = (compare > 0);
+							break;
+						default: // >=
+							result = (compare >= 0);
+					}
+				}
+			#pragma endregion
+		}
+
+		return (result ? XCONDITIONAL_RESULT::True : XCONDITIONAL_RESULT::False);
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Class for evaluation of a conditional expression over columnar table
+	//****************************************************************************************
+	struct XCONDITIONAL_BATCH_EVALUATOR
+	{
+		XCONDITIONAL_BATCH_EVALUATOR() = delete;
+		~XCONDITIONAL_BATCH_EVALUATOR() = default;
+
+		XCONDITIONAL_BATCH_EVALUATOR(const XCONDITIONAL_EXPRESSION&);
+
+		XCLAIMS_TABLE Table() const; // Make an empty table with all necessary columns
+
+		XCONDITIONAL_BATCH_RESULT Evaluate(const XCLAIMS_TABLE&) const;
+
+		XCONDITIONAL_EVALUATOR Evaluator; // Used for "membership" operators, row-at-a-time
+
+	private:
+		// Values of all literals (and composites) are prepared only once, during construction
+		struct literal_t
+		{
+			XCLAIMS_VALUE_KIND Kind = XCLAIMS_VALUE_KIND::Invalid;
+
+			std::vector<LONG64> Integers;
+			std::vector<std::wstring> Strings;
+			std::vector<std::wstring> Folded; // Strings for comparison with case-insensitive attributes
+			std::vector<bin_t> Binaries;
+
+			XCLAIMS_VALUES_VIEW View(const bool& /*CaseSensitive*/) const;
+			void Put(const XCONDITIONAL_OPERATOR*);
+			void Normalize();
+		};
+
+		std::map<const XCONDITIONAL_OPERATOR*, literal_t> literals;
+
+		void Compile(const XCONDITIONAL_OPERATOR*);
+
+		XCONDITIONAL_BATCH_RESULT Evaluate(const XCONDITIONAL_OPERATOR*, const XCLAIMS_TABLE&) const;
+
+		const XCLAIMS_COLUMN& Column(const XCONDITIONAL_OPERATOR*, const XCLAIMS_TABLE&) const;
+		XCLAIMS_VALUES_VIEW Values(const XCONDITIONAL_OPERATOR*, const XCLAIMS_TABLE&, const size_t&, const bool&) const;
+	};
+	//****************************************************************************************
+	XCLAIMS_VALUES_VIEW XCONDITIONAL_BATCH_EVALUATOR::literal_t::View(const bool& caseSensitive) const
+	{
+		XCLAIMS_VALUES_VIEW result;
+
+		const std::vector<std::wstring>& strings = caseSensitive ? Strings : Folded;
+
+		result.Kind = Kind;
+		result.Integers = Integers.data();
+		result.Strings = strings.data();
+		result.Binaries = Binaries.data();
+		result.Count = Integers.size() + strings.size() + Binaries.size();
+		result.CaseSensitive = caseSensitive;
+		result.Sorted = true;
+
+		return result;
+	}
+	//****************************************************************************************
+	void XCONDITIONAL_BATCH_EVALUATOR::literal_t::Normalize()
+	{
+		sort_unique(Integers);
+		sort_unique(Strings);
+		sort_unique(Binaries);
+
+		Folded.clear();
+
+		for(auto&& element : Strings)
+			Folded.push_back(fold_case(element));
+
+		sort_unique(Folded);
+	}
+	//****************************************************************************************
+	void XCONDITIONAL_BATCH_EVALUATOR::literal_t::Put(const XCONDITIONAL_OPERATOR* value)
+	{
+		#pragma region Get kind of the value
+		XCLAIMS_VALUE_KIND kind = XCLAIMS_VALUE_KIND::Invalid;
+
+		switch(value->Code())
+		{
+			case 0x01: // Signed Int8 Type
+			case 0x02: // Signed Int16 Type
+			case 0x03: // Signed Int32 Type
+			case 0x04: // Signed Int64 Type
+				kind = XCLAIMS_VALUE_KIND::Integer;
+				Integers.push_back(dynamic_cast<const XCONDITIONAL_OPERATOR_INT*>(value)->Value);
+				break;
+			case 0x10: // XUnicode Type
+				kind = XCLAIMS_VALUE_KIND::String;
+				Strings.emplace_back(dynamic_cast<const XCONDITIONAL_OPERATOR_UNICODE*>(value)->View());
+				break;
+			case 0x18: // Octet String Type
+				kind = XCLAIMS_VALUE_KIND::Octet;
+				{
+					auto octet = dynamic_cast<const XCONDITIONAL_OPERATOR_OCTET*>(value)->View();
+					Binaries.emplace_back(octet.begin(), octet.end());
+				}
+				break;
+			case 0x51: // SID Type
+				kind = XCLAIMS_VALUE_KIND::Sid;
+				Binaries.push_back((bin_t)*(dynamic_cast<const XCONDITIONAL_OPERATOR_SID*>(value)->Value));
+				break;
+			case 0x50: // XComposite Type
+				for(auto&& element : dynamic_cast<const XCONDITIONAL_OPERATOR_COMPOSITE*>(value)->Value)
+					Put(element.get());
+				return;
+			default:
+				throw std::exception("XCONDITIONAL_BATCH_EVALUATOR: invalid literal");
+		}
+		#pragma endregion
+
+		#pragma region Values of different kinds could not be compared with any attribute
+		if(1 == (Integers.size() + Strings.size() + Binaries.size()))
+			Kind = kind;
+		else
+		{
+			if(Kind != kind)
+				Kind = XCLAIMS_VALUE_KIND::Invalid;
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	XCONDITIONAL_BATCH_EVALUATOR::XCONDITIONAL_BATCH_EVALUATOR(const XCONDITIONAL_EXPRESSION& expression) : Evaluator(expression)
+	{
+		Compile(Evaluator.Operator.get());
+	}
+	//****************************************************************************************
+	void XCONDITIONAL_BATCH_EVALUATOR::Compile(const XCONDITIONAL_OPERATOR* value)
+	{
+		switch(value->Code())
+		{
+			case 0x80: // ==
+			case 0x81: // !=
+			case 0x82: // <
+			case 0x83: // <=
+			case 0x84: // >
+			case 0x85: // >=
+			case 0x86: // XContains
+			case 0x88: // XAny_of
+			case 0x8E: // XNot_Contains
+			case 0x8F: // XNot_Any_of
+				{
+					auto rhs = dynamic_cast<const XCONDITIONAL_OPERATOR_BRELATIONAL*>(value)->RHS.get();
+
+					if((rhs->Code() < 0xF8) || (rhs->Code() > 0xFB)) // Attributes on RHS are read from the table
+					{
+						literals[rhs].Put(rhs);
+						literals[rhs].Normalize();
+					}
+				}
+				break;
+			case 0x87: // XExists
+			case 0x8D: // XNot_Exists
+			case 0xA2: // Logical NOT (!)
+				Compile(dynamic_cast<const XCONDITIONAL_OPERATOR_ULOGICAL*>(value)->Value.get());
+				break;
+			case 0xA0: // Logical AND (&&)
+			case 0xA1: // Logical OR (||)
+				{
+					auto op = dynamic_cast<const XCONDITIONAL_OPERATOR_BLOGICAL*>(value);
+
+					Compile(op->LHS.get());
+					Compile(op->RHS.get());
+				}
+				break;
+			default:;
+		}
+	}
+	//****************************************************************************************
+	XCLAIMS_TABLE XCONDITIONAL_BATCH_EVALUATOR::Table() const
+	{
+		return XCLAIMS_TABLE(Evaluator.References);
+	}
+	//****************************************************************************************
+	const XCLAIMS_COLUMN& XCONDITIONAL_BATCH_EVALUATOR::Column(const XCONDITIONAL_OPERATOR* value, const XCLAIMS_TABLE& table) const
+	{
+		#pragma region Get correct columns
+		const std::map<std::wstring, XCLAIMS_COLUMN, wstring_iless>* columns = nullptr;
+
+		switch(value->Code())
+		{
+			case 0xF8: // XLocal Attribute
+				columns = &table.Local;
+				break;
+			case 0xF9: // XUser Attribute
+				columns = &table.User;
+				break;
+			case 0xFA: // XResource Attribute
+				columns = &table.Resource;
+				break;
+			case 0xFB: // XDevice Attribute
+				columns = &table.Device;
+				break;
+			default:
+				throw std::exception("XCONDITIONAL_BATCH_EVALUATOR: attribute expected");
+		}
+		#pragma endregion
+
+		auto find = columns->find(std::wstring(dynamic_cast<const XCONDITIONAL_OPERATOR_UNICODE*>(value)->View()));
+		if(columns->end() == find)
+			throw std::exception("XCONDITIONAL_BATCH_EVALUATOR: table was not prepared for the expression");
+
+		return find->second;
+	}
+	//****************************************************************************************
+	XCLAIMS_VALUES_VIEW XCONDITIONAL_BATCH_EVALUATOR::Values(const XCONDITIONAL_OPERATOR* value, const XCLAIMS_TABLE& table, const size_t& row, const bool& caseSensitive) const
+	{
+		if((value->Code() >= 0xF8) && (value->Code() <= 0xFB))
+			return Column(value, table).Row(row);
+
+		// Literals are prepared in form of the attribute they are compared with
+		return literals.at(value).View(caseSensitive);
+	}
+	//****************************************************************************************
+	XCONDITIONAL_BATCH_RESULT XCONDITIONAL_BATCH_EVALUATOR::Evaluate(const XCLAIMS_TABLE& table) const
+	{
+		return Evaluate(Evaluator.Operator.get(), table);
+	}
+	//****************************************************************************************
+	XCONDITIONAL_BATCH_RESULT XCONDITIONAL_BATCH_EVALUATOR::Evaluate(const XCONDITIONAL_OPERATOR* value, const XCLAIMS_TABLE& table) const
+	{
+		#pragma region Initial variables
+		XCONDITIONAL_BATCH_RESULT result(table.Rows);
+
+		size_t words = result.True.size();
+		auto code = value->Code();
+		#pragma endregion
+
+		switch(code)
+		{
+			#pragma region Attribute in a logical context
+			case 0xF8: // XLocal Attribute
+			case 0xF9: // XUser Attribute
+			case 0xFA: // XResource Attribute
+			case 0xFB: // XDevice Attribute
+				{
+					auto& column = Column(value, table);
+
+					// Only a single integer (or boolean) value could be treated as a logical value
+					if((XCLAIMS_VALUE_KIND::Integer == value_kind(column.ValueType)) && column.SingleValued)
+					{
+						for(size_t i = 0; i < words; i++)
+						{
+							size_t count = std::min<size_t>(64, table.Rows - (i << 6));
+							uint64_t non_zero = compare_block(column.Dense.data() + (i << 6), count, 0, 0x81);
+
+							result.True[i] = non_zero & column.Present[i];
+							result.False[i] = ~non_zero & column.Present[i];
+						}
+					}
+				}
+				break;
+			#pragma endregion
+
+			#pragma region Relational operators
+			case 0x80: // ==
+			case 0x81: // !=
+			case 0x82: // <
+			case 0x83: // <=
+			case 0x84: // >
+			case 0x85: // >=
+			case 0x86: // XContains
+			case 0x88: // XAny_of
+			case 0x8E: // XNot_Contains
+			case 0x8F: // XNot_Any_of
+				{
+					auto op = dynamic_cast<const XCONDITIONAL_OPERATOR_BRELATIONAL*>(value);
+					auto& column = Column(op->LHS.get(), table);
+
+					#pragma region Column-at-a-time for single integer values compared with integer literal
+					if((code <= 0x85) && column.SingleValued && (XCLAIMS_VALUE_KIND::Integer == value_kind(column.ValueType)))
+					{
+						auto find = literals.find(op->RHS.get());
+
+						if((literals.end() != find) && (XCLAIMS_VALUE_KIND::Integer == find->second.Kind) && (1 == find->second.Integers.size()))
+						{
+							for(size_t i = 0; i < words; i++)
+							{
+								size_t count = std::min<size_t>(64, table.Rows - (i << 6));
+								uint64_t mask = compare_block(column.Dense.data() + (i << 6), count, find->second.Integers[0], code);
+
+								result.True[i] = mask & column.Present[i];
+								result.False[i] = ~mask & column.Present[i];
+							}
+
+							break;
+						}
+					}
+					#pragma endregion
+
+					#pragma region Row-at-a-time for all other cases
+					for(size_t row = 0; row < table.Rows; row++)
+						result.Set(row, compare_values(column.Row(row), Values(op->RHS.get(), table, row, column.CaseSensitive && column.Sorted), code));
+					#pragma endregion
+				}
+				break;
+			#pragma endregion
+
+			#pragma region Membership operators
+			case 0x89: // XMember_of
+			case 0x8A: // XDevice_Member_of
+			case 0x8B: // XMember_of_Any
+			case 0x8C: // XDevice_Member_of_Any
+			case 0x90: // XNot_Member_of
+			case 0x91: // XNot_Device_Member_of
+			case 0x92: // XNot_Member_of_Any
+			case 0x93: // XNot_Device_Member_of_Any
+				for(size_t row = 0; row < table.Rows; row++)
+					result.Set(row, Evaluator.Evaluate(value, table.Groups[row]));
+
+				break;
+			#pragma endregion
+
+			#pragma region Logical operators
+			case 0x87: // XExists
+			case 0x8D: // XNot_Exists
+				{
+					auto& column = Column(dynamic_cast<const XCONDITIONAL_OPERATOR_ULOGICAL*>(value)->Value.get(), table);
+
+					for(size_t row = 0; row < table.Rows; row++)
+					{
+						bool exists = (column.Offsets[row + 1] != column.Offsets[row]);
+						result.Set(row, ((0x87 == code) == exists) ? XCONDITIONAL_RESULT::True : XCONDITIONAL_RESULT::False);
+					}
+				}
+				break;
+			case 0xA2: // Logical NOT (!)
+				{
+					auto operand = Evaluate(dynamic_cast<const XCONDITIONAL_OPERATOR_ULOGICAL*>(value)->Value.get(), table);
+
+					result.True.swap(operand.False);
+					result.False.swap(operand.True);
+				}
+				break;
+			case 0xA0: // Logical AND (&&)
+			case 0xA1: // Logical OR (||)
+				{
+					auto op = dynamic_cast<const XCONDITIONAL_OPERATOR_BLOGICAL*>(value);
+
+					auto lhs = Evaluate(op->LHS.get(), table);
+					auto rhs = Evaluate(op->RHS.get(), table);
+
+					for(size_t i = 0; i < words; i++)
+					{
+						if(0xA0 == code)
+						{
+							result.True[i] = lhs.True[i] & rhs.True[i];
+							result.False[i] = lhs.False[i] | rhs.False[i];
+						}
+						else
+						{
+							result.True[i] = lhs.True[i] | rhs.True[i];
+							result.False[i] = lhs.False[i] & rhs.False[i];
+						}
+					}
+				}
+				break;
+			#pragma endregion
+
+			default:
+				throw std::exception("XCONDITIONAL_BATCH_EVALUATOR: invalid operator");
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -1484,10 +1484,12 @@ PARTIAL_SECRETS_ACCOUNT				0x04000000
 		XBITSET(const unsigned char*, const std::array<std::array<std::wstring, 2>, S>&);
 		XBITSET(const bin_t&, const std::array<std::array<std::wstring, 2>, S>&);
 		XBITSET(const msxml_et&, const std::array<std::array<std::wstring, 2>, S>&);
+		XBITSET(XXML_READER&, const std::array<std::array<std::wstring, 2>, S>&);
 
 		explicit operator char*() const;
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		explicit operator DWORD() const;
 		explicit operator WORD() const;
@@ -1505,30 +1507,35 @@ PARTIAL_SECRETS_ACCOUNT				0x04000000
 		bool set(const std::vector<std::wstring>&, bool);
 
 		std::bitset<S> Bits;
-		const std::array<std::array<std::wstring, 2>, S> Meaning;
+
+	private:
+		std::shared_ptr<const std::array<std::array<std::wstring, 2>, S>> table; // One interned copy for all bitsets with the same meanings
+
+	public:
+		const std::array<std::array<std::wstring, 2>, S>& Meaning = *table;
 
 		const size_t Length = (S >> 3);
 	};
 	//****************************************************************************************
 	template<size_t S>
-	XBITSET<S>::XBITSET(const std::array<std::array<std::wstring, 2>, S>& meaning, const std::vector<std::wstring>& meanings) : Meaning(meaning)
+	XBITSET<S>::XBITSET(const std::array<std::array<std::wstring, 2>, S>& meaning, const std::vector<std::wstring>& meanings) : table(intern(meaning, meaning_hash(meaning)))
 	{
 		if(false == set(meanings, true))
 			throw std::exception("XBITSET: incorrect 'Meanings' array");
 	}
 	//****************************************************************************************
 	template<size_t S>
-	XBITSET<S>::XBITSET(const std::bitset<S>& bits, const std::array<std::array<std::wstring, 2>, S>& meaning) : Bits(bits), Meaning(meaning)
+	XBITSET<S>::XBITSET(const std::bitset<S>& bits, const std::array<std::array<std::wstring, 2>, S>& meaning) : Bits(bits), table(intern(meaning, meaning_hash(meaning)))
 	{
 	}
 	//****************************************************************************************
 	template<size_t S>
-	XBITSET<S>::XBITSET(const char* string, const std::array<std::array<std::wstring, 2>, S>& meaning) : Bits(string), Meaning(meaning)
+	XBITSET<S>::XBITSET(const char* string, const std::array<std::array<std::wstring, 2>, S>& meaning) : Bits(string), table(intern(meaning, meaning_hash(meaning)))
 	{
 	}
 	//****************************************************************************************
 	template<size_t S>
-	XBITSET<S>::XBITSET(const unsigned char* data, const std::array<std::array<std::wstring, 2>, S>& meaning) : Meaning(meaning)
+	XBITSET<S>::XBITSET(const unsigned char* data, const std::array<std::array<std::wstring, 2>, S>& meaning) : table(intern(meaning, meaning_hash(meaning)))
 	{
 		#pragma region Initial check
 		if(nullptr == data)
@@ -1550,12 +1557,12 @@ PARTIAL_SECRETS_ACCOUNT				0x04000000
 	}
 	//****************************************************************************************
 	template<size_t S>
-	XBITSET<S>::XBITSET(const bin_t& data, const std::array<std::array<std::wstring, 2>, S>& meaning) : Meaning(meaning), Bits(set_vec<S>(data))
+	XBITSET<S>::XBITSET(const bin_t& data, const std::array<std::array<std::wstring, 2>, S>& meaning) : Bits(set_vec<S>(data)), table(intern(meaning, meaning_hash(meaning)))
 	{
 	}
 	//****************************************************************************************
 	template<size_t S>
-	XBITSET<S>::XBITSET(const msxml_et& xml, const std::array<std::array<std::wstring, 2>, S>& meaning) : Meaning(meaning)
+	XBITSET<S>::XBITSET(const msxml_et& xml, const std::array<std::array<std::wstring, 2>, S>& meaning) : table(intern(meaning, meaning_hash(meaning)))
 	{
 		#pragma region Additional check
 		if(nullptr == xml)
@@ -1593,6 +1600,45 @@ PARTIAL_SECRETS_ACCOUNT				0x04000000
 	}
 	//****************************************************************************************
 	template<size_t S>
+	XBITSET<S>::XBITSET(XXML_READER& xml, const std::array<std::array<std::wstring, 2>, S>& meaning) : table(intern(meaning, meaning_hash(meaning)))
+	{
+		bool found = false;
+
+		// Both "Data" and "Bits" are written, "Data" is shorter and is used when present
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("Data" == xml.Name())
+			{
+				Bits = set_vec<S>(xml.Hex());
+				found = true;
+			}
+			else if(("Bits" == xml.Name()) && (false == found))
+			{
+				std::bitset<S> bits;
+
+				size_t level = xml.Depth();
+				while(xml.Child(level))
+				{
+					size_t index = S;
+					std::from_chars(xml.Name().data() + 1, xml.Name().data() + xml.Name().size(), index);
+
+					if((xml.Name().size() < 2) || ('b' != xml.Name()[0]) || (index >= S))
+						throw std::exception("XBITSET: invalid name of bit in input XML");
+
+					bits[index] = ("0" != xml.Text());
+				}
+
+				Bits = bits;
+				found = true;
+			}
+		}
+
+		if(false == found)
+			throw std::exception("XBITSET: no 'Bits' and 'Data' in input XML");
+	}
+	//****************************************************************************************
+	template<size_t S>
 	XBITSET<S>::operator char*() const
 	{
 		return Bits.to_string();
@@ -1670,6 +1716,40 @@ PARTIAL_SECRETS_ACCOUNT				0x04000000
 	}
 	//****************************************************************************************
 	template<size_t S>
+	void XBITSET<S>::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("XBITSET"));
+
+		#pragma region Data
+		xml.Start("Data");
+		xml.Hex(vec_set(Bits));
+		xml.End();
+		#pragma endregion
+
+		#pragma region Bits
+		xml.Start("Bits");
+
+		for(size_t i = 0; i < Bits.size(); i++)
+		{
+			char name[] = { 'b', (char)('0' + i / 10), (char)('0' + i % 10), 0 };
+
+			xml.Start(name);
+
+			const std::wstring& meaning = Meaning.at(i).at(0);
+			if(meaning.empty() == false)
+				xml.Attribute("Meaning", meaning);
+
+			xml.Text(Bits[i] ? "1" : "0");
+			xml.End();
+		}
+
+		xml.End();
+		#pragma endregion
+
+		xml.End();
+	}
+	//****************************************************************************************
+	template<size_t S>
 	XBITSET<S>::operator DWORD()const
 	{
 		throw std::exception("XBITSET: can cast to DWORD for XBITSET<32> only");
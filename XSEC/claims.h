@@ -35,10 +35,12 @@ namespace XSEC
 		XSECURITY_ATTRIBUTE_FQBN_VALUE(const CLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE&);
 		XSECURITY_ATTRIBUTE_FQBN_VALUE(const TOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE&);
 		XSECURITY_ATTRIBUTE_FQBN_VALUE(const msxml_et&);
+		XSECURITY_ATTRIBUTE_FQBN_VALUE(XXML_READER&);
 
 		explicit operator CLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE() const;
 		explicit operator TOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		DWORD64 Version = 1;
 		std::wstring Name;
@@ -59,9 +61,8 @@ namespace XSEC
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_FQBN_VALUE::XSECURITY_ATTRIBUTE_FQBN_VALUE(const TOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE& value) : Version(value.Version)
 	{
-		Name.clear();
-		Name.resize(value.Name.Length);
-		memcpy(Name.data(), value.Name.Buffer, value.Name.Length);
+		// Length of UNICODE_STRING is in bytes
+		Name.assign(value.Name.Buffer, value.Name.Length / sizeof(wchar_t));
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_FQBN_VALUE::XSECURITY_ATTRIBUTE_FQBN_VALUE(const msxml_et& xml)
@@ -88,6 +89,33 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_FQBN_VALUE::XSECURITY_ATTRIBUTE_FQBN_VALUE(XXML_READER& xml)
+	{
+		bool version = false;
+		bool name = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("Version" == xml.Name())
+			{
+				Version = xml.Number<DWORD64>();
+				version = true;
+			}
+			else if("Name" == xml.Name())
+			{
+				Name = xml.WText();
+				name = true;
+			}
+		}
+
+		if(false == version)
+			throw std::exception("XSECURITY_ATTRIBUTE_FQBN_VALUE: cannot find 'Version' XML node");
+
+		if(false == name)
+			throw std::exception("XSECURITY_ATTRIBUTE_FQBN_VALUE: cannot find 'Name' XML node");
+	}
+	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_FQBN_VALUE::operator CLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE() const
 	{
 		return { Version, (PWSTR)Name.data() };
@@ -151,6 +179,188 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_FQBN_VALUE::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("XSECURITY_ATTRIBUTE_FQBN_VALUE"));
+
+		xml.Element("Version", Version);
+		xml.Element("Name", Name);
+
+		xml.End();
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Parsed FQBN for bulk evaluation of application identity policies
+	//****************************************************************************************
+	// Name is split into "publisher\product\file" segments, each segment is interned case-insensitively
+	// and stored as an identifier. Version has the same packed form as in FQBN claims: four 16-bit parts
+	// from major (highest word) to revision. Parsing does not allocate memory for already known segments.
+	struct XFQBN_NAME
+	{
+		XFQBN_NAME() = delete;
+		~XFQBN_NAME() = default;
+
+		XFQBN_NAME(std::wstring_view, const DWORD64& = 0);
+		XFQBN_NAME(const XSECURITY_ATTRIBUTE_FQBN_VALUE&);
+
+		bool Matches(const XFQBN_NAME&) const; // Argument is a pattern: segments are equal or "*", missing trailing segments match anything
+		int CompareVersion(const XFQBN_NAME&) const;
+
+		static DWORD64 PackVersion(std::wstring_view); // "10.0.19041.1" -> 0x000A00004A610001, missing parts are zeros
+		static std::wstring UnpackVersion(const DWORD64&);
+
+		static constexpr DWORD Any = 0xFFFFFFFF; // Identifier for "*" segment
+
+		std::array<DWORD, 3> Segments{}; // Publisher, product, file
+		unsigned char Count = 0;
+		DWORD64 Version = 0;
+
+	private:
+		struct hash_t
+		{
+			using is_transparent = void;
+			size_t operator()(std::wstring_view value) const { return std::hash<std::wstring_view>{}(value); }
+		};
+
+		struct table_t
+		{
+			std::shared_mutex mutex;
+			std::unordered_map<std::wstring, DWORD, hash_t, std::equal_to<>> ids;
+		};
+
+		static table_t& table();
+		static DWORD intern(std::wstring_view);
+	};
+	//****************************************************************************************
+	XFQBN_NAME::table_t& XFQBN_NAME::table()
+	{
+		static table_t result;
+		return result;
+	}
+	//****************************************************************************************
+	DWORD XFQBN_NAME::intern(std::wstring_view segment)
+	{
+		if(L"*" == segment)
+			return Any;
+
+		#pragma region Fold case into a stack buffer if possible
+		wchar_t buffer[MAX_PATH];
+		std::wstring heap;
+
+		std::wstring_view folded;
+
+		if(segment.size() <= MAX_PATH)
+		{
+			std::transform(segment.begin(), segment.end(), buffer, fold_char);
+
+			folded = std::wstring_view(buffer, segment.size());
+		}
+		else
+		{
+			heap = fold_case(segment);
+			folded = heap;
+		}
+		#pragma endregion
+
+		table_t& segments = table();
+
+		#pragma region Fast path for already known segments
+		{
+			std::shared_lock lock(segments.mutex);
+
+			auto found = segments.ids.find(folded);
+			if(found != segments.ids.end())
+				return found->second;
+		}
+		#pragma endregion
+
+		std::unique_lock lock(segments.mutex);
+
+		return segments.ids.try_emplace(std::wstring(folded), (DWORD)(segments.ids.size() + 1)).first->second;
+	}
+	//****************************************************************************************
+	XFQBN_NAME::XFQBN_NAME(std::wstring_view name, const DWORD64& version) : Version(version)
+	{
+		while(name.size())
+		{
+			if(Count == Segments.size())
+				throw std::exception("XFQBN_NAME: too many segments in FQBN");
+
+			size_t position = name.find(L'\\');
+
+			Segments[Count++] = intern(name.substr(0, position));
+
+			if(std::wstring_view::npos == position)
+				break;
+
+			name.remove_prefix(position + 1);
+		}
+	}
+	//****************************************************************************************
+	XFQBN_NAME::XFQBN_NAME(const XSECURITY_ATTRIBUTE_FQBN_VALUE& value) : XFQBN_NAME(value.Name, value.Version)
+	{
+	}
+	//****************************************************************************************
+	bool XFQBN_NAME::Matches(const XFQBN_NAME& pattern) const
+	{
+		if(pattern.Count > Count)
+			return false;
+
+		for(unsigned char i = 0; i < pattern.Count; i++)
+		{
+			if((Segments[i] != pattern.Segments[i]) && (Any != pattern.Segments[i]))
+				return false;
+		}
+
+		return true;
+	}
+	//****************************************************************************************
+	int XFQBN_NAME::CompareVersion(const XFQBN_NAME& value) const
+	{
+		return (Version > value.Version) - (Version < value.Version);
+	}
+	//****************************************************************************************
+	DWORD64 XFQBN_NAME::PackVersion(std::wstring_view value)
+	{
+		DWORD64 result = 0;
+		DWORD part = 0;
+		int parts = 0;
+		bool digits = false;
+
+		for(size_t i = 0; i <= value.size(); i++)
+		{
+			if((i == value.size()) || (L'.' == value[i]))
+			{
+				if((false == digits) || (parts == 4))
+					throw std::exception("XFQBN_NAME: invalid version");
+
+				result |= (DWORD64)part << (48 - 16 * parts++);
+
+				part = 0;
+				digits = false;
+
+				continue;
+			}
+
+			if((value[i] < L'0') || (value[i] > L'9'))
+				throw std::exception("XFQBN_NAME: invalid version");
+
+			part = part * 10 + (value[i] - L'0');
+			digits = true;
+
+			if(part > 0xFFFF)
+				throw std::exception("XFQBN_NAME: invalid version");
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	std::wstring XFQBN_NAME::UnpackVersion(const DWORD64& value)
+	{
+		return std::to_wstring((value >> 48) & 0xFFFF) + L"." + std::to_wstring((value >> 32) & 0xFFFF) + L"." + std::to_wstring((value >> 16) & 0xFFFF) + L"." + std::to_wstring(value & 0xFFFF);
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Class for working with XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE structure (XTOKEN and CLAIM)
@@ -167,6 +377,7 @@ namespace XSEC
 
 		explicit operator CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		bin_t Value;
 	};
@@ -188,37 +399,653 @@ namespace XSEC
 			throw std::exception("XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE: invalid input XML");
 		#pragma endregion
 
-		#pragma region pValue
-		Value = from_hex_codes((wchar_t*)xml->text);
-		#pragma endregion
+		#pragma region pValue
+		Value = from_hex_codes((wchar_t*)xml->text);
+		#pragma endregion
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE::operator CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE() const
+	{
+		return { (PVOID)Value.data(), (DWORD)Value.size() };
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE::operator xml_t() const
+	{
+		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
+		{
+			#pragma region Additional check
+			if(nullptr == xml)
+				throw std::exception("XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE: invalid input XML");
+			#pragma endregion
+
+			#pragma region Root element
+			msxml_et cattr = xml->createElement(std::wstring(root.value_or(L"XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE")).c_str());
+			if(nullptr == cattr)
+				throw std::exception("XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE: cannot create root XML node");
+			#pragma endregion
+
+			#pragma region pValue
+			cattr->appendChild(xml->createTextNode(hex_codes(Value).c_str()));
+			#pragma endregion
+
+			return cattr;
+		};
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE"));
+		xml.Hex(Value);
+		xml.End();
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Non-owning reader for relative (self-relative binary) form of XSECURITY_ATTRIBUTE_V1
+	//****************************************************************************************
+	struct XSECURITY_ATTRIBUTE_V1_READER
+	{
+		XSECURITY_ATTRIBUTE_V1_READER() = delete;
+		~XSECURITY_ATTRIBUTE_V1_READER() = default;
+
+		XSECURITY_ATTRIBUTE_V1_READER(std::span<const unsigned char>); // Data must outlive the reader
+		XSECURITY_ATTRIBUTE_V1_READER(const std::shared_ptr<bin_t>&); // Reader keeps the buffer alive
+
+		// Values for CLAIM_SECURITY_ATTRIBUTE_TYPE_SID and CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING are both "span" on raw data
+		using value_type = std::variant<LONG64, DWORD64, std::wstring_view, std::span<const unsigned char>>;
+
+		#pragma region Forward iterator reading values one by one, directly from the buffer
+		struct iterator
+		{
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = XSECURITY_ATTRIBUTE_V1_READER::value_type;
+			using pointer = const value_type*;
+			using reference = const value_type&;
+
+			reference operator*() const { return value; }
+			pointer operator->() const { return &value; }
+
+			iterator& operator++();
+			iterator operator++(int);
+
+			bool operator==(const iterator& other) const { return (index == other.index); }
+			bool operator!=(const iterator& other) const { return (index != other.index); }
+
+		private:
+			friend struct XSECURITY_ATTRIBUTE_V1_READER;
+
+			iterator(const XSECURITY_ATTRIBUTE_V1_READER*, const DWORD&, const size_t&);
+
+			const XSECURITY_ATTRIBUTE_V1_READER* reader = nullptr;
+
+			DWORD index = 0;
+			size_t offset = 0;
+			size_t next = 0;
+
+			value_type value;
+		};
+		#pragma endregion
+
+		iterator begin() const;
+		iterator end() const;
+
+		#pragma region Comparisons without decoding of values
+		bool NameEquals(std::wstring_view) const; // Case-insensitive, same as Windows compares claim names
+
+		bool Contains(const LONG64&) const; // For all integer types, including CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN
+		bool Contains(std::wstring_view) const; // Case-insensitive unless CLAIM_SECURITY_ATTRIBUTE_VALUE_CASE_SENSITIVE is set
+		bool Contains(const XSID&) const;
+		bool Contains(std::span<const unsigned char>) const;
+		#pragma endregion
+
+		std::wstring_view Name;
+		WORD ValueType = 0;
+		DWORD Flags = 0;
+		DWORD ValueCount = 0;
+
+	private:
+		std::shared_ptr<bin_t> source;
+		std::span<const unsigned char> data;
+
+		size_t offset_values = 0;
+
+		std::wstring_view read_string(const size_t&, size_t&) const;
+		value_type read_value(const size_t&, size_t&) const;
+	};
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1_READER::XSECURITY_ATTRIBUTE_V1_READER(const std::shared_ptr<bin_t>& _source) : XSECURITY_ATTRIBUTE_V1_READER((nullptr == _source) ? std::span<const unsigned char>{} : std::span<const unsigned char>(*_source))
+	{
+		source = _source;
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1_READER::XSECURITY_ATTRIBUTE_V1_READER(std::span<const unsigned char> _data) : data(_data)
+	{
+		#pragma region Initial check
+		if(data.size() < 20)
+			throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: unexpected end of data");
+		#pragma endregion
+
+		#pragma region Fixed part
+		DWORD offset_name = 0;
+		DWORD offset = 0;
+
+		memcpy(&offset_name, data.data(), sizeof(DWORD));
+		memcpy(&ValueType, data.data() + 4, sizeof(WORD));
+		memcpy(&Flags, data.data() + 8, sizeof(DWORD));
+		memcpy(&ValueCount, data.data() + 12, sizeof(DWORD));
+		memcpy(&offset, data.data() + 16, sizeof(DWORD));
+
+		offset_values = offset;
+		#pragma endregion
+
+		#pragma region Name
+		size_t next = 0;
+		Name = read_string(offset_name, next);
+		#pragma endregion
+
+		#pragma region Additional checks
+		switch(ValueType)
+		{
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+				if(((data.size() - std::min(data.size(), offset_values)) / sizeof(LONG64)) < ValueCount)
+					throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: unexpected end of data");
+
+				break;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
+				if(ValueCount && (offset_values >= data.size()))
+					throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: unexpected end of data");
+
+				break;
+			default:
+				throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: invalid ValueType");
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	std::wstring_view XSECURITY_ATTRIBUTE_V1_READER::read_string(const size_t& offset, size_t& next) const
+	{
+		// UTF-16 data inside the buffer could be unaligned, it is fine for all Windows targets
+		const wchar_t* begin = (const wchar_t*)(data.data() + offset);
+
+		for(size_t i = offset; (i + 1) < data.size(); i += sizeof(wchar_t))
+		{
+			if((0 == data[i]) && (0 == data[i + 1]))
+			{
+				next = i + sizeof(wchar_t);
+				return std::wstring_view(begin, (i - offset) / sizeof(wchar_t));
+			}
+		}
+
+		throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: unexpected end of data");
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1_READER::value_type XSECURITY_ATTRIBUTE_V1_READER::read_value(const size_t& offset, size_t& next) const
+	{
+		switch(ValueType)
+		{
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+				{
+					if((offset + sizeof(LONG64)) > data.size())
+						throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: unexpected end of data");
+
+					next = offset + sizeof(LONG64);
+
+					if(CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64 == ValueType)
+					{
+						LONG64 value = 0;
+						memcpy(&value, data.data() + offset, sizeof(LONG64));
+
+						return value;
+					}
+
+					DWORD64 value = 0;
+					memcpy(&value, data.data() + offset, sizeof(DWORD64));
+
+					return value;
+				}
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+				return read_string(offset, next);
+			default: // CLAIM_SECURITY_ATTRIBUTE_TYPE_SID and CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING
+				{
+					if((offset + sizeof(DWORD)) > data.size())
+						throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: unexpected end of data");
+
+					DWORD length = 0;
+					memcpy(&length, data.data() + offset, sizeof(DWORD));
+
+					if(length > (data.size() - offset - sizeof(DWORD)))
+						throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: unexpected end of data");
+
+					auto value = data.subspan(offset + sizeof(DWORD), length);
+
+					if(CLAIM_SECURITY_ATTRIBUTE_TYPE_SID == ValueType)
+					{
+						if((length < 8) || (length != (8 + value[1] * sizeof(DWORD))))
+							throw std::exception("XSECURITY_ATTRIBUTE_V1_READER: invalid length for SID element");
+					}
+
+					next = offset + sizeof(DWORD) + length;
+
+					return value;
+				}
+		}
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1_READER::iterator::iterator(const XSECURITY_ATTRIBUTE_V1_READER* _reader, const DWORD& _index, const size_t& _offset) : reader(_reader), index(_index), offset(_offset)
+	{
+		if(index < reader->ValueCount)
+			value = reader->read_value(offset, next);
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1_READER::iterator& XSECURITY_ATTRIBUTE_V1_READER::iterator::operator++()
+	{
+		offset = next;
+
+		if(++index < reader->ValueCount)
+			value = reader->read_value(offset, next);
+
+		return *this;
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1_READER::iterator XSECURITY_ATTRIBUTE_V1_READER::iterator::operator++(int)
+	{
+		iterator result = *this;
+		++(*this);
+
+		return result;
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1_READER::iterator XSECURITY_ATTRIBUTE_V1_READER::begin() const
+	{
+		return iterator(this, 0, offset_values);
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1_READER::iterator XSECURITY_ATTRIBUTE_V1_READER::end() const
+	{
+		return iterator(this, ValueCount, 0);
+	}
+	//****************************************************************************************
+	bool XSECURITY_ATTRIBUTE_V1_READER::NameEquals(std::wstring_view name) const
+	{
+		return (0 == compare_ordinal(Name, name, true));
+	}
+	//****************************************************************************************
+	bool XSECURITY_ATTRIBUTE_V1_READER::Contains(const LONG64& value) const
+	{
+		if((CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64 != ValueType) && (CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64 != ValueType) && (CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN != ValueType))
+			return false;
+
+		// Values are stored one by one, there is no need to use the iterator
+		for(DWORD i = 0; i < ValueCount; i++)
+		{
+			if(0 == memcmp(data.data() + offset_values + i * sizeof(LONG64), &value, sizeof(LONG64)))
+				return true;
+		}
+
+		return false;
+	}
+	//****************************************************************************************
+	bool XSECURITY_ATTRIBUTE_V1_READER::Contains(std::wstring_view value) const
+	{
+		if(CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING != ValueType)
+			return false;
+
+		bool ignore_case = (0 == (Flags & CLAIM_SECURITY_ATTRIBUTE_VALUE_CASE_SENSITIVE));
+
+		for(auto&& element : *this)
+		{
+			auto string = std::get<std::wstring_view>(element);
+
+			if(0 == compare_ordinal(string, value, ignore_case))
+				return true;
+		}
+
+		return false;
+	}
+	//****************************************************************************************
+	bool XSECURITY_ATTRIBUTE_V1_READER::Contains(const XSID& value) const
+	{
+		if(CLAIM_SECURITY_ATTRIBUTE_TYPE_SID != ValueType)
+			return false;
+
+		bin_t sid = (bin_t)value;
+
+		for(auto&& element : *this)
+		{
+			auto bytes = std::get<std::span<const unsigned char>>(element);
+
+			if((bytes.size() == sid.size()) && std::equal(bytes.begin(), bytes.end(), sid.begin()))
+				return true;
+		}
+
+		return false;
+	}
+	//****************************************************************************************
+	bool XSECURITY_ATTRIBUTE_V1_READER::Contains(std::span<const unsigned char> value) const
+	{
+		if(CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING != ValueType)
+			return false;
+
+		for(auto&& element : *this)
+		{
+			auto bytes = std::get<std::span<const unsigned char>>(element);
+
+			if(std::equal(bytes.begin(), bytes.end(), value.begin(), value.end()))
+				return true;
+		}
+
+		return false;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Compact storage for values of XSECURITY_ATTRIBUTE_V1
+	//****************************************************************************************
+	// All values of one attribute are stored in few contiguous tables instead of one heap object per value:
+	// integers (INT64, UINT64 and BOOLEAN) in "Integers", strings (STRING and names of FQBN) in one zero-separated "Strings",
+	// SID and OCTET_STRING in one "Binaries" buffer. For strings and binaries "Offsets" keeps end of each value.
+	// Versions of FQBN go to "Integers" in parallel with "Offsets" of names, so no separate table is kept.
+	struct XSECURITY_ATTRIBUTE_VALUES
+	{
+		XSECURITY_ATTRIBUTE_VALUES() = default;
+		~XSECURITY_ATTRIBUTE_VALUES() = default;
+
+		size_t size() const;
+		bool empty() const;
+		void clear();
+
+		void Push(const LONG64&);
+		void Push(const DWORD64&);
+		void Push(std::wstring_view);
+		void Push(std::wstring_view, const DWORD64&); // For CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN
+		void Push(std::span<const unsigned char>);
+
+		LONG64 Integer(const size_t&) const;
+		DWORD64 Unsigned(const size_t&) const;
+		std::wstring_view String(const size_t&) const; // Terminating zero is right after the view
+		std::span<const unsigned char> Binary(const size_t&) const;
+		DWORD64 Version(const size_t&) const; // For CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN
+
+		std::vector<LONG64> Integers;
+		std::wstring Strings;
+		bin_t Binaries;
+		std::vector<DWORD> Offsets;
+
+	private:
+		size_t start(const size_t&) const;
+	};
+	//****************************************************************************************
+	size_t XSECURITY_ATTRIBUTE_VALUES::size() const
+	{
+		// For FQBN both tables have an entry for each value
+		return (Offsets.empty()) ? Integers.size() : Offsets.size();
+	}
+	//****************************************************************************************
+	bool XSECURITY_ATTRIBUTE_VALUES::empty() const
+	{
+		return (0 == size());
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_VALUES::clear()
+	{
+		Integers.clear();
+		Strings.clear();
+		Binaries.clear();
+		Offsets.clear();
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_VALUES::Push(const LONG64& value)
+	{
+		Integers.push_back(value);
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_VALUES::Push(const DWORD64& value)
+	{
+		Integers.push_back(static_cast<LONG64>(value));
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_VALUES::Push(std::wstring_view value)
+	{
+		Strings.append(value);
+		Strings.push_back(L'\0');
+
+		Offsets.push_back((DWORD)Strings.size());
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_VALUES::Push(std::wstring_view name, const DWORD64& version)
+	{
+		Push(name);
+		Integers.push_back(static_cast<LONG64>(version));
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_VALUES::Push(std::span<const unsigned char> value)
+	{
+		Binaries.insert(Binaries.end(), value.begin(), value.end());
+		Offsets.push_back((DWORD)Binaries.size());
+	}
+	//****************************************************************************************
+	LONG64 XSECURITY_ATTRIBUTE_VALUES::Integer(const size_t& index) const
+	{
+		return Integers.at(index);
+	}
+	//****************************************************************************************
+	DWORD64 XSECURITY_ATTRIBUTE_VALUES::Unsigned(const size_t& index) const
+	{
+		return static_cast<DWORD64>(Integers.at(index));
+	}
+	//****************************************************************************************
+	std::wstring_view XSECURITY_ATTRIBUTE_VALUES::String(const size_t& index) const
+	{
+		size_t begin = start(index);
+		return std::wstring_view(Strings.data() + begin, Offsets[index] - begin - 1);
+	}
+	//****************************************************************************************
+	std::span<const unsigned char> XSECURITY_ATTRIBUTE_VALUES::Binary(const size_t& index) const
+	{
+		size_t begin = start(index);
+		return std::span<const unsigned char>(Binaries.data() + begin, Offsets[index] - begin);
+	}
+	//****************************************************************************************
+	DWORD64 XSECURITY_ATTRIBUTE_VALUES::Version(const size_t& index) const
+	{
+		return static_cast<DWORD64>(Integers.at(index));
+	}
+	//****************************************************************************************
+	size_t XSECURITY_ATTRIBUTE_VALUES::start(const size_t& index) const
+	{
+		if(index >= Offsets.size())
+			throw std::exception("XSECURITY_ATTRIBUTE_VALUES: index out of range");
+
+		return (index) ? Offsets[index - 1] : 0;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Normalized set of values of XSECURITY_ATTRIBUTE_V1 (for set-relational operators)
+	//****************************************************************************************
+	enum class XCLAIMS_VALUE_KIND : unsigned char
+	{
+		Invalid, // Mixed or unsupported types
+		Integer, // CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64, CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64, CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN
+		String,  // CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING, CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN (name only)
+		Sid,     // CLAIM_SECURITY_ATTRIBUTE_TYPE_SID
+		Octet    // CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING
+	};
+	//****************************************************************************************
+	XCLAIMS_VALUE_KIND value_kind(const WORD& valueType)
+	{
+		switch(valueType)
+		{
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+				return XCLAIMS_VALUE_KIND::Integer;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
+				return XCLAIMS_VALUE_KIND::String;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
+				return XCLAIMS_VALUE_KIND::Sid;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
+				return XCLAIMS_VALUE_KIND::Octet;
+			default:
+				return XCLAIMS_VALUE_KIND::Invalid;
+		}
+	}
+	//****************************************************************************************
+	// Values are sorted without duplicates, so "Contains", "Any_of" and "==" are linear merges.
+	// Strings (and names of FQBN) are folded to upper case unless the set is case-sensitive, SIDs are in binary form.
+	struct XSECURITY_ATTRIBUTE_VALUE_SET
+	{
+		XSECURITY_ATTRIBUTE_VALUE_SET() = delete;
+		~XSECURITY_ATTRIBUTE_VALUE_SET() = default;
+
+		XSECURITY_ATTRIBUTE_VALUE_SET(const XSECURITY_ATTRIBUTE_VALUES&, const WORD&, const bool& /*CaseSensitive*/);
+
+		size_t size() const;
+
+		bool Includes(const XSECURITY_ATTRIBUTE_VALUE_SET&) const; // "Contains": all values of the argument are in the set
+		bool Intersects(const XSECURITY_ATTRIBUTE_VALUE_SET&) const; // "Any_of": at least one value of the argument is in the set
+		bool Equals(const XSECURITY_ATTRIBUTE_VALUE_SET&) const; // "==" for sets of values
+
+		XCLAIMS_VALUE_KIND Kind = XCLAIMS_VALUE_KIND::Invalid;
+		bool CaseSensitive = false;
+
+		std::vector<LONG64> Integers;
+		std::vector<std::wstring> Strings;
+		std::vector<bin_t> Binaries;
+
+	private:
+		// Folded, sorted and unique strings of the argument (only for sets with different case sensitivity)
+		std::vector<std::wstring> strings(const XSECURITY_ATTRIBUTE_VALUE_SET&) const;
+	};
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_VALUE_SET::XSECURITY_ATTRIBUTE_VALUE_SET(const XSECURITY_ATTRIBUTE_VALUES& values, const WORD& valueType, const bool& caseSensitive) : Kind(value_kind(valueType)), CaseSensitive(caseSensitive)
+	{
+		switch(Kind)
+		{
+			case XCLAIMS_VALUE_KIND::Integer:
+				Integers = values.Integers;
+				sort_unique(Integers);
+
+				break;
+			case XCLAIMS_VALUE_KIND::String:
+				Strings.reserve(values.size());
+
+				for(size_t i = 0; i < values.size(); i++)
+					Strings.push_back(CaseSensitive ? std::wstring(values.String(i)) : fold_case(values.String(i)));
+
+				sort_unique(Strings);
+
+				break;
+			case XCLAIMS_VALUE_KIND::Sid:
+			case XCLAIMS_VALUE_KIND::Octet:
+				Binaries.reserve(values.size());
+
+				for(size_t i = 0; i < values.size(); i++)
+				{
+					auto value = values.Binary(i);
+					Binaries.emplace_back(value.begin(), value.end());
+				}
+
+				sort_unique(Binaries);
+
+				break;
+			default:
+				throw std::exception("XSECURITY_ATTRIBUTE_VALUE_SET: invalid ValueType");
+		}
+	}
+	//****************************************************************************************
+	size_t XSECURITY_ATTRIBUTE_VALUE_SET::size() const
+	{
+		return (Integers.size() + Strings.size() + Binaries.size());
+	}
+	//****************************************************************************************
+	std::vector<std::wstring> XSECURITY_ATTRIBUTE_VALUE_SET::strings(const XSECURITY_ATTRIBUTE_VALUE_SET& set) const
+	{
+		// A case-sensitive set could not restore the case of folded strings,
+		// so sets with different case sensitivity are compared case-insensitively
+		std::vector<std::wstring> result;
+		result.reserve(set.Strings.size());
+
+		for(auto&& element : set.Strings)
+			result.push_back(fold_case(element));
+
+		sort_unique(result);
+
+		return result;
 	}
 	//****************************************************************************************
-	XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE::operator CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE() const
+	bool XSECURITY_ATTRIBUTE_VALUE_SET::Includes(const XSECURITY_ATTRIBUTE_VALUE_SET& set) const
 	{
-		return { (PVOID)Value.data(), (DWORD)Value.size() };
+		if(Kind != set.Kind)
+			return false;
+
+		switch(Kind)
+		{
+			case XCLAIMS_VALUE_KIND::Integer:
+				return std::includes(Integers.begin(), Integers.end(), set.Integers.begin(), set.Integers.end());
+			case XCLAIMS_VALUE_KIND::String:
+				{
+					if(CaseSensitive == set.CaseSensitive)
+						return std::includes(Strings.begin(), Strings.end(), set.Strings.begin(), set.Strings.end());
+
+					auto lhs = strings(*this);
+					auto rhs = strings(set);
+
+					return std::includes(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+				}
+			default:
+				return std::includes(Binaries.begin(), Binaries.end(), set.Binaries.begin(), set.Binaries.end());
+		}
 	}
 	//****************************************************************************************
-	XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE::operator xml_t() const
+	bool XSECURITY_ATTRIBUTE_VALUE_SET::Intersects(const XSECURITY_ATTRIBUTE_VALUE_SET& set) const
 	{
-		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
+		if(Kind != set.Kind)
+			return false;
+
+		switch(Kind)
 		{
-			#pragma region Additional check
-			if(nullptr == xml)
-				throw std::exception("XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE: invalid input XML");
-			#pragma endregion
+			case XCLAIMS_VALUE_KIND::Integer:
+				return sorted_intersects(Integers, set.Integers);
+			case XCLAIMS_VALUE_KIND::String:
+				{
+					if(CaseSensitive == set.CaseSensitive)
+						return sorted_intersects(Strings, set.Strings);
 
-			#pragma region Root element
-			msxml_et cattr = xml->createElement(std::wstring(root.value_or(L"XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE")).c_str());
-			if(nullptr == cattr)
-				throw std::exception("XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE: cannot create root XML node");
-			#pragma endregion
+					return sorted_intersects(strings(*this), strings(set));
+				}
+			default:
+				return sorted_intersects(Binaries, set.Binaries);
+		}
+	}
+	//****************************************************************************************
+	bool XSECURITY_ATTRIBUTE_VALUE_SET::Equals(const XSECURITY_ATTRIBUTE_VALUE_SET& set) const
+	{
+		if(Kind != set.Kind)
+			return false;
 
-			#pragma region pValue
-			cattr->appendChild(xml->createTextNode(hex_codes(Value).c_str()));
-			#pragma endregion
+		switch(Kind)
+		{
+			case XCLAIMS_VALUE_KIND::Integer:
+				return (Integers == set.Integers);
+			case XCLAIMS_VALUE_KIND::String:
+				{
+					if(CaseSensitive == set.CaseSensitive)
+						return (Strings == set.Strings);
 
-			return cattr;
-		};
+					return (strings(*this) == strings(set));
+				}
+			default:
+				return (Binaries == set.Binaries);
+		}
 	}
 	//****************************************************************************************
 	#pragma endregion
@@ -230,7 +1057,7 @@ namespace XSEC
 		XSECURITY_ATTRIBUTE_V1() = delete;
 		~XSECURITY_ATTRIBUTE_V1() = default;
 
-		XSECURITY_ATTRIBUTE_V1(const XSECURITY_ATTRIBUTE_V1& copy) : Name(copy.Name), ValueType(copy.ValueType), Flags(copy.Flags), Values(copy.Values)  {}
+		XSECURITY_ATTRIBUTE_V1(const XSECURITY_ATTRIBUTE_V1& copy) : Name(copy.Name), ValueType(copy.ValueType), Flags(copy.Flags), Values(copy.Values), ValueSet(copy.ValueSet)  {}
 
 		XSECURITY_ATTRIBUTE_V1(
 			const std::wstring&, 
@@ -251,72 +1078,83 @@ namespace XSEC
 		XSECURITY_ATTRIBUTE_V1(const TOKEN_SECURITY_ATTRIBUTE_V1&);
 
 		XSECURITY_ATTRIBUTE_V1(const bin_t&);
+		XSECURITY_ATTRIBUTE_V1(const XSECURITY_ATTRIBUTE_V1_READER&);
 		XSECURITY_ATTRIBUTE_V1(const msxml_et&);
+		XSECURITY_ATTRIBUTE_V1(XXML_READER&);
 
 		explicit operator CLAIM_SECURITY_ATTRIBUTE_V1() const;
 		explicit operator TOKEN_SECURITY_ATTRIBUTE_V1() const;
 
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::vector<std::wstring> values_to_string() const;
 
+		void Normalize(); // Build "ValueSet" from current "Values"
+
+		const XSECURITY_ATTRIBUTE_VALUES& GetValues() const { return Values; }
+		XSECURITY_ATTRIBUTE_VALUES& ChangeValues() { ValueSet.reset(); return Values; } // Drops cached "ValueSet", call "Normalize" after all changes to rebuild it
+		const std::shared_ptr<const XSECURITY_ATTRIBUTE_VALUE_SET>& GetValueSet() const { return ValueSet; } // Optional, "nullptr" when not built or dropped by "ChangeValues"
+
 		std::wstring Name;
 		WORD ValueType = 0;
 		std::shared_ptr<XBITSET<32>> Flags;
 
-		// Data in the vector has types "shared_ptr" because there are using as a "persistent buffer" when converting to other types in operators.
-		// In case there are direct types each "get_if" would return a copy to initial object and at the end of block the value will disapear.
-		std::vector<std::variant<LONG64, DWORD64, std::shared_ptr<std::wstring>, std::shared_ptr<XSECURITY_ATTRIBUTE_FQBN_VALUE>, std::shared_ptr<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>, std::shared_ptr<XSID>>> Values;
-
 		private:
-		// Two different buffer in order to give a user ability to cast to different types from same instance
-		std::unique_ptr<bin_t> buffer_claim = std::make_unique<bin_t>();
-		std::unique_ptr<bin_t> buffer_token = std::make_unique<bin_t>();
+		XSECURITY_ATTRIBUTE_VALUES Values;
+		std::shared_ptr<const XSECURITY_ATTRIBUTE_VALUE_SET> ValueSet; // Always built from current "Values", all changes go through "ChangeValues"
+
+		// Two different buffer in order to give a user ability to cast to different types from same instance.
+		// Buffers keep only arrays of pointers into "Values", both are in one block allocated on first conversion only.
+		mutable std::unique_ptr<std::array<bin_t, 2>> buffers; // [0] for CLAIM_SECURITY_ATTRIBUTE_V1, [1] for TOKEN_SECURITY_ATTRIBUTE_V1
 
-		std::unique_ptr<std::vector<bin_t>> bins = std::make_unique<std::vector<bin_t>>();
+		void CheckValues() const;
 	};
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const std::wstring& name, const std::initializer_list<int>& list, const XBITSET<32>& flags) : Name(name), ValueType(CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64), Flags(std::make_shared<XBITSET<32>>(flags))
 	{
 		for(auto&& element : list)
-			Values.push_back(static_cast<LONG64>(element));
+			Values.Push(static_cast<LONG64>(element));
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const std::wstring& name, const std::initializer_list<LONG64>& list, const XBITSET<32>& flags) : Name(name), ValueType(CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64), Flags(std::make_shared<XBITSET<32>>(flags))
 	{
 		for(auto&& element : list)
-			Values.push_back(element);
+			Values.Push(element);
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const std::wstring& name, const std::initializer_list<bool>& list, const XBITSET<32>& flags) : Name(name), ValueType(CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN), Flags(std::make_shared<XBITSET<32>>(flags))
 	{
 		for(auto&& element : list)
-			Values.push_back(static_cast<DWORD64>(element));
+			Values.Push(static_cast<DWORD64>(element));
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const std::wstring& name, const std::initializer_list<const wchar_t*>& list, const XBITSET<32>& flags) : Name(name), ValueType(CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING), Flags(std::make_shared<XBITSET<32>>(flags))
 	{
 		for(auto&& element : list)
-			Values.push_back(std::make_shared<std::wstring>(element));
+			Values.Push(std::wstring_view(element));
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const std::wstring& name, const std::initializer_list<bin_t>& list, const XBITSET<32>& flags) : Name(name), ValueType(CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING), Flags(std::make_shared<XBITSET<32>>(flags))
 	{
 		for(auto&& element : list)
-			Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>(element));
+			Values.Push(std::span<const unsigned char>(element));
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const std::wstring& name, const std::initializer_list<XSID>& list, const XBITSET<32>& flags) : Name(name), ValueType(CLAIM_SECURITY_ATTRIBUTE_TYPE_SID), Flags(std::make_shared<XBITSET<32>>(flags))
 	{
 		for(auto&& element : list)
-			Values.push_back(std::make_shared<XSID>(element));
+		{
+			bin_t sid = (bin_t)element;
+			Values.Push(std::span<const unsigned char>(sid));
+		}
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const std::wstring& name, const std::initializer_list<XSECURITY_ATTRIBUTE_FQBN_VALUE>& list, const XBITSET<32>& flags) : Name(name), ValueType(CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN), Flags(std::make_shared<XBITSET<32>>(flags))
 	{
 		for(auto&& element : list)
-			Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_FQBN_VALUE>(element));
+			Values.Push(element.Name, element.Version);
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(
@@ -335,7 +1173,7 @@ namespace XSEC
 					if(nullptr == get_if)
 						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
 
-					Values.push_back(*get_if);
+					Values.Push(*get_if);
 				}
 
 				break;
@@ -347,7 +1185,7 @@ namespace XSEC
 					if(nullptr == get_if)
 						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
 
-					Values.push_back(*get_if);
+					Values.Push(*get_if);
 				}
 
 				break;
@@ -358,7 +1196,7 @@ namespace XSEC
 					if(nullptr == get_if)
 						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
 
-					Values.push_back(std::make_shared<std::wstring>(*get_if));
+					Values.Push(std::wstring_view(*get_if));
 				}
 
 				break;
@@ -369,7 +1207,7 @@ namespace XSEC
 					if(nullptr == get_if)
 						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
 
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_FQBN_VALUE>(*get_if));
+					Values.Push(get_if->Name, get_if->Version);
 				}
 
 				break;
@@ -380,7 +1218,8 @@ namespace XSEC
 					if(nullptr == get_if)
 						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
 
-					Values.push_back(std::make_shared<XSID>(*get_if));
+					bin_t sid = (bin_t)*get_if;
+					Values.Push(std::span<const unsigned char>(sid));
 				}
 
 				break;
@@ -391,7 +1230,7 @@ namespace XSEC
 					if(nullptr == get_if)
 						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
 
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>(*get_if));
+					Values.Push(std::span<const unsigned char>(get_if->Value));
 				}
 
 				break;
@@ -418,34 +1257,36 @@ namespace XSEC
 		switch(ValueType)
 		{
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(value.Values.pInt64[i]);
-
+				Values.Integers.assign(value.Values.pInt64, value.Values.pInt64 + value.ValueCount);
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(value.Values.pUint64[i]);
+					Values.Push(value.Values.pUint64[i]);
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(std::make_shared<std::wstring>(value.Values.ppString[i]));
+					Values.Push(std::wstring_view(value.Values.ppString[i]));
 					
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_FQBN_VALUE>(value.Values.pFqbn[i]));
+					Values.Push(std::wstring_view(value.Values.pFqbn[i].Name), value.Values.pFqbn[i].Version);
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(std::make_shared<XSID>((BYTE*)(value.Values.pOctetString[i].pValue)));
+				{
+					// Length of SID is taken from the SID itself, not from "ValueLength"
+					bin_t sid = (bin_t)XSID((BYTE*)(value.Values.pOctetString[i].pValue));
+					Values.Push(std::span<const unsigned char>(sid));
+				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>(value.Values.pOctetString[i]));
+					Values.Push(std::span<const unsigned char>((const unsigned char*)value.Values.pOctetString[i].pValue, value.Values.pOctetString[i].ValueLength));
 
 				break;
 			default:
@@ -457,9 +1298,8 @@ namespace XSEC
 	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const TOKEN_SECURITY_ATTRIBUTE_V1& value)
 	{
 		#pragma region Name
-		Name.clear();
-		Name.resize(value.Name.Length);
-		memcpy(Name.data(), value.Name.Buffer, value.Name.Length);
+		// "Length" in UNICODE_STRING is in bytes
+		Name.assign(value.Name.Buffer, value.Name.Length / sizeof(wchar_t));
 		#pragma endregion
 
 		#pragma region ValueType
@@ -474,40 +1314,35 @@ namespace XSEC
 		switch(ValueType)
 		{
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(value.Values.pInt64[i]);
-
+				Values.Integers.assign(value.Values.pInt64, value.Values.pInt64 + value.ValueCount);
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(value.Values.pUint64[i]);
+					Values.Push(value.Values.pUint64[i]);
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-				{
-					std::wstring string;
-					string.resize(value.Values.ppString[i].Length);
-					memcpy(string.data(), value.Values.ppString[i].Buffer, value.Values.ppString[i].Length);
-
-					Values.push_back(std::make_shared<std::wstring>(string));
-				}
+					Values.Push(std::wstring_view(value.Values.ppString[i].Buffer, value.Values.ppString[i].Length / sizeof(wchar_t)));
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_FQBN_VALUE>(value.Values.pFqbn[i]));
+					Values.Push(std::wstring_view(value.Values.pFqbn[i].Name.Buffer, value.Values.pFqbn[i].Name.Length / sizeof(wchar_t)), value.Values.pFqbn[i].Version);
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(std::make_shared<XSID>((BYTE*)(value.Values.pOctetString[i].pValue)));
+				{
+					bin_t sid = (bin_t)XSID((BYTE*)(value.Values.pOctetString[i].pValue));
+					Values.Push(std::span<const unsigned char>(sid));
+				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
 				for(DWORD i = 0; i < value.ValueCount; i++)
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>(value.Values.pOctetString[i]));
+					Values.Push(std::span<const unsigned char>((const unsigned char*)value.Values.pOctetString[i].pValue, value.Values.pOctetString[i].ValueLength));
 
 				break;
 			default:
@@ -521,13 +1356,13 @@ namespace XSEC
 		#pragma region Initial variables
 		CLAIM_SECURITY_ATTRIBUTE_V1 result{};
 		result.Reserved = 0;
-
-		size_t i = 0;
 		#pragma endregion
 
 		#pragma region Initial check
 		if((ValueType == 0) || (Values.size() == 0))
 			throw std::exception("XSECURITY_ATTRIBUTE_V1: initialize data first");
+
+		CheckValues();
 		#pragma endregion
 
 		#pragma region Name
@@ -547,122 +1382,61 @@ namespace XSEC
 		#pragma endregion
 
 		#pragma region Values
+		if(nullptr == buffers)
+			buffers = std::make_unique<std::array<bin_t, 2>>();
+
+		bin_t& buffer_claim = (*buffers)[0];
+
 		switch(ValueType)
 		{
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-				{
-					buffer_claim->resize(Values.size() * sizeof(LONG64));
-
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<LONG64>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						((PLONG64)buffer_claim->data())[i++] = *get_if;
-					}
-
-					result.Values.pInt64 = (PLONG64)buffer_claim->data();
-				}
-
+				// Integers are stored exactly as WinAPI expects, no additional buffer needed
+				result.Values.pInt64 = (PLONG64)Values.Integers.data();
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
-				{
-					buffer_claim->resize(Values.size() * sizeof(DWORD64));
-
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<DWORD64>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						((PDWORD64)buffer_claim->data())[i++] = *get_if;
-					}
-
-					result.Values.pUint64 = (PDWORD64)buffer_claim->data();
-				}
-
+				result.Values.pUint64 = (PDWORD64)Values.Integers.data();
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
 				{
-					buffer_claim->resize(Values.size() * sizeof(PWSTR));
-
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<std::shared_ptr<std::wstring>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+					buffer_claim.resize(Values.size() * sizeof(PWSTR));
 
-						// Data would be persistent because of "variant<shared_ptr>": 
-						// even a copy from "get_if" points to exactly one source of data, not to a copy
-						((PWSTR*)buffer_claim->data())[i++] = (PWSTR)(*get_if)->data();
-					}
+					// Each string in the table has terminating zero, so pointers could be used directly
+					for(size_t i = 0; i < Values.size(); i++)
+						((PWSTR*)buffer_claim.data())[i] = (PWSTR)Values.String(i).data();
 
-					result.Values.ppString = (PWSTR*)buffer_claim->data();
+					result.Values.ppString = (PWSTR*)buffer_claim.data();
 				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
 				{
-					buffer_claim->resize(Values.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE));
+					buffer_claim.resize(Values.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE));
 
-					for(auto&& element : Values)
+					for(size_t i = 0; i < Values.size(); i++)
 					{
-						auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_FQBN_VALUE>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						// Data would be persistent because of "variant<shared_ptr>": 
-						// even a copy from "get_if" points to exactly one source of data, not to a copy
-						((PCLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_claim->data())[i++] = (CLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE)*(*get_if);
+						((PCLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_claim.data())[i].Version = Values.Version(i);
+						((PCLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_claim.data())[i].Name = (PWSTR)Values.String(i).data();
 					}
 
-					result.Values.pFqbn = (PCLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_claim->data();
+					result.Values.pFqbn = (PCLAIM_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_claim.data();
 				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
-				{
-					buffer_claim->resize(Values.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE));
-					bins->resize(Values.size());
-
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<std::shared_ptr<XSID>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						// Need to use additional buffer_claim here because binary transformation array is not persistent
-						bins->at(i) = (bin_t)*(*get_if);
-
-						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_claim->data())[i].ValueLength = bins->at(i).size();
-						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_claim->data())[i].pValue = bins->at(i).data();
-
-						i++;
-					}
-
-					result.Values.pOctetString = (PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_claim->data();
-				}
-
-				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
 				{
-					buffer_claim->resize(Values.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE));
-					bins->resize(Values.size());
+					buffer_claim.resize(Values.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE));
 
-					for(auto&& element : Values)
+					for(size_t i = 0; i < Values.size(); i++)
 					{
-						auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+						auto value = Values.Binary(i);
 
-						// Data would be persistent because of "variant<shared_ptr>": 
-						// even a copy from "get_if" points to exactly one source of data, not to a copy
-						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_claim->data())[i++] = (CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)*(*get_if);
+						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_claim.data())[i].ValueLength = (DWORD)value.size();
+						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_claim.data())[i].pValue = (PVOID)value.data();
 					}
 
-					result.Values.pOctetString = (PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_claim->data();
+					result.Values.pOctetString = (PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_claim.data();
 				}
 
 				break;
@@ -678,13 +1452,13 @@ namespace XSEC
 	{
 		#pragma region Initial variables
 		TOKEN_SECURITY_ATTRIBUTE_V1 result{};
-
-		size_t i = 0;
 		#pragma endregion
 
 		#pragma region Initial check
 		if((ValueType == 0) || (Values.size() == 0))
 			throw std::exception("XSECURITY_ATTRIBUTE_V1: initialize data first");
+
+		CheckValues();
 		#pragma endregion
 
 		#pragma region Name
@@ -710,129 +1484,76 @@ namespace XSEC
 		#pragma endregion
 
 		#pragma region Values
+		if(nullptr == buffers)
+			buffers = std::make_unique<std::array<bin_t, 2>>();
+
+		bin_t& buffer_token = (*buffers)[1];
+
 		switch(ValueType)
 		{
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-				{
-					buffer_token->resize(Values.size() * sizeof(LONG64));
-
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<LONG64>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						((PLONG64)buffer_token->data())[i++] = *get_if;
-					}
-
-					result.Values.pInt64 = (PLONG64)buffer_token->data();
-				}
-
+				result.Values.pInt64 = (PLONG64)Values.Integers.data();
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
-				{
-					buffer_token->resize(Values.size() * sizeof(DWORD64));
-
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<DWORD64>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						((PDWORD64)buffer_token->data())[i++] = *get_if;
-					}
-
-					result.Values.pUint64 = (PDWORD64)buffer_token->data();
-				}
-
+				result.Values.pUint64 = (PDWORD64)Values.Integers.data();
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
 				{
-					buffer_token->resize(Values.size() * sizeof(UNICODE_STRING));
+					buffer_token.resize(Values.size() * sizeof(UNICODE_STRING));
 
-					for(auto&& element : Values)
+					for(size_t i = 0; i < Values.size(); i++)
 					{
-						auto get_if = std::get_if<std::shared_ptr<std::wstring>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+						auto value = Values.String(i);
 
-						// Data would be persistent because of "variant<shared_ptr>": 
-						// even a copy from "get_if" points to exactly one source of data, not to a copy
 						#pragma warning(push)
 						#pragma warning(disable:4267)
-						((PUNICODE_STRING)buffer_token->data())[i].Length = (*get_if)->size() * sizeof(wchar_t);
-						((PUNICODE_STRING)buffer_token->data())[i].MaximumLength = (*get_if)->size() * sizeof(wchar_t);
+						((PUNICODE_STRING)buffer_token.data())[i].Length = value.size() * sizeof(wchar_t);
+						((PUNICODE_STRING)buffer_token.data())[i].MaximumLength = value.size() * sizeof(wchar_t);
 						#pragma warning(pop)
-						((PUNICODE_STRING)buffer_token->data())[i].Buffer = (PWSTR)(*get_if)->data();
-
-						i++;
+						((PUNICODE_STRING)buffer_token.data())[i].Buffer = (PWSTR)value.data();
 					}
 
-					result.Values.ppString = (PUNICODE_STRING)buffer_token->data();
+					result.Values.ppString = (PUNICODE_STRING)buffer_token.data();
 				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
 				{
-					buffer_token->resize(Values.size() * sizeof(TOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE));
-
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_FQBN_VALUE>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						// Data would be persistent because of "variant<shared_ptr>": 
-						// even a copy from "get_if" points to exactly one source of data, not to a copy
-						((PTOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_token->data())[i++] = (TOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE)*(*get_if);
-					}
-
-					result.Values.pFqbn = (PTOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_token->data();
-				}
-
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
-				{
-					buffer_token->resize(Values.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE));
-					bins->resize(Values.size());
+					buffer_token.resize(Values.size() * sizeof(TOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE));
 
-					for(auto&& element : Values)
+					for(size_t i = 0; i < Values.size(); i++)
 					{
-						auto get_if = std::get_if<std::shared_ptr<XSID>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						// Need to use additional buffer_token here because binary transformation array is not persistent
-						bins->at(i) = (bin_t)*(*get_if);
+						auto value = Values.String(i);
 
-						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_token->data())[i].ValueLength = bins->at(i).size();
-						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_token->data())[i].pValue = bins->at(i).data();
+						((PTOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_token.data())[i].Version = Values.Version(i);
 
-						i++;
+						#pragma warning(push)
+						#pragma warning(disable:4267)
+						((PTOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_token.data())[i].Name.Length = value.size() * sizeof(wchar_t);
+						((PTOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_token.data())[i].Name.MaximumLength = value.size() * sizeof(wchar_t);
+						#pragma warning(pop)
+						((PTOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_token.data())[i].Name.Buffer = (PWSTR)value.data();
 					}
 
-					result.Values.pOctetString = (PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_token->data();
+					result.Values.pFqbn = (PTOKEN_SECURITY_ATTRIBUTE_FQBN_VALUE)buffer_token.data();
 				}
 
 				break;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
 				{
-					buffer_token->resize(Values.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE));
-					bins->resize(Values.size());
+					buffer_token.resize(Values.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE));
 
-					for(auto&& element : Values)
+					for(size_t i = 0; i < Values.size(); i++)
 					{
-						auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+						auto value = Values.Binary(i);
 
-						// Data would be persistent because of "variant<shared_ptr>": 
-						// even a copy from "get_if" points to exactly one source of data, not to a copy
-						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_token->data())[i++] = (CLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE) * (*get_if);
+						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_token.data())[i].ValueLength = (DWORD)value.size();
+						((PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_token.data())[i].pValue = (PVOID)value.data();
 					}
 
-					result.Values.pOctetString = (PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_token->data();
+					result.Values.pOctetString = (PCLAIM_SECURITY_ATTRIBUTE_OCTET_STRING_VALUE)buffer_token.data();
 				}
 
 				break;
@@ -844,100 +1565,20 @@ namespace XSEC
 		return result;
 	}
 	//****************************************************************************************
-	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const bin_t& data)
+	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const bin_t& data) : XSECURITY_ATTRIBUTE_V1(XSECURITY_ATTRIBUTE_V1_READER(std::span<const unsigned char>(data)))
+	{
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(const XSECURITY_ATTRIBUTE_V1_READER& reader) : Name(reader.Name), ValueType(reader.ValueType)
 	{
-		#pragma region Name
-		DWORD OffsetName = 0;
-		((BYTE*)&OffsetName)[0] = data[0];
-		((BYTE*)&OffsetName)[1] = data[1];
-		((BYTE*)&OffsetName)[2] = data[2];
-		((BYTE*)&OffsetName)[3] = data[3];
-
-		Name = (wchar_t*)(data.data() + OffsetName);
-		#pragma endregion
-
-		#pragma region ValueType
-		((BYTE*)&ValueType)[0] = data[4];
-		((BYTE*)&ValueType)[1] = data[5];
-		#pragma endregion
-
 		#pragma region Flags
-		Flags = std::make_shared<XBITSET<32>>(data.data() + 8, SecurityAttributeV1Meaning);
-		#pragma endregion
-
-		#pragma region ValueCount
-		DWORD ValueCount = 0;
-
-		((BYTE*)&ValueCount)[0] = data[12];
-		((BYTE*)&ValueCount)[1] = data[13];
-		((BYTE*)&ValueCount)[2] = data[14];
-		((BYTE*)&ValueCount)[3] = data[15];
+		DWORD flags = reader.Flags;
+		Flags = std::make_shared<XBITSET<32>>((BYTE*)&flags, SecurityAttributeV1Meaning);
 		#pragma endregion
 
 		#pragma region Values
-		DWORD OffsetValues = 0;
-		((BYTE*)&OffsetValues)[0] = data[16];
-		((BYTE*)&OffsetValues)[1] = data[17];
-		((BYTE*)&OffsetValues)[2] = data[18];
-		((BYTE*)&OffsetValues)[3] = data[19];
-
-		switch(ValueType)
-		{
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-				for(DWORD i = 0; i < ValueCount; i++, OffsetValues += sizeof(LONG64))
-					Values.push_back(*((LONG64*)(data.data() + OffsetValues)));
-
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
-				for(DWORD i = 0; i < ValueCount; i++, OffsetValues += sizeof(ULONG64))
-					Values.push_back(*((ULONG64*)(data.data() + OffsetValues)));
-
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
-				for(DWORD i = 0; i < ValueCount; i++)
-				{
-					std::wstring string = (wchar_t*)(data.data() + OffsetValues);
-					OffsetValues += ((string.size() + 1) * sizeof(wchar_t));
-
-					Values.push_back(std::make_shared<std::wstring>(string.c_str()));
-				}
-
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
-				for(DWORD i = 0; i < ValueCount; i++)
-				{
-					DWORD len;
-					memcpy(&len, data.data() + OffsetValues, sizeof(DWORD));
-					OffsetValues += sizeof(DWORD);
-
-					auto sid = std::make_shared<XSID>((unsigned char*)(data.data() + OffsetValues));
-
-					if(len != sid->Length)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid length for SID element");
-
-					OffsetValues += sid->Length;
-
-					Values.push_back(sid);					 
-				}
-
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
-				for(DWORD i = 0; i < ValueCount; i++)
-				{
-					DWORD len;
-					memcpy(&len, data.data() + OffsetValues, sizeof(DWORD));
-					OffsetValues += sizeof(DWORD);
-
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>(bin_t{ data.data() + OffsetValues, data.data() + OffsetValues + len }));
-
-					OffsetValues += len;
-				}
-
-				break;
-			default:
-				throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid ValueType");
-		}
+		for(auto&& element : reader)
+			std::visit([&](auto&& arg){ Values.Push(arg); }, element);
 		#pragma endregion
 	}
 	//****************************************************************************************
@@ -946,6 +1587,8 @@ namespace XSEC
 		#pragma region Initial check
 		if((ValueType == 0) || (Values.size() == 0))
 			throw std::exception("XSECURITY_ATTRIBUTE_V1: initialize data first");
+
+		CheckValues();
 		#pragma endregion
 
 		#pragma region Initial variables
@@ -957,52 +1600,20 @@ namespace XSEC
 		switch(ValueType)
 		{
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-				length = Values.size() * sizeof(LONG64);
-				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
-				length = Values.size() * sizeof(ULONG64);
+				length = Values.size() * sizeof(LONG64);
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<std::wstring>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-					length += ((*get_if)->size() + 1) * sizeof(WCHAR);
-				}
-
+				length = Values.Strings.size() * sizeof(WCHAR); // Each value is stored with terminating zero
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<XSID>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-					length += (((bin_t)*(*get_if)).size() + sizeof(DWORD));
-				}
-
-				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-					length += ((*get_if)->Value.size() + sizeof(DWORD));
-				}
-
+				length = Values.Binaries.size() + Values.size() * sizeof(DWORD);
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
-				for(auto&& element : Values)
+				for(size_t i = 0; i < Values.size(); i++)
 				{
-					auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_FQBN_VALUE>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
 					// Variants:
 					// =========
 					// 1. () DWORD64 + DWORD64 + DWORD64 + STRING(WO/N)
@@ -1029,43 +1640,43 @@ namespace XSEC
 					// 13. () MULTI_SZ type from [MS-DTYP]
 
 					#pragma region Variant 1
-					//length += (((*get_if)->Name.size() * sizeof(WCHAR)) + sizeof(DWORD64) + sizeof(DWORD) + sizeof(DWORD));
+					//length += ((Values.String(i).size() * sizeof(WCHAR)) + sizeof(DWORD64) + sizeof(DWORD) + sizeof(DWORD));
 					#pragma endregion
 
 					#pragma region Variant 2
-					//length += ((*get_if)->Name.size() + 1) * sizeof(WCHAR);
+					//length += (Values.String(i).size() + 1) * sizeof(WCHAR);
 					#pragma endregion
 
 					#pragma region Variant 3
-					//length += (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(DWORD);
+					//length += Values.String(i).size() * sizeof(WCHAR) + sizeof(DWORD);
 					#pragma endregion
 
 					#pragma region Variant 4
-					//length += (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(DWORD) + sizeof(DWORD64);
+					//length += Values.String(i).size() * sizeof(WCHAR) + sizeof(DWORD) + sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 5
-					//length += (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(DWORD) + sizeof(DWORD64);
+					//length += Values.String(i).size() * sizeof(WCHAR) + sizeof(DWORD) + sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 6
-					//length += (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(DWORD) + sizeof(DWORD64);
+					//length += Values.String(i).size() * sizeof(WCHAR) + sizeof(DWORD) + sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 7
-					//length += (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(DWORD64) + sizeof(DWORD64);
+					//length += Values.String(i).size() * sizeof(WCHAR) + sizeof(DWORD64) + sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 8
-					//length += (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(USHORT) + sizeof(USHORT) + sizeof(DWORD64) + sizeof(DWORD);
+					//length += Values.String(i).size() * sizeof(WCHAR) + sizeof(USHORT) + sizeof(USHORT) + sizeof(DWORD64) + sizeof(DWORD);
 					#pragma endregion
 
 					#pragma region Variant 9
-					//length += (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(USHORT) + sizeof(USHORT) + sizeof(DWORD64);
+					//length += Values.String(i).size() * sizeof(WCHAR) + sizeof(USHORT) + sizeof(USHORT) + sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 10
-					//length += (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(USHORT) + sizeof(USHORT) + sizeof(DWORD64);
+					//length += Values.String(i).size() * sizeof(WCHAR) + sizeof(USHORT) + sizeof(USHORT) + sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 11
@@ -1077,7 +1688,7 @@ namespace XSEC
 					#pragma endregion
 
 					#pragma region Variant 13
-					length += ((*get_if)->Name.size() + 2) * sizeof(WCHAR) + sizeof(DWORD);
+					length += (Values.String(i).size() + 2) * sizeof(WCHAR) + sizeof(DWORD);
 					#pragma endregion
 				}
 
@@ -1128,97 +1739,45 @@ namespace XSEC
 		#pragma region OffsetValues
 		DWORD OffsetValues = 20 + ((Name.size() + 1) * sizeof(wchar_t));
 
-		result[16] = ((BYTE*)&OffsetValues)[0];
-		result[17] = ((BYTE*)&OffsetValues)[1];
-		result[18] = ((BYTE*)&OffsetValues)[2];
-		result[19] = ((BYTE*)&OffsetValues)[3];
-		#pragma endregion
-
-		#pragma region Name
-		memcpy(result.data() + 20, &Name[0], Name.size() * sizeof(wchar_t));
-		#pragma endregion
-
-		#pragma region Values
-		switch(ValueType)
-		{
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<LONG64>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-					*((LONG64*)(result.data() + OffsetValues)) = (*get_if);
-					OffsetValues += sizeof(LONG64);
-				}
-
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<DWORD64>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-					*((ULONG64*)(result.data() + OffsetValues)) = (*get_if);
-					OffsetValues += sizeof(LONG64);
-				}
-
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<std::wstring>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-					memcpy(result.data() + OffsetValues, (*get_if)->data(), (*get_if)->size() * sizeof(wchar_t));
-					OffsetValues += ((*get_if)->size() + 1) * sizeof(wchar_t);
-				}
-
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<XSID>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-					auto bin = (bin_t) * (*get_if);
-
-					DWORD len = bin.size();
-					memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
-					OffsetValues += sizeof(DWORD);
+		result[16] = ((BYTE*)&OffsetValues)[0];
+		result[17] = ((BYTE*)&OffsetValues)[1];
+		result[18] = ((BYTE*)&OffsetValues)[2];
+		result[19] = ((BYTE*)&OffsetValues)[3];
+		#pragma endregion
 
-					memcpy(result.data() + OffsetValues, bin.data(), bin.size());
-					OffsetValues += bin.size();
-				}
+		#pragma region Name
+		memcpy(result.data() + 20, &Name[0], Name.size() * sizeof(wchar_t));
+		#pragma endregion
 
+		#pragma region Values
+		switch(ValueType)
+		{
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+				memcpy(result.data() + OffsetValues, Values.Integers.data(), Values.size() * sizeof(LONG64));
+				break;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+				memcpy(result.data() + OffsetValues, Values.Strings.data(), Values.Strings.size() * sizeof(wchar_t));
 				break;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
-				for(auto&& element : Values)
+				for(size_t i = 0; i < Values.size(); i++)
 				{
-					auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+					auto value = Values.Binary(i);
 
-					DWORD len = (*get_if)->Value.size();
+					DWORD len = value.size();
 					memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					OffsetValues += sizeof(DWORD);
 
-					memcpy(result.data() + OffsetValues, (*get_if)->Value.data(), (*get_if)->Value.size());
-					OffsetValues += (*get_if)->Value.size();
+					memcpy(result.data() + OffsetValues, value.data(), value.size());
+					OffsetValues += value.size();
 				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
-				for(auto&& element : Values)
+				for(size_t i = 0; i < Values.size(); i++)
 				{
-					auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_FQBN_VALUE>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
 					// Variants:
 					// =========
 					// 1. () DWORD64 + DWORD64 + DWORD64 + STRING(WO/N)
@@ -1235,135 +1794,135 @@ namespace XSEC
 					// 3. () DWORD(Len) + STRING(WO/N)
 
 					#pragma region Variant 1
-					//memcpy(result.data() + OffsetValues, &((*get_if)->Version), sizeof(DWORD64));
+					//memcpy(result.data() + OffsetValues, &(Values.Integers[i]), sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 
-					//DWORD len = (*get_if)->Name.size() * sizeof(WCHAR);
+					//DWORD len = Values.String(i).size() * sizeof(WCHAR);
 
 					//memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					//OffsetValues += sizeof(DWORD);
 					//memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					//OffsetValues += sizeof(DWORD);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 					#pragma endregion
 
 					#pragma region Variant 2
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += ((*get_if)->Name.size() + 1) * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += (Values.String(i).size() + 1) * sizeof(WCHAR);
 					#pragma endregion
 
 					#pragma region Variant 3
-					//DWORD len = (*get_if)->Name.size() * sizeof(WCHAR);
+					//DWORD len = Values.String(i).size() * sizeof(WCHAR);
 
 					//memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					//OffsetValues += sizeof(DWORD);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 					#pragma endregion
 
 					#pragma region Variant 4
-					//DWORD len = (*get_if)->Name.size() * sizeof(WCHAR);
+					//DWORD len = Values.String(i).size() * sizeof(WCHAR);
 
 					//memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					//OffsetValues += sizeof(DWORD);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 
-					//memcpy(result.data() + OffsetValues, &((*get_if)->Version), sizeof(DWORD64));
+					//memcpy(result.data() + OffsetValues, &(Values.Integers[i]), sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 5
-					//DWORD len = (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(DWORD64);
+					//DWORD len = Values.String(i).size() * sizeof(WCHAR) + sizeof(DWORD64);
 
 					//memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					//OffsetValues += sizeof(DWORD);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 
-					//memcpy(result.data() + OffsetValues, &((*get_if)->Version), sizeof(DWORD64));
+					//memcpy(result.data() + OffsetValues, &(Values.Integers[i]), sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 6
-					//DWORD len = (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(DWORD64);
+					//DWORD len = Values.String(i).size() * sizeof(WCHAR) + sizeof(DWORD64);
 
 					//memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					//OffsetValues += sizeof(DWORD);
 
-					//memcpy(result.data() + OffsetValues, &((*get_if)->Version), sizeof(DWORD64));
+					//memcpy(result.data() + OffsetValues, &(Values.Integers[i]), sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 					#pragma endregion
 
 					#pragma region Variant 7
-					//DWORD64 len = (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(DWORD64);
+					//DWORD64 len = Values.String(i).size() * sizeof(WCHAR) + sizeof(DWORD64);
 
 					//memcpy(result.data() + OffsetValues, &len, sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 
-					//memcpy(result.data() + OffsetValues, &((*get_if)->Version), sizeof(DWORD64));
+					//memcpy(result.data() + OffsetValues, &(Values.Integers[i]), sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 					#pragma endregion
 
 					#pragma region Variant 8
-					//DWORD len = (*get_if)->Name.size() * sizeof(WCHAR) + sizeof(USHORT) + sizeof(USHORT) + sizeof(DWORD64);
+					//DWORD len = Values.String(i).size() * sizeof(WCHAR) + sizeof(USHORT) + sizeof(USHORT) + sizeof(DWORD64);
 
 					//memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					//OffsetValues += sizeof(DWORD);
 
-					//USHORT len1 = (*get_if)->Name.size() * sizeof(WCHAR);
+					//USHORT len1 = Values.String(i).size() * sizeof(WCHAR);
 
 					//memcpy(result.data() + OffsetValues, &len1, sizeof(USHORT));
 					//OffsetValues += sizeof(USHORT);
 					//memcpy(result.data() + OffsetValues, &len1, sizeof(USHORT));
 					//OffsetValues += sizeof(USHORT);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 
-					//memcpy(result.data() + OffsetValues, &((*get_if)->Version), sizeof(DWORD64));
+					//memcpy(result.data() + OffsetValues, &(Values.Integers[i]), sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 9
-					//USHORT len1 = (*get_if)->Name.size() * sizeof(WCHAR);
+					//USHORT len1 = Values.String(i).size() * sizeof(WCHAR);
 
 					//memcpy(result.data() + OffsetValues, &len1, sizeof(USHORT));
 					//OffsetValues += sizeof(USHORT);
 					//memcpy(result.data() + OffsetValues, &len1, sizeof(USHORT));
 					//OffsetValues += sizeof(USHORT);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 
-					//memcpy(result.data() + OffsetValues, &((*get_if)->Version), sizeof(DWORD64));
+					//memcpy(result.data() + OffsetValues, &(Values.Integers[i]), sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 					#pragma endregion
 
 					#pragma region Variant 10
-					//memcpy(result.data() + OffsetValues, &((*get_if)->Version), sizeof(DWORD64));
+					//memcpy(result.data() + OffsetValues, &(Values.Integers[i]), sizeof(DWORD64));
 					//OffsetValues += sizeof(DWORD64);
 
-					//USHORT len1 = (*get_if)->Name.size() * sizeof(WCHAR);
+					//USHORT len1 = Values.String(i).size() * sizeof(WCHAR);
 
 					//memcpy(result.data() + OffsetValues, &len1, sizeof(USHORT));
 					//OffsetValues += sizeof(USHORT);
 					//memcpy(result.data() + OffsetValues, &len1, sizeof(USHORT));
 					//OffsetValues += sizeof(USHORT);
 
-					//memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					//OffsetValues += (*get_if)->Name.size() * sizeof(WCHAR);
+					//memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					//OffsetValues += Values.String(i).size() * sizeof(WCHAR);
 					#pragma endregion
 
 					#pragma region Variant 11
@@ -1381,10 +1940,10 @@ namespace XSEC
 					#pragma endregion
 
 					#pragma region Variant 13
-					DWORD len = (*get_if)->Name.size() + 2;
+					DWORD len = Values.String(i).size() + 2;
 
-					memcpy(result.data() + OffsetValues, (*get_if)->Name.data(), (*get_if)->Name.size() * sizeof(WCHAR));
-					OffsetValues += ((*get_if)->Name.size() + 2) * sizeof(WCHAR);
+					memcpy(result.data() + OffsetValues, Values.String(i).data(), Values.String(i).size() * sizeof(WCHAR));
+					OffsetValues += (Values.String(i).size() + 2) * sizeof(WCHAR);
 
 					memcpy(result.data() + OffsetValues, &len, sizeof(DWORD));
 					OffsetValues += sizeof(DWORD);
@@ -1442,33 +2001,45 @@ namespace XSEC
 		{
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
 				for(long i = 0; i < values->length; i++)
-					Values.push_back(_variant_t(values->item[i]->text).operator long long());
+					Values.Push(static_cast<LONG64>(_variant_t(values->item[i]->text).operator long long()));
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
 				for(long i = 0; i < values->length; i++)
-					Values.push_back(_variant_t(values->item[i]->text).operator unsigned long long());
+					Values.Push(static_cast<DWORD64>(_variant_t(values->item[i]->text).operator unsigned long long()));
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
 				for(long i = 0; i < values->length; i++)
-					Values.push_back(std::make_shared<std::wstring>((wchar_t*)values->item[i]->text));
+				{
+					_bstr_t text = values->item[i]->text;
+					Values.Push(std::wstring_view((wchar_t*)text, text.length()));
+				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
 				for(long i = 0; i < values->length; i++)
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_FQBN_VALUE>(values->item[i]));
+				{
+					XSECURITY_ATTRIBUTE_FQBN_VALUE value(values->item[i]);
+					Values.Push(value.Name, value.Version);
+				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
 				for(long i = 0; i < values->length; i++)
-					Values.push_back(std::make_shared<XSID>(values->item[i]));
+				{
+					bin_t sid = (bin_t)XSID(values->item[i]);
+					Values.Push(std::span<const unsigned char>(sid));
+				}
 
 				break;
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
 				for(long i = 0; i < values->length; i++)
-					Values.push_back(std::make_shared<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>(values->item[i]));
+				{
+					XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE value(values->item[i]);
+					Values.Push(std::span<const unsigned char>(value.Value));
+				}
 
 				break;
 			default:
@@ -1477,6 +2048,74 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XSECURITY_ATTRIBUTE_V1::XSECURITY_ATTRIBUTE_V1(XXML_READER& xml)
+	{
+		bool name = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("Name" == xml.Name())
+			{
+				Name = xml.WText();
+				name = true;
+			}
+			else if("ValueType" == xml.Name())
+				ValueType = xml.Number<WORD>();
+			else if("Flags" == xml.Name())
+				Flags = std::make_shared<XBITSET<32>>(xml, SecurityAttributeV1Meaning);
+			else if("Value" == xml.Name())
+			{
+				// Values are written after "ValueType"
+				switch(ValueType)
+				{
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+						Values.Push(xml.Number<LONG64>());
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+						Values.Push(xml.Number<DWORD64>());
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+						Values.Push(std::wstring_view(xml.WText()));
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
+						{
+							XSECURITY_ATTRIBUTE_FQBN_VALUE value(xml);
+							Values.Push(value.Name, value.Version);
+						}
+
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
+						{
+							bin_t sid = (bin_t)XSID(xml);
+							Values.Push(std::span<const unsigned char>(sid));
+						}
+
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
+						{
+							bin_t value = xml.Hex();
+							Values.Push(std::span<const unsigned char>(value));
+						}
+
+						break;
+					default:
+						throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid ValueType");
+				}
+			}
+		}
+
+		if(false == name)
+			throw std::exception("XSECURITY_ATTRIBUTE_V1: cannot find 'Name' XML node");
+
+		if(0 == ValueType)
+			throw std::exception("XSECURITY_ATTRIBUTE_V1: cannot find 'ValueType' XML node");
+
+		if(nullptr == Flags)
+			throw std::exception("XSECURITY_ATTRIBUTE_V1: cannot find 'Flags' XML node");
+	}
+	//****************************************************************************************
 	XSECURITY_ATTRIBUTE_V1::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -1484,6 +2123,8 @@ namespace XSEC
 			#pragma region Additional check
 			if(nullptr == xml)
 				throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid input XML");
+
+			CheckValues();
 			#pragma endregion
 
 			#pragma region Root element
@@ -1521,192 +2162,271 @@ namespace XSEC
 			#pragma endregion
 
 			#pragma region Values
-			switch(ValueType)
+			for(size_t i = 0; i < Values.size(); i++)
 			{
-				case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<LONG64>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+				switch(ValueType)
+				{
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+						{
+							msxml_et value = xml->createElement(L"Value");
+							if(nullptr == value)
+								throw std::exception("XSECURITY_ATTRIBUTE_V1: cannot create 'Value' XML node");
+
+							if(CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING == ValueType)
+								value->appendChild(xml->createTextNode(Values.String(i).data()));
+							else
+							{
+								if(CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64 == ValueType)
+									value->appendChild(xml->createTextNode(_variant_t(Values.Integer(i)).operator _bstr_t()));
+								else
+									value->appendChild(xml->createTextNode(_variant_t(Values.Unsigned(i)).operator _bstr_t()));
+							}
+
+							cattr->appendChild(value);
+						}
+
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
+						cattr->appendChild(((xml_t)XSECURITY_ATTRIBUTE_FQBN_VALUE(std::wstring(Values.String(i)), Values.Version(i)))(xml, L"Value"));
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
+						cattr->appendChild(((xml_t)XSID(Values.Binary(i).data()))(xml, L"Value"));
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
+						{
+							msxml_et value = xml->createElement(L"Value");
+							if(nullptr == value)
+								throw std::exception("XSECURITY_ATTRIBUTE_V1: cannot create 'Value' XML node");
+
+							value->appendChild(xml->createTextNode(hex_codes(Values.Binary(i)).c_str()));
+
+							cattr->appendChild(value);
+						}
+
+						break;
+					default:
+						throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid ValueType");
+				}
+			}
+			#pragma endregion
+
+			return cattr;
+		};
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_V1::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		CheckValues();
 
-						msxml_et value = xml->createElement(L"Value");
-						if(nullptr == value)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: cannot create 'Value' XML node");
+		xml.Start(root.value_or("XSECURITY_ATTRIBUTE_V1"));
 
-						value->appendChild(xml->createTextNode(_variant_t(*get_if).operator _bstr_t()));
+		xml.Element("Name", Name);
+		xml.Element("ValueType", ValueType);
 
-						cattr->appendChild(value);
-					}
+		Flags->Write(xml, "Flags");
 
+		#pragma region Values
+		for(size_t i = 0; i < Values.size(); i++)
+		{
+			switch(ValueType)
+			{
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+					xml.Element("Value", Values.Integer(i));
 					break;
 				case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
 				case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<DWORD64>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						msxml_et value = xml->createElement(L"Value");
-						if(nullptr == value)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: cannot create 'Value' XML node");
-
-						value->appendChild(xml->createTextNode(_variant_t(*get_if).operator _bstr_t()));
-
-						cattr->appendChild(value);
-					}
-
+					xml.Element("Value", Values.Unsigned(i));
 					break;
 				case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<std::shared_ptr<std::wstring>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+					xml.Element("Value", Values.String(i));
+					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
+					// Same elements as XSECURITY_ATTRIBUTE_FQBN_VALUE has, without a copy of the name
+					xml.Start("Value");
+					xml.Element("Version", Values.Version(i));
+					xml.Element("Name", Values.String(i));
+					xml.End();
+					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
+					XSID(Values.Binary(i).data()).Write(xml, "Value");
+					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
+					xml.Start("Value");
+					xml.Hex(Values.Binary(i));
+					xml.End();
+					break;
+				default:
+					throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid ValueType");
+			}
+		}
+		#pragma endregion
 
-						msxml_et value = xml->createElement(L"Value");
-						if(nullptr == value)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: cannot create 'Value' XML node");
+		xml.End();
+	}
+	//****************************************************************************************
+	std::vector<std::wstring> XSECURITY_ATTRIBUTE_V1::values_to_string() const
+	{
+		std::vector<std::wstring> result;
 
-						value->appendChild(xml->createTextNode((*get_if)->c_str()));
+		CheckValues();
 
-						cattr->appendChild(value);
-					}
+		for(size_t i = 0; i < Values.size(); i++)
+		{
+			std::wstringstream stream;
 
+			switch(ValueType)
+			{
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+					stream << Values.Integer(i);
 					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+					stream << Values.Unsigned(i);
+					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
 				case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_FQBN_VALUE>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						cattr->appendChild(((xml_t)*(*get_if))(xml, L"Value"));
-					}
-
+					stream << Values.String(i);
 					break;
 				case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
-					for(auto&& element : Values)
-					{
-						auto get_if = std::get_if<std::shared_ptr<XSID>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						cattr->appendChild(((xml_t)*(*get_if))(xml, L"Value"));
-					}
-
+					stream << XSID(Values.Binary(i).data()).commonName();
 					break;
 				case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
-					for(auto&& element : Values)
 					{
-						auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>>(&element);
-						if(nullptr == get_if)
-							throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-						cattr->appendChild(((xml_t)*(*get_if))(xml, L"Value"));
+						auto value = Values.Binary(i);
+						stream << whex_codes(bin_t(value.begin(), value.end()));
 					}
 
 					break;
 				default:
 					throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid ValueType");
 			}
-			#pragma endregion
 
-			return cattr;
-		};
+			result.push_back(stream.str());
+		}
+
+		return std::move(result);
 	}
 	//****************************************************************************************
-	std::vector<std::wstring> XSECURITY_ATTRIBUTE_V1::values_to_string() const
+	void XSECURITY_ATTRIBUTE_V1::Normalize()
 	{
-		std::vector<std::wstring> result;
+		CheckValues();
 
-		switch(ValueType)
+		if(XCLAIMS_VALUE_KIND::Invalid == value_kind(ValueType))
 		{
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<LONG64>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
-
-					std::wstringstream stream;
-					stream << *get_if;
+			ValueSet.reset(); // Values of unsupported types are never used in set operators
+			return;
+		}
 
-					result.push_back(stream.str());
-				}
+		ValueSet = std::make_shared<const XSECURITY_ATTRIBUTE_VALUE_SET>(Values, ValueType, Flags->get(L"CLAIM_SECURITY_ATTRIBUTE_VALUE_CASE_SENSITIVE"));
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTE_V1::CheckValues() const
+	{
+		bool correct = false;
 
-				break;
+		switch(ValueType)
+		{
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
 			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<DWORD64>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+				correct = Values.Offsets.empty();
+				break;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
+				correct = Values.Integers.empty();
+				break;
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
+				correct = (Values.Integers.size() == Values.Offsets.size());
+				break;
+			default:
+				throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid ValueType");
+		}
 
-					std::wstringstream stream;
-					stream << *get_if;
+		if(false == correct)
+			throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Global table of interned names of claims
+	//****************************************************************************************
+	// Names of claims are case-insensitive. Each name is folded to upper case with "fold_char"
+	// and gets a small integer identifier, same for all principals. Identifiers are never reused and start from 1.
+	struct XCLAIM_NAMES
+	{
+		XCLAIM_NAMES() = delete;
+		~XCLAIM_NAMES() = delete;
 
-					result.push_back(stream.str());
-				}
+		static DWORD Intern(std::wstring_view);
+		static DWORD Find(std::wstring_view); // 0 if the name was never interned
+		static std::wstring Name(const DWORD&); // Folded form of the name
 
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<std::wstring>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+	private:
+		struct table_t
+		{
+			std::shared_mutex mutex;
+			std::unordered_map<std::wstring, DWORD> ids;
+			std::deque<std::wstring> names;
+		};
 
-					std::wstringstream stream;
-					stream << (*get_if)->c_str();
+		static table_t& table();
+	};
+	//****************************************************************************************
+	XCLAIM_NAMES::table_t& XCLAIM_NAMES::table()
+	{
+		static table_t result;
+		return result;
+	}
+	//****************************************************************************************
+	DWORD XCLAIM_NAMES::Intern(std::wstring_view name)
+	{
+		std::wstring folded = fold_case(name);
+		table_t& names = table();
 
-					result.push_back(stream.str());
-				}
+		#pragma region Fast path for already known names
+		{
+			std::shared_lock lock(names.mutex);
 
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_FQBN_VALUE>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+			auto found = names.ids.find(folded);
+			if(found != names.ids.end())
+				return found->second;
+		}
+		#pragma endregion
 
-					result.push_back((*get_if)->Name);
-				}
+		std::unique_lock lock(names.mutex);
 
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_SID:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<XSID>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+		auto [element, inserted] = names.ids.try_emplace(folded, (DWORD)(names.names.size() + 1));
+		if(inserted)
+			names.names.push_back(folded);
 
-					std::wstringstream stream;
-					stream << (*get_if)->commonName();
+		return element->second;
+	}
+	//****************************************************************************************
+	DWORD XCLAIM_NAMES::Find(std::wstring_view name)
+	{
+		std::wstring folded = fold_case(name);
+		table_t& names = table();
 
-					result.push_back(stream.str());
-				}
+		std::shared_lock lock(names.mutex);
 
-				break;
-			case CLAIM_SECURITY_ATTRIBUTE_TYPE_OCTET_STRING:
-				for(auto&& element : Values)
-				{
-					auto get_if = std::get_if<std::shared_ptr<XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE>>(&element);
-					if(nullptr == get_if)
-						throw std::exception("XSECURITY_ATTRIBUTE_V1: incorrect combination of ValueType and Values");
+		auto found = names.ids.find(folded);
+		return (found == names.ids.end()) ? 0 : found->second;
+	}
+	//****************************************************************************************
+	std::wstring XCLAIM_NAMES::Name(const DWORD& id)
+	{
+		table_t& names = table();
 
-					result.push_back(whex_codes((*get_if)->Value));
-				}
+		std::shared_lock lock(names.mutex);
 
-				break;
-			default:
-				throw std::exception("XSECURITY_ATTRIBUTE_V1: invalid ValueType");
-		}
+		if((0 == id) || (id > names.names.size()))
+			throw std::exception("XCLAIM_NAMES: unknown identifier");
 
-		return std::move(result);
+		return names.names[id - 1];
 	}
 	//****************************************************************************************
 	#pragma endregion
@@ -1718,7 +2438,7 @@ namespace XSEC
 		XSECURITY_ATTRIBUTES_INFORMATION() = delete;
 		~XSECURITY_ATTRIBUTES_INFORMATION() = default;
 
-		XSECURITY_ATTRIBUTES_INFORMATION(const XSECURITY_ATTRIBUTES_INFORMATION& copy) : Version(copy.Version), Attributes(copy.Attributes)
+		XSECURITY_ATTRIBUTES_INFORMATION(const XSECURITY_ATTRIBUTES_INFORMATION& copy) : Version(copy.Version), Attributes(copy.Attributes), index(copy.index), indexed(copy.indexed)
 		{}
 
 		XSECURITY_ATTRIBUTES_INFORMATION(const std::initializer_list<XSECURITY_ATTRIBUTE_V1>&, const WORD& = 1);
@@ -1727,29 +2447,50 @@ namespace XSEC
 		XSECURITY_ATTRIBUTES_INFORMATION(const CLAIM_SECURITY_ATTRIBUTES_INFORMATION&);
 		XSECURITY_ATTRIBUTES_INFORMATION(const TOKEN_SECURITY_ATTRIBUTES_INFORMATION&);
 		XSECURITY_ATTRIBUTES_INFORMATION(const msxml_et&);
+		XSECURITY_ATTRIBUTES_INFORMATION(XXML_READER&);
 
 		explicit operator CLAIM_SECURITY_ATTRIBUTES_INFORMATION() const;
 		explicit operator TOKEN_SECURITY_ATTRIBUTES_INFORMATION() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
+
+		#pragma region Case-insensitive search by name of claim
+		// Index is built by all constructors and never changed by "Find", so lookups from many threads are safe.
+		// After "Attributes" were changed (added, removed, replaced, reordered or renamed) "Reindex" must be called.
+		// Changed number of attributes and replaced or moved found attribute are detected and throw an exception.
+		const XSECURITY_ATTRIBUTE_V1* Find(std::wstring_view) const;
+		const XSECURITY_ATTRIBUTE_V1* Find(const DWORD&) const; // By identifier from "XCLAIM_NAMES"
+
+		void Reindex();
+		#pragma endregion
+
+		void Normalize(); // Build normalized sets of values for all attributes
 
 		WORD Version = 1;
 		std::vector<std::shared_ptr<XSECURITY_ATTRIBUTE_V1>> Attributes;
 
 		private:
-		std::unique_ptr<bin_t> buffer_claim = std::make_unique<bin_t>();
-		std::unique_ptr<bin_t> buffer_token = std::make_unique<bin_t>();
+		mutable std::unique_ptr<bin_t> buffer_claim;
+		mutable std::unique_ptr<bin_t> buffer_token;
+
+		std::unordered_map<DWORD, size_t> index; // Interned name identifier -> index in "Attributes"
+		std::vector<const XSECURITY_ATTRIBUTE_V1*> indexed; // Attributes at time of indexing, to detect stale index
 	};
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTES_INFORMATION::XSECURITY_ATTRIBUTES_INFORMATION(const std::vector<XSECURITY_ATTRIBUTE_V1>& attributes, const WORD& version) : Version(version)
 	{
 		for(auto&& element : attributes)
 			Attributes.push_back(std::make_shared<XSECURITY_ATTRIBUTE_V1>(element));
+
+		Reindex();
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTES_INFORMATION::XSECURITY_ATTRIBUTES_INFORMATION(const std::initializer_list<XSECURITY_ATTRIBUTE_V1>& attributes, const WORD& version) : Version(version)
 	{
 		for(auto&& element : attributes)
 			Attributes.push_back(std::make_shared<XSECURITY_ATTRIBUTE_V1>(element));
+
+		Reindex();
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTES_INFORMATION::XSECURITY_ATTRIBUTES_INFORMATION(const CLAIM_SECURITY_ATTRIBUTES_INFORMATION& value)
@@ -1760,6 +2501,8 @@ namespace XSEC
 
 		for(DWORD i = 0; i < value.AttributeCount; i++)
 			Attributes.push_back(std::make_shared<XSECURITY_ATTRIBUTE_V1>(value.Attribute.pAttributeV1[i]));
+
+		Reindex();
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTES_INFORMATION::XSECURITY_ATTRIBUTES_INFORMATION(const TOKEN_SECURITY_ATTRIBUTES_INFORMATION& value)
@@ -1770,6 +2513,8 @@ namespace XSEC
 
 		for(DWORD i = 0; i < value.AttributeCount; i++)
 			Attributes.push_back(std::make_shared<XSECURITY_ATTRIBUTE_V1>(value.Attribute.pAttributeV1[i]));
+
+		Reindex();
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTES_INFORMATION::XSECURITY_ATTRIBUTES_INFORMATION(const msxml_et& xml)
@@ -1795,6 +2540,30 @@ namespace XSEC
 		for(long i = 0; i < attributes->length; i++)
 			Attributes.push_back(std::make_shared<XSECURITY_ATTRIBUTE_V1>(attributes->item[i]));
 		#pragma endregion
+
+		Reindex();
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTES_INFORMATION::XSECURITY_ATTRIBUTES_INFORMATION(XXML_READER& xml)
+	{
+		bool version = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("Version" == xml.Name())
+			{
+				Version = xml.Number<WORD>();
+				version = true;
+			}
+			else if("Attribute" == xml.Name())
+				Attributes.push_back(std::make_shared<XSECURITY_ATTRIBUTE_V1>(xml));
+		}
+
+		if(false == version)
+			throw std::exception("XSECURITY_ATTRIBUTES_INFORMATION: cannot find 'Version' XML node");
+
+		Reindex();
 	}
 	//****************************************************************************************
 	XSECURITY_ATTRIBUTES_INFORMATION::operator CLAIM_SECURITY_ATTRIBUTES_INFORMATION() const
@@ -1805,6 +2574,9 @@ namespace XSEC
 		result.Reserved = 0;
 		result.AttributeCount = Attributes.size();
 
+		if(nullptr == buffer_claim)
+			buffer_claim = std::make_unique<bin_t>();
+
 		buffer_claim->resize(Attributes.size() * sizeof(CLAIM_SECURITY_ATTRIBUTE_V1));
 
 		for(DWORD i = 0; i < result.AttributeCount; i++)
@@ -1823,6 +2595,9 @@ namespace XSEC
 		result.Reserved = 0;
 		result.AttributeCount = Attributes.size();
 
+		if(nullptr == buffer_token)
+			buffer_token = std::make_unique<bin_t>();
+
 		buffer_token->resize(Attributes.size() * sizeof(TOKEN_SECURITY_ATTRIBUTE_V1));
 
 		for(DWORD i = 0; i < result.AttributeCount; i++)
@@ -1833,6 +2608,57 @@ namespace XSEC
 		return result;
 	}
 	//****************************************************************************************
+	void XSECURITY_ATTRIBUTES_INFORMATION::Reindex()
+	{
+		index.clear();
+		index.reserve(Attributes.size());
+
+		indexed.clear();
+		indexed.reserve(Attributes.size());
+
+		// For duplicated names first attribute wins, same as for linear search
+		for(size_t i = 0; i < Attributes.size(); i++)
+		{
+			index.try_emplace(XCLAIM_NAMES::Intern(Attributes[i]->Name), i);
+			indexed.push_back(Attributes[i].get());
+		}
+	}
+	//****************************************************************************************
+	void XSECURITY_ATTRIBUTES_INFORMATION::Normalize()
+	{
+		for(auto&& element : Attributes)
+			element->Normalize();
+	}
+	//****************************************************************************************
+	const XSECURITY_ATTRIBUTE_V1* XSECURITY_ATTRIBUTES_INFORMATION::Find(const DWORD& id) const
+	{
+		if(indexed.size() != Attributes.size())
+			throw std::exception("XSECURITY_ATTRIBUTES_INFORMATION: index is out of date, call 'Reindex'");
+
+		auto found = index.find(id);
+		if(found == index.end())
+			return nullptr;
+
+		const XSECURITY_ATTRIBUTE_V1* result = Attributes[found->second].get();
+		if(indexed[found->second] != result)
+			throw std::exception("XSECURITY_ATTRIBUTES_INFORMATION: index is out of date, call 'Reindex'");
+
+		return result;
+	}
+	//****************************************************************************************
+	const XSECURITY_ATTRIBUTE_V1* XSECURITY_ATTRIBUTES_INFORMATION::Find(std::wstring_view name) const
+	{
+		// All names of attributes are interned while building the index, so unknown name could not be found in this set
+		if(indexed.size() != Attributes.size())
+			throw std::exception("XSECURITY_ATTRIBUTES_INFORMATION: index is out of date, call 'Reindex'");
+
+		DWORD id = XCLAIM_NAMES::Find(name);
+		if(0 == id)
+			return nullptr;
+
+		return Find(id);
+	}
+	//****************************************************************************************
 	XSECURITY_ATTRIBUTES_INFORMATION::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -1867,6 +2693,18 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XSECURITY_ATTRIBUTES_INFORMATION::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("XSECURITY_ATTRIBUTES_INFORMATION"));
+
+		xml.Element("Version", Version);
+
+		for(auto&& element : Attributes)
+			element->Write(xml, "Attribute");
+
+		xml.End();
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 };
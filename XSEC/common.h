@@ -96,9 +96,55 @@ namespace XSEC
 	};
 	#pragma endregion
 	//********************************************************************************************
+	#pragma region Read-only mapping of a whole file
+	//********************************************************************************************
+	struct XMAPPED_FILE
+	{
+		XMAPPED_FILE() = delete;
+		~XMAPPED_FILE() = default;
+
+		XMAPPED_FILE(const std::wstring&);
+
+		std::span<const unsigned char> Data; // Valid while at least one copy of the object exists
+
+	private:
+		std::shared_ptr<const void> view;
+	};
+	//********************************************************************************************
+	XMAPPED_FILE::XMAPPED_FILE(const std::wstring& path)
+	{
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if(INVALID_HANDLE_VALUE == file)
+			throw std::exception("XMAPPED_FILE: cannot execute 'CreateFileW'");
+
+		token_guard file_guard(file);
+
+		LARGE_INTEGER size{};
+		if(FALSE == GetFileSizeEx(file, &size))
+			throw std::exception("XMAPPED_FILE: cannot execute 'GetFileSizeEx'");
+
+		if(0 == size.QuadPart)
+			return; // Empty files could not be mapped
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(nullptr == mapping)
+			throw std::exception("XMAPPED_FILE: cannot execute 'CreateFileMappingW'");
+
+		token_guard mapping_guard(mapping); // The view keeps the mapping alive
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if(nullptr == data)
+			throw std::exception("XMAPPED_FILE: cannot execute 'MapViewOfFile'");
+
+		view = std::shared_ptr<const void>(data, [](const void* value){ UnmapViewOfFile(value); });
+		Data = std::span<const unsigned char>((const unsigned char*)data, (size_t)size.QuadPart);
+	}
+	//********************************************************************************************
+	#pragma endregion
+	//********************************************************************************************
 	#pragma region Common functions
 	//********************************************************************************************
-	std::string hex_codes(std::vector<unsigned char> value)
+	std::string hex_codes(std::span<const unsigned char> value)
 	{
 		std::stringstream stream;
 		stream << std::uppercase << std::setfill('0') << std::hex;
@@ -220,14 +266,117 @@ namespace XSEC
 		return result;
 	}
 	//********************************************************************************************
-	template<typename T>
-	void XSave(const T& element, const std::wstring& path)
+	// The only case folding in the library: each UTF-16 code unit is mapped to one upper case code
+	// unit with the invariant locale table. Folded keys (hashed and interned names, normalized
+	// values) and all case-insensitive comparisons use this mapping, so they always agree.
+	wchar_t fold_char(const wchar_t& value)
+	{
+		static const std::vector<wchar_t> table = []()
+		{
+			std::vector<wchar_t> result(0x10000);
+
+			for(size_t i = 0; i < result.size(); i++)
+				result[i] = (wchar_t)i;
+
+			// Surrogates are left as is, all other code units are mapped one to one
+			auto map = [&result](const size_t& begin, const size_t& end)
+			{
+				std::wstring source(result.begin() + begin, result.begin() + end);
+
+				if(0 == LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_UPPERCASE, source.data(), (int)source.size(), result.data() + begin, (int)source.size(), nullptr, nullptr, 0))
+					throw std::exception("fold_char: cannot execute 'LCMapStringEx'");
+			};
+
+			map(0x0000, 0xD800);
+			map(0xE000, 0x10000);
+
+			return result;
+		}();
+
+		return table[(unsigned short)value];
+	}
+	//********************************************************************************************
+	std::wstring fold_case(std::wstring_view value)
 	{
-		MSXML2::IXMLDOMDocument2Ptr xml;
-		xml.CreateInstance(__uuidof(MSXML2::DOMDocument60), NULL, CLSCTX_INPROC_SERVER);
+		std::wstring result(value.size(), L'\0');
+		std::transform(value.begin(), value.end(), result.begin(), fold_char);
 
-		xml->documentElement = ((xml_t)element)(xml, std::nullopt);
-		xml->save(path.c_str());
+		return result;
+	}
+	//********************************************************************************************
+	// Ordinal comparison of code units (folded by "fold_char" if case is ignored), result is
+	// negative, zero or positive
+	int compare_ordinal(std::wstring_view lhs, std::wstring_view rhs, const bool& ignoreCase)
+	{
+		const size_t size = std::min(lhs.size(), rhs.size());
+
+		for(size_t i = 0; i < size; i++)
+		{
+			const wchar_t left = ignoreCase ? fold_char(lhs[i]) : lhs[i];
+			const wchar_t right = ignoreCase ? fold_char(rhs[i]) : rhs[i];
+
+			if(left != right)
+				return (left < right) ? -1 : 1;
+		}
+
+		if(lhs.size() == rhs.size())
+			return 0;
+
+		return (lhs.size() < rhs.size()) ? -1 : 1;
+	}
+	//********************************************************************************************
+	// Case-insensitive ordinal comparison, used for names of claims
+	struct wstring_iless
+	{
+		bool operator()(const std::wstring& lhs, const std::wstring& rhs) const
+		{
+			return (compare_ordinal(lhs, rhs, true) < 0);
+		}
+	};
+	//********************************************************************************************
+	// Calls "function" for each index from 0 to "size" on a pool of "threads" threads (0 means
+	// number of processors). Each worker has its own copy of "function", so values captured by
+	// copy are per-worker state. The first exception is thrown after all workers stopped.
+	template<typename F>
+	void parallel(const size_t& size, const size_t& threads, const F& function)
+	{
+		std::atomic<size_t> next = 0;
+		std::exception_ptr error;
+		std::mutex lock;
+
+		auto worker = [&]()
+		{
+			try
+			{
+				F local = function;
+
+				for(size_t i = next++; i < size; i = next++)
+					local(i);
+			}
+			catch(...)
+			{
+				std::scoped_lock guard(lock);
+
+				if(nullptr == error)
+					error = std::current_exception();
+
+				next = size; // Stop all other workers
+			}
+		};
+
+		size_t count = (threads) ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+		{
+			std::vector<std::jthread> workers;
+
+			for(size_t i = 1; i < std::min(count, size); i++)
+				workers.emplace_back(worker);
+
+			worker();
+		}
+
+		if(nullptr != error)
+			std::rethrow_exception(error);
 	}
 	//********************************************************************************************
 	template<typename T>
@@ -243,24 +392,6 @@ namespace XSEC
 		file.close();
 	}
 	//********************************************************************************************
-	template<typename T, typename... Types>
-	T XLoad(const std::wstring& path, Types&&... args)
-	{
-		MSXML2::IXMLDOMDocument2Ptr xml;
-		xml.CreateInstance(__uuidof(MSXML2::DOMDocument60), NULL, CLSCTX_INPROC_SERVER);
-
-		xml->async = VARIANT_FALSE;
-		xml->validateOnParse = VARIANT_FALSE;
-
-		VARIANT_BOOL result = xml->load(path.c_str());
-		if(VARIANT_FALSE == result)
-			throw std::exception("XLoad: cannot load from XML");
-
-		// There is a compiler error, at least in VS 16.9.4, and in order to have
-		// correct type user needs to pass all default parameters here
-		return T(xml->documentElement, std::forward<Types>(args)...);
-	}
-	//********************************************************************************************
 	#pragma endregion
 	//********************************************************************************************
 };
@@ -0,0 +1,219 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+
+#pragma once
+//********************************************************************************************
+// Comparison of blocks of 64-bit integers with a constant, used by column-at-a-time batch
+// evaluation. Vector versions are compiled for their own instruction sets and selected at run
+// time, so builds without "/arch:AVX2" (or "-mavx2") still use them on capable processors.
+// Only the standard library and compiler intrinsics are used (bench/compare_block_bench.cpp).
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define XSEC_COMPARE_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// Per-function instruction sets: GCC and Clang need a target attribute, MSVC emits any intrinsic
+#if defined(XSEC_COMPARE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define XSEC_TARGET(name) __attribute__((target(name)))
+#else
+#define XSEC_TARGET(name)
+#endif
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Compare block
+	//****************************************************************************************
+	enum class XCOMPARE_ISA
+	{
+		Scalar = 0,
+		SSE42 = 1, // "_mm_cmpgt_epi64" is SSE 4.2, 2 values at once
+		AVX2 = 2   // 4 values at once
+	};
+	//****************************************************************************************
+	// Best instruction set supported by processor and operating system
+	XCOMPARE_ISA compare_isa()
+	{
+		#if defined(__AVX2__)
+		return XCOMPARE_ISA::AVX2;
+		#elif !defined(XSEC_COMPARE_X86)
+		return XCOMPARE_ISA::Scalar;
+		#elif defined(_MSC_VER) && !defined(__clang__)
+		int info[4] = { 0 };
+
+		__cpuid(info, 0);
+		const int maximum = info[0];
+
+		__cpuid(info, 1);
+		const bool sse42 = (0 != (info[2] & (1 << 20)));
+		const bool osxsave = (0 != (info[2] & (1 << 27)));
+
+		bool avx2 = false;
+
+		// AVX2 needs YMM registers to be saved by operating system (XCR0 bits 1 and 2)
+		if((maximum >= 7) && osxsave && (6 == (_xgetbv(0) & 6)))
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (0 != (info[1] & (1 << 5)));
+		}
+
+		return avx2 ? XCOMPARE_ISA::AVX2 : (sse42 ? XCOMPARE_ISA::SSE42 : XCOMPARE_ISA::Scalar);
+		#else
+		__builtin_cpu_init();
+
+		if(__builtin_cpu_supports("avx2"))
+			return XCOMPARE_ISA::AVX2;
+
+		return __builtin_cpu_supports("sse4.2") ? XCOMPARE_ISA::SSE42 : XCOMPARE_ISA::Scalar;
+		#endif
+	}
+	//****************************************************************************************
+	// Codes are the same as for conditional expressions: 0x80 "==", 0x81 "!=", 0x82 "<",
+	// 0x83 "<=", 0x84 ">", all others ">=". Bit "i" of result is set if "values[i]" satisfies.
+	uint64_t compare_block_scalar(const int64_t* values, const size_t& count, const int64_t& constant, const unsigned char& code, size_t i = 0)
+	{
+		uint64_t result = 0;
+
+		for(; i < count; i++)
+		{
+			bool value = false;
+
+			switch(code)
+			{
+				case 0x80: // ==
+					value = (values[i] == constant);
+					break;
+				case 0x81: // !=
+					value = (values[i] != constant);
+					break;
+				case 0x82: // <
+					value = (values[i] < constant);
+					break;
+				case 0x83: // <=
+					value = (values[i] <= constant);
+					break;
+				case 0x84: // >
+					value = (values[i] > constant);
+					break;
+				default: // >=
+					value = (values[i] >= constant);
+			}
+
+			result |= (uint64_t)value << i;
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	#if defined(XSEC_COMPARE_X86)
+	// Each code is one of "==" and ">" with swapped operands and/or inverted result
+	void compare_decode(const unsigned char& code, bool& equal, bool& swap, bool& invert)
+	{
+		equal = (0x80 == code) || (0x81 == code);
+		swap = (0x82 == code) || (0x85 == code); // "constant > value"
+		invert = (0x81 == code) || (0x83 == code) || (0x85 == code);
+	}
+	//****************************************************************************************
+	XSEC_TARGET("sse4.2")
+	uint64_t compare_block_sse42(const int64_t* values, const size_t& count, const int64_t& constant, const unsigned char& code)
+	{
+		uint64_t result = 0;
+		size_t i = 0;
+
+		bool equal = false;
+		bool swap = false;
+		bool invert = false;
+		compare_decode(code, equal, swap, invert);
+
+		const __m128i k = _mm_set1_epi64x(constant);
+
+		for(; (i + 2) <= count; i += 2)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+			__m128i mask = equal ? _mm_cmpeq_epi64(v, k) : (swap ? _mm_cmpgt_epi64(k, v) : _mm_cmpgt_epi64(v, k));
+
+			result |= (uint64_t)(_mm_movemask_pd(_mm_castsi128_pd(mask)) & 0x03) << i;
+		}
+
+		if(invert)
+			result ^= (64 == i) ? ~(uint64_t)0 : (((uint64_t)1 << i) - 1);
+
+		return result | compare_block_scalar(values, count, constant, code, i);
+	}
+	//****************************************************************************************
+	XSEC_TARGET("avx2")
+	uint64_t compare_block_avx2(const int64_t* values, const size_t& count, const int64_t& constant, const unsigned char& code)
+	{
+		uint64_t result = 0;
+		size_t i = 0;
+
+		bool equal = false;
+		bool swap = false;
+		bool invert = false;
+		compare_decode(code, equal, swap, invert);
+
+		const __m256i k = _mm256_set1_epi64x(constant);
+
+		for(; (i + 4) <= count; i += 4)
+		{
+			__m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+			__m256i mask = equal ? _mm256_cmpeq_epi64(v, k) : (swap ? _mm256_cmpgt_epi64(k, v) : _mm256_cmpgt_epi64(v, k));
+
+			result |= (uint64_t)(_mm256_movemask_pd(_mm256_castsi256_pd(mask)) & 0x0F) << i;
+		}
+
+		if(invert)
+			result ^= (64 == i) ? ~(uint64_t)0 : (((uint64_t)1 << i) - 1);
+
+		return result | compare_block_scalar(values, count, constant, code, i);
+	}
+	#endif
+	//****************************************************************************************
+	// Compare up to 64 integer values with a constant and return a bit mask with results
+	uint64_t compare_block(const int64_t* values, const size_t& count, const int64_t& constant, const unsigned char& code)
+	{
+		#if defined(XSEC_COMPARE_X86)
+		static const XCOMPARE_ISA isa = compare_isa();
+
+		switch(isa)
+		{
+			case XCOMPARE_ISA::AVX2:
+				return compare_block_avx2(values, count, constant, code);
+			case XCOMPARE_ISA::SSE42:
+				return compare_block_sse42(values, count, constant, code);
+			default:
+				break;
+		}
+		#endif
+
+		return compare_block_scalar(values, count, constant, code);
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
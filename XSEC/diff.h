@@ -0,0 +1,539 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Differences between two tokens
+	//****************************************************************************************
+	enum class XTOKEN_DIFF_AREA : unsigned char
+	{
+		User,
+		Owner,
+		PrimaryGroup,
+		IntegrityLevel,
+		MandatoryPolicy,
+		ElevationType,
+		Groups,
+		RestrictedSids,
+		Capabilities,
+		DeviceGroups,
+		RestrictedDeviceGroups,
+		Privileges,
+		UserClaims,
+		DeviceClaims,
+		SecurityAttributes
+	};
+	//****************************************************************************************
+	enum class XTOKEN_DIFF_KIND : unsigned char
+	{
+		Added,
+		Removed,
+		Changed
+	};
+	//****************************************************************************************
+	struct XTOKEN_DIFF_VALUES
+	{
+		std::vector<LONG64> Integers;
+		std::vector<std::wstring> Strings; // Folded for case-insensitive claims
+		std::vector<bin_t> Binaries;
+
+		bool empty() const { return (Integers.empty() && Strings.empty() && Binaries.empty()); }
+	};
+	//****************************************************************************************
+	struct XTOKEN_DIFF_ENTRY
+	{
+		XTOKEN_DIFF_AREA Area = XTOKEN_DIFF_AREA::Groups;
+		XTOKEN_DIFF_KIND Kind = XTOKEN_DIFF_KIND::Changed;
+
+		bin_t Sid;    // SID of group, or new SID for User, Owner, PrimaryGroup and IntegrityLevel
+		bin_t OldSid; // Previous SID for User, Owner, PrimaryGroup and IntegrityLevel
+		LUID Luid{};  // Privileges
+		std::wstring Name; // Name of claim
+
+		DWORD OldAttributes = 0; // Attributes of groups and privileges, flags of claims, mandatory policy and elevation type
+		DWORD NewAttributes = 0;
+		WORD OldValueType = 0;   // Claims only
+		WORD NewValueType = 0;
+
+		XTOKEN_DIFF_VALUES AddedValues;   // Claims existing in both tokens
+		XTOKEN_DIFF_VALUES RemovedValues;
+	};
+	//****************************************************************************************
+	// All lists are compared with merges of sorted sequences. Tokens are normalized once per
+	// comparison, snapshots are read in place except claims.
+	struct XTOKEN_DIFF
+	{
+		XTOKEN_DIFF() = delete;
+		~XTOKEN_DIFF() = default;
+
+		XTOKEN_DIFF(const XTOKEN& /*before*/, const XTOKEN& /*after*/);
+		XTOKEN_DIFF(const XTOKEN_SNAPSHOT& /*before*/, const XTOKEN_SNAPSHOT& /*after*/, const XGROUP_SETS* = nullptr);
+
+		static std::vector<XTOKEN_DIFF> Compare(std::span<const std::pair<const XTOKEN*, const XTOKEN*>>, const size_t& /*threads*/ = 0);
+		static std::vector<XTOKEN_DIFF> Compare(std::span<const std::pair<const XTOKEN_SNAPSHOT*, const XTOKEN_SNAPSHOT*>>, const XGROUP_SETS* = nullptr, const size_t& /*threads*/ = 0);
+
+		bool empty() const { return Entries.empty(); }
+
+		// Changes in terms of conditional expressions, for "XCONDITIONAL_EVALUATOR::Reevaluate"
+		XCONDITIONAL_REFERENCES References() const;
+
+		std::vector<XTOKEN_DIFF_ENTRY> Entries;
+
+	private:
+		#pragma region Normalized token
+		using group_t = std::pair<bin_t, DWORD>;
+
+		struct claim_t
+		{
+			std::wstring Folded;
+			std::wstring Name;
+			WORD ValueType = 0;
+			DWORD Flags = 0;
+			std::shared_ptr<const XSECURITY_ATTRIBUTE_VALUE_SET> Values; // Empty for unsupported types
+		};
+
+		struct profile_t
+		{
+			bin_t User;
+			bin_t Owner;
+			bin_t PrimaryGroup;
+			bin_t IntegrityLevel;
+
+			std::optional<DWORD> MandatoryPolicy;
+			DWORD ElevationType = 0;
+
+			std::array<std::vector<group_t>, 5> Lists; // Groups, RestrictedSids, Capabilities, DeviceGroups, RestrictedDeviceGroups
+			std::vector<std::pair<DWORD64, DWORD>> Privileges;
+			std::array<std::vector<claim_t>, 3> Claims; // UserClaims, DeviceClaims, SecurityAttributes
+		};
+
+		static constexpr std::array<XTOKEN_DIFF_AREA, 5> lists = { XTOKEN_DIFF_AREA::Groups, XTOKEN_DIFF_AREA::RestrictedSids, XTOKEN_DIFF_AREA::Capabilities, XTOKEN_DIFF_AREA::DeviceGroups, XTOKEN_DIFF_AREA::RestrictedDeviceGroups };
+		static constexpr std::array<XTOKEN_DIFF_AREA, 3> claims = { XTOKEN_DIFF_AREA::UserClaims, XTOKEN_DIFF_AREA::DeviceClaims, XTOKEN_DIFF_AREA::SecurityAttributes };
+		#pragma endregion
+
+		static profile_t profile(const XTOKEN&);
+		static profile_t profile(const XTOKEN_SNAPSHOT&, const XGROUP_SETS*);
+
+		static void claims_of(std::vector<claim_t>&, const XSECURITY_ATTRIBUTE_V1&);
+		static void finish(profile_t&);
+
+		void compare(const profile_t&, const profile_t&);
+		void compare(const XTOKEN_DIFF_AREA&, const std::vector<claim_t>&, const std::vector<claim_t>&);
+		static void values(const XSECURITY_ATTRIBUTE_VALUE_SET&, const XSECURITY_ATTRIBUTE_VALUE_SET&, XTOKEN_DIFF_VALUES&);
+
+		template<typename T, typename F>
+		static std::vector<XTOKEN_DIFF> batch(std::span<const T>, const size_t&, F&&);
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Normalization
+	//****************************************************************************************
+	void XTOKEN_DIFF::claims_of(std::vector<claim_t>& result, const XSECURITY_ATTRIBUTE_V1& attribute)
+	{
+		claim_t claim{ fold_case(attribute.Name), attribute.Name, attribute.ValueType, (nullptr == attribute.Flags) ? 0 : (DWORD)*attribute.Flags, attribute.GetValueSet() };
+
+		if((nullptr == claim.Values) && (XCLAIMS_VALUE_KIND::Invalid != value_kind(attribute.ValueType)))
+			claim.Values = std::make_shared<const XSECURITY_ATTRIBUTE_VALUE_SET>(attribute.GetValues(), attribute.ValueType, (0 != (claim.Flags & CLAIM_SECURITY_ATTRIBUTE_VALUE_CASE_SENSITIVE)));
+
+		result.push_back(std::move(claim));
+	}
+	//****************************************************************************************
+	void XTOKEN_DIFF::finish(profile_t& value)
+	{
+		for(auto&& element : value.Lists)
+			std::sort(element.begin(), element.end());
+
+		std::sort(value.Privileges.begin(), value.Privileges.end());
+
+		for(auto&& element : value.Claims)
+			std::sort(element.begin(), element.end(), [](const claim_t& lhs, const claim_t& rhs){ return (lhs.Folded < rhs.Folded); });
+	}
+	//****************************************************************************************
+	XTOKEN_DIFF::profile_t XTOKEN_DIFF::profile(const XTOKEN& token)
+	{
+		token.Require(XTOKEN::ClassDiff, "XTOKEN_DIFF");
+
+		profile_t result;
+
+		auto sid = [](const std::shared_ptr<XSID>& value){ return (nullptr == value) ? bin_t{} : (bin_t)*value; };
+
+		if(nullptr != token.User)
+			result.User = sid(token.User->Sid);
+		if(nullptr != token.IntegrityLevel)
+			result.IntegrityLevel = sid(token.IntegrityLevel->Sid);
+
+		result.Owner = sid(token.Owner);
+		result.PrimaryGroup = sid(token.PrimaryGroup);
+
+		if(nullptr != token.MandatoryPolicy)
+			result.MandatoryPolicy = (DWORD)*token.MandatoryPolicy;
+
+		result.ElevationType = (DWORD)token.ElevationType;
+
+		const std::array<const std::vector<XSID_AND_ATTRIBUTES>*, 5> sources = { &token.Groups, &token.RestrictedSids, &token.Capabilities, &token.DeviceGroups, &token.RestrictedDeviceGroups };
+		for(size_t i = 0; i < sources.size(); i++)
+		{
+			result.Lists[i].reserve(sources[i]->size());
+
+			for(auto&& element : *sources[i])
+				result.Lists[i].emplace_back(sid(element.Sid), (DWORD)*element.Attributes);
+		}
+
+		for(auto&& element : token.Privileges)
+			result.Privileges.emplace_back(((DWORD64)(DWORD)element.Luid->HighPart << 32) | element.Luid->LowPart, (DWORD)*element.Attributes);
+
+		const std::array<const std::shared_ptr<XSECURITY_ATTRIBUTES_INFORMATION>*, 3> information = { &token.UserClaimAttributes, &token.DeviceClaimAttributes, &token.SecurityAttributes };
+		for(size_t i = 0; i < information.size(); i++)
+		{
+			if(nullptr == *information[i])
+				continue;
+
+			for(auto&& element : (*information[i])->Attributes)
+				claims_of(result.Claims[i], *element);
+		}
+
+		finish(result);
+
+		return result;
+	}
+	//****************************************************************************************
+	XTOKEN_DIFF::profile_t XTOKEN_DIFF::profile(const XTOKEN_SNAPSHOT& snapshot, const XGROUP_SETS* groupSets)
+	{
+		profile_t result;
+
+		const XTOKEN_SNAPSHOT_SCALARS& scalars = snapshot.Scalars();
+
+		auto sid = [&snapshot](const DWORD& index)
+		{
+			if(XTOKEN_SNAPSHOT_NO_SID == index)
+				return bin_t{};
+
+			auto value = snapshot.Sid(index);
+			return bin_t(value.begin(), value.end());
+		};
+
+		result.User = sid(scalars.User);
+		result.Owner = sid(scalars.Owner);
+		result.PrimaryGroup = sid(scalars.PrimaryGroup);
+		result.IntegrityLevel = sid(scalars.IntegrityLevel);
+
+		if(scalars.Present & PresentMandatoryPolicy)
+			result.MandatoryPolicy = scalars.MandatoryPolicy;
+
+		result.ElevationType = scalars.ElevationType;
+
+		const std::array<XTOKEN_SNAPSHOT_SECTION, 5> sections = { XTOKEN_SNAPSHOT_SECTION::Groups, XTOKEN_SNAPSHOT_SECTION::RestrictedSids, XTOKEN_SNAPSHOT_SECTION::Capabilities, XTOKEN_SNAPSHOT_SECTION::DeviceGroups, XTOKEN_SNAPSHOT_SECTION::RestrictedDeviceGroups };
+		for(size_t i = 0; i < sections.size(); i++)
+		{
+			for(auto&& element : snapshot.Groups(sections[i]))
+				result.Lists[i].emplace_back(sid(element.Sid), element.Attributes);
+		}
+
+		if(std::optional<DWORD> groupSet = snapshot.GroupSet())
+		{
+			if(nullptr == groupSets)
+				throw std::exception("XTOKEN_DIFF: dictionary of group sets is required");
+
+			for(auto&& element : groupSets->Groups(groupSet.value()))
+				result.Lists[0].emplace_back((bin_t)*element.Sid, (DWORD)*element.Attributes);
+		}
+
+		for(auto&& element : snapshot.Privileges())
+			result.Privileges.emplace_back(((DWORD64)(DWORD)element.HighPart << 32) | element.LowPart, element.Attributes);
+
+		const std::array<XTOKEN_SNAPSHOT_SECTION, 3> information = { XTOKEN_SNAPSHOT_SECTION::UserClaims, XTOKEN_SNAPSHOT_SECTION::DeviceClaims, XTOKEN_SNAPSHOT_SECTION::SecurityAttributes };
+		for(size_t i = 0; i < information.size(); i++)
+		{
+			for(auto&& element : snapshot.Claims(information[i]))
+				claims_of(result.Claims[i], XSECURITY_ATTRIBUTE_V1(element));
+		}
+
+		finish(result);
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Comparison
+	//****************************************************************************************
+	XTOKEN_DIFF::XTOKEN_DIFF(const XTOKEN& before, const XTOKEN& after)
+	{
+		compare(profile(before), profile(after));
+	}
+	//****************************************************************************************
+	XTOKEN_DIFF::XTOKEN_DIFF(const XTOKEN_SNAPSHOT& before, const XTOKEN_SNAPSHOT& after, const XGROUP_SETS* groupSets)
+	{
+		compare(profile(before, groupSets), profile(after, groupSets));
+	}
+	//****************************************************************************************
+	void XTOKEN_DIFF::values(const XSECURITY_ATTRIBUTE_VALUE_SET& before, const XSECURITY_ATTRIBUTE_VALUE_SET& after, XTOKEN_DIFF_VALUES& result)
+	{
+		auto difference = [](const auto& lhs, const auto& rhs, auto& output)
+		{
+			std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(output));
+		};
+
+		difference(after.Integers, before.Integers, result.Integers);
+		difference(after.Strings, before.Strings, result.Strings);
+		difference(after.Binaries, before.Binaries, result.Binaries);
+	}
+	//****************************************************************************************
+	void XTOKEN_DIFF::compare(const XTOKEN_DIFF_AREA& area, const std::vector<claim_t>& before, const std::vector<claim_t>& after)
+	{
+		auto i = before.begin();
+		auto j = after.begin();
+
+		while((i != before.end()) || (j != after.end()))
+		{
+			XTOKEN_DIFF_ENTRY entry{ area };
+
+			if((j == after.end()) || ((i != before.end()) && (i->Folded < j->Folded)))
+			{
+				entry.Kind = XTOKEN_DIFF_KIND::Removed;
+				entry.Name = i->Name;
+				entry.OldAttributes = i->Flags;
+				entry.OldValueType = i->ValueType;
+
+				Entries.push_back(std::move(entry));
+				i++;
+
+				continue;
+			}
+
+			if((i == before.end()) || (j->Folded < i->Folded))
+			{
+				entry.Kind = XTOKEN_DIFF_KIND::Added;
+				entry.Name = j->Name;
+				entry.NewAttributes = j->Flags;
+				entry.NewValueType = j->ValueType;
+
+				Entries.push_back(std::move(entry));
+				j++;
+
+				continue;
+			}
+
+			entry.Name = j->Name;
+			entry.OldAttributes = i->Flags;
+			entry.NewAttributes = j->Flags;
+			entry.OldValueType = i->ValueType;
+			entry.NewValueType = j->ValueType;
+
+			bool changed = ((i->Flags != j->Flags) || (i->ValueType != j->ValueType));
+
+			if((nullptr != i->Values) && (nullptr != j->Values) && (i->Values->Kind == j->Values->Kind) && (i->Values->CaseSensitive == j->Values->CaseSensitive))
+			{
+				values(*i->Values, *j->Values, entry.AddedValues);
+				values(*j->Values, *i->Values, entry.RemovedValues);
+
+				changed = (changed || (false == entry.AddedValues.empty()) || (false == entry.RemovedValues.empty()));
+			}
+			else
+				changed = true; // Values could not be compared, report the claim as changed
+
+			if(changed)
+				Entries.push_back(std::move(entry));
+
+			i++;
+			j++;
+		}
+	}
+	//****************************************************************************************
+	void XTOKEN_DIFF::compare(const profile_t& before, const profile_t& after)
+	{
+		#pragma region Scalar values
+		auto scalar = [this](const XTOKEN_DIFF_AREA& area, const bin_t& lhs, const bin_t& rhs)
+		{
+			if(lhs == rhs)
+				return;
+
+			XTOKEN_DIFF_ENTRY entry{ area, (lhs.empty()) ? XTOKEN_DIFF_KIND::Added : ((rhs.empty()) ? XTOKEN_DIFF_KIND::Removed : XTOKEN_DIFF_KIND::Changed) };
+			entry.OldSid = lhs;
+			entry.Sid = rhs;
+
+			Entries.push_back(std::move(entry));
+		};
+
+		scalar(XTOKEN_DIFF_AREA::User, before.User, after.User);
+		scalar(XTOKEN_DIFF_AREA::Owner, before.Owner, after.Owner);
+		scalar(XTOKEN_DIFF_AREA::PrimaryGroup, before.PrimaryGroup, after.PrimaryGroup);
+		scalar(XTOKEN_DIFF_AREA::IntegrityLevel, before.IntegrityLevel, after.IntegrityLevel);
+
+		if(before.MandatoryPolicy != after.MandatoryPolicy)
+		{
+			XTOKEN_DIFF_ENTRY entry{ XTOKEN_DIFF_AREA::MandatoryPolicy, (false == before.MandatoryPolicy.has_value()) ? XTOKEN_DIFF_KIND::Added : ((false == after.MandatoryPolicy.has_value()) ? XTOKEN_DIFF_KIND::Removed : XTOKEN_DIFF_KIND::Changed) };
+			entry.OldAttributes = before.MandatoryPolicy.value_or(0);
+			entry.NewAttributes = after.MandatoryPolicy.value_or(0);
+
+			Entries.push_back(std::move(entry));
+		}
+
+		if(before.ElevationType != after.ElevationType)
+		{
+			XTOKEN_DIFF_ENTRY entry{ XTOKEN_DIFF_AREA::ElevationType, XTOKEN_DIFF_KIND::Changed };
+			entry.OldAttributes = before.ElevationType;
+			entry.NewAttributes = after.ElevationType;
+
+			Entries.push_back(std::move(entry));
+		}
+		#pragma endregion
+
+		#pragma region Lists of groups and privileges
+		// Both lists are sorted by key and then by attributes, so the same key with different attributes is "Changed"
+		auto merge = [this](const XTOKEN_DIFF_AREA& area, const auto& lhs, const auto& rhs, auto&& key)
+		{
+			auto i = lhs.begin();
+			auto j = rhs.begin();
+
+			while((i != lhs.end()) || (j != rhs.end()))
+			{
+				XTOKEN_DIFF_ENTRY entry{ area };
+
+				if((j == rhs.end()) || ((i != lhs.end()) && (i->first < j->first)))
+				{
+					entry.Kind = XTOKEN_DIFF_KIND::Removed;
+					entry.OldAttributes = i->second;
+					key(entry, i->first);
+
+					Entries.push_back(std::move(entry));
+					i++;
+				}
+				else
+				{
+					if((i == lhs.end()) || (j->first < i->first))
+					{
+						entry.Kind = XTOKEN_DIFF_KIND::Added;
+						entry.NewAttributes = j->second;
+						key(entry, j->first);
+
+						Entries.push_back(std::move(entry));
+						j++;
+					}
+					else
+					{
+						if(i->second != j->second)
+						{
+							entry.Kind = XTOKEN_DIFF_KIND::Changed;
+							entry.OldAttributes = i->second;
+							entry.NewAttributes = j->second;
+							key(entry, i->first);
+
+							Entries.push_back(std::move(entry));
+						}
+
+						i++;
+						j++;
+					}
+				}
+			}
+		};
+
+		for(size_t i = 0; i < lists.size(); i++)
+			merge(lists[i], before.Lists[i], after.Lists[i], [](XTOKEN_DIFF_ENTRY& entry, const bin_t& sid){ entry.Sid = sid; });
+
+		merge(XTOKEN_DIFF_AREA::Privileges, before.Privileges, after.Privileges, [](XTOKEN_DIFF_ENTRY& entry, const DWORD64& luid)
+		{
+			entry.Luid.LowPart = (DWORD)luid;
+			entry.Luid.HighPart = (LONG)(luid >> 32);
+		});
+		#pragma endregion
+
+		#pragma region Claims
+		for(size_t i = 0; i < claims.size(); i++)
+			compare(claims[i], before.Claims[i], after.Claims[i]);
+		#pragma endregion
+	}
+	//****************************************************************************************
+	XCONDITIONAL_REFERENCES XTOKEN_DIFF::References() const
+	{
+		XCONDITIONAL_REFERENCES result;
+
+		for(auto&& element : Entries)
+		{
+			switch(element.Area)
+			{
+				// User's SID is a part of "Member_of" set, restricted SIDs are used by the second access check pass
+				case XTOKEN_DIFF_AREA::User:
+				case XTOKEN_DIFF_AREA::Groups:
+				case XTOKEN_DIFF_AREA::RestrictedSids:
+					result.UserGroups = true;
+					break;
+				case XTOKEN_DIFF_AREA::DeviceGroups:
+				case XTOKEN_DIFF_AREA::RestrictedDeviceGroups:
+					result.DeviceGroups = true;
+					break;
+				case XTOKEN_DIFF_AREA::UserClaims:
+					result.User.insert(element.Name);
+					break;
+				case XTOKEN_DIFF_AREA::DeviceClaims:
+					result.Device.insert(element.Name);
+					break;
+				case XTOKEN_DIFF_AREA::SecurityAttributes: // "@Local" attributes
+					result.Local.insert(element.Name);
+					break;
+				default:; // Not visible to conditional expressions
+			}
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Batch comparison
+	//****************************************************************************************
+	template<typename T, typename F>
+	std::vector<XTOKEN_DIFF> XTOKEN_DIFF::batch(std::span<const T> pairs, const size_t& threads, F&& function)
+	{
+		std::vector<std::optional<XTOKEN_DIFF>> results(pairs.size());
+
+		parallel(pairs.size(), threads, [&](const size_t& i)
+		{
+			results[i].emplace(function(pairs[i]));
+		});
+
+		std::vector<XTOKEN_DIFF> result;
+		result.reserve(results.size());
+
+		for(auto&& element : results)
+			result.push_back(std::move(element.value()));
+
+		return result;
+	}
+	//****************************************************************************************
+	std::vector<XTOKEN_DIFF> XTOKEN_DIFF::Compare(std::span<const std::pair<const XTOKEN*, const XTOKEN*>> pairs, const size_t& threads)
+	{
+		return batch(pairs, threads, [](const std::pair<const XTOKEN*, const XTOKEN*>& value){ return XTOKEN_DIFF(*value.first, *value.second); });
+	}
+	//****************************************************************************************
+	std::vector<XTOKEN_DIFF> XTOKEN_DIFF::Compare(std::span<const std::pair<const XTOKEN_SNAPSHOT*, const XTOKEN_SNAPSHOT*>> pairs, const XGROUP_SETS* groupSets, const size_t& threads)
+	{
+		return batch(pairs, threads, [groupSets](const std::pair<const XTOKEN_SNAPSHOT*, const XTOKEN_SNAPSHOT*>& value){ return XTOKEN_DIFF(*value.first, *value.second, groupSets); });
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
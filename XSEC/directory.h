@@ -0,0 +1,655 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Offline token groups from a directory export
+	//****************************************************************************************
+	constexpr DWORD XDIRECTORY_GROUP_TYPE_DOMAIN_LOCAL = 0x00000004; // groupType: ADS_GROUP_TYPE_DOMAIN_LOCAL_GROUP
+	//****************************************************************************************
+	// Graph of principals and groups made from a directory export, used to compute groups of a
+	// token in the same way as KDC and LSA do for a S4U logon, but without a domain controller:
+	//   - membership is expanded transitively (cycles are allowed), including the primary group;
+	//   - domain-local groups are used (and expanded) only in the domain of the resource;
+	//   - sIDHistory of the principal and of all its groups is added with the same attributes;
+	//   - Everyone, Authenticated Users, This Organization and Service Asserted Identity are added.
+	// Local groups of the resource computer (BUILTIN etc.) are not part of a directory export.
+	struct XDIRECTORY
+	{
+		XDIRECTORY() = default;
+		~XDIRECTORY() = default;
+
+		XDIRECTORY(std::string_view /*LDIF*/); // Export made by "ldifde", see "Load" for used attributes
+
+		#pragma region Making of graph
+		void Load(std::string_view /*LDIF*/); // objectSid, objectClass, groupType, primaryGroupID, member, memberOf, sIDHistory
+
+		DWORD Add(std::string_view /*DN*/, const bin_t& /*objectSid*/, const bool& /*isGroup*/, const DWORD& /*groupType*/ = 0, const DWORD& /*primaryGroupID*/ = 0);
+		void AddMember(std::string_view /*group DN*/, std::string_view /*member DN*/); // Unknown DNs (foreign principals) are ignored
+		void AddHistory(std::string_view /*DN*/, const bin_t&);
+
+		void Build(); // Must be called after all changes and before expansion
+		#pragma endregion
+
+		#pragma region Expansion
+		std::optional<DWORD> Find(std::string_view /*DN*/) const;
+		std::optional<DWORD> Find(const bin_t& /*SID*/) const;
+
+		const bin_t& Sid(const DWORD&) const;
+		size_t size() const { return nodes.size(); }
+
+		// Sorted identifiers of all groups of principal, by default the resource is in domain of principal
+		std::vector<DWORD> Expand(const DWORD&, const std::optional<bin_t>& /*resource domain SID*/ = std::nullopt) const;
+		std::vector<std::vector<DWORD>> Expand(std::span<const DWORD>, const size_t& /*threads*/ = 0) const;
+
+		std::vector<std::pair<bin_t, DWORD>> Groups(const DWORD&, const std::vector<DWORD>& /*result of "Expand"*/) const; // SIDs with attributes as in token
+		XTOKEN Token(const DWORD&, const std::optional<bin_t>& /*resource domain SID*/ = std::nullopt) const;
+		#pragma endregion
+
+	private:
+		friend struct XMEMBERSHIP;
+
+		#pragma region Internal types
+		struct node_t
+		{
+			bin_t Sid;
+			std::string Dn; // ASCII letters are lower case
+			bool Group = false;
+			DWORD GroupType = 0;
+			DWORD PrimaryGroup = 0; // RID
+			DWORD Domain = 0;       // Index in "domains"
+		};
+
+		// Visited nodes for breadth-first search, cleared by list of set bits
+		struct visited_t
+		{
+			std::vector<DWORD64> Bits;
+			std::vector<DWORD> Set;
+
+			bool Visit(const DWORD& node)
+			{
+				DWORD64& word = Bits[node >> 6];
+				DWORD64 bit = (DWORD64)1 << (node & 63);
+
+				if(word & bit)
+					return false;
+
+				word |= bit;
+				Set.push_back(node);
+
+				return true;
+			}
+
+			void Clear()
+			{
+				for(auto&& element : Set)
+					Bits[element >> 6] = 0;
+
+				Set.clear();
+			}
+		};
+		#pragma endregion
+
+		std::vector<node_t> nodes;
+		std::unordered_map<std::string, DWORD> by_dn;
+		std::map<bin_t, DWORD> by_sid;
+
+		std::vector<bin_t> domains;
+		std::map<bin_t, DWORD> by_domain;
+
+		std::vector<std::pair<std::string, std::string>> members; // Group and member DNs, resolved in "Build"
+		std::vector<std::pair<DWORD, bin_t>> history;
+
+		#pragma region Adjacency lists (groups of each node) and histories
+		std::vector<DWORD> parent_offsets;
+		std::vector<DWORD> parents;
+		std::vector<DWORD> history_offsets;
+		std::vector<bin_t> histories;
+		#pragma endregion
+
+		bool built = false;
+
+		void expand(const DWORD&, const DWORD&, visited_t&, std::vector<DWORD>&) const;
+		DWORD domain(const std::optional<bin_t>&, const DWORD&) const;
+
+		static std::string key(std::string_view);
+		static bin_t base64(std::string_view);
+		static bin_t well_known(const unsigned char&, std::initializer_list<DWORD>);
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Making of graph
+	//****************************************************************************************
+	std::string XDIRECTORY::key(std::string_view dn)
+	{
+		std::string result(dn);
+
+		for(auto&& element : result)
+		{
+			if((element >= 'A') && (element <= 'Z'))
+				element += ('a' - 'A');
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	bin_t XDIRECTORY::base64(std::string_view value)
+	{
+		bin_t result;
+		result.reserve(value.size() * 3 / 4);
+
+		DWORD buffer = 0;
+		int bits = 0;
+
+		for(const char& element : value)
+		{
+			int code = -1;
+
+			if((element >= 'A') && (element <= 'Z'))
+				code = element - 'A';
+			else if((element >= 'a') && (element <= 'z'))
+				code = element - 'a' + 26;
+			else if((element >= '0') && (element <= '9'))
+				code = element - '0' + 52;
+			else if('+' == element)
+				code = 62;
+			else if('/' == element)
+				code = 63;
+			else if(('=' == element) || (' ' == element) || ('\r' == element))
+				continue;
+			else
+				throw std::exception("XDIRECTORY: invalid base64 value");
+
+			buffer = (buffer << 6) | (DWORD)code;
+			bits += 6;
+
+			if(bits >= 8)
+			{
+				bits -= 8;
+				result.push_back((unsigned char)(buffer >> bits));
+			}
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	bin_t XDIRECTORY::well_known(const unsigned char& authority, std::initializer_list<DWORD> subAuthorities)
+	{
+		bin_t result{ 1, (unsigned char)subAuthorities.size(), 0, 0, 0, 0, 0, authority };
+
+		for(const DWORD& element : subAuthorities)
+		{
+			for(int i = 0; i < 4; i++)
+				result.push_back((unsigned char)(element >> (8 * i)));
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	DWORD XDIRECTORY::Add(std::string_view dn, const bin_t& sid, const bool& isGroup, const DWORD& groupType, const DWORD& primaryGroupID)
+	{
+		#pragma region Additional check
+		// Domain SID is SID of principal without last sub-authority (RID)
+		if((sid.size() < 12) || (sid.size() != (8 + 4 * (size_t)sid[1])))
+			throw std::exception("XDIRECTORY: invalid objectSid");
+		#pragma endregion
+
+		built = false;
+
+		DWORD id = (DWORD)nodes.size();
+
+		if(false == by_dn.emplace(key(dn), id).second)
+			throw std::exception("XDIRECTORY: duplicated DN");
+
+		by_sid.emplace(sid, id);
+
+		bin_t domain(sid.begin(), sid.end() - 4);
+		domain[1]--;
+
+		auto [position, inserted] = by_domain.emplace(domain, (DWORD)domains.size());
+		if(inserted)
+			domains.push_back(domain);
+
+		nodes.push_back({ sid, key(dn), isGroup, groupType, primaryGroupID, position->second });
+
+		return id;
+	}
+	//****************************************************************************************
+	void XDIRECTORY::AddMember(std::string_view group, std::string_view member)
+	{
+		built = false;
+		members.emplace_back(key(group), key(member));
+	}
+	//****************************************************************************************
+	void XDIRECTORY::AddHistory(std::string_view dn, const bin_t& sid)
+	{
+		auto position = by_dn.find(key(dn));
+		if(position == by_dn.end())
+			throw std::exception("XDIRECTORY: unknown DN");
+
+		built = false;
+		history.emplace_back(position->second, sid);
+	}
+	//****************************************************************************************
+	void XDIRECTORY::Build()
+	{
+		#pragma region Edges from members to groups
+		std::vector<std::pair<DWORD, DWORD>> edges; // Member and group
+		edges.reserve(members.size() + nodes.size());
+
+		for(auto&& [group, member] : members)
+		{
+			auto g = by_dn.find(group);
+			auto m = by_dn.find(member);
+
+			if((g == by_dn.end()) || (m == by_dn.end()) || (false == nodes[g->second].Group))
+				continue;
+
+			edges.emplace_back(m->second, g->second);
+		}
+
+		// Primary group is a membership without "member" value in directory
+		for(DWORD i = 0; i < (DWORD)nodes.size(); i++)
+		{
+			if(0 == nodes[i].PrimaryGroup)
+				continue;
+
+			bin_t sid = domains[nodes[i].Domain];
+			sid[1]++;
+
+			for(int j = 0; j < 4; j++)
+				sid.push_back((unsigned char)(nodes[i].PrimaryGroup >> (8 * j)));
+
+			auto position = by_sid.find(sid);
+			if((position != by_sid.end()) && nodes[position->second].Group)
+				edges.emplace_back(i, position->second);
+		}
+
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		parent_offsets.assign(nodes.size() + 1, 0);
+		for(auto&& element : edges)
+			parent_offsets[element.first + 1]++;
+
+		for(size_t i = 1; i < parent_offsets.size(); i++)
+			parent_offsets[i] += parent_offsets[i - 1];
+
+		parents.resize(edges.size());
+		for(size_t i = 0; i < edges.size(); i++)
+			parents[i] = edges[i].second;
+		#pragma endregion
+
+		#pragma region SID history
+		std::sort(history.begin(), history.end());
+		history.erase(std::unique(history.begin(), history.end()), history.end());
+
+		history_offsets.assign(nodes.size() + 1, 0);
+		for(auto&& element : history)
+			history_offsets[element.first + 1]++;
+
+		for(size_t i = 1; i < history_offsets.size(); i++)
+			history_offsets[i] += history_offsets[i - 1];
+
+		histories.clear();
+		for(auto&& element : history)
+			histories.push_back(element.second);
+		#pragma endregion
+
+		built = true;
+	}
+	//****************************************************************************************
+	XDIRECTORY::XDIRECTORY(std::string_view ldif)
+	{
+		Load(ldif);
+	}
+	//****************************************************************************************
+	void XDIRECTORY::Load(std::string_view ldif)
+	{
+		#pragma region Records
+		using record_t = std::vector<std::pair<std::string, std::string>>; // Lower case attribute and value as is
+
+		std::vector<record_t> records;
+		record_t record;
+		std::string line;
+
+		auto attribute = [&record](const std::string& value)
+		{
+			size_t colon = value.find(':');
+			if(std::string::npos == colon)
+				throw std::exception("XDIRECTORY: invalid LDIF line");
+
+			std::string name = key(std::string_view(value).substr(0, colon));
+			std::string_view data = std::string_view(value).substr(colon + 1);
+
+			if(data.size() && (':' == data[0])) // "attribute:: base64"
+			{
+				data.remove_prefix(std::min(data.find_first_not_of(' ', 1), data.size()));
+
+				bin_t decoded = base64(data);
+				record.emplace_back(name, std::string(decoded.begin(), decoded.end()));
+			}
+			else
+			{
+				data.remove_prefix(std::min(data.find_first_not_of(' '), data.size()));
+				record.emplace_back(name, std::string(data));
+			}
+		};
+
+		auto flush = [&]()
+		{
+			if(line.size())
+				attribute(line);
+
+			line.clear();
+		};
+
+		size_t position = 0;
+
+		while(position <= ldif.size())
+		{
+			size_t end = std::min(ldif.find('\n', position), ldif.size());
+			std::string_view current = ldif.substr(position, end - position);
+
+			position = end + 1;
+
+			if(current.size() && ('\r' == current.back()))
+				current.remove_suffix(1);
+
+			if(current.empty())
+			{
+				flush();
+
+				if(record.size())
+					records.push_back(std::move(record));
+
+				record.clear();
+				continue;
+			}
+
+			if('#' == current[0])
+				continue;
+
+			if(' ' == current[0]) // Continuation of previous line
+			{
+				line.append(current.substr(1));
+				continue;
+			}
+
+			flush();
+			line.assign(current);
+		}
+
+		flush();
+
+		if(record.size())
+			records.push_back(std::move(record));
+		#pragma endregion
+
+		#pragma region Principals
+		auto integer = [](const std::string& value)
+		{
+			LONG64 result = 0;
+
+			auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+			if(std::errc() != error)
+				throw std::exception("XDIRECTORY: invalid integer value");
+
+			return (DWORD)result; // "groupType" is a signed value
+		};
+
+		for(auto&& element : records)
+		{
+			std::string dn;
+			bin_t sid;
+			bool group = false;
+			DWORD groupType = 0;
+			DWORD primaryGroup = 0;
+
+			for(auto&& [name, value] : element)
+			{
+				if("dn" == name)
+					dn = value;
+				else if("objectsid" == name)
+					sid.assign(value.begin(), value.end());
+				else if(("objectclass" == name) && ("group" == key(value)))
+					group = true;
+				else if("grouptype" == name)
+					groupType = integer(value);
+				else if("primarygroupid" == name)
+					primaryGroup = integer(value);
+			}
+
+			if(dn.empty() || sid.empty())
+				continue; // Containers and other objects without SID
+
+			Add(dn, sid, group, groupType, primaryGroup);
+
+			for(auto&& [name, value] : element)
+			{
+				if("member" == name)
+					AddMember(dn, value);
+				else if("memberof" == name)
+					AddMember(value, dn);
+				else if("sidhistory" == name)
+					AddHistory(dn, bin_t(value.begin(), value.end()));
+			}
+		}
+		#pragma endregion
+
+		Build();
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Expansion
+	//****************************************************************************************
+	std::optional<DWORD> XDIRECTORY::Find(std::string_view dn) const
+	{
+		auto position = by_dn.find(key(dn));
+		if(position == by_dn.end())
+			return std::nullopt;
+
+		return position->second;
+	}
+	//****************************************************************************************
+	std::optional<DWORD> XDIRECTORY::Find(const bin_t& sid) const
+	{
+		auto position = by_sid.find(sid);
+		if(position == by_sid.end())
+			return std::nullopt;
+
+		return position->second;
+	}
+	//****************************************************************************************
+	const bin_t& XDIRECTORY::Sid(const DWORD& id) const
+	{
+		if(id >= nodes.size())
+			throw std::exception("XDIRECTORY: unknown principal");
+
+		return nodes[id].Sid;
+	}
+	//****************************************************************************************
+	DWORD XDIRECTORY::domain(const std::optional<bin_t>& resource, const DWORD& principal) const
+	{
+		if(false == resource.has_value())
+			return nodes[principal].Domain;
+
+		auto position = by_domain.find(resource.value());
+		return (position == by_domain.end()) ? (DWORD)domains.size() : position->second; // Unknown domain has no domain-local groups
+	}
+	//****************************************************************************************
+	void XDIRECTORY::expand(const DWORD& principal, const DWORD& resource, visited_t& visited, std::vector<DWORD>& result) const
+	{
+		#pragma region Level-synchronous breadth-first search
+		std::vector<DWORD> frontier{ principal };
+		std::vector<DWORD> next;
+
+		visited.Visit(principal);
+
+		while(frontier.size())
+		{
+			next.clear();
+
+			for(const DWORD& node : frontier)
+			{
+				for(DWORD i = parent_offsets[node]; i < parent_offsets[node + 1]; i++)
+				{
+					const DWORD& group = parents[i];
+					const node_t& value = nodes[group];
+
+					// Domain-local groups are not applicable (and not expanded) outside of their domain
+					if((value.GroupType & XDIRECTORY_GROUP_TYPE_DOMAIN_LOCAL) && (value.Domain != resource))
+						continue;
+
+					if(visited.Visit(group))
+					{
+						next.push_back(group);
+						result.push_back(group);
+					}
+				}
+			}
+
+			frontier.swap(next);
+		}
+		#pragma endregion
+
+		std::sort(result.begin(), result.end());
+		visited.Clear();
+	}
+	//****************************************************************************************
+	std::vector<DWORD> XDIRECTORY::Expand(const DWORD& principal, const std::optional<bin_t>& resource) const
+	{
+		#pragma region Additional check
+		if(false == built)
+			throw std::exception("XDIRECTORY: call 'Build' first");
+
+		if(principal >= nodes.size())
+			throw std::exception("XDIRECTORY: unknown principal");
+		#pragma endregion
+
+		visited_t visited{ std::vector<DWORD64>((nodes.size() + 63) / 64) };
+		std::vector<DWORD> result;
+
+		expand(principal, domain(resource, principal), visited, result);
+
+		return result;
+	}
+	//****************************************************************************************
+	std::vector<std::vector<DWORD>> XDIRECTORY::Expand(std::span<const DWORD> principals, const size_t& threads) const
+	{
+		#pragma region Additional check
+		if(false == built)
+			throw std::exception("XDIRECTORY: call 'Build' first");
+
+		for(const DWORD& element : principals)
+		{
+			if(element >= nodes.size())
+				throw std::exception("XDIRECTORY: unknown principal");
+		}
+		#pragma endregion
+
+		std::vector<std::vector<DWORD>> result(principals.size());
+
+		#pragma region Process all principals in parallel, each worker has its own visited set
+		visited_t visited{ std::vector<DWORD64>((nodes.size() + 63) / 64) };
+
+		parallel(principals.size(), threads, [&, visited](const size_t& i) mutable
+		{
+			expand(principals[i], nodes[principals[i]].Domain, visited, result[i]);
+		});
+		#pragma endregion
+
+		return result;
+	}
+	//****************************************************************************************
+	std::vector<std::pair<bin_t, DWORD>> XDIRECTORY::Groups(const DWORD& principal, const std::vector<DWORD>& groups) const
+	{
+		const DWORD attributes = SE_GROUP_MANDATORY | SE_GROUP_ENABLED_BY_DEFAULT | SE_GROUP_ENABLED;
+
+		std::vector<std::pair<bin_t, DWORD>> result;
+
+		auto add_history = [&](const DWORD& node, const DWORD& value)
+		{
+			for(DWORD i = history_offsets[node]; i < history_offsets[node + 1]; i++)
+				result.emplace_back(histories[i], value);
+		};
+
+		add_history(principal, attributes);
+
+		for(const DWORD& element : groups)
+		{
+			DWORD value = attributes;
+			if(nodes[element].GroupType & XDIRECTORY_GROUP_TYPE_DOMAIN_LOCAL)
+				value |= SE_GROUP_RESOURCE;
+
+			result.emplace_back(nodes[element].Sid, value);
+			add_history(element, value);
+		}
+
+		#pragma region Well-known groups of network logon
+		result.emplace_back(well_known(1, { 0 }), attributes);   // Everyone
+		result.emplace_back(well_known(5, { 11 }), attributes);  // Authenticated Users
+		result.emplace_back(well_known(5, { 15 }), attributes);  // This Organization
+		result.emplace_back(well_known(18, { 2 }), attributes);  // Service Asserted Identity
+		#pragma endregion
+
+		return result;
+	}
+	//****************************************************************************************
+	XTOKEN XDIRECTORY::Token(const DWORD& principal, const std::optional<bin_t>& resource) const
+	{
+		// Token without handle, all values are set from directory below
+		XTOKEN result(nullptr, (DWORD64)0, std::make_shared<const XTOKEN_INFO_MEMORY>());
+
+		const bin_t& sid = Sid(principal);
+
+		result.User = std::make_shared<XSID_AND_ATTRIBUTES>(SID_AND_ATTRIBUTES{ (PSID)sid.data(), 0 });
+		result.Owner = std::make_shared<XSID>(sid.data());
+
+		for(auto&& [group, attributes] : Groups(principal, Expand(principal, resource)))
+			result.Groups.emplace_back(SID_AND_ATTRIBUTES{ (PSID)group.data(), attributes });
+
+		if(const node_t& node = nodes[principal]; node.PrimaryGroup)
+		{
+			bin_t primary = domains[node.Domain];
+			primary[1]++;
+
+			for(int i = 0; i < 4; i++)
+				primary.push_back((unsigned char)(node.PrimaryGroup >> (8 * i)));
+
+			result.PrimaryGroup = std::make_shared<XSID>(primary.data());
+		}
+
+		result.Type = TokenImpersonation;
+		result.ImpersonationLevel = SecurityIdentification; // Same as for S4U logon without TCB privilege
+		result.Loaded = XTOKEN::ClassAll;
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
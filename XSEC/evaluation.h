@@ -0,0 +1,473 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Class for working with a sorted set of binary SIDs
+	//****************************************************************************************
+	struct XSID_SET
+	{
+		XSID_SET() = default;
+		~XSID_SET() = default;
+
+		XSID_SET(const std::vector<XSID>&);
+		XSID_SET(const std::vector<bin_t>&);
+		XSID_SET(const XCONDITIONAL_OPERATOR&); // XCONDITIONAL_OPERATOR_SID or COMPOSITE{SID} only
+		XSID_SET(const std::shared_ptr<XSID_AND_ATTRIBUTES>&, const std::vector<XSID_AND_ATTRIBUTES>&, const bool& = false);
+
+		bool Contains(const bin_t&) const;
+		bool Contains(const XSID&) const;
+
+		bool Includes(const XSID_SET&) const; // All SIDs from input set are in the current set
+		bool Intersects(const XSID_SET&) const; // Any SID from input set is in the current set
+
+		std::vector<bin_t> Values; // Sorted binary SIDs without duplicates
+
+	private:
+		void Normalize();
+	};
+	//****************************************************************************************
+	XSID_SET::XSID_SET(const std::vector<XSID>& sids)
+	{
+		Values.reserve(sids.size());
+
+		for(auto&& element : sids)
+			Values.push_back((bin_t)element);
+
+		Normalize();
+	}
+	//****************************************************************************************
+	XSID_SET::XSID_SET(const std::vector<bin_t>& sids) : Values(sids)
+	{
+		Normalize();
+	}
+	//****************************************************************************************
+	XSID_SET::XSID_SET(const XCONDITIONAL_OPERATOR& value)
+	{
+		switch(value.Code())
+		{
+			case 0x50: // XComposite type
+				{
+					auto composite = dynamic_cast<const XCONDITIONAL_OPERATOR_COMPOSITE*>(&value);
+					Values.reserve(composite->Value.size());
+
+					for(auto&& element : composite->Value)
+					{
+						if(0x51 != element->Code())
+							throw std::exception("XSID_SET: only SIDs allowed in composite");
+
+						Values.push_back((bin_t)*(dynamic_cast<XCONDITIONAL_OPERATOR_SID*>(element.get())->Value));
+					}
+				}
+				break;
+			case 0x51: // SID type
+				Values.push_back((bin_t)*(dynamic_cast<const XCONDITIONAL_OPERATOR_SID*>(&value)->Value));
+				break;
+			default:
+				throw std::exception("XSID_SET: invalid operator type");
+		}
+
+		Normalize();
+	}
+	//****************************************************************************************
+	XSID_SET::XSID_SET(const std::shared_ptr<XSID_AND_ATTRIBUTES>& user, const std::vector<XSID_AND_ATTRIBUTES>& groups, const bool& denyOnly)
+	{
+		Values.reserve(groups.size() + 1);
+
+		// User's SID has no "SE_GROUP_ENABLED" bit, only "deny-only" flag matters for it
+		if(nullptr != user)
+		{
+			if(denyOnly || (false == user->Attributes->get((size_t)4 /*SE_GROUP_USE_FOR_DENY_ONLY*/)))
+				Values.push_back((bin_t)*user->Sid);
+		}
+
+		for(auto&& element : groups)
+		{
+			if(element.Attributes->get((size_t)2 /*SE_GROUP_ENABLED*/) || (denyOnly && element.Attributes->get((size_t)4 /*SE_GROUP_USE_FOR_DENY_ONLY*/)))
+				Values.push_back((bin_t)*element.Sid);
+		}
+
+		Normalize();
+	}
+	//****************************************************************************************
+	void XSID_SET::Normalize()
+	{
+		sort_unique(Values);
+	}
+	//****************************************************************************************
+	bool XSID_SET::Contains(const bin_t& sid) const
+	{
+		return std::binary_search(Values.begin(), Values.end(), sid);
+	}
+	//****************************************************************************************
+	bool XSID_SET::Contains(const XSID& sid) const
+	{
+		return Contains((bin_t)sid);
+	}
+	//****************************************************************************************
+	bool XSID_SET::Includes(const XSID_SET& set) const
+	{
+		return sorted_includes(Values, set.Values);
+	}
+	//****************************************************************************************
+	bool XSID_SET::Intersects(const XSID_SET& set) const
+	{
+		return sorted_intersects(Values, set.Values);
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Context for conditional expressions evaluation
+	//****************************************************************************************
+	enum class XCONDITIONAL_RESULT : unsigned char
+	{
+		False = 0,
+		True = 1,
+		Unknown = 2
+	};
+	//****************************************************************************************
+	struct XCONDITIONAL_CONTEXT
+	{
+		XCONDITIONAL_CONTEXT() = default;
+		~XCONDITIONAL_CONTEXT() = default;
+
+		XCONDITIONAL_CONTEXT(const XSID_SET&, const XSID_SET& = {});
+		XCONDITIONAL_CONTEXT(const XTOKEN&, const bool& = false);
+
+		XSID_SET UserSids; // Used for "Member_of" and "Member_of_Any" operators
+		XSID_SET DeviceSids; // Used for "Device_Member_of" and "Device_Member_of_Any" operators
+	};
+	//****************************************************************************************
+	XCONDITIONAL_CONTEXT::XCONDITIONAL_CONTEXT(const XSID_SET& userSids, const XSID_SET& deviceSids) : UserSids(userSids), DeviceSids(deviceSids)
+	{
+	}
+	//****************************************************************************************
+	XCONDITIONAL_CONTEXT::XCONDITIONAL_CONTEXT(const XTOKEN& token, const bool& denyOnly) :
+		UserSids(token.User, token.Groups, denyOnly),
+		DeviceSids(nullptr, token.DeviceGroups, denyOnly)
+	{
+		token.Require(XTOKEN::Class(TokenUser) | XTOKEN::Class(TokenGroups) | XTOKEN::Class(TokenDeviceGroups), "XCONDITIONAL_CONTEXT");
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Static analysis for conditional expressions
+	//****************************************************************************************
+	struct XCONDITIONAL_REFERENCES
+	{
+		XCONDITIONAL_REFERENCES() = default;
+		~XCONDITIONAL_REFERENCES() = default;
+
+		XCONDITIONAL_REFERENCES(const XCONDITIONAL_EXPRESSION&);
+		XCONDITIONAL_REFERENCES(const std::shared_ptr<XCONDITIONAL_OPERATOR>&);
+
+		bool Intersects(const XCONDITIONAL_REFERENCES&) const;
+
+		#pragma region Names of all attributes referenced in the expression
+		std::set<std::wstring, wstring_iless> Local;
+		std::set<std::wstring, wstring_iless> User;
+		std::set<std::wstring, wstring_iless> Resource;
+		std::set<std::wstring, wstring_iless> Device;
+		#pragma endregion
+
+		bool UserGroups = false; // There is at least one "Member_of" or "Member_of_Any" operator
+		bool DeviceGroups = false; // There is at least one "Device_Member_of" or "Device_Member_of_Any" operator
+
+	private:
+		void Collect(const XCONDITIONAL_OPERATOR*);
+	};
+	//****************************************************************************************
+	XCONDITIONAL_REFERENCES::XCONDITIONAL_REFERENCES(const XCONDITIONAL_EXPRESSION& expression) : XCONDITIONAL_REFERENCES(expression.Operator)
+	{
+	}
+	//****************************************************************************************
+	XCONDITIONAL_REFERENCES::XCONDITIONAL_REFERENCES(const std::shared_ptr<XCONDITIONAL_OPERATOR>& value)
+	{
+		if(nullptr == value)
+			throw std::exception("XCONDITIONAL_REFERENCES: initialize expression first");
+
+		Collect(value.get());
+	}
+	//****************************************************************************************
+	void XCONDITIONAL_REFERENCES::Collect(const XCONDITIONAL_OPERATOR* value)
+	{
+		switch(value->Code())
+		{
+			#pragma region Attributes
+			case 0xF8: // XLocal Attribute
+				Local.emplace(dynamic_cast<const XCONDITIONAL_OPERATOR_UNICODE*>(value)->View());
+				break;
+			case 0xF9: // XUser Attribute
+				User.emplace(dynamic_cast<const XCONDITIONAL_OPERATOR_UNICODE*>(value)->View());
+				break;
+			case 0xFA: // XResource Attribute
+				Resource.emplace(dynamic_cast<const XCONDITIONAL_OPERATOR_UNICODE*>(value)->View());
+				break;
+			case 0xFB: // XDevice Attribute
+				Device.emplace(dynamic_cast<const XCONDITIONAL_OPERATOR_UNICODE*>(value)->View());
+				break;
+			#pragma endregion
+
+			#pragma region Membership operators
+			case 0x89: // XMember_of
+			case 0x8B: // XMember_of_Any
+			case 0x90: // XNot_Member_of
+			case 0x92: // XNot_Member_of_Any
+				UserGroups = true;
+				break;
+			case 0x8A: // XDevice_Member_of
+			case 0x8C: // XDevice_Member_of_Any
+			case 0x91: // XNot_Device_Member_of
+			case 0x93: // XNot_Device_Member_of_Any
+				DeviceGroups = true;
+				break;
+			#pragma endregion
+
+			#pragma region Operators with nested values
+			case 0x50: // XComposite Type
+				for(auto&& element : dynamic_cast<const XCONDITIONAL_OPERATOR_COMPOSITE*>(value)->Value)
+					Collect(element.get());
+				break;
+			case 0x80: // ==
+			case 0x81: // !=
+			case 0x82: // <
+			case 0x83: // <=
+			case 0x84: // >
+			case 0x85: // >=
+			case 0x86: // XContains
+			case 0x88: // XAny_of
+			case 0x8E: // XNot_Contains
+			case 0x8F: // XNot_Any_of
+				{
+					auto op = dynamic_cast<const XCONDITIONAL_OPERATOR_BRELATIONAL*>(value);
+
+					Collect(op->LHS.get());
+					Collect(op->RHS.get());
+				}
+				break;
+			case 0x87: // XExists
+			case 0x8D: // XNot_Exists
+			case 0xA2: // Logical NOT (!)
+				Collect(dynamic_cast<const XCONDITIONAL_OPERATOR_ULOGICAL*>(value)->Value.get());
+				break;
+			case 0xA0: // Logical AND (&&)
+			case 0xA1: // Logical OR (||)
+				{
+					auto op = dynamic_cast<const XCONDITIONAL_OPERATOR_BLOGICAL*>(value);
+
+					Collect(op->LHS.get());
+					Collect(op->RHS.get());
+				}
+				break;
+			#pragma endregion
+
+			default:; // Literals do not reference anything
+		}
+	}
+	//****************************************************************************************
+	bool XCONDITIONAL_REFERENCES::Intersects(const XCONDITIONAL_REFERENCES& changes) const
+	{
+		#pragma region Groups
+		if((UserGroups && changes.UserGroups) || (DeviceGroups && changes.DeviceGroups))
+			return true;
+		#pragma endregion
+
+		#pragma region Attributes
+		auto intersects = [](const std::set<std::wstring, wstring_iless>& lhs, const std::set<std::wstring, wstring_iless>& rhs) -> bool
+		{
+			for(auto&& element : rhs)
+			{
+				if(lhs.count(element))
+					return true;
+			}
+
+			return false;
+		};
+
+		return (intersects(Local, changes.Local) || intersects(User, changes.User) || intersects(Resource, changes.Resource) || intersects(Device, changes.Device));
+		#pragma endregion
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Class for evaluation of conditional expressions
+	//****************************************************************************************
+	struct XCONDITIONAL_EVALUATOR
+	{
+		XCONDITIONAL_EVALUATOR() = delete;
+		~XCONDITIONAL_EVALUATOR() = default;
+
+		XCONDITIONAL_EVALUATOR(const XCONDITIONAL_EXPRESSION&);
+
+		XCONDITIONAL_RESULT Evaluate(const XCONDITIONAL_CONTEXT&) const;
+		XCONDITIONAL_RESULT Evaluate(const XCONDITIONAL_OPERATOR*, const XCONDITIONAL_CONTEXT&) const; // Evaluate a sub-expression of "Operator"
+
+		// Result for a changed token: "previous" is kept if "changes" (for example from "XTOKEN_DIFF::References")
+		// touch nothing referenced by the expression, otherwise the expression is evaluated again
+		XCONDITIONAL_RESULT Reevaluate(const XCONDITIONAL_RESULT& /*previous*/, const XCONDITIONAL_REFERENCES& /*changes*/, const XCONDITIONAL_CONTEXT&) const;
+
+		std::shared_ptr<XCONDITIONAL_OPERATOR> Operator;
+		XCONDITIONAL_REFERENCES References; // Attributes and groups used by "Operator"
+
+	private:
+		// All SID sets for "membership" operators are prepared only once, during construction
+		std::map<const XCONDITIONAL_OPERATOR*, XSID_SET> sets;
+
+		void Compile(const std::shared_ptr<XCONDITIONAL_OPERATOR>&);
+	};
+	//****************************************************************************************
+	XCONDITIONAL_EVALUATOR::XCONDITIONAL_EVALUATOR(const XCONDITIONAL_EXPRESSION& expression) : Operator(expression.Operator)
+	{
+		if(nullptr == Operator)
+			throw std::exception("XCONDITIONAL_EVALUATOR: initialize expression first");
+
+		Compile(Operator);
+
+		References = XCONDITIONAL_REFERENCES(Operator);
+	}
+	//****************************************************************************************
+	void XCONDITIONAL_EVALUATOR::Compile(const std::shared_ptr<XCONDITIONAL_OPERATOR>& value)
+	{
+		switch(value->Code())
+		{
+			case 0x89: // XMember_of
+			case 0x8A: // XDevice_Member_of
+			case 0x8B: // XMember_of_Any
+			case 0x8C: // XDevice_Member_of_Any
+			case 0x90: // XNot_Member_of
+			case 0x91: // XNot_Device_Member_of
+			case 0x92: // XNot_Member_of_Any
+			case 0x93: // XNot_Device_Member_of_Any
+				sets.emplace(value.get(), XSID_SET(*(dynamic_cast<XCONDITIONAL_OPERATOR_URELATIONAL*>(value.get())->Value)));
+				break;
+			case 0x87: // XExists
+			case 0x8D: // XNot_Exists
+			case 0xA2: // Logical NOT (!)
+				Compile(dynamic_cast<XCONDITIONAL_OPERATOR_ULOGICAL*>(value.get())->Value);
+				break;
+			case 0xA0: // Logical AND (&&)
+			case 0xA1: // Logical OR (||)
+				{
+					auto op = dynamic_cast<XCONDITIONAL_OPERATOR_BLOGICAL*>(value.get());
+
+					Compile(op->LHS);
+					Compile(op->RHS);
+				}
+				break;
+			default:;
+		}
+	}
+	//****************************************************************************************
+	XCONDITIONAL_RESULT XCONDITIONAL_EVALUATOR::Evaluate(const XCONDITIONAL_CONTEXT& context) const
+	{
+		return Evaluate(Operator.get(), context);
+	}
+	//****************************************************************************************
+	XCONDITIONAL_RESULT XCONDITIONAL_EVALUATOR::Reevaluate(const XCONDITIONAL_RESULT& previous, const XCONDITIONAL_REFERENCES& changes, const XCONDITIONAL_CONTEXT& context) const
+	{
+		if(false == References.Intersects(changes))
+			return previous;
+
+		return Evaluate(context);
+	}
+	//****************************************************************************************
+	XCONDITIONAL_RESULT XCONDITIONAL_EVALUATOR::Evaluate(const XCONDITIONAL_OPERATOR* value, const XCONDITIONAL_CONTEXT& context) const
+	{
+		auto code = value->Code();
+
+		switch(code)
+		{
+			#pragma region Membership operators
+			case 0x89: // XMember_of
+			case 0x8A: // XDevice_Member_of
+			case 0x8B: // XMember_of_Any
+			case 0x8C: // XDevice_Member_of_Any
+			case 0x90: // XNot_Member_of
+			case 0x91: // XNot_Device_Member_of
+			case 0x92: // XNot_Member_of_Any
+			case 0x93: // XNot_Device_Member_of_Any
+				{
+					auto find = sets.find(value);
+					if(sets.end() == find)
+						throw std::exception("XCONDITIONAL_EVALUATOR: operator was not compiled");
+
+					const XSID_SET& token_sids = ((0x8A == code) || (0x8C == code) || (0x91 == code) || (0x93 == code)) ? context.DeviceSids : context.UserSids;
+
+					bool result = ((0x8B == code) || (0x8C == code) || (0x92 == code) || (0x93 == code)) ? token_sids.Intersects(find->second) : token_sids.Includes(find->second);
+
+					if(code >= 0x90)
+						result = !result;
+
+					return (result ? XCONDITIONAL_RESULT::True : XCONDITIONAL_RESULT::False);
+				}
+			#pragma endregion
+
+			#pragma region Logical operators
+			case 0xA2: // Logical NOT (!)
+				{
+					auto result = Evaluate(dynamic_cast<const XCONDITIONAL_OPERATOR_ULOGICAL*>(value)->Value.get(), context);
+
+					if(XCONDITIONAL_RESULT::Unknown == result)
+						return result;
+
+					return ((XCONDITIONAL_RESULT::True == result) ? XCONDITIONAL_RESULT::False : XCONDITIONAL_RESULT::True);
+				}
+			case 0xA0: // Logical AND (&&)
+				{
+					auto op = dynamic_cast<const XCONDITIONAL_OPERATOR_BLOGICAL*>(value);
+
+					auto lhs = Evaluate(op->LHS.get(), context);
+					if(XCONDITIONAL_RESULT::False == lhs)
+						return lhs;
+
+					auto rhs = Evaluate(op->RHS.get(), context);
+					if(XCONDITIONAL_RESULT::False == rhs)
+						return rhs;
+
+					return (((XCONDITIONAL_RESULT::True == lhs) && (XCONDITIONAL_RESULT::True == rhs)) ? XCONDITIONAL_RESULT::True : XCONDITIONAL_RESULT::Unknown);
+				}
+			case 0xA1: // Logical OR (||)
+				{
+					auto op = dynamic_cast<const XCONDITIONAL_OPERATOR_BLOGICAL*>(value);
+
+					auto lhs = Evaluate(op->LHS.get(), context);
+					if(XCONDITIONAL_RESULT::True == lhs)
+						return lhs;
+
+					auto rhs = Evaluate(op->RHS.get(), context);
+					if(XCONDITIONAL_RESULT::True == rhs)
+						return rhs;
+
+					return (((XCONDITIONAL_RESULT::False == lhs) && (XCONDITIONAL_RESULT::False == rhs)) ? XCONDITIONAL_RESULT::False : XCONDITIONAL_RESULT::Unknown);
+				}
+			#pragma endregion
+
+			default:
+				throw std::exception("XCONDITIONAL_EVALUATOR: operators over attributes are not supported");
+		}
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
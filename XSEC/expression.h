@@ -32,6 +32,7 @@ namespace XSEC
 
 		virtual explicit operator bin_t() = 0;
 		virtual explicit operator xml_t() = 0;
+		virtual void Write(XXML_WRITER&) const = 0; // Same elements as "operator xml_t"
 
 		virtual unsigned char Code() const = 0;
 	};
@@ -55,9 +56,11 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_INT(bin_t::const_iterator*, bin_t::const_iterator, const unsigned char&);
 		XCONDITIONAL_OPERATOR_INT(const msxml_et&, const unsigned char&);
+		XCONDITIONAL_OPERATOR_INT(XXML_READER&, const unsigned char&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
 		int64_t Value = 0;
 		int8_t Sign = 0;
@@ -177,6 +180,16 @@ namespace XSEC
 		Base = 0x02;
 	}
 	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_INT::XCONDITIONAL_OPERATOR_INT(XXML_READER& xml, const unsigned char& _code) : code(_code)
+	{
+		CheckCode();
+
+		Value = xml.Number<int64_t>();
+
+		Sign = (Value > 0) ? 0x01 : ((Value < 0) ? 0x02 : 0x03);
+		Base = 0x02;
+	}
+	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_INT::operator bin_t()
 	{
 		bin_t result(11);
@@ -228,6 +241,17 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_INT::Write(XXML_WRITER& xml) const
+	{
+		auto find = XCONDITIONAL_OPERATOR_INT::Names.find(Code());
+		if(XCONDITIONAL_OPERATOR_INT::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_INT: invalid code value");
+
+		xml.Start(find->second);
+		xml.Number(Value);
+		xml.End();
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_INT::Code() const
 	{
 		return code;
@@ -247,13 +271,16 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_UNICODE(const std::wstring&, const unsigned char&);
 
-		XCONDITIONAL_OPERATOR_UNICODE(bin_t::const_iterator*, bin_t::const_iterator, const unsigned char&);
+		XCONDITIONAL_OPERATOR_UNICODE(bin_t::const_iterator*, bin_t::const_iterator, const unsigned char&, const std::shared_ptr<const bin_t>& /*Source*/ = nullptr);
 		XCONDITIONAL_OPERATOR_UNICODE(const msxml_et&, const unsigned char&);
+		XCONDITIONAL_OPERATOR_UNICODE(XXML_READER&, const unsigned char&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
-		std::wstring Value;
+		std::wstring_view View() const; // Value of the string, could be a view on a source buffer
+		const std::wstring& Materialize(); // Copy value from a source buffer and release the buffer
 
 		unsigned char Code() const override;
 
@@ -275,6 +302,15 @@ namespace XSEC
 		private:
 		unsigned char code;
 
+		std::wstring value; // Empty if the operator was read as a view on a source buffer
+
+		#pragma region Data for operators read as views
+		std::shared_ptr<const bin_t> source;
+
+		const unsigned char* view = nullptr;
+		size_t view_size = 0; // In bytes
+		#pragma endregion
+
 		void CheckCode()
 		{
 			switch(code)
@@ -295,56 +331,49 @@ namespace XSEC
 	{
 	}
 	//****************************************************************************************
-	XCONDITIONAL_OPERATOR_UNICODE::XCONDITIONAL_OPERATOR_UNICODE(const std::wstring& value) : Value(value), code((unsigned char)0x10)
+	XCONDITIONAL_OPERATOR_UNICODE::XCONDITIONAL_OPERATOR_UNICODE(const std::wstring& _value) : value(_value), code((unsigned char)0x10)
 	{
 	}
 	//****************************************************************************************
-	XCONDITIONAL_OPERATOR_UNICODE::XCONDITIONAL_OPERATOR_UNICODE(const std::wstring& value, const unsigned char& _code) : Value(value), code(_code)
+	XCONDITIONAL_OPERATOR_UNICODE::XCONDITIONAL_OPERATOR_UNICODE(const std::wstring& _value, const unsigned char& _code) : value(_value), code(_code)
 	{
 		CheckCode();
 	}
 	//****************************************************************************************
-	XCONDITIONAL_OPERATOR_UNICODE::XCONDITIONAL_OPERATOR_UNICODE(bin_t::const_iterator* iter, bin_t::const_iterator end, const unsigned char& _code) : code(_code)
+	XCONDITIONAL_OPERATOR_UNICODE::XCONDITIONAL_OPERATOR_UNICODE(bin_t::const_iterator* iter, bin_t::const_iterator end, const unsigned char& _code, const std::shared_ptr<const bin_t>& _source) : code(_code)
 	{
 		CheckCode();
 
-		#pragma region Initial variables
-		size_t i = 0;
-		size_t j = 0;
-		size_t k = 0;
+		#pragma region Read length of the XUnicode string
+		if((end - *iter) < 4)
+			throw std::exception("XCONDITIONAL_OPERATOR_UNICODE: unexpected end of data");
 
-		wchar_t ch = L' ';
 		DWORD length = 0;
-		#pragma endregion
-
-		#pragma region Read length of the XUnicode string
-		do
-		{
-			if(*iter == end)
-				throw std::exception("XCONDITIONAL_OPERATOR_UNICODE: unexpected end of data");
+		memcpy(&length, &(**iter), 4);
+		*iter += 4;
 
-			((BYTE*)&length)[i++] = *((*iter)++);
-		} while(i < 4);
+		if((length & 1) || ((size_t)(end - *iter) < length))
+			throw std::exception("XCONDITIONAL_OPERATOR_UNICODE: invalid length of data");
 		#pragma endregion
 
-
 		#pragma region Read a value of XUnicode string
-		i = 0;
-		Value.resize(length >> 1);
-
-		do
+		if(length)
 		{
-			if(*iter == end)
-				throw std::exception("XCONDITIONAL_OPERATOR_UNICODE: unexpected end of data");
-
-			((BYTE*)&ch)[j++] = *((*iter)++);
-
-			if(2 == j)
+			if(nullptr != _source)
 			{
-				Value[k++] = ch;
-				j = 0;
+				// Value stays in the source buffer, the buffer is kept alive by the operator
+				source = _source;
+				view = &(**iter);
+				view_size = length;
 			}
-		} while(++i < length);
+			else
+			{
+				value.resize(length >> 1);
+				memcpy(value.data(), &(**iter), length);
+			}
+
+			*iter += length;
+		}
 		#pragma endregion
 	}
 	//****************************************************************************************
@@ -352,7 +381,14 @@ namespace XSEC
 	{
 		CheckCode();
 
-		Value = (wchar_t*)xml->text;
+		value = (wchar_t*)xml->text;
+	}
+	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_UNICODE::XCONDITIONAL_OPERATOR_UNICODE(XXML_READER& xml, const unsigned char& _code) : code(_code)
+	{
+		CheckCode();
+
+		value = xml.WText();
 	}
 	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_UNICODE::operator bin_t()
@@ -362,18 +398,15 @@ namespace XSEC
 		result.push_back(code);
 
 		#pragma region Put information about string length
-		DWORD length = Value.size() << 1; // Size in bytes, not wchars
+		auto value = View();
+		DWORD length = value.size() << 1; // Size in bytes, not wchars
 
 		for(size_t i = 0; i < 4; i++)
 			result.push_back(((BYTE*)&length)[i]);
 		#pragma endregion
 
 		#pragma region Put information about Value
-		for(auto&& element : Value)
-		{
-			result.push_back(((BYTE*)&element)[0]);
-			result.push_back(((BYTE*)&element)[1]);
-		}
+		result.insert(result.end(), (const BYTE*)value.data(), (const BYTE*)value.data() + length);
 		#pragma endregion
 
 		return result;
@@ -403,13 +436,47 @@ namespace XSEC
 			#pragma endregion
 
 			#pragma region Value
-			op->appendChild(xml->createTextNode(Value.c_str()));
+			op->appendChild(xml->createTextNode(_bstr_t(SysAllocStringLen(View().data(), (UINT)View().size()), false)));
 			#pragma endregion
 
 			return op;
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_UNICODE::Write(XXML_WRITER& xml) const
+	{
+		auto find = XCONDITIONAL_OPERATOR_UNICODE::Names.find(code);
+		if(XCONDITIONAL_OPERATOR_UNICODE::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_UNICODE: invalid code value");
+
+		xml.Start(find->second);
+		xml.Text(View());
+		xml.End();
+	}
+	//****************************************************************************************
+	std::wstring_view XCONDITIONAL_OPERATOR_UNICODE::View() const
+	{
+		// UTF-16 data inside the source buffer could be unaligned, it is fine for all Windows targets
+		if(nullptr != view)
+			return std::wstring_view((const wchar_t*)view, view_size >> 1);
+
+		return std::wstring_view(value);
+	}
+	//****************************************************************************************
+	const std::wstring& XCONDITIONAL_OPERATOR_UNICODE::Materialize()
+	{
+		if(nullptr != view)
+		{
+			value = std::wstring(View());
+
+			view = nullptr;
+			view_size = 0;
+			source = nullptr;
+		}
+
+		return value;
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_UNICODE::Code() const
 	{
 		return code;
@@ -426,13 +493,16 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_OCTET(const bin_t&);
 
-		XCONDITIONAL_OPERATOR_OCTET(bin_t::const_iterator*, bin_t::const_iterator);
+		XCONDITIONAL_OPERATOR_OCTET(bin_t::const_iterator*, bin_t::const_iterator, const std::shared_ptr<const bin_t>& /*Source*/ = nullptr);
 		XCONDITIONAL_OPERATOR_OCTET(const msxml_et&);
+		XCONDITIONAL_OPERATOR_OCTET(XXML_READER&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
-		bin_t Value;
+		std::span<const unsigned char> View() const; // Value of the octet string, could be a view on a source buffer
+		const bin_t& Materialize(); // Copy value from a source buffer and release the buffer
 
 		unsigned char Code() const override;
 
@@ -442,45 +512,59 @@ namespace XSEC
 		inline static const std::map<std::wstring, unsigned char> Codes = {
 			{ L"OCTET", (unsigned char)0x18 }
 		};
+
+		private:
+		bin_t value; // Empty if the operator was read as a view on a source buffer
+
+		#pragma region Data for operators read as views
+		std::shared_ptr<const bin_t> source;
+		std::span<const unsigned char> view;
+		#pragma endregion
 	};
 	//****************************************************************************************
-	XCONDITIONAL_OPERATOR_OCTET::XCONDITIONAL_OPERATOR_OCTET(const bin_t& value) : Value(value)
+	XCONDITIONAL_OPERATOR_OCTET::XCONDITIONAL_OPERATOR_OCTET(const bin_t& _value) : value(_value)
 	{
 	}
 	//****************************************************************************************
-	XCONDITIONAL_OPERATOR_OCTET::XCONDITIONAL_OPERATOR_OCTET(bin_t::const_iterator* iter, bin_t::const_iterator end)
+	XCONDITIONAL_OPERATOR_OCTET::XCONDITIONAL_OPERATOR_OCTET(bin_t::const_iterator* iter, bin_t::const_iterator end, const std::shared_ptr<const bin_t>& _source)
 	{
-		size_t i = 0;
-		DWORD length = 0;
-
 		#pragma region Read length of the Octet string
-		do
-		{
-			if(*iter == end)
-				throw std::exception("XCONDITIONAL_OPERATOR_OCTET: unexpected end of data");
+		if((end - *iter) < 4)
+			throw std::exception("XCONDITIONAL_OPERATOR_OCTET: unexpected end of data");
 
-			((BYTE*)&length)[i++] = *((*iter)++);
-		} while(i < 4);
+		DWORD length = 0;
+		memcpy(&length, &(**iter), 4);
+		*iter += 4;
+
+		if((size_t)(end - *iter) < length)
+			throw std::exception("XCONDITIONAL_OPERATOR_OCTET: invalid length of data");
 		#pragma endregion
 
 		#pragma region Read a value of Octet string
-		i = 0;
-		Value.resize(length);
-
-		do
+		if(length)
 		{
-			if(*iter == end)
-				throw std::exception("XCONDITIONAL_OPERATOR_OCTET: unexpected end of data");
-
-			Value[i++] = *((*iter)++);
+			if(nullptr != _source)
+			{
+				// Value stays in the source buffer, the buffer is kept alive by the operator
+				source = _source;
+				view = std::span<const unsigned char>(&(**iter), length);
+			}
+			else
+				value.assign(*iter, *iter + length);
 
-		} while(i < length);
+			*iter += length;
+		}
 		#pragma endregion
 	}
 	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_OCTET::XCONDITIONAL_OPERATOR_OCTET(const msxml_et& xml)
 	{
-		Value = from_hex_codes((wchar_t*)xml->text);
+		value = from_hex_codes((wchar_t*)xml->text);
+	}
+	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_OCTET::XCONDITIONAL_OPERATOR_OCTET(XXML_READER& xml)
+	{
+		value = xml.Hex();
 	}
 	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_OCTET::operator bin_t()
@@ -490,14 +574,15 @@ namespace XSEC
 		result.push_back(0x18);
 
 		#pragma region Put information about string length
-		DWORD length = Value.size();
+		auto value = View();
+		DWORD length = value.size();
 
 		for(size_t i = 0; i < 4; i++)
 			result.push_back(((BYTE*)&length)[i]);
 		#pragma endregion
 
 		#pragma region Put information about Value
-		std::copy(Value.begin(), Value.end(), std::back_inserter(result));
+		result.insert(result.end(), value.begin(), value.end());
 		#pragma endregion
 
 		return result;
@@ -527,13 +612,45 @@ namespace XSEC
 			#pragma endregion
 
 			#pragma region Value
-			op->appendChild(xml->createTextNode(hex_codes(Value).c_str()));
+			op->appendChild(xml->createTextNode(hex_codes(View()).c_str()));
 			#pragma endregion
 
 			return op;
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_OCTET::Write(XXML_WRITER& xml) const
+	{
+		auto find = XCONDITIONAL_OPERATOR_OCTET::Names.find(Code());
+		if(XCONDITIONAL_OPERATOR_OCTET::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_OCTET: invalid code value");
+
+		xml.Start(find->second);
+		xml.Hex(View());
+		xml.End();
+	}
+	//****************************************************************************************
+	std::span<const unsigned char> XCONDITIONAL_OPERATOR_OCTET::View() const
+	{
+		if(nullptr != source)
+			return view;
+
+		return std::span<const unsigned char>(value);
+	}
+	//****************************************************************************************
+	const bin_t& XCONDITIONAL_OPERATOR_OCTET::Materialize()
+	{
+		if(nullptr != source)
+		{
+			value.assign(view.begin(), view.end());
+
+			view = {};
+			source = nullptr;
+		}
+
+		return value;
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_OCTET::Code() const
 	{
 		return 0x18;
@@ -552,9 +669,11 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_SID(bin_t::const_iterator*, bin_t::const_iterator);
 		XCONDITIONAL_OPERATOR_SID(const msxml_et&);
+		XCONDITIONAL_OPERATOR_SID(XXML_READER&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
 		std::shared_ptr<XSID> Value;
 
@@ -600,6 +719,11 @@ namespace XSEC
 		Value = std::make_shared<XSID>(xml);
 	}
 	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_SID::XCONDITIONAL_OPERATOR_SID(XXML_READER& xml)
+	{
+		Value = std::make_shared<XSID>(xml);
+	}
+	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_SID::operator bin_t()
 	{
 		if(nullptr == Value)
@@ -649,6 +773,19 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_SID::Write(XXML_WRITER& xml) const
+	{
+		if(nullptr == Value)
+			throw std::exception("XCONDITIONAL_OPERATOR_SID: initialize data first");
+
+		auto find = XCONDITIONAL_OPERATOR_SID::Names.find(Code());
+		if(XCONDITIONAL_OPERATOR_SID::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_SID: invalid code value");
+
+		// Names of operators are ASCII
+		Value->Write(xml, std::string(find->second.begin(), find->second.end()));
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_SID::Code() const
 	{
 		return 0x51;
@@ -675,13 +812,18 @@ namespace XSEC
 		XCONDITIONAL_EXPRESSION(const XCONDITIONAL_OPERATOR_BLOGICAL&);
 
 		XCONDITIONAL_EXPRESSION(const bin_t&);
+		XCONDITIONAL_EXPRESSION(const std::shared_ptr<bin_t>&); // XUnicode and Octet values would be views on one immutable copy of the buffer
 		XCONDITIONAL_EXPRESSION(const msxml_et&);
+		XCONDITIONAL_EXPRESSION(XXML_READER&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
-		static std::vector<std::shared_ptr<XCONDITIONAL_OPERATOR>> ReadOperators(bin_t::const_iterator*, bin_t::const_iterator, bool = false);
+		static std::vector<std::shared_ptr<XCONDITIONAL_OPERATOR>> ReadOperators(bin_t::const_iterator*, bin_t::const_iterator, bool = false, const std::shared_ptr<const bin_t>& /*Source*/ = nullptr);
 		static std::shared_ptr<XCONDITIONAL_OPERATOR> ReadOperator(msxml_et, bool = false);
+		static std::shared_ptr<XCONDITIONAL_OPERATOR> ReadOperator(XXML_READER&, bool = false);
+		static std::shared_ptr<XCONDITIONAL_OPERATOR> ReadSingleOperator(XXML_READER&); // The only child element of the current one
 
 		std::shared_ptr<XCONDITIONAL_OPERATOR> Operator;
 	};
@@ -700,11 +842,13 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_COMPOSITE(const type&);
 
-		XCONDITIONAL_OPERATOR_COMPOSITE(bin_t::const_iterator*, bin_t::const_iterator);
+		XCONDITIONAL_OPERATOR_COMPOSITE(bin_t::const_iterator*, bin_t::const_iterator, const std::shared_ptr<const bin_t>& /*Source*/ = nullptr);
 		XCONDITIONAL_OPERATOR_COMPOSITE(const msxml_et&);
+		XCONDITIONAL_OPERATOR_COMPOSITE(XXML_READER&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
 		std::vector<std::shared_ptr<XCONDITIONAL_OPERATOR>> Value;
 
@@ -740,7 +884,7 @@ namespace XSEC
 		}
 	}
 	//****************************************************************************************
-	XCONDITIONAL_OPERATOR_COMPOSITE::XCONDITIONAL_OPERATOR_COMPOSITE(bin_t::const_iterator* iter, bin_t::const_iterator end)
+	XCONDITIONAL_OPERATOR_COMPOSITE::XCONDITIONAL_OPERATOR_COMPOSITE(bin_t::const_iterator* iter, bin_t::const_iterator end, const std::shared_ptr<const bin_t>& source)
 	{
 		#pragma region Initial variables
 		size_t i = 0;
@@ -759,7 +903,10 @@ namespace XSEC
 
 		#pragma region Read a values of XComposite operator
 		// After the operation values would be in reverse order, but it does not matter for the type
-		Value = XCONDITIONAL_EXPRESSION::ReadOperators(iter, *iter + length, true);
+		if((size_t)(end - *iter) < length)
+			throw std::exception("XCONDITIONAL_OPERATOR_COMPOSITE: invalid length of data");
+
+		Value = XCONDITIONAL_EXPRESSION::ReadOperators(iter, *iter + length, true, source);
 		#pragma endregion
 	}
 	//****************************************************************************************
@@ -774,6 +921,16 @@ namespace XSEC
 			Value.push_back(XCONDITIONAL_EXPRESSION::ReadOperator(list->item[i], true));
 	}
 	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_COMPOSITE::XCONDITIONAL_OPERATOR_COMPOSITE(XXML_READER& xml)
+	{
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+			Value.push_back(XCONDITIONAL_EXPRESSION::ReadOperator(xml, true));
+
+		if(Value.empty())
+			throw std::exception("XCONDITIONAL_OPERATOR_COMPOSITE: invalid XML data");
+	}
+	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_COMPOSITE::operator bin_t()
 	{
 		#pragma region Initial variables
@@ -839,6 +996,20 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_COMPOSITE::Write(XXML_WRITER& xml) const
+	{
+		auto find = XCONDITIONAL_OPERATOR_COMPOSITE::Names.find(Code());
+		if(XCONDITIONAL_OPERATOR_COMPOSITE::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_COMPOSITE: invalid code value");
+
+		xml.Start(find->second);
+
+		for(auto&& element : Value)
+			element->Write(xml);
+
+		xml.End();
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_COMPOSITE::Code() const
 	{
 		return 0x50;
@@ -867,9 +1038,11 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_URELATIONAL(const std::shared_ptr<XCONDITIONAL_OPERATOR>&, const unsigned char&);
 		XCONDITIONAL_OPERATOR_URELATIONAL(const msxml_et&, const unsigned char&);
+		XCONDITIONAL_OPERATOR_URELATIONAL(XXML_READER&, const unsigned char&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
 		std::shared_ptr<XCONDITIONAL_OPERATOR> Value;
 
@@ -957,6 +1130,13 @@ namespace XSEC
 		CheckValue();
 	}
 	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_URELATIONAL::XCONDITIONAL_OPERATOR_URELATIONAL(XXML_READER& xml, const unsigned char& _code) : code(_code)
+	{
+		Value = XCONDITIONAL_EXPRESSION::ReadSingleOperator(xml);
+
+		CheckValue();
+	}
+	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_URELATIONAL::operator bin_t()
 	{
 		#pragma region Initial check
@@ -1009,6 +1189,20 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_URELATIONAL::Write(XXML_WRITER& xml) const
+	{
+		if(nullptr == Value)
+			throw std::exception("XCONDITIONAL_OPERATOR_URELATIONAL: initialize data first");
+
+		auto find = XCONDITIONAL_OPERATOR_URELATIONAL::Names.find(Code());
+		if(XCONDITIONAL_OPERATOR_URELATIONAL::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_URELATIONAL: invalid code value");
+
+		xml.Start(find->second);
+		Value->Write(xml);
+		xml.End();
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_URELATIONAL::Code() const
 	{
 		return code;
@@ -1031,9 +1225,11 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_BRELATIONAL(const std::shared_ptr<XCONDITIONAL_OPERATOR>&, const std::shared_ptr<XCONDITIONAL_OPERATOR>&, const unsigned char&);
 		XCONDITIONAL_OPERATOR_BRELATIONAL(const msxml_et&, const unsigned char&);
+		XCONDITIONAL_OPERATOR_BRELATIONAL(XXML_READER&, const unsigned char&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
 		std::shared_ptr<XCONDITIONAL_OPERATOR> LHS;
 		std::shared_ptr<XCONDITIONAL_OPERATOR> RHS;
@@ -1224,6 +1420,26 @@ namespace XSEC
 		CheckValues();
 	}
 	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_BRELATIONAL::XCONDITIONAL_OPERATOR_BRELATIONAL(XXML_READER& xml, const unsigned char& _code) : code(_code)
+	{
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("LHS" == xml.Name())
+				LHS = XCONDITIONAL_EXPRESSION::ReadSingleOperator(xml);
+			else if("RHS" == xml.Name())
+				RHS = XCONDITIONAL_EXPRESSION::ReadSingleOperator(xml);
+		}
+
+		if(nullptr == LHS)
+			throw std::exception("XCONDITIONAL_OPERATOR_BRELATIONAL: cannot find 'LHS' XML node");
+
+		if(nullptr == RHS)
+			throw std::exception("XCONDITIONAL_OPERATOR_BRELATIONAL: cannot find 'RHS' XML node");
+
+		CheckValues();
+	}
+	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_BRELATIONAL::operator bin_t()
 	{
 		#pragma region Initial check
@@ -1293,6 +1509,28 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_BRELATIONAL::Write(XXML_WRITER& xml) const
+	{
+		if((nullptr == LHS) || (nullptr == RHS))
+			throw std::exception("XCONDITIONAL_OPERATOR_BRELATIONAL: initialize data first");
+
+		auto find = XCONDITIONAL_OPERATOR_BRELATIONAL::Names.find(Code());
+		if(XCONDITIONAL_OPERATOR_BRELATIONAL::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_BRELATIONAL: invalid code value");
+
+		xml.Start(find->second);
+
+		xml.Start("LHS");
+		LHS->Write(xml);
+		xml.End();
+
+		xml.Start("RHS");
+		RHS->Write(xml);
+		xml.End();
+
+		xml.End();
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_BRELATIONAL::Code() const
 	{
 		return code;
@@ -1311,9 +1549,11 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_ULOGICAL(const std::shared_ptr<XCONDITIONAL_OPERATOR>&, const unsigned char&);
 		XCONDITIONAL_OPERATOR_ULOGICAL(const msxml_et&, const unsigned char&);
+		XCONDITIONAL_OPERATOR_ULOGICAL(XXML_READER&, const unsigned char&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
 		std::shared_ptr<XCONDITIONAL_OPERATOR> Value;
 
@@ -1375,6 +1615,13 @@ namespace XSEC
 		CheckValue();
 	}
 	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_ULOGICAL::XCONDITIONAL_OPERATOR_ULOGICAL(XXML_READER& xml, const unsigned char& _code) : code(_code)
+	{
+		Value = XCONDITIONAL_EXPRESSION::ReadSingleOperator(xml);
+
+		CheckValue();
+	}
+	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_ULOGICAL::operator bin_t()
 	{
 		#pragma region Initial check
@@ -1424,6 +1671,20 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_ULOGICAL::Write(XXML_WRITER& xml) const
+	{
+		if(nullptr == Value)
+			throw std::exception("XCONDITIONAL_OPERATOR_ULOGICAL: initialize data first");
+
+		auto find = XCONDITIONAL_OPERATOR_ULOGICAL::Names.find(Code());
+		if(XCONDITIONAL_OPERATOR_ULOGICAL::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_ULOGICAL: invalid code value");
+
+		xml.Start(find->second);
+		Value->Write(xml);
+		xml.End();
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_ULOGICAL::Code() const
 	{
 		return code;
@@ -1440,9 +1701,11 @@ namespace XSEC
 
 		XCONDITIONAL_OPERATOR_BLOGICAL(const std::shared_ptr<XCONDITIONAL_OPERATOR>&, const std::shared_ptr<XCONDITIONAL_OPERATOR>&, const unsigned char&);
 		XCONDITIONAL_OPERATOR_BLOGICAL(const msxml_et&, const unsigned char&);
+		XCONDITIONAL_OPERATOR_BLOGICAL(XXML_READER&, const unsigned char&);
 
 		explicit operator bin_t();
 		explicit operator xml_t();
+		void Write(XXML_WRITER&) const;
 
 		std::shared_ptr<XCONDITIONAL_OPERATOR> LHS;
 		std::shared_ptr<XCONDITIONAL_OPERATOR> RHS;
@@ -1515,6 +1778,26 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XCONDITIONAL_OPERATOR_BLOGICAL::XCONDITIONAL_OPERATOR_BLOGICAL(XXML_READER& xml, const unsigned char& _code) : code(_code)
+	{
+		CheckCode();
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("LHS" == xml.Name())
+				LHS = XCONDITIONAL_EXPRESSION::ReadSingleOperator(xml);
+			else if("RHS" == xml.Name())
+				RHS = XCONDITIONAL_EXPRESSION::ReadSingleOperator(xml);
+		}
+
+		if(nullptr == LHS)
+			throw std::exception("XCONDITIONAL_OPERATOR_BLOGICAL: cannot find 'LHS' XML node");
+
+		if(nullptr == RHS)
+			throw std::exception("XCONDITIONAL_OPERATOR_BLOGICAL: cannot find 'RHS' XML node");
+	}
+	//****************************************************************************************
 	XCONDITIONAL_OPERATOR_BLOGICAL::operator bin_t()
 	{
 		#pragma region Initial check
@@ -1584,6 +1867,28 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XCONDITIONAL_OPERATOR_BLOGICAL::Write(XXML_WRITER& xml) const
+	{
+		if((nullptr == LHS) || (nullptr == RHS))
+			throw std::exception("XCONDITIONAL_OPERATOR_BLOGICAL: initialize data first");
+
+		auto find = XCONDITIONAL_OPERATOR_BLOGICAL::Names.find(Code());
+		if(XCONDITIONAL_OPERATOR_BLOGICAL::Names.end() == find)
+			throw std::exception("XCONDITIONAL_OPERATOR_BLOGICAL: invalid code value");
+
+		xml.Start(find->second);
+
+		xml.Start("LHS");
+		LHS->Write(xml);
+		xml.End();
+
+		xml.Start("RHS");
+		RHS->Write(xml);
+		xml.End();
+
+		xml.End();
+	}
+	//****************************************************************************************
 	unsigned char XCONDITIONAL_OPERATOR_BLOGICAL::Code() const
 	{
 		return code;
@@ -1643,6 +1948,29 @@ namespace XSEC
 		Operator = XCONDITIONAL_EXPRESSION::ReadOperators(&iterator, end)[0];
 	}
 	//****************************************************************************************
+	XCONDITIONAL_EXPRESSION::XCONDITIONAL_EXPRESSION(const std::shared_ptr<bin_t>& data)
+	{
+		#pragma region Check input data
+		if((nullptr == data) || (data->size() < 4))
+			throw std::exception("XCONDITIONAL_EXPRESSION: invalid header");
+		#pragma endregion
+
+		#pragma region Check data header
+		if(((*data)[0] != 0x61) || ((*data)[1] != 0x72) || ((*data)[2] != 0x74) || ((*data)[3] != 0x78))
+			throw std::exception("XCONDITIONAL_EXPRESSION: invalid header");
+		#pragma endregion
+
+		#pragma region Initial variables
+		// Input buffer (usually "ApplicationData" of ACE) could be changed later, so all views are on a private copy
+		auto source = std::make_shared<const bin_t>(*data);
+
+		bin_t::const_iterator iterator = source->cbegin() + 4;
+		bin_t::const_iterator end = source->cend();
+		#pragma endregion
+
+		Operator = XCONDITIONAL_EXPRESSION::ReadOperators(&iterator, end, false, source)[0];
+	}
+	//****************************************************************************************
 	XCONDITIONAL_EXPRESSION::XCONDITIONAL_EXPRESSION(const msxml_et& xml)
 	{
 		msxml_nt list = xml->selectNodes(L"./node()");
@@ -1653,6 +1981,11 @@ namespace XSEC
 		Operator = XCONDITIONAL_EXPRESSION::ReadOperator(list->item[0]);
 	}
 	//****************************************************************************************
+	XCONDITIONAL_EXPRESSION::XCONDITIONAL_EXPRESSION(XXML_READER& xml)
+	{
+		Operator = XCONDITIONAL_EXPRESSION::ReadSingleOperator(xml);
+	}
+	//****************************************************************************************
 	XCONDITIONAL_EXPRESSION::operator bin_t()
 	{
 		if(nullptr == Operator)
@@ -1691,7 +2024,17 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
-	std::vector<std::shared_ptr<XCONDITIONAL_OPERATOR>> XCONDITIONAL_EXPRESSION::ReadOperators(bin_t::const_iterator* iter, bin_t::const_iterator end, bool data_only)
+	void XCONDITIONAL_EXPRESSION::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if(nullptr == Operator)
+			throw std::exception("XCONDITIONAL_EXPRESSION: initialize data first");
+
+		xml.Start(root.value_or("ConditionalExpression"));
+		Operator->Write(xml);
+		xml.End();
+	}
+	//****************************************************************************************
+	std::vector<std::shared_ptr<XCONDITIONAL_OPERATOR>> XCONDITIONAL_EXPRESSION::ReadOperators(bin_t::const_iterator* iter, bin_t::const_iterator end, bool data_only, const std::shared_ptr<const bin_t>& source)
 	{
 		#pragma region Initial variables
 		std::vector<std::shared_ptr<XCONDITIONAL_OPERATOR>> result;
@@ -1718,13 +2061,13 @@ namespace XSEC
 				case 0xF9: // XUser Attribute
 				case 0xFA: // XResource Attribute
 				case 0xFB: // XDevice Attribute
-					stack.push(std::make_shared<XCONDITIONAL_OPERATOR_UNICODE>(iter, end, value));
+					stack.push(std::make_shared<XCONDITIONAL_OPERATOR_UNICODE>(iter, end, value, source));
 					break;
 				case 0x18: // Octet String Type
-					stack.push(std::make_shared<XCONDITIONAL_OPERATOR_OCTET>(iter, end));
+					stack.push(std::make_shared<XCONDITIONAL_OPERATOR_OCTET>(iter, end, source));
 					break;
 				case 0x50: // XComposite Type
-					stack.push(std::make_shared<XCONDITIONAL_OPERATOR_COMPOSITE>(iter, end));
+					stack.push(std::make_shared<XCONDITIONAL_OPERATOR_COMPOSITE>(iter, end, source));
 					break;
 				case 0x51: // SID Type
 					stack.push(std::make_shared<XCONDITIONAL_OPERATOR_SID>(iter, end));
@@ -1908,6 +2251,109 @@ namespace XSEC
 		return Value;
 	}
 	//****************************************************************************************
+	std::shared_ptr<XCONDITIONAL_OPERATOR> XCONDITIONAL_EXPRESSION::ReadOperator(XXML_READER& xml, bool data_only)
+	{
+		#pragma region Initial variables
+		std::shared_ptr<XCONDITIONAL_OPERATOR> Value;
+
+		std::wstring Name = XXML_READER::wide(xml.Name());
+
+		// "XUnicode" is the only name written in mixed case
+		if(0 == XCONDITIONAL_OPERATOR_UNICODE::Codes.count(Name))
+			std::transform(Name.begin(), Name.end(), Name.begin(), ::toupper);
+		#pragma endregion
+
+		#pragma region XCONDITIONAL_OPERATOR_INT
+		if((nullptr == Value) && XCONDITIONAL_OPERATOR_INT::Codes.count(Name))
+		{
+			auto find = XCONDITIONAL_OPERATOR_INT::Codes.find(Name);
+			Value = std::make_shared<XCONDITIONAL_OPERATOR_INT>(xml, find->second);
+		}
+		#pragma endregion
+
+		#pragma region XCONDITIONAL_OPERATOR_UNICODE
+		if((nullptr == Value) && XCONDITIONAL_OPERATOR_UNICODE::Codes.count(Name))
+		{
+			auto find = XCONDITIONAL_OPERATOR_UNICODE::Codes.find(Name);
+			Value = std::make_shared<XCONDITIONAL_OPERATOR_UNICODE>(xml, find->second);
+		}
+		#pragma endregion
+
+		#pragma region XCONDITIONAL_OPERATOR_OCTET
+		if((nullptr == Value) && XCONDITIONAL_OPERATOR_OCTET::Codes.count(Name))
+			Value = std::make_shared<XCONDITIONAL_OPERATOR_OCTET>(xml);
+		#pragma endregion
+
+		#pragma region XCONDITIONAL_OPERATOR_COMPOSITE
+		if((nullptr == Value) && XCONDITIONAL_OPERATOR_COMPOSITE::Codes.count(Name))
+			Value = std::make_shared<XCONDITIONAL_OPERATOR_COMPOSITE>(xml);
+		#pragma endregion
+
+		#pragma region XCONDITIONAL_OPERATOR_SID
+		if((nullptr == Value) && XCONDITIONAL_OPERATOR_SID::Codes.count(Name))
+			Value = std::make_shared<XCONDITIONAL_OPERATOR_SID>(xml);
+		#pragma endregion
+
+		if(false == data_only)
+		{
+			#pragma region XCONDITIONAL_OPERATOR_URELATIONAL
+			if((nullptr == Value) && XCONDITIONAL_OPERATOR_URELATIONAL::Codes.count(Name))
+			{
+				auto find = XCONDITIONAL_OPERATOR_URELATIONAL::Codes.find(Name);
+				Value = std::make_shared<XCONDITIONAL_OPERATOR_URELATIONAL>(xml, find->second);
+			}
+			#pragma endregion
+
+			#pragma region XCONDITIONAL_OPERATOR_BRELATIONAL
+			if((nullptr == Value) && XCONDITIONAL_OPERATOR_BRELATIONAL::Codes.count(Name))
+			{
+				auto find = XCONDITIONAL_OPERATOR_BRELATIONAL::Codes.find(Name);
+				Value = std::make_shared<XCONDITIONAL_OPERATOR_BRELATIONAL>(xml, find->second);
+			}
+			#pragma endregion
+
+			#pragma region XCONDITIONAL_OPERATOR_ULOGICAL
+			if((nullptr == Value) && XCONDITIONAL_OPERATOR_ULOGICAL::Codes.count(Name))
+			{
+				auto find = XCONDITIONAL_OPERATOR_ULOGICAL::Codes.find(Name);
+				Value = std::make_shared<XCONDITIONAL_OPERATOR_ULOGICAL>(xml, find->second);
+			}
+			#pragma endregion
+
+			#pragma region XCONDITIONAL_OPERATOR_BLOGICAL
+			if((nullptr == Value) && XCONDITIONAL_OPERATOR_BLOGICAL::Codes.count(Name))
+			{
+				auto find = XCONDITIONAL_OPERATOR_BLOGICAL::Codes.find(Name);
+				Value = std::make_shared<XCONDITIONAL_OPERATOR_BLOGICAL>(xml, find->second);
+			}
+			#pragma endregion
+		}
+
+		if(nullptr == Value)
+			throw std::exception("XCONDITIONAL_EXPRESSION: invalid input XML data");
+
+		return Value;
+	}
+	//****************************************************************************************
+	std::shared_ptr<XCONDITIONAL_OPERATOR> XCONDITIONAL_EXPRESSION::ReadSingleOperator(XXML_READER& xml)
+	{
+		std::shared_ptr<XCONDITIONAL_OPERATOR> result;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if(nullptr != result)
+				throw std::exception("XCONDITIONAL_EXPRESSION: only a single element allowed in XML");
+
+			result = XCONDITIONAL_EXPRESSION::ReadOperator(xml);
+		}
+
+		if(nullptr == result)
+			throw std::exception("XCONDITIONAL_EXPRESSION: only a single element allowed in XML");
+
+		return result;
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Aux function for conditional expressions
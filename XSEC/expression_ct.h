@@ -0,0 +1,393 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+// Compile-time version of the conditional expressions DSL from "expression2.h".
+// The header has no dependencies on Windows headers, so all "static_assert" checks below could be verified by any C++20 compiler.
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Types for compile-time conditional expressions
+	//****************************************************************************************
+	enum class XCONDITIONAL_CONSTANT_TYPE : unsigned char
+	{
+		Literal,   // XSigned*, XCUnicode, XCOctetString
+		Sid,       // XCSid
+		Composite, // XCComposite
+		Attribute, // XCLocal, XCUser, XCResource, XCDevice
+		Boolean    // Result of any relational or logical operator
+	};
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE Type, size_t N>
+	struct XCONDITIONAL_CONSTANT
+	{
+		std::array<unsigned char, N> Value{};
+
+		explicit operator std::vector<unsigned char>() const
+		{
+			return { Value.begin(), Value.end() };
+		}
+	};
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE Type>
+	constexpr bool is_constant_data = (Type == XCONDITIONAL_CONSTANT_TYPE::Literal) || (Type == XCONDITIONAL_CONSTANT_TYPE::Sid) || (Type == XCONDITIONAL_CONSTANT_TYPE::Composite);
+
+	template<XCONDITIONAL_CONSTANT_TYPE Type>
+	constexpr bool is_constant_logical = (Type == XCONDITIONAL_CONSTANT_TYPE::Attribute) || (Type == XCONDITIONAL_CONSTANT_TYPE::Boolean);
+
+	template<XCONDITIONAL_CONSTANT_TYPE Type>
+	constexpr bool is_constant_rhs = is_constant_data<Type> || (Type == XCONDITIONAL_CONSTANT_TYPE::Attribute);
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Aux functions for compile-time conditional expressions
+	//****************************************************************************************
+	template<size_t N>
+	constexpr size_t constexpr_put_dword(std::array<unsigned char, N>& to, size_t offset, const uint32_t& value)
+	{
+		for(size_t i = 0; i < 4; i++)
+			to[offset++] = (unsigned char)((value >> (i << 3)) & 0xFF);
+
+		return offset;
+	}
+	//****************************************************************************************
+	template<size_t N, size_t M>
+	constexpr size_t constexpr_copy(std::array<unsigned char, N>& to, size_t offset, const std::array<unsigned char, M>& from)
+	{
+		for(auto&& element : from)
+			to[offset++] = element;
+
+		return offset;
+	}
+	//****************************************************************************************
+	constexpr XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Literal, 11> constexpr_int(const int64_t& value, const unsigned char& code)
+	{
+		XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Literal, 11> result{};
+
+		result.Value[0] = code;
+
+		#pragma region Value (always 8 bytes, little-endian)
+		for(size_t i = 0; i < 8; i++)
+			result.Value[i + 1] = (unsigned char)(((uint64_t)value >> (i << 3)) & 0xFF);
+		#pragma endregion
+
+		result.Value[9] = (value > 0) ? 0x01 : ((value < 0) ? 0x02 : 0x03);
+		result.Value[10] = 0x02; // No support for other bases for now
+
+		return result;
+	}
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE Type, typename CharT, size_t N>
+	constexpr XCONDITIONAL_CONSTANT<Type, 5 + ((N - 1) << 1)> constexpr_unicode(const CharT (&value)[N], const unsigned char& code)
+	{
+		XCONDITIONAL_CONSTANT<Type, 5 + ((N - 1) << 1)> result{};
+
+		result.Value[0] = code;
+
+		size_t offset = constexpr_put_dword(result.Value, 1, (uint32_t)((N - 1) << 1)); // Size in bytes, not wchars
+
+		#pragma region Value (UTF-16LE, the last null character is not stored)
+		for(size_t i = 0; i < (N - 1); i++)
+		{
+			if((uint32_t)value[i] > 0xFFFF)
+				throw std::invalid_argument("XCONDITIONAL_CONSTANT: only BMP characters allowed in compile-time strings");
+
+			result.Value[offset++] = (unsigned char)((uint32_t)value[i] & 0xFF);
+			result.Value[offset++] = (unsigned char)(((uint32_t)value[i] >> 8) & 0xFF);
+		}
+		#pragma endregion
+
+		return result;
+	}
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE Type, size_t N>
+	constexpr XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Boolean, N + 1> constexpr_unary(const XCONDITIONAL_CONSTANT<Type, N>& value, const unsigned char& code)
+	{
+		XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Boolean, N + 1> result{};
+
+		result.Value[constexpr_copy(result.Value, 0, value.Value)] = code;
+
+		return result;
+	}
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE LType, size_t N, XCONDITIONAL_CONSTANT_TYPE RType, size_t M>
+	constexpr XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Boolean, N + M + 1> constexpr_binary(const XCONDITIONAL_CONSTANT<LType, N>& lhs, const XCONDITIONAL_CONSTANT<RType, M>& rhs, const unsigned char& code)
+	{
+		XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Boolean, N + M + 1> result{};
+
+		result.Value[constexpr_copy(result.Value, constexpr_copy(result.Value, 0, lhs.Value), rhs.Value)] = code;
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Compile-time operands
+	//****************************************************************************************
+	constexpr auto XCSigned8(const int8_t& value)
+	{
+		return constexpr_int(value, (unsigned char)0x01);
+	}
+	//****************************************************************************************
+	constexpr auto XCSigned16(const int16_t& value)
+	{
+		return constexpr_int(value, (unsigned char)0x02);
+	}
+	//****************************************************************************************
+	constexpr auto XCSigned32(const int32_t& value)
+	{
+		return constexpr_int(value, (unsigned char)0x03);
+	}
+	//****************************************************************************************
+	constexpr auto XCSigned64(const int64_t& value)
+	{
+		return constexpr_int(value, (unsigned char)0x04);
+	}
+	//****************************************************************************************
+	template<typename CharT, size_t N>
+	constexpr auto XCUnicode(const CharT (&string)[N])
+	{
+		return constexpr_unicode<XCONDITIONAL_CONSTANT_TYPE::Literal>(string, (unsigned char)0x10);
+	}
+	//****************************************************************************************
+	template<typename CharT, size_t N>
+	constexpr auto XCLocal(const CharT (&string)[N])
+	{
+		return constexpr_unicode<XCONDITIONAL_CONSTANT_TYPE::Attribute>(string, (unsigned char)0xF8);
+	}
+	//****************************************************************************************
+	template<typename CharT, size_t N>
+	constexpr auto XCUser(const CharT (&string)[N])
+	{
+		return constexpr_unicode<XCONDITIONAL_CONSTANT_TYPE::Attribute>(string, (unsigned char)0xF9);
+	}
+	//****************************************************************************************
+	template<typename CharT, size_t N>
+	constexpr auto XCResource(const CharT (&string)[N])
+	{
+		return constexpr_unicode<XCONDITIONAL_CONSTANT_TYPE::Attribute>(string, (unsigned char)0xFA);
+	}
+	//****************************************************************************************
+	template<typename CharT, size_t N>
+	constexpr auto XCDevice(const CharT (&string)[N])
+	{
+		return constexpr_unicode<XCONDITIONAL_CONSTANT_TYPE::Attribute>(string, (unsigned char)0xFB);
+	}
+	//****************************************************************************************
+	template<size_t N>
+	constexpr auto XCOctetString(const unsigned char (&value)[N])
+	{
+		XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Literal, N + 5> result{};
+
+		result.Value[0] = 0x18;
+
+		size_t offset = constexpr_put_dword(result.Value, 1, (uint32_t)N);
+
+		for(size_t i = 0; i < N; i++)
+			result.Value[offset++] = value[i];
+
+		return result;
+	}
+	//****************************************************************************************
+	// Example: XCSid(5, { 32, 544 }) is the same as XSID(L"S-1-5-32-544")
+	template<size_t N>
+	constexpr auto XCSid(const uint64_t& authority, const uint32_t (&subAuthorities)[N])
+	{
+		static_assert((N > 0) && (N <= 15), "XCSid: invalid number of sub-authorities");
+
+		XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Sid, 13 + (N << 2)> result{};
+
+		result.Value[0] = 0x51;
+
+		size_t offset = constexpr_put_dword(result.Value, 1, (uint32_t)(8 + (N << 2)));
+
+		#pragma region Binary SID representation
+		result.Value[offset++] = 0x01; // Revision
+		result.Value[offset++] = (unsigned char)N;
+
+		for(size_t i = 0; i < 6; i++)
+			result.Value[offset++] = (unsigned char)((authority >> ((5 - i) << 3)) & 0xFF); // Big-endian
+
+		for(size_t i = 0; i < N; i++)
+			offset = constexpr_put_dword(result.Value, offset, subAuthorities[i]);
+		#pragma endregion
+
+		return result;
+	}
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE... Types, size_t... N>
+	constexpr auto XCComposite(const XCONDITIONAL_CONSTANT<Types, N>&... elements)
+	{
+		static_assert((is_constant_data<Types> && ...), "XCComposite: only literals, SIDs and composites allowed");
+
+		XCONDITIONAL_CONSTANT<XCONDITIONAL_CONSTANT_TYPE::Composite, 5 + (N + ... + 0)> result{};
+
+		result.Value[0] = 0x50;
+
+		size_t offset = constexpr_put_dword(result.Value, 1, (uint32_t)(N + ... + 0));
+		((offset = constexpr_copy(result.Value, offset, elements.Value)), ...);
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Compile-time operators
+	//****************************************************************************************
+	#define CONSTEXPR_URELATIONAL(name, code) template<XCONDITIONAL_CONSTANT_TYPE Type, size_t N>\
+	constexpr auto name(const XCONDITIONAL_CONSTANT<Type, N>& value)\
+	{\
+		static_assert((Type == XCONDITIONAL_CONSTANT_TYPE::Sid) || (Type == XCONDITIONAL_CONSTANT_TYPE::Composite), #name ": only SID or composite allowed");\
+		return constexpr_unary(value, (unsigned char)code);\
+	}
+	//****************************************************************************************
+	CONSTEXPR_URELATIONAL(XCMember_of, 0x89)
+	CONSTEXPR_URELATIONAL(XCDevice_Member_of, 0x8A)
+	CONSTEXPR_URELATIONAL(XCMember_of_Any, 0x8B)
+	CONSTEXPR_URELATIONAL(XCDevice_Member_of_Any, 0x8C)
+	CONSTEXPR_URELATIONAL(XCNot_Member_of, 0x90)
+	CONSTEXPR_URELATIONAL(XCNot_Device_Member_of, 0x91)
+	CONSTEXPR_URELATIONAL(XCNot_Member_of_Any, 0x92)
+	CONSTEXPR_URELATIONAL(XCNot_Device_Member_of_Any, 0x93)
+	//****************************************************************************************
+	#define CONSTEXPR_BRELATIONAL(name, code) template<XCONDITIONAL_CONSTANT_TYPE LType, size_t N, XCONDITIONAL_CONSTANT_TYPE RType, size_t M>\
+	constexpr auto name(const XCONDITIONAL_CONSTANT<LType, N>& lhs, const XCONDITIONAL_CONSTANT<RType, M>& rhs)\
+	{\
+		static_assert(LType == XCONDITIONAL_CONSTANT_TYPE::Attribute, #name ": only attributes allowed as LHS");\
+		static_assert(is_constant_rhs<RType>, #name ": invalid RHS");\
+		return constexpr_binary(lhs, rhs, (unsigned char)code);\
+	}
+	//****************************************************************************************
+	CONSTEXPR_BRELATIONAL(XCContains, 0x86)
+	CONSTEXPR_BRELATIONAL(XCAny_of, 0x88)
+	CONSTEXPR_BRELATIONAL(XCNot_Contains, 0x8E)
+	CONSTEXPR_BRELATIONAL(XCNot_Any_of, 0x8F)
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE Type, size_t N>
+	constexpr auto XCExists(const XCONDITIONAL_CONSTANT<Type, N>& value)
+	{
+		static_assert(Type == XCONDITIONAL_CONSTANT_TYPE::Attribute, "XCExists: only attributes allowed");
+		return constexpr_unary(value, (unsigned char)0x87);
+	}
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE Type, size_t N>
+	constexpr auto XCNot_Exists(const XCONDITIONAL_CONSTANT<Type, N>& value)
+	{
+		static_assert(Type == XCONDITIONAL_CONSTANT_TYPE::Attribute, "XCNot_Exists: only attributes allowed");
+		return constexpr_unary(value, (unsigned char)0x8D);
+	}
+	//****************************************************************************************
+	// Comparison operators are constrained (not static_assert'ed) in order to do not intervene with rewritten candidates from C++20
+	#define CONSTEXPR_COMPARISON(op, code, composite) template<XCONDITIONAL_CONSTANT_TYPE LType, size_t N, XCONDITIONAL_CONSTANT_TYPE RType, size_t M>\
+	requires (LType == XCONDITIONAL_CONSTANT_TYPE::Attribute) && is_constant_rhs<RType> && (composite || (RType != XCONDITIONAL_CONSTANT_TYPE::Composite))\
+	constexpr auto operator op(const XCONDITIONAL_CONSTANT<LType, N>& lhs, const XCONDITIONAL_CONSTANT<RType, M>& rhs)\
+	{\
+		return constexpr_binary(lhs, rhs, (unsigned char)code);\
+	}
+	//****************************************************************************************
+	CONSTEXPR_COMPARISON(==, 0x80, true)
+	CONSTEXPR_COMPARISON(!=, 0x81, true)
+	CONSTEXPR_COMPARISON(<, 0x82, false)
+	CONSTEXPR_COMPARISON(<=, 0x83, false)
+	CONSTEXPR_COMPARISON(>, 0x84, false)
+	CONSTEXPR_COMPARISON(>=, 0x85, false)
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE Type, size_t N>
+	requires is_constant_logical<Type>
+	constexpr auto operator!(const XCONDITIONAL_CONSTANT<Type, N>& value)
+	{
+		return constexpr_unary(value, (unsigned char)0xA2);
+	}
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE LType, size_t N, XCONDITIONAL_CONSTANT_TYPE RType, size_t M>
+	requires is_constant_logical<LType> && is_constant_logical<RType>
+	constexpr auto operator&&(const XCONDITIONAL_CONSTANT<LType, N>& lhs, const XCONDITIONAL_CONSTANT<RType, M>& rhs)
+	{
+		return constexpr_binary(lhs, rhs, (unsigned char)0xA0);
+	}
+	//****************************************************************************************
+	template<XCONDITIONAL_CONSTANT_TYPE LType, size_t N, XCONDITIONAL_CONSTANT_TYPE RType, size_t M>
+	requires is_constant_logical<LType> && is_constant_logical<RType>
+	constexpr auto operator||(const XCONDITIONAL_CONSTANT<LType, N>& lhs, const XCONDITIONAL_CONSTANT<RType, M>& rhs)
+	{
+		return constexpr_binary(lhs, rhs, (unsigned char)0xA1);
+	}
+	//****************************************************************************************
+	// Makes a final binary representation, byte-to-byte equal to "(bin_t)XCONDITIONAL_EXPRESSION"
+	template<XCONDITIONAL_CONSTANT_TYPE Type, size_t N>
+	constexpr std::array<unsigned char, N + 4> XCExpression(const XCONDITIONAL_CONSTANT<Type, N>& value)
+	{
+		static_assert(is_constant_logical<Type>, "XCExpression: only attributes or logical operators allowed on top level");
+
+		std::array<unsigned char, N + 4> result{ 0x61, 0x72, 0x74, 0x78 };
+		constexpr_copy(result, 4, value.Value);
+
+		return result;
+	}
+	//****************************************************************************************
+	#undef CONSTEXPR_URELATIONAL
+	#undef CONSTEXPR_BRELATIONAL
+	#undef CONSTEXPR_COMPARISON
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Encoding checks
+	//****************************************************************************************
+	static_assert(XCSigned8(-1).Value == std::array<unsigned char, 11>{ 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02, 0x02 });
+	static_assert(XCSigned64(0).Value == std::array<unsigned char, 11>{ 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x02 });
+	static_assert(XCUser(L"ab").Value == std::array<unsigned char, 9>{ 0xF9, 0x04, 0x00, 0x00, 0x00, 0x61, 0x00, 0x62, 0x00 });
+	static_assert(XCOctetString({ 0x01, 0x02 }).Value == std::array<unsigned char, 7>{ 0x18, 0x02, 0x00, 0x00, 0x00, 0x01, 0x02 });
+	static_assert(XCSid(5, { 32, 544 }).Value == std::array<unsigned char, 21>{
+		0x51, 0x10, 0x00, 0x00, 0x00,
+		0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x20, 0x00, 0x00, 0x00, 0x20, 0x02, 0x00, 0x00
+	});
+	static_assert(XCComposite(XCSigned8(1), XCUnicode(L"a")).Value == std::array<unsigned char, 23>{
+		0x50, 0x12, 0x00, 0x00, 0x00,
+		0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02,
+		0x10, 0x02, 0x00, 0x00, 0x00, 0x61, 0x00
+	});
+	static_assert(XCExpression(XCMember_of(XCSid(5, { 18 }))) == std::array<unsigned char, 22>{
+		0x61, 0x72, 0x74, 0x78,
+		0x51, 0x0C, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x12, 0x00, 0x00, 0x00,
+		0x89
+	});
+	static_assert(XCExpression(!(XCUser(L"a") == XCUnicode(L"b")) || XCExists(XCDevice(L"c"))) == std::array<unsigned char, 29>{
+		0x61, 0x72, 0x74, 0x78,
+		0xF9, 0x02, 0x00, 0x00, 0x00, 0x61, 0x00,
+		0x10, 0x02, 0x00, 0x00, 0x00, 0x62, 0x00,
+		0x80,
+		0xA2,
+		0xFB, 0x02, 0x00, 0x00, 0x00, 0x63, 0x00,
+		0x87,
+		0xA1
+	});
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
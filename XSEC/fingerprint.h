@@ -0,0 +1,456 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Authorization fingerprint of token
+	//****************************************************************************************
+	// MurmurHash3 (x64, 128 bits) of canonical encoding of all token parts used by access check:
+	//   - SIDs of enabled and deny-only groups (separately) of Groups, Capabilities and DeviceGroups;
+	//   - restricted SIDs and restricted device groups with "enabled" and "deny-only" attributes;
+	//   - LUIDs of privileges with "enabled" attribute;
+	//   - integrity level and mandatory policy;
+	//   - user and device claims and security attributes (folded names, type, flags and values);
+	//   - user SID with "deny-only" attribute (unless "withUser" is false).
+	// Disabled groups are not used by access check. Owner and primary group are not a part of
+	// fingerprint. User SID is matched by ACEs and "Member_of" like any group, so it is encoded
+	// by default. Without it tokens of different users with the same groups have the same
+	// fingerprint, which is valid ONLY for security descriptors without ACEs (and conditions)
+	// for user SIDs, e.g. DACLs granting access to groups only.
+	// All lists are sorted before encoding, so order of values in token does not matter.
+	struct XTOKEN_FINGERPRINT
+	{
+		XTOKEN_FINGERPRINT() = default;
+		~XTOKEN_FINGERPRINT() = default;
+
+		explicit XTOKEN_FINGERPRINT(const XTOKEN&, const bool& /*withUser*/ = true);
+
+		DWORD64 Low = 0;
+		DWORD64 High = 0;
+
+		auto operator<=>(const XTOKEN_FINGERPRINT&) const = default;
+
+		std::wstring Text() const; // 32 hexadecimal digits, high part first
+
+	private:
+		static void put(bin_t&, const DWORD&);
+		static void put(bin_t&, const DWORD64&);
+		static void put(bin_t&, std::span<const unsigned char>);
+		static void put(bin_t&, std::wstring_view);
+
+		static void hash(const bin_t&, DWORD64&, DWORD64&);
+	};
+	//****************************************************************************************
+	// Partition of a set of tokens into classes of the same fingerprint. Classes are numbered
+	// in order of first token of each class, members of each class are in order of tokens.
+	struct XTOKEN_CLASSES
+	{
+		XTOKEN_CLASSES() = delete;
+		~XTOKEN_CLASSES() = default;
+
+		XTOKEN_CLASSES(std::span<const XTOKEN>, const size_t& /*threads*/ = 0, const bool& /*withUser*/ = true); // See "XTOKEN_FINGERPRINT" for "withUser"
+
+		size_t size() const { return Fingerprints.size(); } // Number of classes
+
+		const DWORD& Class(const DWORD& /*token*/) const;
+		const DWORD& Representative(const DWORD& /*class*/) const; // First token of class
+		std::span<const DWORD> Members(const DWORD& /*class*/) const;
+
+		// Calls "function" once for representative of each class, result is per token
+		template<typename F>
+		auto Apply(std::span<const XTOKEN>, F&& /*function*/) const -> std::vector<decltype(function(std::declval<const XTOKEN&>()))>;
+
+		std::vector<XTOKEN_FINGERPRINT> Fingerprints; // For each class
+
+	private:
+		std::vector<DWORD> classes; // For each token
+		std::vector<DWORD> offsets; // Members of each class
+		std::vector<DWORD> members;
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Fingerprint
+	//****************************************************************************************
+	void XTOKEN_FINGERPRINT::put(bin_t& data, const DWORD& value)
+	{
+		for(int i = 0; i < 4; i++)
+			data.push_back((unsigned char)(value >> (8 * i)));
+	}
+	//****************************************************************************************
+	void XTOKEN_FINGERPRINT::put(bin_t& data, const DWORD64& value)
+	{
+		for(int i = 0; i < 8; i++)
+			data.push_back((unsigned char)(value >> (8 * i)));
+	}
+	//****************************************************************************************
+	void XTOKEN_FINGERPRINT::put(bin_t& data, std::span<const unsigned char> value)
+	{
+		put(data, (DWORD)value.size());
+		data.insert(data.end(), value.begin(), value.end());
+	}
+	//****************************************************************************************
+	void XTOKEN_FINGERPRINT::put(bin_t& data, std::wstring_view value)
+	{
+		put(data, (DWORD)value.size());
+
+		for(const wchar_t& element : value)
+		{
+			data.push_back((unsigned char)element);
+			data.push_back((unsigned char)(element >> 8));
+		}
+	}
+	//****************************************************************************************
+	// MurmurHash3_x64_128 with zero seed, "Low" is the first 64-bit word. Known answers:
+	//   ""                                            Low 0000000000000000 High 0000000000000000
+	//   "a"                                           Low 85555565F6597889 High E6B53A48510E895A
+	//   "abc"                                         Low B4963F3F3FAD7867 High 3BA2744126CA2D52
+	//   "The quick brown fox jumps over the lazy dog" Low E34BBC7BBC071B6C High 7A433CA9C49A9347
+	//   bytes 00 01 02 ... 20 (33 bytes)              Low 7D41281BFABA4612 High 55AC8073A7D6A30B
+	void XTOKEN_FINGERPRINT::hash(const bin_t& data, DWORD64& low, DWORD64& high)
+	{
+		const DWORD64 c1 = 0x87C37B91114253D5;
+		const DWORD64 c2 = 0x4CF5AD432745937F;
+
+		DWORD64 h1 = 0;
+		DWORD64 h2 = 0;
+
+		auto read = [&data](const size_t& offset, const size_t& size)
+		{
+			DWORD64 result = 0;
+
+			for(size_t i = 0; i < size; i++)
+				result |= (DWORD64)data[offset + i] << (8 * i);
+
+			return result;
+		};
+
+		auto mix = [](DWORD64 value)
+		{
+			value ^= value >> 33;
+			value *= 0xFF51AFD7ED558CCD;
+			value ^= value >> 33;
+			value *= 0xC4CEB9FE1A85EC53;
+			value ^= value >> 33;
+
+			return value;
+		};
+
+		#pragma region Blocks of 16 bytes
+		const size_t blocks = data.size() / 16;
+
+		for(size_t i = 0; i < blocks; i++)
+		{
+			DWORD64 k1 = read(i * 16, 8);
+			DWORD64 k2 = read(i * 16 + 8, 8);
+
+			k1 *= c1; k1 = std::rotl(k1, 31); k1 *= c2; h1 ^= k1;
+			h1 = std::rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52DCE729;
+
+			k2 *= c2; k2 = std::rotl(k2, 33); k2 *= c1; h2 ^= k2;
+			h2 = std::rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495AB5;
+		}
+		#pragma endregion
+
+		#pragma region Tail
+		const size_t tail = data.size() & 15;
+
+		if(tail > 8)
+		{
+			DWORD64 k2 = read(blocks * 16 + 8, tail - 8);
+			k2 *= c2; k2 = std::rotl(k2, 33); k2 *= c1; h2 ^= k2;
+		}
+
+		if(tail)
+		{
+			DWORD64 k1 = read(blocks * 16, std::min<size_t>(tail, 8));
+			k1 *= c1; k1 = std::rotl(k1, 31); k1 *= c2; h1 ^= k1;
+		}
+		#pragma endregion
+
+		h1 ^= (DWORD64)data.size();
+		h2 ^= (DWORD64)data.size();
+
+		h1 += h2;
+		h2 += h1;
+
+		h1 = mix(h1);
+		h2 = mix(h2);
+
+		h1 += h2;
+		h2 += h1;
+
+		low = h1;
+		high = h2;
+	}
+	//****************************************************************************************
+	XTOKEN_FINGERPRINT::XTOKEN_FINGERPRINT(const XTOKEN& token, const bool& withUser)
+	{
+		token.Require((withUser) ? XTOKEN::ClassFingerprint : (XTOKEN::ClassFingerprint & ~XTOKEN::Class(TokenUser)), "XTOKEN_FINGERPRINT");
+
+		bin_t data;
+		data.reserve(4096);
+
+		#pragma region User
+		// User's SID has no "SE_GROUP_ENABLED" bit, only "deny-only" flag matters for it
+		if(withUser && (nullptr != token.User))
+		{
+			put(data, (DWORD)0);
+			put(data, (bin_t)*token.User->Sid);
+			put(data, (DWORD)*token.User->Attributes & SE_GROUP_USE_FOR_DENY_ONLY);
+		}
+		#pragma endregion
+
+		#pragma region Groups
+		const DWORD used = SE_GROUP_ENABLED | SE_GROUP_USE_FOR_DENY_ONLY;
+
+		// Each list is encoded as a tag, number of values and values
+		auto groups = [&](const DWORD& tag, const std::vector<XSID_AND_ATTRIBUTES>& values, const bool& restricted)
+		{
+			std::vector<std::pair<bin_t, DWORD>> list;
+			list.reserve(values.size());
+
+			for(auto&& element : values)
+			{
+				DWORD attributes = (DWORD)*element.Attributes & used;
+
+				// Disabled groups are not used, except restricting SIDs (only "deny-only" is meaningful there)
+				if((0 == attributes) && (false == restricted))
+					continue;
+
+				list.emplace_back((bin_t)*element.Sid, attributes);
+			}
+
+			std::sort(list.begin(), list.end());
+			list.erase(std::unique(list.begin(), list.end()), list.end());
+
+			put(data, tag);
+			put(data, (DWORD)list.size());
+
+			for(auto&& [sid, attributes] : list)
+			{
+				put(data, sid);
+				put(data, attributes);
+			}
+		};
+
+		groups(1, token.Groups, false);
+		groups(2, token.RestrictedSids, true);
+		groups(3, token.Capabilities, false);
+		groups(4, token.DeviceGroups, false);
+		groups(5, token.RestrictedDeviceGroups, true);
+		#pragma endregion
+
+		#pragma region Privileges
+		std::vector<std::pair<DWORD64, DWORD>> privileges;
+		privileges.reserve(token.Privileges.size());
+
+		for(auto&& element : token.Privileges)
+		{
+			if((DWORD)*element.Attributes & SE_PRIVILEGE_REMOVED)
+				continue;
+
+			privileges.emplace_back(((DWORD64)(DWORD)element.Luid->HighPart << 32) | element.Luid->LowPart, (DWORD)*element.Attributes & SE_PRIVILEGE_ENABLED);
+		}
+
+		std::sort(privileges.begin(), privileges.end());
+
+		put(data, (DWORD)6);
+		put(data, (DWORD)privileges.size());
+
+		for(auto&& [luid, attributes] : privileges)
+		{
+			put(data, luid);
+			put(data, attributes);
+		}
+		#pragma endregion
+
+		#pragma region Integrity level and mandatory policy
+		put(data, (DWORD)7);
+		put(data, (nullptr == token.IntegrityLevel) ? bin_t{} : (bin_t)*token.IntegrityLevel->Sid);
+
+		put(data, (DWORD)8);
+		put(data, (DWORD)(nullptr != token.MandatoryPolicy));
+		put(data, (nullptr == token.MandatoryPolicy) ? (DWORD)0 : (DWORD)*token.MandatoryPolicy);
+		#pragma endregion
+
+		#pragma region Claims
+		const std::array<const std::shared_ptr<XSECURITY_ATTRIBUTES_INFORMATION>*, 3> information = { &token.UserClaimAttributes, &token.DeviceClaimAttributes, &token.SecurityAttributes };
+
+		for(DWORD i = 0; i < (DWORD)information.size(); i++)
+		{
+			std::vector<std::pair<std::wstring, const XSECURITY_ATTRIBUTE_V1*>> claims;
+
+			if(nullptr != *information[i])
+			{
+				for(auto&& element : (*information[i])->Attributes)
+					claims.emplace_back(fold_case(element->Name), element.get());
+			}
+
+			std::sort(claims.begin(), claims.end(), [](const auto& lhs, const auto& rhs){ return (lhs.first < rhs.first); });
+
+			put(data, 9 + i);
+			put(data, (DWORD)claims.size());
+
+			for(auto&& [name, claim] : claims)
+			{
+				const DWORD flags = (nullptr == claim->Flags) ? 0 : (DWORD)*claim->Flags;
+
+				put(data, name);
+				put(data, (DWORD)claim->ValueType);
+				put(data, flags);
+
+				#pragma region Values as normalized set (sorted and unique, folded if case-insensitive)
+				if(XCLAIMS_VALUE_KIND::Invalid == value_kind(claim->ValueType))
+				{
+					put(data, (DWORD)0); // Values of unsupported types are not compared by access check
+					continue;
+				}
+
+				std::shared_ptr<const XSECURITY_ATTRIBUTE_VALUE_SET> values = claim->GetValueSet();
+				if(nullptr == values)
+					values = std::make_shared<const XSECURITY_ATTRIBUTE_VALUE_SET>(claim->GetValues(), claim->ValueType, (0 != (flags & CLAIM_SECURITY_ATTRIBUTE_VALUE_CASE_SENSITIVE)));
+
+				put(data, (DWORD)values->size());
+
+				for(const LONG64& element : values->Integers)
+					put(data, (DWORD64)element);
+
+				for(auto&& element : values->Strings)
+					put(data, std::wstring_view(element));
+
+				for(auto&& element : values->Binaries)
+					put(data, std::span<const unsigned char>(element));
+				#pragma endregion
+			}
+		}
+		#pragma endregion
+
+		hash(data, Low, High);
+	}
+	//****************************************************************************************
+	std::wstring XTOKEN_FINGERPRINT::Text() const
+	{
+		std::wstringstream stream;
+		stream << std::hex << std::uppercase << std::setfill(L'0') << std::setw(16) << High << std::setw(16) << Low;
+
+		return stream.str();
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Equivalence classes
+	//****************************************************************************************
+	XTOKEN_CLASSES::XTOKEN_CLASSES(std::span<const XTOKEN> tokens, const size_t& threads, const bool& withUser)
+	{
+		std::vector<XTOKEN_FINGERPRINT> fingerprints(tokens.size());
+
+		#pragma region Fingerprints of all tokens in parallel
+		parallel(tokens.size(), threads, [&](const size_t& i)
+		{
+			fingerprints[i] = XTOKEN_FINGERPRINT(tokens[i], withUser);
+		});
+		#pragma endregion
+
+		#pragma region Classes in order of first token
+		std::map<XTOKEN_FINGERPRINT, DWORD> known;
+
+		classes.resize(tokens.size());
+
+		for(DWORD i = 0; i < (DWORD)tokens.size(); i++)
+		{
+			auto [position, inserted] = known.try_emplace(fingerprints[i], (DWORD)Fingerprints.size());
+			if(inserted)
+				Fingerprints.push_back(fingerprints[i]);
+
+			classes[i] = position->second;
+		}
+		#pragma endregion
+
+		#pragma region Members of each class
+		offsets.assign(Fingerprints.size() + 1, 0);
+
+		for(const DWORD& element : classes)
+			offsets[element + 1]++;
+
+		for(size_t i = 1; i < offsets.size(); i++)
+			offsets[i] += offsets[i - 1];
+
+		members.resize(tokens.size());
+
+		std::vector<DWORD> positions(offsets.begin(), offsets.end() - 1);
+
+		for(DWORD i = 0; i < (DWORD)tokens.size(); i++)
+			members[positions[classes[i]]++] = i;
+		#pragma endregion
+	}
+	//****************************************************************************************
+	const DWORD& XTOKEN_CLASSES::Class(const DWORD& token) const
+	{
+		if(token >= classes.size())
+			throw std::exception("XTOKEN_CLASSES: invalid token index");
+
+		return classes[token];
+	}
+	//****************************************************************************************
+	const DWORD& XTOKEN_CLASSES::Representative(const DWORD& value) const
+	{
+		if(value >= Fingerprints.size())
+			throw std::exception("XTOKEN_CLASSES: invalid class index");
+
+		return members[offsets[value]];
+	}
+	//****************************************************************************************
+	std::span<const DWORD> XTOKEN_CLASSES::Members(const DWORD& value) const
+	{
+		if(value >= Fingerprints.size())
+			throw std::exception("XTOKEN_CLASSES: invalid class index");
+
+		return std::span<const DWORD>(members.data() + offsets[value], offsets[value + 1] - offsets[value]);
+	}
+	//****************************************************************************************
+	template<typename F>
+	auto XTOKEN_CLASSES::Apply(std::span<const XTOKEN> tokens, F&& function) const -> std::vector<decltype(function(std::declval<const XTOKEN&>()))>
+	{
+		if(tokens.size() != classes.size())
+			throw std::exception("XTOKEN_CLASSES: tokens are not the same as used for classes");
+
+		std::vector<decltype(function(std::declval<const XTOKEN&>()))> values;
+		values.reserve(Fingerprints.size());
+
+		for(DWORD i = 0; i < (DWORD)Fingerprints.size(); i++)
+			values.push_back(function(tokens[Representative(i)]));
+
+		std::vector<decltype(function(std::declval<const XTOKEN&>()))> result;
+		result.reserve(tokens.size());
+
+		for(const DWORD& element : classes)
+			result.push_back(values[element]);
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
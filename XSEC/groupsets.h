@@ -0,0 +1,429 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Dictionary of group sets shared between many tokens
+	//****************************************************************************************
+	struct XGROUP_SETS_USAGE
+	{
+		DWORD64 Sets = 0;        // Distinct sets
+		DWORD64 Deltas = 0;      // Sets stored as a delta from a base set
+		DWORD64 References = 0;  // Calls of "Intern"
+		DWORD64 Groups = 0;      // Groups in all references
+		DWORD64 Entries = 0;     // Groups stored in dictionary
+		DWORD64 Sids = 0;        // Distinct SIDs
+		DWORD64 Bytes = 0;       // Size of dictionary
+		DWORD64 PlainBytes = 0;  // Size of all references with their own SIDs and attributes
+	};
+	//****************************************************************************************
+	// Each distinct sorted set of (SID, attributes) is stored once and referenced by identifier.
+	// A set could be stored as a delta from a base set, bases are always complete sets, so a set
+	// is reconstructed with a single merge.
+	struct XGROUP_SETS
+	{
+		XGROUP_SETS() = default;
+		~XGROUP_SETS() = default;
+
+		XGROUP_SETS(const std::wstring&); // Load a file made by "Save"
+
+		static constexpr DWORD NoBase = 0xFFFFFFFF;
+
+		DWORD Intern(const std::vector<XSID_AND_ATTRIBUTES>&, const DWORD& = NoBase); // Delta from base is used only if smaller than the whole set
+
+		std::vector<XSID_AND_ATTRIBUTES> Groups(const DWORD&) const;
+		bool Contains(const DWORD&, std::span<const unsigned char>, const DWORD& = SE_GROUP_ENABLED) const; // All bits from mask must be set
+
+		size_t size() const { return sets.size(); }
+
+		XGROUP_SETS_USAGE Usage() const;
+
+		void Save(const std::wstring&) const;
+
+	private:
+		#pragma region Internal types
+		struct entry_t
+		{
+			DWORD Sid; // Index in "sids"
+			DWORD Attributes;
+
+			auto operator<=>(const entry_t&) const = default;
+		};
+
+		struct set_t
+		{
+			DWORD Base;    // NoBase for complete sets
+			DWORD Added;   // For complete sets all entries are "added"
+			DWORD Removed;
+			DWORD Reserved;
+			DWORD64 Offset; // Added entries and then removed entries, both sorted
+			DWORD64 Hash;   // Hash of complete sorted set
+		};
+		#pragma endregion
+
+		std::vector<bin_t> sids;
+		std::map<bin_t, DWORD> sid_index;
+
+		std::vector<entry_t> entries;
+		std::vector<set_t> sets;
+
+		std::unordered_multimap<DWORD64, DWORD> index; // Sets by hash of complete sorted set
+
+		DWORD64 references = 0;
+		DWORD64 groups = 0;
+		DWORD64 plain = 0;
+
+		std::span<const entry_t> added(const set_t& set) const { return std::span<const entry_t>(entries).subspan((size_t)set.Offset, set.Added); }
+		std::span<const entry_t> removed(const set_t& set) const { return std::span<const entry_t>(entries).subspan((size_t)(set.Offset + set.Added), set.Removed); }
+
+		std::vector<entry_t> resolve(const DWORD&) const;
+		static DWORD64 hash(const std::vector<entry_t>&);
+	};
+	//****************************************************************************************
+	DWORD64 XGROUP_SETS::hash(const std::vector<entry_t>& value)
+	{
+		// FNV-1a over identifiers and attributes
+		DWORD64 result = 0xCBF29CE484222325;
+
+		for(auto&& element : value)
+		{
+			for(const DWORD& part : { element.Sid, element.Attributes })
+			{
+				result ^= part;
+				result *= 0x100000001B3;
+			}
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	std::vector<XGROUP_SETS::entry_t> XGROUP_SETS::resolve(const DWORD& id) const
+	{
+		if(id >= sets.size())
+			throw std::exception("XGROUP_SETS: unknown group set");
+
+		const set_t& set = sets[id];
+
+		if(NoBase == set.Base)
+		{
+			auto values = added(set);
+			return std::vector<entry_t>(values.begin(), values.end());
+		}
+
+		auto base = added(sets[set.Base]);
+		auto plus = added(set);
+		auto minus = removed(set);
+
+		std::vector<entry_t> kept;
+		kept.reserve(base.size());
+		std::set_difference(base.begin(), base.end(), minus.begin(), minus.end(), std::back_inserter(kept));
+
+		std::vector<entry_t> result;
+		result.reserve(kept.size() + plus.size());
+		std::merge(kept.begin(), kept.end(), plus.begin(), plus.end(), std::back_inserter(result));
+
+		return result;
+	}
+	//****************************************************************************************
+	DWORD XGROUP_SETS::Intern(const std::vector<XSID_AND_ATTRIBUTES>& value, const DWORD& _base)
+	{
+		#pragma region Canonical form of set
+		std::vector<entry_t> set;
+		set.reserve(value.size());
+
+		for(auto&& element : value)
+		{
+			bin_t sid = (bin_t)*element.Sid;
+
+			plain += sid.size() + sizeof(entry_t);
+
+			auto [position, inserted] = sid_index.emplace(sid, (DWORD)sids.size());
+			if(inserted)
+				sids.push_back(std::move(sid));
+
+			set.push_back({ position->second, (DWORD)*element.Attributes });
+		}
+
+		std::sort(set.begin(), set.end());
+		set.erase(std::unique(set.begin(), set.end()), set.end());
+
+		references++;
+		groups += value.size();
+		#pragma endregion
+
+		#pragma region Existing set
+		DWORD64 code = hash(set);
+
+		auto range = index.equal_range(code);
+		for(auto i = range.first; i != range.second; i++)
+		{
+			if(resolve(i->second) == set)
+				return i->second;
+		}
+		#pragma endregion
+
+		#pragma region New set
+		DWORD id = (DWORD)sets.size();
+		set_t result{ NoBase, (DWORD)set.size(), 0, 0, entries.size(), code };
+
+		DWORD base = _base;
+		if(NoBase != base)
+		{
+			if(base >= sets.size())
+				throw std::exception("XGROUP_SETS: unknown base group set");
+
+			if(NoBase != sets[base].Base)
+				base = sets[base].Base; // Bases are always complete sets
+		}
+
+		if(NoBase != base)
+		{
+			auto values = added(sets[base]);
+
+			std::vector<entry_t> plus;
+			std::set_difference(set.begin(), set.end(), values.begin(), values.end(), std::back_inserter(plus));
+
+			std::vector<entry_t> minus;
+			std::set_difference(values.begin(), values.end(), set.begin(), set.end(), std::back_inserter(minus));
+
+			if((plus.size() + minus.size()) < set.size())
+			{
+				result.Base = base;
+				result.Added = (DWORD)plus.size();
+				result.Removed = (DWORD)minus.size();
+
+				entries.insert(entries.end(), plus.begin(), plus.end());
+				entries.insert(entries.end(), minus.begin(), minus.end());
+			}
+		}
+
+		if(NoBase == result.Base)
+			entries.insert(entries.end(), set.begin(), set.end());
+
+		sets.push_back(result);
+		index.emplace(code, id);
+		#pragma endregion
+
+		return id;
+	}
+	//****************************************************************************************
+	std::vector<XSID_AND_ATTRIBUTES> XGROUP_SETS::Groups(const DWORD& id) const
+	{
+		std::vector<XSID_AND_ATTRIBUTES> result;
+
+		for(auto&& element : resolve(id))
+			result.emplace_back(SID_AND_ATTRIBUTES{ (PSID)sids[element.Sid].data(), element.Attributes });
+
+		return result;
+	}
+	//****************************************************************************************
+	bool XGROUP_SETS::Contains(const DWORD& id, std::span<const unsigned char> sid, const DWORD& mask) const
+	{
+		if(id >= sets.size())
+			throw std::exception("XGROUP_SETS: unknown group set");
+
+		auto position = sid_index.find(bin_t(sid.begin(), sid.end()));
+		if(position == sid_index.end())
+			return false;
+
+		auto matches = [index = position->second, mask](std::span<const entry_t> values, std::span<const entry_t> excluded)
+		{
+			auto first = std::lower_bound(values.begin(), values.end(), entry_t{ index, 0 });
+
+			for(auto i = first; (i != values.end()) && (i->Sid == index); i++)
+			{
+				if((mask == (i->Attributes & mask)) && (false == std::binary_search(excluded.begin(), excluded.end(), *i)))
+					return true;
+			}
+
+			return false;
+		};
+
+		const set_t& set = sets[id];
+
+		if(matches(added(set), {}))
+			return true;
+
+		if(NoBase != set.Base)
+			return matches(added(sets[set.Base]), removed(set));
+
+		return false;
+	}
+	//****************************************************************************************
+	XGROUP_SETS_USAGE XGROUP_SETS::Usage() const
+	{
+		XGROUP_SETS_USAGE result;
+
+		result.Sets = sets.size();
+		result.Deltas = std::count_if(sets.begin(), sets.end(), [](const set_t& set){ return (NoBase != set.Base); });
+		result.References = references;
+		result.Groups = groups;
+		result.Entries = entries.size();
+		result.Sids = sids.size();
+		result.PlainBytes = plain;
+
+		result.Bytes = entries.size() * sizeof(entry_t) + sets.size() * sizeof(set_t) + (sids.size() + 1) * sizeof(DWORD);
+		for(auto&& element : sids)
+			result.Bytes += element.size();
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Persistence
+	//****************************************************************************************
+	// File layout (little-endian, each block is padded to 8 bytes):
+	//   DWORD "XGSD", DWORD version, DWORD64 SIDs, entries, sets, references, groups, plain bytes;
+	//   DWORD offsets[SIDs + 1], all SIDs; entries (DWORD SID, DWORD attributes); sets.
+	constexpr DWORD XGROUP_SETS_MAGIC = 0x44534758; // "XGSD"
+	constexpr DWORD XGROUP_SETS_VERSION = 1;
+	//****************************************************************************************
+	void XGROUP_SETS::Save(const std::wstring& path) const
+	{
+		static const char padding[8] = {};
+
+		std::ofstream stream(path, std::ios_base::binary | std::ios_base::trunc);
+		if(false == stream.is_open())
+			throw std::exception("XGROUP_SETS: cannot open file for writing");
+
+		auto block = [&stream](const void* data, const size_t& size)
+		{
+			stream.write((const char*)data, size);
+			stream.write(padding, (8 - (size & 7)) & 7);
+		};
+
+		DWORD header[2] = { XGROUP_SETS_MAGIC, XGROUP_SETS_VERSION };
+		block(header, sizeof(header));
+
+		DWORD64 counts[6] = { sids.size(), entries.size(), sets.size(), references, groups, plain };
+		block(counts, sizeof(counts));
+
+		std::vector<DWORD> offsets{ 0 };
+		bin_t data;
+
+		for(auto&& element : sids)
+		{
+			data.insert(data.end(), element.begin(), element.end());
+			offsets.push_back((DWORD)data.size());
+		}
+
+		block(offsets.data(), offsets.size() * sizeof(DWORD));
+		block(data.data(), data.size());
+		block(entries.data(), entries.size() * sizeof(entry_t));
+		block(sets.data(), sets.size() * sizeof(set_t));
+
+		stream.flush();
+		if(stream.fail())
+			throw std::exception("XGROUP_SETS: cannot write to file");
+	}
+	//****************************************************************************************
+	XGROUP_SETS::XGROUP_SETS(const std::wstring& path)
+	{
+		XMAPPED_FILE file(path);
+		size_t position = 0;
+
+		auto take = [&file, &position](const size_t& size)
+		{
+			if(size > (file.Data.size() - position))
+				throw std::exception("XGROUP_SETS: invalid file format");
+
+			auto result = file.Data.subspan(position, size);
+			position = std::min(file.Data.size(), position + ((size + 7) & ~(size_t)7));
+
+			return result;
+		};
+
+		#pragma region Header
+		DWORD header[2] = {};
+		memcpy(header, take(sizeof(header)).data(), sizeof(header));
+
+		if((XGROUP_SETS_MAGIC != header[0]) || (XGROUP_SETS_VERSION != header[1]))
+			throw std::exception("XGROUP_SETS: invalid file format");
+
+		DWORD64 counts[6] = {};
+		memcpy(counts, take(sizeof(counts)).data(), sizeof(counts));
+
+		for(size_t i = 0; i < 3; i++)
+		{
+			if(counts[i] >= (file.Data.size() / sizeof(DWORD)))
+				throw std::exception("XGROUP_SETS: invalid file format");
+		}
+
+		references = counts[3];
+		groups = counts[4];
+		plain = counts[5];
+		#pragma endregion
+
+		#pragma region SIDs
+		std::vector<DWORD> offsets((size_t)counts[0] + 1);
+		memcpy(offsets.data(), take(offsets.size() * sizeof(DWORD)).data(), offsets.size() * sizeof(DWORD));
+
+		if(0 != offsets[0])
+			throw std::exception("XGROUP_SETS: invalid file format");
+
+		auto data = take(offsets.back());
+
+		for(size_t i = 1; i < offsets.size(); i++)
+		{
+			if((offsets[i] < offsets[i - 1]) || (offsets[i] > data.size()))
+				throw std::exception("XGROUP_SETS: invalid file format");
+
+			bin_t& sid = sids.emplace_back(data.begin() + offsets[i - 1], data.begin() + offsets[i]);
+			if(false == sid_index.emplace(sid, (DWORD)(i - 1)).second)
+				throw std::exception("XGROUP_SETS: invalid file format");
+		}
+		#pragma endregion
+
+		#pragma region Entries and sets
+		entries.resize((size_t)counts[1]);
+		memcpy(entries.data(), take(entries.size() * sizeof(entry_t)).data(), entries.size() * sizeof(entry_t));
+
+		sets.resize((size_t)counts[2]);
+		memcpy(sets.data(), take(sets.size() * sizeof(set_t)).data(), sets.size() * sizeof(set_t));
+
+		for(auto&& element : entries)
+		{
+			if(element.Sid >= sids.size())
+				throw std::exception("XGROUP_SETS: invalid file format");
+		}
+
+		for(DWORD i = 0; i < (DWORD)sets.size(); i++)
+		{
+			const set_t& set = sets[i];
+
+			if((set.Offset > entries.size()) || (((DWORD64)set.Added + set.Removed) > (entries.size() - set.Offset)))
+				throw std::exception("XGROUP_SETS: invalid file format");
+
+			if((NoBase != set.Base) && ((set.Base >= i) || (NoBase != sets[set.Base].Base)))
+				throw std::exception("XGROUP_SETS: invalid file format");
+
+			index.emplace(set.Hash, i);
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -25,7 +25,9 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
 #include <array>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <span>
 #include <optional>
 #include <memory>
 #include <bitset>
@@ -35,9 +37,21 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <iomanip>
 #include <stack>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <deque>
+#include <shared_mutex>
 #include <algorithm>
 #include <regex>
 #include <fstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <bit>
+#include <charconv>
+#include <filesystem>
+
+#include <immintrin.h>
 
 #include <windows.h>
 #include <winnt.h>
@@ -46,12 +60,34 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #import <msxml6.dll>
 
 #include "./common.h"
+#include "./sorted.h"
+#include "./intern.h"
+#include "./compare.h"
+#include "./token_info.h"
+#include "./xml_stream.h"
+#include "./xml.h"
 #include "./bitset.h"
 #include "./sid.h"
 #include "./auxl.h"
 #include "./claims.h"
+#include "./pac_format.h"
+#include "./pac.h"
 #include "./expression.h"
+#include "./expression_ct.h"
 #include "./ace.h"
 #include "./acl.h"
 #include "./sd.h"
-#include "./token.h"
\ No newline at end of file
+#include "./token.h"
+#include "./evaluation.h"
+#include "./batch.h"
+#include "./warehouse.h"
+#include "./transformation.h"
+#include "./groupsets.h"
+#include "./snapshot_format.h"
+#include "./snapshot.h"
+#include "./diff.h"
+#include "./directory.h"
+#include "./membership.h"
+#include "./fingerprint.h"
+#include "./loader.h"
+#include "./access.h"
\ No newline at end of file
@@ -0,0 +1,104 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+
+#pragma once
+//********************************************************************************************
+// Shared immutable copies of tables, one copy for each distinct content. XBITSET keeps its bit
+// meanings this way instead of a private copy of all strings in each instance. Only the standard
+// library is used, so the same code is measured on any platform (bench/claim_memory_bench.cpp).
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Interned tables
+	//****************************************************************************************
+	// Cheap hash for tables of meanings: sizes and edge characters of all strings. Equal tables
+	// have equal hashes, collisions are resolved by comparison of the whole content.
+	template<typename C, size_t S>
+	size_t meaning_hash(const std::array<std::array<std::basic_string<C>, 2>, S>& table)
+	{
+		size_t result = S;
+
+		for(auto&& pair : table)
+		{
+			for(auto&& element : pair)
+			{
+				result = (result * 31) + element.size();
+
+				if(element.size())
+					result = (result * 31) + (size_t)element.front() + ((size_t)element.back() << 16);
+			}
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	// Returns the shared copy of a table equal to "value", the copy is made on first request.
+	// Tables live till the end of the program, there are only a few distinct ones.
+	template<typename T>
+	std::shared_ptr<const T> intern(const T& value, const size_t& hash)
+	{
+		static std::unordered_multimap<size_t, std::shared_ptr<const T>> cache;
+		static std::shared_mutex mutex;
+
+		auto find = [&]() -> std::shared_ptr<const T>
+		{
+			auto [begin, end] = cache.equal_range(hash);
+
+			for(; begin != end; begin++)
+			{
+				if(*begin->second == value)
+					return begin->second;
+			}
+
+			return nullptr;
+		};
+
+		{
+			std::shared_lock lock(mutex);
+
+			if(auto result = find())
+				return result;
+		}
+
+		std::unique_lock lock(mutex);
+
+		// Other thread could add the same table after the shared lock was released
+		if(auto result = find())
+			return result;
+
+		auto result = std::make_shared<const T>(value);
+		cache.emplace(hash, result);
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
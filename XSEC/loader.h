@@ -0,0 +1,143 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Bulk loading of saved tokens
+	//****************************************************************************************
+	// Tokens saved by "XSave" (files "<user>_token.xml" made by s4uwhoami) are mapped into memory
+	// and read by XXML_READER on a pool of threads, without MSXML. By default only classes from
+	// "XTOKEN::ClassXml" are read. Order of tokens is the same as order of files.
+	struct XTOKEN_CORPUS
+	{
+		XTOKEN_CORPUS() = default;
+		~XTOKEN_CORPUS() = default;
+
+		XTOKEN_CORPUS(std::span<const std::wstring>, const size_t& /*threads*/ = 0, const DWORD64& /*Classes*/ = XTOKEN::ClassXml);
+
+		static std::vector<std::wstring> Files(const std::wstring& /*directory*/, std::wstring_view /*suffix*/ = L"_token.xml"); // Sorted paths
+		static XTOKEN Parse(std::span<const unsigned char>, const DWORD64& /*Classes*/ = XTOKEN::ClassXml); // One saved token
+
+		void Load(std::span<const std::wstring>, const size_t& /*threads*/ = 0, const DWORD64& /*Classes*/ = XTOKEN::ClassXml); // Append tokens from files
+
+		// Save each token (with all classes) as a binary snapshot, "snapshots" has a path for each input file
+		static void Convert(std::span<const std::wstring> /*files*/, std::span<const std::wstring> /*snapshots*/, XGROUP_SETS* = nullptr, const size_t& /*threads*/ = 0);
+
+		std::vector<std::wstring> Paths;
+		std::vector<XTOKEN> Tokens;
+
+		DWORD64 Bytes = 0; // Size of all loaded files
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Loading
+	//****************************************************************************************
+	std::vector<std::wstring> XTOKEN_CORPUS::Files(const std::wstring& directory, std::wstring_view suffix)
+	{
+		std::vector<std::wstring> result;
+
+		for(auto&& element : std::filesystem::directory_iterator(directory))
+		{
+			if(false == element.is_regular_file())
+				continue;
+
+			std::wstring path = element.path().wstring();
+			if(path.ends_with(suffix))
+				result.push_back(std::move(path));
+		}
+
+		std::sort(result.begin(), result.end());
+
+		return result;
+	}
+	//****************************************************************************************
+	XTOKEN XTOKEN_CORPUS::Parse(std::span<const unsigned char> data, const DWORD64& classes)
+	{
+		XXML_READER xml(data);
+		xml.Root();
+
+		return XTOKEN(xml, classes);
+	}
+	//****************************************************************************************
+	XTOKEN_CORPUS::XTOKEN_CORPUS(std::span<const std::wstring> files, const size_t& threads, const DWORD64& classes)
+	{
+		Load(files, threads, classes);
+	}
+	//****************************************************************************************
+	void XTOKEN_CORPUS::Load(std::span<const std::wstring> files, const size_t& threads, const DWORD64& classes)
+	{
+		std::vector<std::optional<XTOKEN>> tokens(files.size());
+		std::atomic<DWORD64> bytes = 0;
+
+		parallel(files.size(), threads, [&](const size_t& i)
+		{
+			XMAPPED_FILE file(files[i]);
+
+			tokens[i].emplace(Parse(file.Data, classes));
+			bytes += file.Data.size();
+		});
+
+		Tokens.reserve(Tokens.size() + tokens.size());
+
+		for(size_t i = 0; i < files.size(); i++)
+		{
+			Paths.push_back(files[i]);
+			Tokens.push_back(std::move(tokens[i].value()));
+		}
+
+		Bytes += bytes;
+	}
+	//****************************************************************************************
+	void XTOKEN_CORPUS::Convert(std::span<const std::wstring> files, std::span<const std::wstring> snapshots, XGROUP_SETS* groupSets, const size_t& threads)
+	{
+		if(files.size() != snapshots.size())
+			throw std::exception("XTOKEN_CORPUS: number of snapshots must be the same as number of files");
+
+		std::mutex lock; // Dictionary of group sets is not thread-safe
+
+		parallel(files.size(), threads, [&](const size_t& i)
+		{
+			bin_t data;
+
+			{
+				XMAPPED_FILE file(files[i]);
+				XTOKEN token = Parse(file.Data, XTOKEN::ClassAll); // Snapshot has all classes
+
+				if(nullptr == groupSets)
+					data = XTOKEN_SNAPSHOT::Make(token);
+				else
+				{
+					std::scoped_lock guard(lock);
+					data = XTOKEN_SNAPSHOT::Make(token, groupSets);
+				}
+			}
+
+			XTOKEN_SNAPSHOT_WRITER::Save(data, snapshots[i]);
+		});
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
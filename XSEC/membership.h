@@ -0,0 +1,421 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Incremental token groups on membership changes
+	//****************************************************************************************
+	struct XMEMBERSHIP_CHANGE
+	{
+		DWORD Principal = 0;
+
+		std::vector<DWORD> Added;   // Sorted identifiers of groups
+		std::vector<DWORD> Removed;
+
+		std::vector<XTOKEN_DIFF_ENTRY> Entries; // Same changes as groups of token, including sIDHistory
+	};
+	//****************************************************************************************
+	// Groups of tracked principals, kept current while memberships change. For each group the
+	// sorted list of tracked principals having it in their groups ("dependents") is kept, so a
+	// change of membership of "member" touches only principals which are "member" itself or
+	// depend on it:
+	//   - adding an edge only adds groups reachable from the new group, merged into each set;
+	//   - removing an edge can lose any group above it, so only affected principals are expanded again.
+	// Resource domain of each principal is its own domain, same as for XDIRECTORY::Expand on a span.
+	// Set of nodes is fixed by the directory, only edges between existing nodes could be changed.
+	struct XMEMBERSHIP
+	{
+		XMEMBERSHIP() = delete;
+		~XMEMBERSHIP() = default;
+
+		// Directory must outlive the object. Empty span means "all principals which are not groups".
+		XMEMBERSHIP(const XDIRECTORY&, std::span<const DWORD> /*principals*/ = {}, const size_t& /*threads*/ = 0);
+
+		std::vector<XMEMBERSHIP_CHANGE> AddMember(const DWORD& /*group*/, const DWORD& /*member*/);
+		std::vector<XMEMBERSHIP_CHANGE> RemoveMember(const DWORD& /*group*/, const DWORD& /*member*/);
+
+		const std::vector<DWORD>& Groups(const DWORD& /*principal*/) const; // Same as XDIRECTORY::Expand for current edges
+		const std::vector<DWORD>& Dependents(const DWORD& /*group*/) const;  // Tracked principals having the group
+
+		bool Tracked(const DWORD& principal) const { return ((principal < slots.size()) && (XMEMBERSHIP_NOT_TRACKED != slots[principal])); }
+
+	private:
+		static constexpr DWORD XMEMBERSHIP_NOT_TRACKED = 0xFFFFFFFF;
+
+		const XDIRECTORY& directory;
+
+		std::vector<std::vector<DWORD>> parents;    // Sorted groups of each node, initially from directory
+		std::vector<std::vector<DWORD>> dependents; // Sorted tracked principals of each group
+
+		std::vector<DWORD> slots; // Index in "principals" and "closures" for each node
+		std::vector<DWORD> principals;
+		std::vector<std::vector<DWORD>> closures;
+
+		XDIRECTORY::visited_t visited; // Shared by all searches, cleared after each one
+
+		bool applicable(const DWORD& /*group*/, const DWORD& /*domain*/) const;
+		void up(const DWORD& /*group*/, const DWORD& /*domain*/, std::vector<DWORD>&);
+		void expand(const DWORD& /*principal*/, std::vector<DWORD>&);
+		std::vector<DWORD> affected(const DWORD& /*member*/) const;
+
+		void entries(const DWORD& /*group*/, const XTOKEN_DIFF_KIND&, std::vector<XTOKEN_DIFF_ENTRY>&) const;
+		void depend(std::map<DWORD, std::vector<DWORD>>&, const bool& /*add*/);
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Initialization and queries
+	//****************************************************************************************
+	XMEMBERSHIP::XMEMBERSHIP(const XDIRECTORY& value, std::span<const DWORD> tracked, const size_t& threads) : directory(value)
+	{
+		if(false == directory.built)
+			throw std::exception("XMEMBERSHIP: call 'XDIRECTORY::Build' first");
+
+		const size_t size = directory.nodes.size();
+
+		#pragma region Mutable copy of adjacency lists (already sorted and unique)
+		parents.resize(size);
+		visited.Bits.assign((size + 63) / 64, 0);
+
+		for(size_t i = 0; i < size; i++)
+			parents[i].assign(directory.parents.begin() + directory.parent_offsets[i], directory.parents.begin() + directory.parent_offsets[i + 1]);
+		#pragma endregion
+
+		#pragma region Tracked principals
+		if(tracked.empty())
+		{
+			for(DWORD i = 0; i < (DWORD)size; i++)
+			{
+				if(false == directory.nodes[i].Group)
+					principals.push_back(i);
+			}
+		}
+		else
+		{
+			principals.assign(tracked.begin(), tracked.end());
+
+			std::sort(principals.begin(), principals.end());
+			principals.erase(std::unique(principals.begin(), principals.end()), principals.end());
+		}
+
+		slots.assign(size, XMEMBERSHIP_NOT_TRACKED);
+
+		for(DWORD i = 0; i < (DWORD)principals.size(); i++)
+		{
+			if(principals[i] >= size)
+				throw std::exception("XMEMBERSHIP: unknown principal");
+
+			slots[principals[i]] = i;
+		}
+		#pragma endregion
+
+		#pragma region Initial closures and reverse index
+		closures = directory.Expand(principals, threads);
+
+		dependents.resize(size);
+
+		// Principals are sorted, so all lists of dependents are sorted as well
+		for(size_t i = 0; i < principals.size(); i++)
+		{
+			for(const DWORD& group : closures[i])
+				dependents[group].push_back(principals[i]);
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	const std::vector<DWORD>& XMEMBERSHIP::Groups(const DWORD& principal) const
+	{
+		if(false == Tracked(principal))
+			throw std::exception("XMEMBERSHIP: principal is not tracked");
+
+		return closures[slots[principal]];
+	}
+	//****************************************************************************************
+	const std::vector<DWORD>& XMEMBERSHIP::Dependents(const DWORD& group) const
+	{
+		if(group >= dependents.size())
+			throw std::exception("XMEMBERSHIP: unknown group");
+
+		return dependents[group];
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Internal functions
+	//****************************************************************************************
+	bool XMEMBERSHIP::applicable(const DWORD& group, const DWORD& domain) const
+	{
+		const XDIRECTORY::node_t& node = directory.nodes[group];
+
+		// Same rule as in XDIRECTORY::expand
+		return ((0 == (node.GroupType & XDIRECTORY_GROUP_TYPE_DOMAIN_LOCAL)) || (node.Domain == domain));
+	}
+	//****************************************************************************************
+	void XMEMBERSHIP::up(const DWORD& group, const DWORD& domain, std::vector<DWORD>& result)
+	{
+		// Sorted set of "group" and all groups above it, applicable in "domain"
+		result.clear();
+
+		if(false == applicable(group, domain))
+			return;
+
+		std::vector<DWORD> stack{ group };
+		visited.Visit(group);
+
+		while(stack.size())
+		{
+			DWORD node = stack.back();
+			stack.pop_back();
+
+			result.push_back(node);
+
+			for(const DWORD& element : parents[node])
+			{
+				if(applicable(element, domain) && visited.Visit(element))
+					stack.push_back(element);
+			}
+		}
+
+		std::sort(result.begin(), result.end());
+		visited.Clear();
+	}
+	//****************************************************************************************
+	void XMEMBERSHIP::expand(const DWORD& principal, std::vector<DWORD>& result)
+	{
+		const DWORD domain = directory.nodes[principal].Domain;
+
+		result.clear();
+
+		std::vector<DWORD> stack{ principal };
+		visited.Visit(principal);
+
+		while(stack.size())
+		{
+			DWORD node = stack.back();
+			stack.pop_back();
+
+			for(const DWORD& element : parents[node])
+			{
+				if(applicable(element, domain) && visited.Visit(element))
+				{
+					stack.push_back(element);
+					result.push_back(element);
+				}
+			}
+		}
+
+		std::sort(result.begin(), result.end());
+		visited.Clear();
+	}
+	//****************************************************************************************
+	std::vector<DWORD> XMEMBERSHIP::affected(const DWORD& member) const
+	{
+		// Principals reaching "member": itself and all principals having it as a group
+		std::vector<DWORD> result = dependents[member];
+
+		if(Tracked(member))
+			result.insert(std::upper_bound(result.begin(), result.end(), member), member);
+
+		return result;
+	}
+	//****************************************************************************************
+	void XMEMBERSHIP::entries(const DWORD& group, const XTOKEN_DIFF_KIND& kind, std::vector<XTOKEN_DIFF_ENTRY>& result) const
+	{
+		DWORD attributes = SE_GROUP_MANDATORY | SE_GROUP_ENABLED_BY_DEFAULT | SE_GROUP_ENABLED;
+		if(directory.nodes[group].GroupType & XDIRECTORY_GROUP_TYPE_DOMAIN_LOCAL)
+			attributes |= SE_GROUP_RESOURCE;
+
+		auto add = [&](const bin_t& sid)
+		{
+			XTOKEN_DIFF_ENTRY entry;
+
+			entry.Area = XTOKEN_DIFF_AREA::Groups;
+			entry.Kind = kind;
+			entry.Sid = sid;
+
+			if(XTOKEN_DIFF_KIND::Added == kind)
+				entry.NewAttributes = attributes;
+			else
+				entry.OldAttributes = attributes;
+
+			result.push_back(std::move(entry));
+		};
+
+		add(directory.nodes[group].Sid);
+
+		for(DWORD i = directory.history_offsets[group]; i < directory.history_offsets[group + 1]; i++)
+			add(directory.histories[i]);
+	}
+	//****************************************************************************************
+	void XMEMBERSHIP::depend(std::map<DWORD, std::vector<DWORD>>& changes, const bool& add)
+	{
+		// Principals for each group are collected in ascending order, one merge per group
+		for(auto&& [group, values] : changes)
+		{
+			std::vector<DWORD>& list = dependents[group];
+			std::vector<DWORD> merged;
+			merged.reserve(add ? (list.size() + values.size()) : list.size());
+
+			if(add)
+				std::set_union(list.begin(), list.end(), values.begin(), values.end(), std::back_inserter(merged));
+			else
+				std::set_difference(list.begin(), list.end(), values.begin(), values.end(), std::back_inserter(merged));
+
+			list.swap(merged);
+		}
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Changes of membership
+	//****************************************************************************************
+	std::vector<XMEMBERSHIP_CHANGE> XMEMBERSHIP::AddMember(const DWORD& group, const DWORD& member)
+	{
+		#pragma region Additional check
+		if((group >= parents.size()) || (member >= parents.size()))
+			throw std::exception("XMEMBERSHIP: unknown principal");
+
+		if(false == directory.nodes[group].Group)
+			throw std::exception("XMEMBERSHIP: only groups could have members");
+		#pragma endregion
+
+		std::vector<XMEMBERSHIP_CHANGE> result;
+
+		#pragma region Add edge
+		std::vector<DWORD>& list = parents[member];
+
+		auto position = std::lower_bound(list.begin(), list.end(), group);
+		if((position != list.end()) && (*position == group))
+			return result;
+
+		list.insert(position, group);
+		#pragma endregion
+
+		#pragma region New groups are reachable only through the new edge
+		std::map<DWORD, std::vector<DWORD>> above; // Groups above the new edge for each domain
+		std::map<DWORD, std::vector<DWORD>> changes;
+
+		for(const DWORD& principal : affected(member))
+		{
+			const DWORD domain = directory.nodes[principal].Domain;
+
+			auto cache = above.find(domain);
+			if(cache == above.end())
+			{
+				cache = above.emplace(domain, std::vector<DWORD>{}).first;
+				up(group, domain, cache->second);
+			}
+
+			std::vector<DWORD>& closure = closures[slots[principal]];
+
+			XMEMBERSHIP_CHANGE change{ principal };
+			std::set_difference(cache->second.begin(), cache->second.end(), closure.begin(), closure.end(), std::back_inserter(change.Added));
+
+			// Tracked group in a cycle is not a group of itself
+			if(auto self = std::lower_bound(change.Added.begin(), change.Added.end(), principal); (self != change.Added.end()) && (*self == principal))
+				change.Added.erase(self);
+
+			if(change.Added.empty())
+				continue;
+
+			std::vector<DWORD> merged;
+			merged.reserve(closure.size() + change.Added.size());
+
+			std::merge(closure.begin(), closure.end(), change.Added.begin(), change.Added.end(), std::back_inserter(merged));
+			closure.swap(merged);
+
+			for(const DWORD& element : change.Added)
+			{
+				changes[element].push_back(principal);
+				entries(element, XTOKEN_DIFF_KIND::Added, change.Entries);
+			}
+
+			result.push_back(std::move(change));
+		}
+
+		depend(changes, true);
+		#pragma endregion
+
+		return result;
+	}
+	//****************************************************************************************
+	std::vector<XMEMBERSHIP_CHANGE> XMEMBERSHIP::RemoveMember(const DWORD& group, const DWORD& member)
+	{
+		#pragma region Additional check
+		if((group >= parents.size()) || (member >= parents.size()))
+			throw std::exception("XMEMBERSHIP: unknown principal");
+		#pragma endregion
+
+		std::vector<XMEMBERSHIP_CHANGE> result;
+
+		#pragma region Remove edge
+		std::vector<DWORD>& list = parents[member];
+
+		auto position = std::lower_bound(list.begin(), list.end(), group);
+		if((position == list.end()) || (*position != group))
+			return result;
+
+		list.erase(position);
+		#pragma endregion
+
+		#pragma region Expand again only principals which had the group
+		std::map<DWORD, std::vector<DWORD>> changes;
+		std::vector<DWORD> closure;
+
+		for(const DWORD& principal : affected(member))
+		{
+			std::vector<DWORD>& previous = closures[slots[principal]];
+
+			// The removed edge was not used if group was not reached (or not applicable)
+			if(false == std::binary_search(previous.begin(), previous.end(), group))
+				continue;
+
+			expand(principal, closure);
+
+			XMEMBERSHIP_CHANGE change{ principal };
+			std::set_difference(previous.begin(), previous.end(), closure.begin(), closure.end(), std::back_inserter(change.Removed));
+
+			if(change.Removed.empty())
+				continue;
+
+			previous.swap(closure);
+
+			for(const DWORD& element : change.Removed)
+			{
+				changes[element].push_back(principal);
+				entries(element, XTOKEN_DIFF_KIND::Removed, change.Entries);
+			}
+
+			result.push_back(std::move(change));
+		}
+
+		depend(changes, false);
+		#pragma endregion
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
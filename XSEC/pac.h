@@ -0,0 +1,91 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Claims from PAC_CLIENT_CLAIMS_INFO and PAC_DEVICE_CLAIMS_INFO buffers ([MS-PAC] 2.11, [MS-ADTS] 2.2.18)
+	//****************************************************************************************
+	struct XPAC_CLAIMS
+	{
+		XPAC_CLAIMS() = delete;
+		~XPAC_CLAIMS() = default;
+
+		XPAC_CLAIMS(std::span<const unsigned char>); // Whole content of the PAC buffer (serialized CLAIMS_SET_METADATA)
+
+		explicit operator XSECURITY_ATTRIBUTES_INFORMATION() const;
+
+		WORD CompressionFormat = COMPRESSION_FORMAT_NONE;
+		DWORD UncompressedSize = 0;
+
+		std::vector<XSECURITY_ATTRIBUTE_V1> Claims;
+		std::vector<WORD> Sources; // CLAIMS_SOURCE_TYPE for each claim: 1 - AD, 2 - certificate
+	};
+	//****************************************************************************************
+	XPAC_CLAIMS::XPAC_CLAIMS(std::span<const unsigned char> value)
+	{
+		XPAC_CLAIMS_SET set(value);
+
+		CompressionFormat = set.CompressionFormat;
+		UncompressedSize = set.UncompressedSize;
+
+		for(auto&& element : set.Claims)
+		{
+			DWORD flags = 0;
+			XSECURITY_ATTRIBUTE_V1 claim(std::wstring(element.Name.begin(), element.Name.end()), element.Type, XBITSET<32>((BYTE*)&flags, SecurityAttributeV1Meaning), {});
+
+			switch(element.Type)
+			{
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+					for(auto&& value : element.Integers)
+						claim.ChangeValues().Push((LONG64)value);
+
+					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+					for(auto&& value : element.Integers)
+						claim.ChangeValues().Push((DWORD64)value);
+
+					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+					for(auto&& value : element.Strings)
+						claim.ChangeValues().Push(std::wstring(value.begin(), value.end()));
+
+					break;
+				default:
+					break;
+			}
+
+			Claims.push_back(claim);
+			Sources.push_back(element.Source);
+		}
+	}
+	//****************************************************************************************
+	XPAC_CLAIMS::operator XSECURITY_ATTRIBUTES_INFORMATION() const
+	{
+		return XSECURITY_ATTRIBUTES_INFORMATION(Claims);
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
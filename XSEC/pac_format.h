@@ -0,0 +1,508 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+
+#pragma once
+//********************************************************************************************
+// Decoding of claims from PAC buffers: XPRESS Huffman decompression, NDR type serialization
+// and CLAIMS_SET_METADATA / CLAIMS_SET. Only the standard library is used, so the decoder is
+// checked on any platform (bench/pac_claims_check.cpp). "XPAC_CLAIMS" (pac.h) is the Windows
+// adapter making XSECURITY_ATTRIBUTE_V1 from decoded claims.
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region XPRESS Huffman decompression ([MS-XCA] 2.2.4)
+	//****************************************************************************************
+	std::vector<unsigned char> xpress_huffman_decompress(std::span<const unsigned char> input, const size_t& size)
+	{
+		#pragma region Initial variables
+		std::vector<unsigned char> result(size);
+		size_t out = 0;
+
+		size_t position = 0;
+
+		// Each entry has symbol in lower 9 bits and length of its code in higher bits, 0 for unused codes
+		std::vector<uint16_t> table(1 << 15);
+
+		// Final bits of the stream could be read past the end of input, they are always zero
+		auto read16 = [&](const size_t& offset) -> uint32_t
+		{
+			uint32_t value = 0;
+
+			if(offset < input.size())
+				value = input[offset];
+
+			if((offset + 1) < input.size())
+				value |= ((uint32_t)input[offset + 1] << 8);
+
+			return value;
+		};
+		#pragma endregion
+
+		while(out < size)
+		{
+			#pragma region Decoding table for the block (512 code lengths, 4 bits each)
+			if((position + 256) > input.size())
+				throw std::runtime_error("xpress_huffman_decompress: unexpected end of data");
+
+			std::fill(table.begin(), table.end(), (uint16_t)0);
+
+			size_t code = 0;
+
+			for(uint16_t length = 1; length < 16; length++)
+			{
+				for(uint16_t symbol = 0; symbol < 512; symbol++)
+				{
+					unsigned char value = input[position + (symbol >> 1)];
+					if(length != ((symbol & 1) ? (value >> 4) : (value & 0x0F)))
+						continue;
+
+					size_t count = (size_t)1 << (15 - length);
+					if((code + count) > table.size())
+						throw std::runtime_error("xpress_huffman_decompress: invalid Huffman table");
+
+					std::fill_n(table.begin() + code, count, (uint16_t)((length << 9) | symbol));
+					code += count;
+				}
+			}
+
+			if(0 == code)
+				throw std::runtime_error("xpress_huffman_decompress: invalid Huffman table");
+			#pragma endregion
+
+			#pragma region Initial state of the bit stream
+			size_t current = position + 256;
+
+			uint32_t bits = (read16(current) << 16) | read16(current + 2);
+			current += 4;
+
+			int extra = 16;
+
+			auto consume = [&](const unsigned char& count)
+			{
+				bits <<= count;
+				extra -= count;
+
+				if(extra < 0)
+				{
+					bits |= (read16(current) << (-extra));
+					current += 2;
+					extra += 16;
+				}
+			};
+			#pragma endregion
+
+			#pragma region Decode one block of 65536 bytes
+			size_t end = std::min(out + 65536, size);
+
+			while(out < end)
+			{
+				uint16_t entry = table[bits >> 17];
+
+				unsigned char length = (unsigned char)(entry >> 9);
+				if(0 == length)
+					throw std::runtime_error("xpress_huffman_decompress: invalid Huffman code");
+
+				consume(length);
+
+				uint16_t symbol = entry & 0x1FF;
+
+				#pragma region Literal
+				if(symbol < 256)
+				{
+					result[out++] = (unsigned char)symbol;
+					continue;
+				}
+				#pragma endregion
+
+				#pragma region Match
+				symbol -= 256;
+
+				size_t match_length = symbol & 0x0F;
+				unsigned char offset_length = (unsigned char)(symbol >> 4);
+
+				if(15 == match_length)
+				{
+					if(current >= input.size())
+						throw std::runtime_error("xpress_huffman_decompress: unexpected end of data");
+
+					match_length = input[current++];
+
+					if(255 == match_length)
+					{
+						if((current + 2) > input.size())
+							throw std::runtime_error("xpress_huffman_decompress: unexpected end of data");
+
+						match_length = read16(current);
+						current += 2;
+
+						if(0 == match_length)
+						{
+							if((current + 4) > input.size())
+								throw std::runtime_error("xpress_huffman_decompress: unexpected end of data");
+
+							match_length = read16(current) | (read16(current + 2) << 16);
+							current += 4;
+						}
+
+						if(match_length < 15)
+							throw std::runtime_error("xpress_huffman_decompress: invalid match length");
+
+						match_length -= 15;
+					}
+
+					match_length += 15;
+				}
+
+				match_length += 3;
+
+				size_t match_offset = (offset_length) ? (bits >> (32 - offset_length)) : 0;
+				match_offset += ((size_t)1 << offset_length);
+
+				consume(offset_length);
+
+				if(match_offset > out)
+					throw std::runtime_error("xpress_huffman_decompress: invalid match offset");
+
+				// Matches could overlap with the output, so bytes are copied one by one
+				match_length = std::min(match_length, size - out);
+
+				for(size_t i = 0; i < match_length; i++, out++)
+					result[out] = result[out - match_offset];
+				#pragma endregion
+			}
+			#pragma endregion
+
+			position = current;
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Reader for NDR type serialization version 1 ([MS-RPCE] 2.2.6)
+	//****************************************************************************************
+	struct XNDR_READER
+	{
+		XNDR_READER() = delete;
+		~XNDR_READER() = default;
+
+		XNDR_READER(std::span<const unsigned char>); // Data with "Common Type Header" and "Private Header"
+
+		void Align(const size_t&);
+
+		template<typename T>
+		T Read();
+
+		std::u16string ReadString(); // Conformant varying string, "[string] wchar_t*"
+		uint32_t ReadCount(const uint32_t&); // Maximum count of a conformant array, must be equal to the size from the structure
+
+		size_t Position = 0;
+
+	private:
+		std::span<const unsigned char> data;
+	};
+	//****************************************************************************************
+	XNDR_READER::XNDR_READER(std::span<const unsigned char> value)
+	{
+		#pragma region Common Type Header
+		if(value.size() < 16)
+			throw std::runtime_error("XNDR_READER: unexpected end of data");
+
+		if((0x01 != value[0]) || (0x10 != value[1]) || (0x08 != value[2]) || (0x00 != value[3]))
+			throw std::runtime_error("XNDR_READER: only version 1 of little-endian type serialization is supported");
+		#pragma endregion
+
+		#pragma region Private Header
+		uint32_t length = 0;
+		memcpy(&length, value.data() + 8, sizeof(uint32_t));
+
+		if(length > (value.size() - 16))
+			throw std::runtime_error("XNDR_READER: unexpected end of data");
+
+		data = value.subspan(16, length);
+		#pragma endregion
+	}
+	//****************************************************************************************
+	void XNDR_READER::Align(const size_t& alignment)
+	{
+		Position = (Position + alignment - 1) & ~(alignment - 1);
+	}
+	//****************************************************************************************
+	template<typename T>
+	T XNDR_READER::Read()
+	{
+		Align(sizeof(T));
+
+		if((Position + sizeof(T)) > data.size())
+			throw std::runtime_error("XNDR_READER: unexpected end of data");
+
+		T result{};
+		memcpy(&result, data.data() + Position, sizeof(T));
+
+		Position += sizeof(T);
+
+		return result;
+	}
+	//****************************************************************************************
+	uint32_t XNDR_READER::ReadCount(const uint32_t& expected)
+	{
+		uint32_t result = Read<uint32_t>();
+		if(result != expected)
+			throw std::runtime_error("XNDR_READER: size of conformant array does not match");
+
+		return result;
+	}
+	//****************************************************************************************
+	std::u16string XNDR_READER::ReadString()
+	{
+		uint32_t maximum = Read<uint32_t>();
+		uint32_t offset = Read<uint32_t>();
+		uint32_t actual = Read<uint32_t>();
+
+		if((0 != offset) || (actual > maximum) || (actual > ((data.size() - Position) / sizeof(char16_t))))
+			throw std::runtime_error("XNDR_READER: invalid conformant varying string");
+
+		std::u16string result(actual, u'\0');
+		memcpy(result.data(), data.data() + Position, actual * sizeof(char16_t));
+		Position += actual * sizeof(char16_t);
+
+		// Terminating zero is a part of the transmitted string
+		if(result.size() && (u'\0' == result.back()))
+			result.pop_back();
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Claims from PAC_CLIENT_CLAIMS_INFO and PAC_DEVICE_CLAIMS_INFO buffers ([MS-PAC] 2.11, [MS-ADTS] 2.2.18)
+	//****************************************************************************************
+	constexpr uint16_t XPAC_COMPRESSION_NONE = 0x0000; // COMPRESSION_FORMAT_NONE
+	constexpr uint16_t XPAC_COMPRESSION_XPRESS_HUFF = 0x0004; // COMPRESSION_FORMAT_XPRESS_HUFF
+
+	constexpr uint16_t XPAC_CLAIM_TYPE_INT64 = 1; // CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64
+	constexpr uint16_t XPAC_CLAIM_TYPE_UINT64 = 2;
+	constexpr uint16_t XPAC_CLAIM_TYPE_STRING = 3;
+	constexpr uint16_t XPAC_CLAIM_TYPE_BOOLEAN = 6;
+	//****************************************************************************************
+	struct XPAC_CLAIM
+	{
+		uint16_t Source = 0; // CLAIMS_SOURCE_TYPE: 1 - AD, 2 - certificate
+		std::u16string Name;
+		uint16_t Type = 0;
+
+		std::vector<uint64_t> Integers; // INT64, UINT64 and BOOLEAN values as transmitted
+		std::vector<std::u16string> Strings;
+	};
+	//****************************************************************************************
+	struct XPAC_CLAIMS_SET
+	{
+		XPAC_CLAIMS_SET() = delete;
+		~XPAC_CLAIMS_SET() = default;
+
+		XPAC_CLAIMS_SET(std::span<const unsigned char>); // Whole content of the PAC buffer (serialized CLAIMS_SET_METADATA)
+
+		uint16_t CompressionFormat = XPAC_COMPRESSION_NONE;
+		uint32_t UncompressedSize = 0;
+
+		std::vector<XPAC_CLAIM> Claims;
+
+	private:
+		void ReadClaimsSet(std::span<const unsigned char>);
+	};
+	//****************************************************************************************
+	XPAC_CLAIMS_SET::XPAC_CLAIMS_SET(std::span<const unsigned char> value)
+	{
+		XNDR_READER reader(value);
+
+		#pragma region Top-level pointer
+		if(0 == reader.Read<uint32_t>())
+			return;
+		#pragma endregion
+
+		#pragma region CLAIMS_SET_METADATA
+		uint32_t size = reader.Read<uint32_t>();
+		uint32_t pointer = reader.Read<uint32_t>();
+
+		CompressionFormat = reader.Read<uint16_t>();
+		UncompressedSize = reader.Read<uint32_t>();
+
+		reader.Read<uint16_t>(); // usReservedType
+		reader.Read<uint32_t>(); // ulReservedFieldSize
+		reader.Read<uint32_t>(); // ReservedField
+		#pragma endregion
+
+		#pragma region ClaimsSet
+		if(0 == pointer)
+			return;
+
+		reader.ReadCount(size);
+
+		if(size > (value.size() - 16 - reader.Position))
+			throw std::runtime_error("XPAC_CLAIMS: unexpected end of data");
+
+		std::span<const unsigned char> data = value.subspan(16 + reader.Position, size);
+
+		switch(CompressionFormat)
+		{
+			case XPAC_COMPRESSION_NONE:
+				ReadClaimsSet(data);
+				break;
+			case XPAC_COMPRESSION_XPRESS_HUFF:
+				ReadClaimsSet(xpress_huffman_decompress(data, UncompressedSize));
+				break;
+			default:
+				throw std::runtime_error("XPAC_CLAIMS: unsupported compression format");
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	void XPAC_CLAIMS_SET::ReadClaimsSet(std::span<const unsigned char> value)
+	{
+		XNDR_READER reader(value);
+
+		#pragma region Top-level pointer
+		if(0 == reader.Read<uint32_t>())
+			return;
+		#pragma endregion
+
+		#pragma region CLAIMS_SET
+		uint32_t count = reader.Read<uint32_t>();
+		uint32_t pointer = reader.Read<uint32_t>();
+
+		reader.Read<uint16_t>(); // usReservedType
+		reader.Read<uint32_t>(); // ulReservedFieldSize
+		reader.Read<uint32_t>(); // ReservedField
+
+		if(0 == pointer)
+			return;
+		#pragma endregion
+
+		#pragma region Scalar parts of all CLAIMS_ARRAY
+		struct array_t
+		{
+			uint16_t Source = 0;
+			uint32_t Count = 0;
+			uint32_t Pointer = 0;
+		};
+
+		std::vector<array_t> arrays(reader.ReadCount(count));
+
+		for(auto&& element : arrays)
+		{
+			element.Source = reader.Read<uint16_t>();
+			element.Count = reader.Read<uint32_t>();
+			element.Pointer = reader.Read<uint32_t>();
+		}
+		#pragma endregion
+
+		#pragma region Claims for each CLAIMS_ARRAY
+		struct entry_t
+		{
+			uint32_t Id = 0;
+			uint16_t Type = 0;
+			uint32_t Count = 0;
+			uint32_t Pointer = 0;
+		};
+
+		for(auto&& element : arrays)
+		{
+			if(0 == element.Pointer)
+				continue;
+
+			#pragma region Scalar parts of all CLAIM_ENTRY
+			std::vector<entry_t> entries(reader.ReadCount(element.Count));
+
+			for(auto&& entry : entries)
+			{
+				entry.Id = reader.Read<uint32_t>();
+				entry.Type = reader.Read<uint16_t>();
+
+				// Non-encapsulated union: discriminant is aligned as the whole union
+				reader.Align(4);
+				if(entry.Type != reader.Read<uint16_t>())
+					throw std::runtime_error("XPAC_CLAIMS: invalid discriminant for claim values");
+
+				entry.Count = reader.Read<uint32_t>();
+				entry.Pointer = reader.Read<uint32_t>();
+			}
+			#pragma endregion
+
+			#pragma region Name and values for each CLAIM_ENTRY
+			for(auto&& entry : entries)
+			{
+				XPAC_CLAIM& claim = Claims.emplace_back();
+
+				claim.Source = element.Source;
+				claim.Type = entry.Type;
+
+				if(entry.Id)
+					claim.Name = reader.ReadString();
+
+				if(0 == entry.Pointer)
+					continue;
+
+				uint32_t values = reader.ReadCount(entry.Count);
+
+				switch(entry.Type)
+				{
+					case XPAC_CLAIM_TYPE_INT64:
+					case XPAC_CLAIM_TYPE_UINT64:
+					case XPAC_CLAIM_TYPE_BOOLEAN:
+						for(uint32_t i = 0; i < values; i++)
+							claim.Integers.push_back(reader.Read<uint64_t>());
+
+						break;
+					case XPAC_CLAIM_TYPE_STRING:
+						{
+							std::vector<uint32_t> pointers(values);
+
+							for(auto&& element : pointers)
+								element = reader.Read<uint32_t>();
+
+							for(auto&& element : pointers)
+								claim.Strings.push_back((element) ? reader.ReadString() : std::u16string{});
+						}
+
+						break;
+					default:
+						throw std::runtime_error("XPAC_CLAIMS: invalid claim type");
+				}
+			}
+			#pragma endregion
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -46,9 +46,11 @@ namespace XSEC
 		XSD(const unsigned char*, const dword_meaning_t&);
 		XSD(const bin_t&, const dword_meaning_t&);
 		XSD(const msxml_et&, const dword_meaning_t&);
+		XSD(XXML_READER&, const dword_meaning_t&);
 
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		void AppendSID(const XSID&, const DWORD&, const bool = false);
 
@@ -615,6 +617,41 @@ namespace XSEC
 		#pragma endregion
 	}
 	//********************************************************************************************
+	XSD::XSD(XXML_READER& xml, const dword_meaning_t& meaning) : Meaning(meaning)
+	{
+		bool revision = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+
+			if("Revision" == name)
+			{
+				Revision = xml.Number<unsigned char>();
+				revision = true;
+			}
+			else if("Control" == name)
+				Control = std::make_shared<XBITSET<16>>(xml, WordBitsMeaningSdControl);
+			else if("Owner" == name)
+				Owner = std::make_shared<XSID>(xml);
+			else if("Group" == name)
+				Group = std::make_shared<XSID>(xml);
+			else if("Sacl" == name)
+				Sacl = std::make_shared<XACL>(xml, Meaning);
+			else if("Dacl" == name)
+				Dacl = std::make_shared<XACL>(xml, Meaning);
+		}
+
+		#pragma region Additional check
+		if(false == revision)
+			throw std::exception("XSD: cannot find 'Revision' XML node");
+
+		if(nullptr == Control)
+			throw std::exception("XSD: cannot find 'Control' XML node");
+		#pragma endregion
+	}
+	//********************************************************************************************
 	XSD::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -670,6 +707,31 @@ namespace XSEC
 		};
 	}
 	//********************************************************************************************
+	void XSD::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if(nullptr == Control)
+			throw std::exception("XSD: initialize data first");
+
+		xml.Start(root.value_or("SecurityDescriptor"));
+
+		xml.Element("Revision", Revision);
+		Control->Write(xml, "Control");
+
+		if(nullptr != Owner)
+			Owner->Write(xml, "Owner");
+
+		if(nullptr != Group)
+			Group->Write(xml, "Group");
+
+		if(nullptr != Sacl)
+			Sacl->Write(xml, "Sacl");
+
+		if(nullptr != Dacl)
+			Dacl->Write(xml, "Dacl");
+
+		xml.End();
+	}
+	//********************************************************************************************
 	void XSD::AppendSID(const XSID& sid, const DWORD& access, const bool denied)
 	{
 		#pragma region Create new DACL if needed
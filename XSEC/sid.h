@@ -36,9 +36,11 @@ namespace XSEC
 		XSID(const unsigned char*);
 		XSID(const bin_t&);
 		XSID(const msxml_et&);
+		XSID(XXML_READER&);
 
 		explicit operator bin_t() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		static XSID ConstructForCurrentDomain(const DWORD&);
 		static XSID ConstructForName(const std::wstring_view);
@@ -60,6 +62,7 @@ namespace XSEC
 		static const XSID PlaceholderCreatorGroup;
 		static const XSID PlaceholderOwnerServer;
 		static const XSID PlaceholderGroupServer;
+		static const XSID OwnerRights;
 
 		static const XSID LocalSystem;
 
@@ -101,6 +104,7 @@ namespace XSEC
 	const XSID XSID::PlaceholderCreatorGroup = L"S-1-3-1";
 	const XSID XSID::PlaceholderOwnerServer = L"S-1-3-2";
 	const XSID XSID::PlaceholderGroupServer = L"S-1-3-3";
+	const XSID XSID::OwnerRights = L"S-1-3-4";
 
 	const XSID XSID::LocalSystem = L"S-1-5-18";
 
@@ -381,6 +385,35 @@ namespace XSEC
 		#pragma endregion
 	}
 	//********************************************************************************************
+	XSID::XSID(XXML_READER& xml)
+	{
+		bool revision = false;
+		bool identifierAuthority = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("Revision" == xml.Name())
+			{
+				Revision = xml.Number<BYTE>();
+				revision = true;
+			}
+			else if("IdentifierAuthority" == xml.Name())
+			{
+				IdentifierAuthority = xml.Number<DWORD>();
+				identifierAuthority = true;
+			}
+			else if("SubAuthority" == xml.Name())
+				SubAuthority.push_back(xml.Number<DWORD>());
+		}
+
+		if(false == revision)
+			throw std::exception("XSID: cannot find 'Revision' in XML");
+
+		if(false == identifierAuthority)
+			throw std::exception("XSID: cannot find 'IdentifierAuthority' in XML");
+	}
+	//********************************************************************************************
 	XSID::operator xml_t() const
 	{
 		return [&](msxml_dt xml, std::optional<const wchar_t*> root) -> msxml_et
@@ -438,6 +471,22 @@ namespace XSEC
 		};
 	}
 	//********************************************************************************************
+	void XSID::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		xml.Start(root.value_or("SID"));
+
+		xml.Attribute("CommonName", commonName());
+		xml.Attribute("StringRepresentation", stringRepresentation());
+
+		xml.Element("Revision", Revision);
+		xml.Element("IdentifierAuthority", IdentifierAuthority);
+
+		for(auto&& element : SubAuthority)
+			xml.Element("SubAuthority", element);
+
+		xml.End();
+	}
+	//********************************************************************************************
 	std::wstring XSID::commonName() const
 	{
 		#pragma region Initial variables
@@ -0,0 +1,402 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Binary snapshot of XTOKEN
+	//****************************************************************************************
+	// Layout, reading and writing of snapshots are in "snapshot_format.h" and do not depend on Windows.
+	// This adapter only converts between XTOKEN and the layout, "Token" makes a complete XTOKEN from snapshot.
+	// Saved tokens do not have "AccessInformation" and "GroupsAndPrivileges": both are combinations of stored values.
+	struct XTOKEN_SNAPSHOT : public XTOKEN_SNAPSHOT_READER
+	{
+		XTOKEN_SNAPSHOT() = delete;
+		~XTOKEN_SNAPSHOT() = default;
+
+		XTOKEN_SNAPSHOT(std::span<const unsigned char>); // Data must be 8-byte aligned and must outlive the object
+		XTOKEN_SNAPSHOT(const std::wstring&); // Map a file made by "Save"
+		XTOKEN_SNAPSHOT(const XTOKEN_SNAPSHOT_READER&);
+
+		// With a dictionary "Groups" are interned and referenced by identifier of group set
+		static bin_t Make(const XTOKEN&, XGROUP_SETS* = nullptr, const DWORD& /*base set*/ = XGROUP_SETS::NoBase);
+		static void Save(const XTOKEN&, const std::wstring&, XGROUP_SETS* = nullptr, const DWORD& /*base set*/ = XGROUP_SETS::NoBase);
+
+		std::vector<XSECURITY_ATTRIBUTE_V1_READER> Claims(const XTOKEN_SNAPSHOT_SECTION& = XTOKEN_SNAPSHOT_SECTION::UserClaims) const;
+		std::optional<XTOKEN_SNAPSHOT> LinkedToken() const;
+
+		XTOKEN Token(const XGROUP_SETS* = nullptr) const; // Dictionary is required for snapshots referencing group sets
+	};
+	//****************************************************************************************
+	XTOKEN_SNAPSHOT::XTOKEN_SNAPSHOT(std::span<const unsigned char> data) : XTOKEN_SNAPSHOT_READER(data)
+	{
+	}
+	//****************************************************************************************
+	XTOKEN_SNAPSHOT::XTOKEN_SNAPSHOT(const std::wstring& path) : XTOKEN_SNAPSHOT_READER(std::filesystem::path(path))
+	{
+	}
+	//****************************************************************************************
+	XTOKEN_SNAPSHOT::XTOKEN_SNAPSHOT(const XTOKEN_SNAPSHOT_READER& value) : XTOKEN_SNAPSHOT_READER(value)
+	{
+	}
+	//****************************************************************************************
+	std::vector<XSECURITY_ATTRIBUTE_V1_READER> XTOKEN_SNAPSHOT::Claims(const XTOKEN_SNAPSHOT_SECTION& id) const
+	{
+		std::vector<XSECURITY_ATTRIBUTE_V1_READER> result;
+
+		for(auto&& element : Blobs(id))
+			result.emplace_back(element);
+
+		return result;
+	}
+	//****************************************************************************************
+	std::optional<XTOKEN_SNAPSHOT> XTOKEN_SNAPSHOT::LinkedToken() const
+	{
+		std::optional<XTOKEN_SNAPSHOT_READER> linked = XTOKEN_SNAPSHOT_READER::LinkedToken();
+		if(false == linked.has_value())
+			return std::nullopt;
+
+		return XTOKEN_SNAPSHOT(linked.value());
+	}
+	//****************************************************************************************
+	bin_t XTOKEN_SNAPSHOT::Make(const XTOKEN& token, XGROUP_SETS* groupSets, const DWORD& base)
+	{
+		token.Require(XTOKEN::ClassAll, "XTOKEN_SNAPSHOT"); // Loaded snapshots claim all classes
+
+		#pragma region Table of SIDs
+		std::set<bin_t> table;
+
+		auto collect = [&table](const std::shared_ptr<XSID>& sid)
+		{
+			if(nullptr != sid)
+				table.insert((bin_t)*sid);
+		};
+
+		auto collect_list = [&collect](const std::vector<XSID_AND_ATTRIBUTES>& list)
+		{
+			for(auto&& element : list)
+				collect(element.Sid);
+		};
+
+		if(nullptr != token.User)
+			collect(token.User->Sid);
+		if(nullptr != token.IntegrityLevel)
+			collect(token.IntegrityLevel->Sid);
+
+		collect(token.Owner);
+		collect(token.PrimaryGroup);
+		collect(token.AppContainerSid);
+
+		if(nullptr == groupSets)
+			collect_list(token.Groups);
+
+		for(auto&& element : { &token.RestrictedSids, &token.LogonSid, &token.Capabilities, &token.DeviceGroups, &token.RestrictedDeviceGroups })
+			collect_list(*element);
+
+		XTOKEN_SNAPSHOT_WRITER writer(table);
+
+		auto id = [&writer](const std::shared_ptr<XSID>& sid){ return (nullptr == sid) ? XTOKEN_SNAPSHOT_NO_SID : writer.Sid((bin_t)*sid); };
+		#pragma endregion
+
+		#pragma region Scalars
+		{
+			XTOKEN_SNAPSHOT_SCALARS scalars{};
+
+			scalars.User = (nullptr == token.User) ? XTOKEN_SNAPSHOT_NO_SID : id(token.User->Sid);
+			scalars.UserAttributes = (nullptr == token.User) ? 0 : (DWORD)*token.User->Attributes;
+			scalars.Owner = id(token.Owner);
+			scalars.PrimaryGroup = id(token.PrimaryGroup);
+			scalars.IntegrityLevel = (nullptr == token.IntegrityLevel) ? XTOKEN_SNAPSHOT_NO_SID : id(token.IntegrityLevel->Sid);
+			scalars.IntegrityLevelAttributes = (nullptr == token.IntegrityLevel) ? 0 : (DWORD)*token.IntegrityLevel->Attributes;
+			scalars.AppContainerSid = id(token.AppContainerSid);
+
+			scalars.Type = (DWORD)token.Type;
+			scalars.ImpersonationLevel = (DWORD)token.ImpersonationLevel;
+			scalars.SessionId = token.SessionId;
+			scalars.Elevation = token.Elevation;
+			scalars.HasRestrictions = token.HasRestrictions;
+			scalars.ElevationType = (DWORD)token.ElevationType;
+			scalars.UIAccess = token.UIAccess;
+			scalars.AppContainerNumber = token.AppContainerNumber;
+			scalars.IsAppContainer = token.IsAppContainer;
+			scalars.SandBoxInert = token.SandBoxInert;
+			scalars.VirtualizationAllowed = token.VirtualizationAllowed;
+			scalars.VirtualizationEnabled = token.VirtualizationEnabled;
+
+			if(token.IsLinkedToken)
+				scalars.Present |= PresentIsLinkedToken;
+
+			if(nullptr != token.MandatoryPolicy)
+			{
+				scalars.Present |= PresentMandatoryPolicy;
+				scalars.MandatoryPolicy = (DWORD)*token.MandatoryPolicy;
+			}
+
+			if(nullptr != token.Origin)
+			{
+				scalars.Present |= PresentOrigin;
+				scalars.OriginLowPart = token.Origin->LowPart;
+				scalars.OriginHighPart = token.Origin->HighPart;
+			}
+
+			if(nullptr != token.Source)
+			{
+				scalars.Present |= PresentSource;
+				memcpy(scalars.SourceName, token.Source->SourceName.data(), std::min(token.Source->SourceName.size(), sizeof(scalars.SourceName)));
+
+				if(nullptr != token.Source->Luid)
+				{
+					scalars.SourceLowPart = token.Source->Luid->LowPart;
+					scalars.SourceHighPart = token.Source->Luid->HighPart;
+				}
+			}
+
+			if(nullptr != token.Statistics)
+			{
+				const XTOKEN_STATISTICS& statistics = *token.Statistics;
+
+				scalars.Present |= PresentStatistics;
+
+				if(nullptr != statistics.TokenId)
+				{
+					scalars.TokenIdLowPart = statistics.TokenId->LowPart;
+					scalars.TokenIdHighPart = statistics.TokenId->HighPart;
+				}
+
+				if(nullptr != statistics.AuthenticationId)
+				{
+					scalars.AuthenticationIdLowPart = statistics.AuthenticationId->LowPart;
+					scalars.AuthenticationIdHighPart = statistics.AuthenticationId->HighPart;
+				}
+
+				if(nullptr != statistics.ModifiedId)
+				{
+					scalars.ModifiedIdLowPart = statistics.ModifiedId->LowPart;
+					scalars.ModifiedIdHighPart = statistics.ModifiedId->HighPart;
+				}
+
+				scalars.DynamicCharged = statistics.DynamicCharged;
+				scalars.DynamicAvailable = statistics.DynamicAvailable;
+				scalars.GroupCount = statistics.GroupCount;
+				scalars.PrivilegeCount = statistics.PrivilegeCount;
+				scalars.ExpirationTime = statistics.ExpirationTime;
+			}
+
+			writer.Scalars(scalars);
+		}
+		#pragma endregion
+
+		#pragma region Lists of groups
+		auto groups = [&](const XTOKEN_SNAPSHOT_SECTION& section, const std::vector<XSID_AND_ATTRIBUTES>& list)
+		{
+			std::vector<XTOKEN_SNAPSHOT_GROUP> records;
+			for(auto&& element : list)
+				records.push_back(XTOKEN_SNAPSHOT_GROUP{ id(element.Sid), (DWORD)*element.Attributes });
+
+			writer.Groups(section, records);
+		};
+
+		if(nullptr == groupSets)
+			groups(XTOKEN_SNAPSHOT_SECTION::Groups, token.Groups);
+		else
+			writer.GroupSet(groupSets->Intern(token.Groups, base));
+		groups(XTOKEN_SNAPSHOT_SECTION::RestrictedSids, token.RestrictedSids);
+		groups(XTOKEN_SNAPSHOT_SECTION::LogonSid, token.LogonSid);
+		groups(XTOKEN_SNAPSHOT_SECTION::Capabilities, token.Capabilities);
+		groups(XTOKEN_SNAPSHOT_SECTION::DeviceGroups, token.DeviceGroups);
+		groups(XTOKEN_SNAPSHOT_SECTION::RestrictedDeviceGroups, token.RestrictedDeviceGroups);
+		#pragma endregion
+
+		#pragma region Privileges
+		std::vector<XTOKEN_SNAPSHOT_PRIVILEGE> privileges;
+		for(auto&& element : token.Privileges)
+			privileges.push_back(XTOKEN_SNAPSHOT_PRIVILEGE{ element.Luid->LowPart, element.Luid->HighPart, (DWORD)*element.Attributes, 0 });
+
+		writer.Privileges(privileges);
+		#pragma endregion
+
+		#pragma region Claims
+		auto claims = [&](const XTOKEN_SNAPSHOT_SECTION& section, const std::shared_ptr<XSECURITY_ATTRIBUTES_INFORMATION>& information)
+		{
+			if(nullptr == information)
+				return;
+
+			std::vector<bin_t> blobs;
+			for(auto&& element : information->Attributes)
+				blobs.push_back((bin_t)*element);
+
+			writer.Blobs(section, blobs);
+		};
+
+		claims(XTOKEN_SNAPSHOT_SECTION::UserClaims, token.UserClaimAttributes);
+		claims(XTOKEN_SNAPSHOT_SECTION::DeviceClaims, token.DeviceClaimAttributes);
+		claims(XTOKEN_SNAPSHOT_SECTION::SecurityAttributes, token.SecurityAttributes);
+		claims(XTOKEN_SNAPSHOT_SECTION::SingletonAttributes, token.SingletonAttributes);
+		#pragma endregion
+
+		#pragma region Default DACL, security descriptor and linked token
+		if(nullptr != token.DefaultDacl)
+			writer.Bytes(XTOKEN_SNAPSHOT_SECTION::DefaultDacl, (bin_t)*token.DefaultDacl);
+
+		if(nullptr != token.SecurityDescriptor)
+			writer.Bytes(XTOKEN_SNAPSHOT_SECTION::SecurityDescriptor, (bin_t)*token.SecurityDescriptor);
+
+		if(nullptr != token.LinkedToken)
+			writer.Bytes(XTOKEN_SNAPSHOT_SECTION::LinkedToken, Make(*token.LinkedToken, groupSets, base));
+		#pragma endregion
+
+		return writer.Data();
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT::Save(const XTOKEN& token, const std::wstring& path, XGROUP_SETS* groupSets, const DWORD& base)
+	{
+		XTOKEN_SNAPSHOT_WRITER::Save(Make(token, groupSets, base), std::filesystem::path(path));
+	}
+	//****************************************************************************************
+	XTOKEN XTOKEN_SNAPSHOT::Token(const XGROUP_SETS* groupSets) const
+	{
+		#pragma region Additional check
+		std::optional<DWORD> groupSet = GroupSet();
+		if(groupSet.has_value() && (nullptr == groupSets))
+			throw std::exception("XTOKEN_SNAPSHOT: dictionary of group sets is required");
+		#pragma endregion
+
+		// Token without handle and with empty provider, all values are set from snapshot below
+		XTOKEN result(nullptr, (DWORD64)0, std::make_shared<const XTOKEN_INFO_MEMORY>(), (0 != (Scalars().Present & PresentIsLinkedToken)));
+		const XTOKEN_SNAPSHOT_SCALARS& scalars = Scalars();
+
+		#pragma region SIDs
+		auto sid = [this](const DWORD& index){ return (XTOKEN_SNAPSHOT_NO_SID == index) ? nullptr : std::make_shared<XSID>(Sid(index).data()); };
+		auto sid_and_attributes = [this](const DWORD& index, const DWORD& attributes){ return XSID_AND_ATTRIBUTES(SID_AND_ATTRIBUTES{ (PSID)Sid(index).data(), attributes }); };
+
+		if(XTOKEN_SNAPSHOT_NO_SID != scalars.User)
+			result.User = std::make_shared<XSID_AND_ATTRIBUTES>(sid_and_attributes(scalars.User, scalars.UserAttributes));
+		if(XTOKEN_SNAPSHOT_NO_SID != scalars.IntegrityLevel)
+			result.IntegrityLevel = std::make_shared<XSID_AND_ATTRIBUTES>(sid_and_attributes(scalars.IntegrityLevel, scalars.IntegrityLevelAttributes));
+
+		result.Owner = sid(scalars.Owner);
+		result.PrimaryGroup = sid(scalars.PrimaryGroup);
+		result.AppContainerSid = sid(scalars.AppContainerSid);
+
+		auto list = [&](const XTOKEN_SNAPSHOT_SECTION& id)
+		{
+			std::vector<XSID_AND_ATTRIBUTES> groups;
+			for(auto&& element : Groups(id))
+				groups.push_back(sid_and_attributes(element.Sid, element.Attributes));
+
+			return groups;
+		};
+
+		result.Groups = (groupSet.has_value()) ? groupSets->Groups(groupSet.value()) : list(XTOKEN_SNAPSHOT_SECTION::Groups);
+		result.RestrictedSids = list(XTOKEN_SNAPSHOT_SECTION::RestrictedSids);
+		result.LogonSid = list(XTOKEN_SNAPSHOT_SECTION::LogonSid);
+		result.Capabilities = list(XTOKEN_SNAPSHOT_SECTION::Capabilities);
+		result.DeviceGroups = list(XTOKEN_SNAPSHOT_SECTION::DeviceGroups);
+		result.RestrictedDeviceGroups = list(XTOKEN_SNAPSHOT_SECTION::RestrictedDeviceGroups);
+		#pragma endregion
+
+		#pragma region Scalars
+		result.Type = (TOKEN_TYPE)scalars.Type;
+		result.ImpersonationLevel = (SECURITY_IMPERSONATION_LEVEL)scalars.ImpersonationLevel;
+		result.SessionId = scalars.SessionId;
+		result.Elevation = scalars.Elevation;
+		result.HasRestrictions = scalars.HasRestrictions;
+		result.ElevationType = (TOKEN_ELEVATION_TYPE)scalars.ElevationType;
+		result.UIAccess = scalars.UIAccess;
+		result.AppContainerNumber = scalars.AppContainerNumber;
+		result.IsAppContainer = scalars.IsAppContainer;
+		result.SandBoxInert = scalars.SandBoxInert;
+		result.VirtualizationAllowed = scalars.VirtualizationAllowed;
+		result.VirtualizationEnabled = scalars.VirtualizationEnabled;
+
+		if(scalars.Present & PresentMandatoryPolicy)
+			result.MandatoryPolicy = std::make_shared<XBITSET<32>>(scalars.MandatoryPolicy, DwordMeaningMandatoryPolicy);
+
+		if(scalars.Present & PresentOrigin)
+			result.Origin = std::make_shared<XLUID>(scalars.OriginLowPart, scalars.OriginHighPart);
+
+		if(scalars.Present & PresentSource)
+			result.Source = std::make_shared<XTOKEN_SOURCE>(std::string(scalars.SourceName, strnlen(scalars.SourceName, sizeof(scalars.SourceName))), XLUID(scalars.SourceLowPart, scalars.SourceHighPart));
+
+		if(scalars.Present & PresentStatistics)
+		{
+			result.Statistics = std::make_shared<XTOKEN_STATISTICS>(
+				XLUID(scalars.TokenIdLowPart, scalars.TokenIdHighPart),
+				XLUID(scalars.AuthenticationIdLowPart, scalars.AuthenticationIdHighPart),
+				scalars.ExpirationTime,
+				(TOKEN_TYPE)scalars.Type,
+				(SECURITY_IMPERSONATION_LEVEL)scalars.ImpersonationLevel,
+				scalars.DynamicCharged,
+				scalars.DynamicAvailable,
+				scalars.GroupCount,
+				scalars.PrivilegeCount,
+				XLUID(scalars.ModifiedIdLowPart, scalars.ModifiedIdHighPart)
+			);
+		}
+		#pragma endregion
+
+		#pragma region Privileges
+		for(auto&& element : Privileges())
+			result.Privileges.emplace_back(LUID_AND_ATTRIBUTES{ { element.LowPart, element.HighPart }, element.Attributes });
+		#pragma endregion
+
+		#pragma region Claims
+		auto claims = [this](const XTOKEN_SNAPSHOT_SECTION& id) -> std::shared_ptr<XSECURITY_ATTRIBUTES_INFORMATION>
+		{
+			if(nullptr == section(id))
+				return nullptr;
+
+			auto information = std::make_shared<XSECURITY_ATTRIBUTES_INFORMATION>(std::vector<XSECURITY_ATTRIBUTE_V1>{});
+			for(auto&& element : Claims(id))
+				information->Attributes.push_back(std::make_shared<XSECURITY_ATTRIBUTE_V1>(element));
+
+			information->Reindex();
+
+			return information;
+		};
+
+		result.UserClaimAttributes = claims(XTOKEN_SNAPSHOT_SECTION::UserClaims);
+		result.DeviceClaimAttributes = claims(XTOKEN_SNAPSHOT_SECTION::DeviceClaims);
+		result.SecurityAttributes = claims(XTOKEN_SNAPSHOT_SECTION::SecurityAttributes);
+		result.SingletonAttributes = claims(XTOKEN_SNAPSHOT_SECTION::SingletonAttributes);
+		#pragma endregion
+
+		#pragma region Default DACL, security descriptor and linked token
+		if(DefaultDacl().size())
+			result.DefaultDacl = std::make_shared<XACL>(DefaultDacl().data(), DwordMeaningToken);
+
+		if(SecurityDescriptor().size())
+			result.SecurityDescriptor = std::make_shared<XSD>(SecurityDescriptor().data(), DwordMeaningToken);
+
+		if(std::optional<XTOKEN_SNAPSHOT> linked = LinkedToken())
+			result.LinkedToken = std::make_shared<XTOKEN>(linked->Token(groupSets));
+		#pragma endregion
+
+		result.Loaded = XTOKEN::ClassAll;
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -0,0 +1,807 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+// Only the standard library and the system call for file mapping are used here, so snapshots
+// could be made and read on any little-endian platform. "XTOKEN_SNAPSHOT" (snapshot.h) is
+// the Windows adapter between this layout and XTOKEN.
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <bit>
+#include <span>
+#include <vector>
+#include <set>
+#include <map>
+#include <optional>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Binary snapshot layout
+	//****************************************************************************************
+	// Snapshot layout (little-endian, all sections start at 8-byte boundary):
+	//   header, table of sections, sections in the same order as in the table.
+	// All offsets are from the start of the snapshot, so a snapshot could be embedded into another one (linked token).
+	// Only fixed-size integers are used, no Windows structures are stored as is.
+	static_assert(std::endian::little == std::endian::native, "XTOKEN_SNAPSHOT: only little-endian platforms are supported");
+
+	constexpr uint32_t XTOKEN_SNAPSHOT_MAGIC = 0x534B5458; // "XTKS"
+	constexpr uint16_t XTOKEN_SNAPSHOT_VERSION = 1;
+	constexpr uint32_t XTOKEN_SNAPSHOT_NO_SID = 0xFFFFFFFF;
+	constexpr uint32_t XTOKEN_SNAPSHOT_GROUP_ENABLED = 0x00000004; // SE_GROUP_ENABLED
+	//****************************************************************************************
+	enum class XTOKEN_SNAPSHOT_SECTION : uint32_t
+	{
+		Sids = 1,                // Count SIDs; uint32_t offsets[count + 1], SIDs sorted as binary strings
+		Scalars = 2,             // XTOKEN_SNAPSHOT_SCALARS
+		Groups = 3,              // Count XTOKEN_SNAPSHOT_GROUP
+		RestrictedSids = 4,
+		LogonSid = 5,
+		Capabilities = 6,
+		DeviceGroups = 7,
+		RestrictedDeviceGroups = 8,
+		Privileges = 9,          // Count XTOKEN_SNAPSHOT_PRIVILEGE
+		UserClaims = 10,         // Count claims; XTOKEN_SNAPSHOT_BLOB[count], claims in relative format of "XSECURITY_ATTRIBUTE_V1"
+		DeviceClaims = 11,
+		SecurityAttributes = 12,
+		SingletonAttributes = 13,
+		DefaultDacl = 14,        // Binary ACL
+		SecurityDescriptor = 15, // Self-relative security descriptor
+		LinkedToken = 16,        // Complete snapshot of linked token
+		GroupSet = 17            // No data, Count is identifier of set in XGROUP_SETS used instead of Groups
+	};
+	//****************************************************************************************
+	enum XTOKEN_SNAPSHOT_PRESENT : uint32_t
+	{
+		PresentOrigin = 0x01,
+		PresentSource = 0x02,
+		PresentStatistics = 0x04,
+		PresentMandatoryPolicy = 0x08,
+		PresentIsLinkedToken = 0x10
+	};
+	//****************************************************************************************
+	struct XTOKEN_SNAPSHOT_HEADER
+	{
+		uint32_t Magic;
+		uint16_t Version;
+		uint16_t Sections;
+		uint64_t Size; // Size of whole snapshot, including all sections
+	};
+	//****************************************************************************************
+	struct XTOKEN_SNAPSHOT_ENTRY
+	{
+		uint32_t Id;
+		uint32_t Count;
+		uint64_t Offset;
+		uint64_t Size;
+	};
+	//****************************************************************************************
+	struct XTOKEN_SNAPSHOT_GROUP
+	{
+		uint32_t Sid; // Index in table of SIDs
+		uint32_t Attributes;
+	};
+	//****************************************************************************************
+	struct XTOKEN_SNAPSHOT_PRIVILEGE
+	{
+		uint32_t LowPart;
+		int32_t HighPart;
+		uint32_t Attributes;
+		uint32_t Reserved;
+	};
+	//****************************************************************************************
+	struct XTOKEN_SNAPSHOT_BLOB
+	{
+		uint64_t Offset; // From the start of section
+		uint64_t Size;
+	};
+	//****************************************************************************************
+	struct XTOKEN_SNAPSHOT_SCALARS
+	{
+		uint32_t Present; // Combination of XTOKEN_SNAPSHOT_PRESENT flags
+
+		#pragma region Indexes in table of SIDs (XTOKEN_SNAPSHOT_NO_SID if not set)
+		uint32_t User;
+		uint32_t UserAttributes;
+		uint32_t Owner;
+		uint32_t PrimaryGroup;
+		uint32_t IntegrityLevel;
+		uint32_t IntegrityLevelAttributes;
+		uint32_t AppContainerSid;
+		#pragma endregion
+
+		uint32_t Type;
+		uint32_t ImpersonationLevel;
+		uint32_t SessionId;
+		uint32_t Elevation;
+		uint32_t HasRestrictions;
+		uint32_t ElevationType;
+		uint32_t UIAccess;
+		uint32_t MandatoryPolicy;
+		uint32_t AppContainerNumber;
+		uint32_t IsAppContainer;
+		uint32_t SandBoxInert;
+		uint32_t VirtualizationAllowed;
+		uint32_t VirtualizationEnabled;
+		uint32_t Reserved;
+
+		uint32_t OriginLowPart;
+		int32_t OriginHighPart;
+
+		char SourceName[8];
+		uint32_t SourceLowPart;
+		int32_t SourceHighPart;
+
+		#pragma region Statistics
+		uint32_t TokenIdLowPart;
+		int32_t TokenIdHighPart;
+		uint32_t AuthenticationIdLowPart;
+		int32_t AuthenticationIdHighPart;
+		uint32_t ModifiedIdLowPart;
+		int32_t ModifiedIdHighPart;
+		uint32_t DynamicCharged;
+		uint32_t DynamicAvailable;
+		uint32_t GroupCount;
+		uint32_t PrivilegeCount;
+		int64_t ExpirationTime;
+		#pragma endregion
+	};
+	//****************************************************************************************
+	static_assert(sizeof(XTOKEN_SNAPSHOT_HEADER) == 16, "XTOKEN_SNAPSHOT: unexpected size of header");
+	static_assert(sizeof(XTOKEN_SNAPSHOT_ENTRY) == 24, "XTOKEN_SNAPSHOT: unexpected size of section entry");
+	static_assert(sizeof(XTOKEN_SNAPSHOT_SCALARS) == 160, "XTOKEN_SNAPSHOT: unexpected size of scalars");
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Read-only mapping of a snapshot file
+	//****************************************************************************************
+	struct XTOKEN_SNAPSHOT_FILE
+	{
+		XTOKEN_SNAPSHOT_FILE() = delete;
+		~XTOKEN_SNAPSHOT_FILE() = default;
+
+		XTOKEN_SNAPSHOT_FILE(const std::filesystem::path&);
+
+		std::span<const unsigned char> Data; // Valid while at least one copy of the object exists
+
+	private:
+		std::shared_ptr<const void> view;
+	};
+	//****************************************************************************************
+	#ifdef _WIN32
+	XTOKEN_SNAPSHOT_FILE::XTOKEN_SNAPSHOT_FILE(const std::filesystem::path& path)
+	{
+		std::unique_ptr<void, decltype(&CloseHandle)> file(CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr), &CloseHandle);
+		if(INVALID_HANDLE_VALUE == file.get())
+		{
+			file.release();
+			throw std::runtime_error("XTOKEN_SNAPSHOT_FILE: cannot execute 'CreateFileW'");
+		}
+
+		LARGE_INTEGER size{};
+		if(FALSE == GetFileSizeEx(file.get(), &size))
+			throw std::runtime_error("XTOKEN_SNAPSHOT_FILE: cannot execute 'GetFileSizeEx'");
+
+		if(0 == size.QuadPart)
+			return; // Empty files could not be mapped
+
+		std::unique_ptr<void, decltype(&CloseHandle)> mapping(CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr), &CloseHandle);
+		if(nullptr == mapping)
+			throw std::runtime_error("XTOKEN_SNAPSHOT_FILE: cannot execute 'CreateFileMappingW'");
+
+		void* data = MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0); // The view keeps the mapping alive
+		if(nullptr == data)
+			throw std::runtime_error("XTOKEN_SNAPSHOT_FILE: cannot execute 'MapViewOfFile'");
+
+		view = std::shared_ptr<const void>(data, [](const void* value){ UnmapViewOfFile(value); });
+		Data = std::span<const unsigned char>((const unsigned char*)data, (size_t)size.QuadPart);
+	}
+	#else
+	XTOKEN_SNAPSHOT_FILE::XTOKEN_SNAPSHOT_FILE(const std::filesystem::path& path)
+	{
+		const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if(-1 == file)
+			throw std::runtime_error("XTOKEN_SNAPSHOT_FILE: cannot execute 'open'");
+
+		struct file_guard
+		{
+			const int value;
+			~file_guard() { close(value); }
+		} guard{ file };
+
+		struct stat information{};
+		if(-1 == fstat(file, &information))
+			throw std::runtime_error("XTOKEN_SNAPSHOT_FILE: cannot execute 'fstat'");
+
+		const size_t size = (size_t)information.st_size;
+		if(0 == size)
+			return; // Empty files could not be mapped
+
+		void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0); // The view stays valid after the file is closed
+		if(MAP_FAILED == data)
+			throw std::runtime_error("XTOKEN_SNAPSHOT_FILE: cannot execute 'mmap'");
+
+		view = std::shared_ptr<const void>(data, [size](const void* value){ munmap(const_cast<void*>(value), size); });
+		Data = std::span<const unsigned char>((const unsigned char*)data, size);
+	}
+	#endif
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Read-only view of a binary token snapshot
+	//****************************************************************************************
+	// All accessors read values in place and check nothing beyond "validate": each value read
+	// from the snapshot was checked once while the view was made.
+	struct XTOKEN_SNAPSHOT_READER
+	{
+		XTOKEN_SNAPSHOT_READER() = delete;
+		~XTOKEN_SNAPSHOT_READER() = default;
+
+		XTOKEN_SNAPSHOT_READER(std::span<const unsigned char>); // Data must be 8-byte aligned and must outlive the object
+		XTOKEN_SNAPSHOT_READER(const std::filesystem::path&); // Map a snapshot file
+
+		#pragma region In-place queries
+		const XTOKEN_SNAPSHOT_SCALARS& Scalars() const;
+
+		uint32_t SidCount() const;
+		std::span<const unsigned char> Sid(const uint32_t&) const;
+		std::optional<uint32_t> FindSid(std::span<const unsigned char>) const; // Binary search in sorted table of SIDs
+
+		std::span<const XTOKEN_SNAPSHOT_GROUP> Groups(const XTOKEN_SNAPSHOT_SECTION& = XTOKEN_SNAPSHOT_SECTION::Groups) const;
+		bool HasGroup(std::span<const unsigned char>, const uint32_t& = XTOKEN_SNAPSHOT_GROUP_ENABLED, const XTOKEN_SNAPSHOT_SECTION& = XTOKEN_SNAPSHOT_SECTION::Groups) const; // All bits from mask must be set
+
+		std::span<const XTOKEN_SNAPSHOT_PRIVILEGE> Privileges() const;
+
+		std::vector<std::span<const unsigned char>> Blobs(const XTOKEN_SNAPSHOT_SECTION& = XTOKEN_SNAPSHOT_SECTION::UserClaims) const; // Claims in relative format
+
+		std::span<const unsigned char> DefaultDacl() const;
+		std::span<const unsigned char> SecurityDescriptor() const;
+		std::optional<XTOKEN_SNAPSHOT_READER> LinkedToken() const;
+		std::optional<uint32_t> GroupSet() const; // If set then "Groups" section is empty
+		#pragma endregion
+
+		std::span<const unsigned char> Data;
+
+	protected:
+		const XTOKEN_SNAPSHOT_ENTRY* section(const XTOKEN_SNAPSHOT_SECTION&) const;
+		std::span<const unsigned char> bytes(const XTOKEN_SNAPSHOT_SECTION&) const;
+
+	private:
+		std::optional<XTOKEN_SNAPSHOT_FILE> file;
+		std::span<const XTOKEN_SNAPSHOT_ENTRY> sections;
+
+		std::span<const uint32_t> offsets; // Offsets of SIDs
+		std::span<const unsigned char> sids;
+
+		void validate();
+
+		template<typename T>
+		std::span<const T> records(const XTOKEN_SNAPSHOT_SECTION&) const;
+	};
+	//****************************************************************************************
+	XTOKEN_SNAPSHOT_READER::XTOKEN_SNAPSHOT_READER(std::span<const unsigned char> data) : Data(data)
+	{
+		validate();
+	}
+	//****************************************************************************************
+	XTOKEN_SNAPSHOT_READER::XTOKEN_SNAPSHOT_READER(const std::filesystem::path& path) : file(std::in_place, path)
+	{
+		Data = file->Data;
+		validate();
+	}
+	//****************************************************************************************
+	const XTOKEN_SNAPSHOT_ENTRY* XTOKEN_SNAPSHOT_READER::section(const XTOKEN_SNAPSHOT_SECTION& id) const
+	{
+		for(auto&& element : sections)
+		{
+			if(element.Id == (uint32_t)id)
+				return &element;
+		}
+
+		return nullptr;
+	}
+	//****************************************************************************************
+	std::span<const unsigned char> XTOKEN_SNAPSHOT_READER::bytes(const XTOKEN_SNAPSHOT_SECTION& id) const
+	{
+		const XTOKEN_SNAPSHOT_ENTRY* entry = section(id);
+		if(nullptr == entry)
+			return {};
+
+		return Data.subspan((size_t)entry->Offset, (size_t)entry->Size);
+	}
+	//****************************************************************************************
+	template<typename T>
+	std::span<const T> XTOKEN_SNAPSHOT_READER::records(const XTOKEN_SNAPSHOT_SECTION& id) const
+	{
+		const XTOKEN_SNAPSHOT_ENTRY* entry = section(id);
+		if(nullptr == entry)
+			return {};
+
+		return std::span<const T>((const T*)(Data.data() + entry->Offset), entry->Count);
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_READER::validate()
+	{
+		#pragma region Header and table of sections
+		if((Data.size() < sizeof(XTOKEN_SNAPSHOT_HEADER)) || (0 != ((uintptr_t)Data.data() & 7)))
+			throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+
+		XTOKEN_SNAPSHOT_HEADER header{};
+		memcpy(&header, Data.data(), sizeof(header));
+
+		if((XTOKEN_SNAPSHOT_MAGIC != header.Magic) || (XTOKEN_SNAPSHOT_VERSION != header.Version) || (header.Size > Data.size()))
+			throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+
+		// Both header and table of sections must be inside declared size, checked before slicing
+		if((header.Size < sizeof(header)) || (header.Size < (sizeof(header) + (uint64_t)header.Sections * sizeof(XTOKEN_SNAPSHOT_ENTRY))))
+			throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+
+		Data = Data.first((size_t)header.Size);
+
+		sections = std::span<const XTOKEN_SNAPSHOT_ENTRY>((const XTOKEN_SNAPSHOT_ENTRY*)(Data.data() + sizeof(header)), header.Sections);
+
+		for(auto&& element : sections)
+		{
+			if((0 != (element.Offset & 7)) || (element.Offset > Data.size()) || (element.Size > (Data.size() - element.Offset)))
+				throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+		}
+		#pragma endregion
+
+		#pragma region Table of SIDs
+		if(const XTOKEN_SNAPSHOT_ENTRY* entry = section(XTOKEN_SNAPSHOT_SECTION::Sids))
+		{
+			size_t table = ((size_t)entry->Count + 1) * sizeof(uint32_t);
+			size_t start = (table + 7) & ~(size_t)7;
+
+			if(((entry->Size / sizeof(uint32_t)) <= entry->Count) || (start > entry->Size))
+				throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+
+			offsets = std::span<const uint32_t>((const uint32_t*)(Data.data() + entry->Offset), (size_t)entry->Count + 1);
+			sids = Data.subspan((size_t)(entry->Offset + start), (size_t)(entry->Size - start));
+
+			if((0 != offsets[0]) || (offsets.back() > sids.size()))
+				throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+
+			for(size_t i = 1; i < offsets.size(); i++)
+			{
+				// Each SID must be complete: 8 bytes of fixed part and 4 bytes per sub-authority
+				if((offsets[i] < offsets[i - 1]) || (offsets[i] > sids.size()) || ((offsets[i] - offsets[i - 1]) < 8) || ((offsets[i] - offsets[i - 1]) != (8 + 4 * (uint32_t)sids[offsets[i - 1] + 1])))
+					throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+			}
+		}
+		#pragma endregion
+
+		#pragma region Scalars
+		const XTOKEN_SNAPSHOT_ENTRY* scalars = section(XTOKEN_SNAPSHOT_SECTION::Scalars);
+		if((nullptr == scalars) || (scalars->Size < sizeof(XTOKEN_SNAPSHOT_SCALARS)))
+			throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+
+		for(const uint32_t& index : { Scalars().User, Scalars().Owner, Scalars().PrimaryGroup, Scalars().IntegrityLevel, Scalars().AppContainerSid })
+		{
+			if((XTOKEN_SNAPSHOT_NO_SID != index) && (index >= SidCount()))
+				throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+		}
+		#pragma endregion
+
+		#pragma region Records
+		for(auto&& element : sections)
+		{
+			size_t size = 0;
+			bool blobs = false; // Privileges have the same size of record as blobs
+
+			switch((XTOKEN_SNAPSHOT_SECTION)element.Id)
+			{
+				case XTOKEN_SNAPSHOT_SECTION::Groups:
+				case XTOKEN_SNAPSHOT_SECTION::RestrictedSids:
+				case XTOKEN_SNAPSHOT_SECTION::LogonSid:
+				case XTOKEN_SNAPSHOT_SECTION::Capabilities:
+				case XTOKEN_SNAPSHOT_SECTION::DeviceGroups:
+				case XTOKEN_SNAPSHOT_SECTION::RestrictedDeviceGroups:
+					size = sizeof(XTOKEN_SNAPSHOT_GROUP);
+					break;
+				case XTOKEN_SNAPSHOT_SECTION::Privileges:
+					size = sizeof(XTOKEN_SNAPSHOT_PRIVILEGE);
+					break;
+				case XTOKEN_SNAPSHOT_SECTION::UserClaims:
+				case XTOKEN_SNAPSHOT_SECTION::DeviceClaims:
+				case XTOKEN_SNAPSHOT_SECTION::SecurityAttributes:
+				case XTOKEN_SNAPSHOT_SECTION::SingletonAttributes:
+					size = sizeof(XTOKEN_SNAPSHOT_BLOB);
+					blobs = true;
+					break;
+				case XTOKEN_SNAPSHOT_SECTION::DefaultDacl:
+					// AclSize is the only length used while parsing ACL
+					if((element.Size < 8) || (*(const uint16_t*)(Data.data() + element.Offset + 2) > element.Size))
+						throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+
+					continue;
+				default:
+					continue;
+			}
+
+			if(element.Count > (element.Size / size))
+				throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+
+			if(size == sizeof(XTOKEN_SNAPSHOT_GROUP))
+			{
+				for(auto&& group : records<XTOKEN_SNAPSHOT_GROUP>((XTOKEN_SNAPSHOT_SECTION)element.Id))
+				{
+					if(group.Sid >= SidCount())
+						throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+				}
+			}
+
+			if(blobs)
+			{
+				for(auto&& blob : records<XTOKEN_SNAPSHOT_BLOB>((XTOKEN_SNAPSHOT_SECTION)element.Id))
+				{
+					if((blob.Offset > element.Size) || (blob.Size > (element.Size - blob.Offset)))
+						throw std::runtime_error("XTOKEN_SNAPSHOT: invalid snapshot");
+				}
+			}
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	const XTOKEN_SNAPSHOT_SCALARS& XTOKEN_SNAPSHOT_READER::Scalars() const
+	{
+		return *(const XTOKEN_SNAPSHOT_SCALARS*)bytes(XTOKEN_SNAPSHOT_SECTION::Scalars).data();
+	}
+	//****************************************************************************************
+	uint32_t XTOKEN_SNAPSHOT_READER::SidCount() const
+	{
+		return (offsets.empty()) ? 0 : (uint32_t)(offsets.size() - 1);
+	}
+	//****************************************************************************************
+	std::span<const unsigned char> XTOKEN_SNAPSHOT_READER::Sid(const uint32_t& index) const
+	{
+		if(index >= SidCount())
+			throw std::out_of_range("XTOKEN_SNAPSHOT: index of SID is out of range");
+
+		return sids.subspan(offsets[index], offsets[index + 1] - offsets[index]);
+	}
+	//****************************************************************************************
+	std::optional<uint32_t> XTOKEN_SNAPSHOT_READER::FindSid(std::span<const unsigned char> value) const
+	{
+		uint32_t low = 0;
+		uint32_t high = SidCount();
+
+		while(low < high)
+		{
+			uint32_t middle = low + (high - low) / 2;
+			auto sid = Sid(middle);
+
+			if(std::lexicographical_compare(sid.begin(), sid.end(), value.begin(), value.end()))
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		if((low < SidCount()) && std::ranges::equal(Sid(low), value))
+			return low;
+
+		return std::nullopt;
+	}
+	//****************************************************************************************
+	std::span<const XTOKEN_SNAPSHOT_GROUP> XTOKEN_SNAPSHOT_READER::Groups(const XTOKEN_SNAPSHOT_SECTION& id) const
+	{
+		switch(id)
+		{
+			case XTOKEN_SNAPSHOT_SECTION::Groups:
+			case XTOKEN_SNAPSHOT_SECTION::RestrictedSids:
+			case XTOKEN_SNAPSHOT_SECTION::LogonSid:
+			case XTOKEN_SNAPSHOT_SECTION::Capabilities:
+			case XTOKEN_SNAPSHOT_SECTION::DeviceGroups:
+			case XTOKEN_SNAPSHOT_SECTION::RestrictedDeviceGroups:
+				return records<XTOKEN_SNAPSHOT_GROUP>(id);
+			default:
+				throw std::invalid_argument("XTOKEN_SNAPSHOT: section is not a list of groups");
+		}
+	}
+	//****************************************************************************************
+	bool XTOKEN_SNAPSHOT_READER::HasGroup(std::span<const unsigned char> sid, const uint32_t& mask, const XTOKEN_SNAPSHOT_SECTION& id) const
+	{
+		std::optional<uint32_t> index = FindSid(sid);
+		if(false == index.has_value())
+			return false;
+
+		for(auto&& element : Groups(id))
+		{
+			if((element.Sid == index.value()) && (mask == (element.Attributes & mask)))
+				return true;
+		}
+
+		return false;
+	}
+	//****************************************************************************************
+	std::span<const XTOKEN_SNAPSHOT_PRIVILEGE> XTOKEN_SNAPSHOT_READER::Privileges() const
+	{
+		return records<XTOKEN_SNAPSHOT_PRIVILEGE>(XTOKEN_SNAPSHOT_SECTION::Privileges);
+	}
+	//****************************************************************************************
+	std::vector<std::span<const unsigned char>> XTOKEN_SNAPSHOT_READER::Blobs(const XTOKEN_SNAPSHOT_SECTION& id) const
+	{
+		switch(id)
+		{
+			case XTOKEN_SNAPSHOT_SECTION::UserClaims:
+			case XTOKEN_SNAPSHOT_SECTION::DeviceClaims:
+			case XTOKEN_SNAPSHOT_SECTION::SecurityAttributes:
+			case XTOKEN_SNAPSHOT_SECTION::SingletonAttributes:
+				break;
+			default:
+				throw std::invalid_argument("XTOKEN_SNAPSHOT: section is not a list of claims");
+		}
+
+		std::vector<std::span<const unsigned char>> result;
+
+		auto data = bytes(id);
+		for(auto&& element : records<XTOKEN_SNAPSHOT_BLOB>(id))
+			result.push_back(data.subspan((size_t)element.Offset, (size_t)element.Size));
+
+		return result;
+	}
+	//****************************************************************************************
+	std::span<const unsigned char> XTOKEN_SNAPSHOT_READER::DefaultDacl() const
+	{
+		return bytes(XTOKEN_SNAPSHOT_SECTION::DefaultDacl);
+	}
+	//****************************************************************************************
+	std::span<const unsigned char> XTOKEN_SNAPSHOT_READER::SecurityDescriptor() const
+	{
+		return bytes(XTOKEN_SNAPSHOT_SECTION::SecurityDescriptor);
+	}
+	//****************************************************************************************
+	std::optional<XTOKEN_SNAPSHOT_READER> XTOKEN_SNAPSHOT_READER::LinkedToken() const
+	{
+		const XTOKEN_SNAPSHOT_ENTRY* entry = section(XTOKEN_SNAPSHOT_SECTION::LinkedToken);
+		if(nullptr == entry)
+			return std::nullopt;
+
+		XTOKEN_SNAPSHOT_READER result(bytes(XTOKEN_SNAPSHOT_SECTION::LinkedToken));
+		result.file = file; // Keep mapping alive while linked snapshot exists
+
+		return result;
+	}
+	//****************************************************************************************
+	std::optional<uint32_t> XTOKEN_SNAPSHOT_READER::GroupSet() const
+	{
+		const XTOKEN_SNAPSHOT_ENTRY* entry = section(XTOKEN_SNAPSHOT_SECTION::GroupSet);
+		if(nullptr == entry)
+			return std::nullopt;
+
+		return entry->Count;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Making of snapshots
+	//****************************************************************************************
+	// Sections are stored in order of calls, the table of SIDs is always the first one.
+	// Each list is skipped if it is empty, so readers see a missing section instead.
+	struct XTOKEN_SNAPSHOT_WRITER
+	{
+		XTOKEN_SNAPSHOT_WRITER() = delete;
+		~XTOKEN_SNAPSHOT_WRITER() = default;
+
+		XTOKEN_SNAPSHOT_WRITER(const std::set<std::vector<unsigned char>>&); // All SIDs referenced by the snapshot
+
+		uint32_t Sid(std::span<const unsigned char>) const; // Index in table of SIDs, XTOKEN_SNAPSHOT_NO_SID for empty value
+
+		void Scalars(const XTOKEN_SNAPSHOT_SCALARS&);
+		void Groups(const XTOKEN_SNAPSHOT_SECTION&, std::span<const XTOKEN_SNAPSHOT_GROUP>);
+		void GroupSet(const uint32_t&);
+		void Privileges(std::span<const XTOKEN_SNAPSHOT_PRIVILEGE>);
+		void Blobs(const XTOKEN_SNAPSHOT_SECTION&, const std::vector<std::vector<unsigned char>>&);
+		void Bytes(const XTOKEN_SNAPSHOT_SECTION&, std::vector<unsigned char>&&); // ACL, security descriptor or linked token
+
+		std::vector<unsigned char> Data() const; // Complete snapshot
+
+		static void Save(std::span<const unsigned char>, const std::filesystem::path&);
+
+	private:
+		std::map<std::vector<unsigned char>, uint32_t> table;
+		std::vector<std::pair<XTOKEN_SNAPSHOT_ENTRY, std::vector<unsigned char>>> sections;
+
+		void add(const XTOKEN_SNAPSHOT_SECTION&, const size_t&, std::vector<unsigned char>&&);
+
+		template<typename T>
+		static void put(std::vector<unsigned char>&, const T&);
+		static void pad(std::vector<unsigned char>&);
+	};
+	//****************************************************************************************
+	template<typename T>
+	void XTOKEN_SNAPSHOT_WRITER::put(std::vector<unsigned char>& buffer, const T& value)
+	{
+		const unsigned char* data = (const unsigned char*)&value;
+		buffer.insert(buffer.end(), data, data + sizeof(T));
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::pad(std::vector<unsigned char>& buffer)
+	{
+		buffer.resize((buffer.size() + 7) & ~(size_t)7, 0);
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::add(const XTOKEN_SNAPSHOT_SECTION& section, const size_t& count, std::vector<unsigned char>&& data)
+	{
+		sections.emplace_back(XTOKEN_SNAPSHOT_ENTRY{ (uint32_t)section, (uint32_t)count, 0, data.size() }, std::move(data));
+	}
+	//****************************************************************************************
+	XTOKEN_SNAPSHOT_WRITER::XTOKEN_SNAPSHOT_WRITER(const std::set<std::vector<unsigned char>>& values)
+	{
+		// Each SID is stored once, sorted for binary search
+		std::vector<unsigned char> data;
+
+		uint32_t offset = 0;
+		put(data, offset);
+
+		for(auto&& element : values)
+		{
+			table.emplace(element, (uint32_t)table.size());
+
+			offset += (uint32_t)element.size();
+			put(data, offset);
+		}
+
+		pad(data);
+
+		for(auto&& element : values)
+			data.insert(data.end(), element.begin(), element.end());
+
+		add(XTOKEN_SNAPSHOT_SECTION::Sids, values.size(), std::move(data));
+	}
+	//****************************************************************************************
+	uint32_t XTOKEN_SNAPSHOT_WRITER::Sid(std::span<const unsigned char> value) const
+	{
+		if(value.empty())
+			return XTOKEN_SNAPSHOT_NO_SID;
+
+		auto element = table.find(std::vector<unsigned char>(value.begin(), value.end()));
+		if(table.end() == element)
+			throw std::invalid_argument("XTOKEN_SNAPSHOT: SID is not in the table");
+
+		return element->second;
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::Scalars(const XTOKEN_SNAPSHOT_SCALARS& value)
+	{
+		std::vector<unsigned char> data;
+		put(data, value);
+
+		add(XTOKEN_SNAPSHOT_SECTION::Scalars, 1, std::move(data));
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::Groups(const XTOKEN_SNAPSHOT_SECTION& section, std::span<const XTOKEN_SNAPSHOT_GROUP> values)
+	{
+		if(values.empty())
+			return;
+
+		std::vector<unsigned char> data;
+		for(auto&& element : values)
+			put(data, element);
+
+		add(section, values.size(), std::move(data));
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::GroupSet(const uint32_t& value)
+	{
+		add(XTOKEN_SNAPSHOT_SECTION::GroupSet, value, {});
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::Privileges(std::span<const XTOKEN_SNAPSHOT_PRIVILEGE> values)
+	{
+		if(values.empty())
+			return;
+
+		std::vector<unsigned char> data;
+		for(auto&& element : values)
+			put(data, element);
+
+		add(XTOKEN_SNAPSHOT_SECTION::Privileges, values.size(), std::move(data));
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::Blobs(const XTOKEN_SNAPSHOT_SECTION& section, const std::vector<std::vector<unsigned char>>& values)
+	{
+		if(values.empty())
+			return;
+
+		std::vector<unsigned char> data;
+
+		uint64_t offset = values.size() * sizeof(XTOKEN_SNAPSHOT_BLOB);
+		for(auto&& element : values)
+		{
+			put(data, XTOKEN_SNAPSHOT_BLOB{ offset, element.size() });
+			offset += (element.size() + 7) & ~(size_t)7;
+		}
+
+		for(auto&& element : values)
+		{
+			data.insert(data.end(), element.begin(), element.end());
+			pad(data);
+		}
+
+		add(section, values.size(), std::move(data));
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::Bytes(const XTOKEN_SNAPSHOT_SECTION& section, std::vector<unsigned char>&& value)
+	{
+		add(section, 1, std::move(value));
+	}
+	//****************************************************************************************
+	std::vector<unsigned char> XTOKEN_SNAPSHOT_WRITER::Data() const
+	{
+		std::vector<unsigned char> result;
+
+		put(result, XTOKEN_SNAPSHOT_HEADER{ XTOKEN_SNAPSHOT_MAGIC, XTOKEN_SNAPSHOT_VERSION, (uint16_t)sections.size(), 0 });
+
+		uint64_t offset = sizeof(XTOKEN_SNAPSHOT_HEADER) + sections.size() * sizeof(XTOKEN_SNAPSHOT_ENTRY);
+		for(auto&& [entry, data] : sections)
+		{
+			XTOKEN_SNAPSHOT_ENTRY value = entry;
+			value.Offset = offset;
+			put(result, value);
+
+			offset += (data.size() + 7) & ~(size_t)7;
+		}
+
+		for(auto&& [entry, data] : sections)
+		{
+			result.insert(result.end(), data.begin(), data.end());
+			pad(result);
+		}
+
+		uint64_t size = result.size();
+		memcpy(result.data() + offsetof(XTOKEN_SNAPSHOT_HEADER, Size), &size, sizeof(size));
+
+		return result;
+	}
+	//****************************************************************************************
+	void XTOKEN_SNAPSHOT_WRITER::Save(std::span<const unsigned char> data, const std::filesystem::path& path)
+	{
+		std::ofstream stream(path, std::ios_base::binary | std::ios_base::trunc);
+		if(false == stream.is_open())
+			throw std::runtime_error("XTOKEN_SNAPSHOT: cannot open file for writing");
+
+		stream.write((const char*)data.data(), data.size());
+
+		stream.flush();
+		if(stream.fail())
+			throw std::runtime_error("XTOKEN_SNAPSHOT: cannot write to file");
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -0,0 +1,130 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+// Set algorithms over sorted ranges without duplicates. Only the standard library is used, so
+// the same code is benchmarked on any platform (bench/sid_set_bench.cpp).
+#include <algorithm>
+#include <iterator>
+#include <vector>
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Sorted sets
+	//****************************************************************************************
+	template<typename T>
+	void sort_unique(std::vector<T>& values)
+	{
+		std::sort(values.begin(), values.end());
+		values.erase(std::unique(values.begin(), values.end()), values.end());
+	}
+	//****************************************************************************************
+	// All values from the second range are in the first one. A small range against a large one
+	// is checked by binary search for each value, ranges with similar sizes by a linear merge.
+	template<typename I, typename J>
+	bool sorted_includes(I first, I last, J valuesFirst, J valuesLast)
+	{
+		const auto size = std::distance(first, last);
+		const auto count = std::distance(valuesFirst, valuesLast);
+
+		if(count > size)
+			return false;
+
+		if((count << 4) < size)
+		{
+			for(; valuesFirst != valuesLast; valuesFirst++)
+			{
+				if(false == std::binary_search(first, last, *valuesFirst))
+					return false;
+			}
+
+			return true;
+		}
+
+		return std::includes(first, last, valuesFirst, valuesLast);
+	}
+	//****************************************************************************************
+	// Any value from one range is in the other one, with the same choice of algorithm
+	template<typename I, typename J>
+	bool sorted_intersects(I lhsFirst, I lhsLast, J rhsFirst, J rhsLast)
+	{
+		const auto lhsSize = std::distance(lhsFirst, lhsLast);
+		const auto rhsSize = std::distance(rhsFirst, rhsLast);
+
+		#pragma region Small range against large one
+		if((lhsSize << 4) < rhsSize)
+		{
+			for(; lhsFirst != lhsLast; lhsFirst++)
+			{
+				if(std::binary_search(rhsFirst, rhsLast, *lhsFirst))
+					return true;
+			}
+
+			return false;
+		}
+
+		if((rhsSize << 4) < lhsSize)
+		{
+			for(; rhsFirst != rhsLast; rhsFirst++)
+			{
+				if(std::binary_search(lhsFirst, lhsLast, *rhsFirst))
+					return true;
+			}
+
+			return false;
+		}
+		#pragma endregion
+
+		#pragma region Linear merge
+		while((lhsFirst != lhsLast) && (rhsFirst != rhsLast))
+		{
+			if(*lhsFirst < *rhsFirst)
+				lhsFirst++;
+			else
+			{
+				if(*rhsFirst < *lhsFirst)
+					rhsFirst++;
+				else
+					return true;
+			}
+		}
+		#pragma endregion
+
+		return false;
+	}
+	//****************************************************************************************
+	template<typename L, typename R>
+	bool sorted_includes(const L& lhs, const R& rhs)
+	{
+		return sorted_includes(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+	}
+	//****************************************************************************************
+	template<typename L, typename R>
+	bool sorted_intersects(const L& lhs, const R& rhs)
+	{
+		return sorted_intersects(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs));
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -39,8 +39,10 @@ namespace XSEC
 
 		XTOKEN_GROUPS_AND_PRIVILEGES(const TOKEN_GROUPS_AND_PRIVILEGES&);
 		XTOKEN_GROUPS_AND_PRIVILEGES(const msxml_et&);
+		XTOKEN_GROUPS_AND_PRIVILEGES(XXML_READER&);
 
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::vector<XSID_AND_ATTRIBUTES> Sids;
 		std::vector<XSID_AND_ATTRIBUTES> RestrictedSids;
@@ -117,6 +119,37 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XTOKEN_GROUPS_AND_PRIVILEGES::XTOKEN_GROUPS_AND_PRIVILEGES(XXML_READER& xml)
+	{
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+			size_t level = xml.Depth();
+
+			if("Sids" == name)
+			{
+				while(xml.Child(level))
+					Sids.emplace_back(xml, SidAndAttributesMeaningDefault);
+			}
+			else if("RestrictedSids" == name)
+			{
+				while(xml.Child(level))
+					RestrictedSids.emplace_back(xml, SidAndAttributesMeaningDefault);
+			}
+			else if("Privileges" == name)
+			{
+				while(xml.Child(level))
+					Privileges.emplace_back(xml);
+			}
+			else if("AuthenticationId" == name)
+				AuthenticationId = std::make_shared<XLUID>(xml);
+		}
+
+		if(nullptr == AuthenticationId)
+			throw std::exception("TOKEN_GROUPS_AND_PRIVILEGES: cannot find 'AuthenticationId' XML node");
+	}
+	//****************************************************************************************
 	XTOKEN_GROUPS_AND_PRIVILEGES::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -179,6 +212,48 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XTOKEN_GROUPS_AND_PRIVILEGES::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if(nullptr == AuthenticationId)
+			throw std::exception("TOKEN_GROUPS_AND_PRIVILEGES: initialize data first");
+
+		xml.Start(root.value_or("TokenGroupsAndPrivileges"));
+
+		#pragma region Sids
+		xml.Start("Sids");
+
+		for(auto&& element : Sids)
+			element.Write(xml, "Sid");
+
+		xml.End();
+		#pragma endregion
+
+		#pragma region RestrictedSids
+		if(RestrictedSids.empty() == false)
+		{
+			xml.Start("RestrictedSids");
+
+			for(auto&& element : RestrictedSids)
+				element.Write(xml, "RestrictedSid");
+
+			xml.End();
+		}
+		#pragma endregion
+
+		#pragma region Privileges
+		xml.Start("Privileges");
+
+		for(auto&& element : Privileges)
+			element.Write(xml, "Privilege");
+
+		xml.End();
+		#pragma endregion
+
+		AuthenticationId->Write(xml, "AuthenticationId");
+
+		xml.End();
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Class for working with TOKEN_ACCESS_INFORMATION structure
@@ -205,8 +280,10 @@ namespace XSEC
 
 		XTOKEN_ACCESS_INFORMATION(const TOKEN_ACCESS_INFORMATION&);
 		XTOKEN_ACCESS_INFORMATION(const msxml_et&);
+		XTOKEN_ACCESS_INFORMATION(XXML_READER&);
 
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::shared_ptr<XSID_AND_ATTRIBUTES_HASH> SidHash;
 		std::shared_ptr<XSID_AND_ATTRIBUTES_HASH> RestrictedSidHash;
@@ -385,6 +462,70 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XTOKEN_ACCESS_INFORMATION::XTOKEN_ACCESS_INFORMATION(XXML_READER& xml) : ImpersonationLevel(SecurityAnonymous)
+	{
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+
+			if("SidHash" == name)
+				SidHash = std::make_shared<XSID_AND_ATTRIBUTES_HASH>(xml, SidAndAttributesMeaningDefault);
+			else if("RestrictedSidHash" == name)
+				RestrictedSidHash = std::make_shared<XSID_AND_ATTRIBUTES_HASH>(xml, SidAndAttributesMeaningDefault);
+			else if("Privileges" == name)
+			{
+				size_t level = xml.Depth();
+				while(xml.Child(level))
+					Privileges.emplace_back(xml);
+			}
+			else if("AuthenticationId" == name)
+				AuthenticationId = std::make_shared<XLUID>(xml);
+			else if("Type" == name)
+				Type = xml.Number<BYTE>();
+			else if("ImpersonationLevel" == name)
+				ImpersonationLevel = (SECURITY_IMPERSONATION_LEVEL)xml.Number<BYTE>();
+			else if("MandatoryPolicy" == name)
+				MandatoryPolicy = std::make_shared<XBITSET<32>>(xml, DwordMeaningMandatoryPolicy);
+			else if("Flags" == name)
+				Flags = std::make_shared<XBITSET<32>>(xml, DwordMeaningEmpty);
+			else if("AppContainerNumber" == name)
+				AppContainerNumber = xml.Number<DWORD>();
+			else if("PackageSid" == name)
+				PackageSid = std::make_shared<XSID>(xml);
+			else if("CapabilitiesHash" == name)
+			{
+				// "TrustLevelSid" is saved with the same name, it is always the second element
+				if(nullptr == CapabilitiesHash)
+					CapabilitiesHash = std::make_shared<XSID_AND_ATTRIBUTES_HASH>(xml, SidAndAttributesMeaningDefault);
+				else
+					TrustLevelSid = std::make_shared<XSID>(xml);
+			}
+			else if("TrustLevelSid" == name)
+				TrustLevelSid = std::make_shared<XSID>(xml);
+		}
+
+		#pragma region Additional check
+		if(nullptr == SidHash)
+			throw std::exception("TOKEN_ACCESS_INFORMATION: cannot find 'SidHash' XML node");
+
+		if(nullptr == RestrictedSidHash)
+			throw std::exception("TOKEN_ACCESS_INFORMATION: cannot find 'RestrictedSidHash' XML node");
+
+		if(nullptr == AuthenticationId)
+			throw std::exception("TOKEN_ACCESS_INFORMATION: cannot find 'AuthenticationId' XML node");
+
+		if(nullptr == MandatoryPolicy)
+			throw std::exception("TOKEN_ACCESS_INFORMATION: cannot find 'MandatoryPolicy' XML node");
+
+		if(nullptr == Flags)
+			throw std::exception("TOKEN_ACCESS_INFORMATION: cannot find 'Flags' XML node");
+
+		if(nullptr == CapabilitiesHash)
+			throw std::exception("TOKEN_ACCESS_INFORMATION: cannot find 'CapabilitiesHash' XML node");
+		#pragma endregion
+	}
+	//****************************************************************************************
 	XTOKEN_ACCESS_INFORMATION::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -491,6 +632,47 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XTOKEN_ACCESS_INFORMATION::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == SidHash) || (nullptr == RestrictedSidHash) || (nullptr == AuthenticationId) || (nullptr == CapabilitiesHash))
+			throw std::exception("TOKEN_ACCESS_INFORMATION: initialize data first");
+
+		xml.Start(root.value_or("TokeAccessInformation"));
+
+		SidHash->Write(xml, "SidHash");
+		RestrictedSidHash->Write(xml, "RestrictedSidHash");
+
+		#pragma region Privileges
+		xml.Start("Privileges");
+
+		for(auto&& element : Privileges)
+			element.Write(xml, "Privilege");
+
+		xml.End();
+		#pragma endregion
+
+		AuthenticationId->Write(xml, "AuthenticationId");
+
+		xml.Element("Type", Type);
+		xml.Element("ImpersonationLevel", (DWORD)ImpersonationLevel);
+
+		MandatoryPolicy->Write(xml, "MandatoryPolicy");
+		Flags->Write(xml, "Flags");
+
+		xml.Element("AppContainerNumber", AppContainerNumber);
+
+		if(nullptr != PackageSid)
+			PackageSid->Write(xml, "PackageSid");
+
+		CapabilitiesHash->Write(xml, "CapabilitiesHash");
+
+		// Same element name as "operator xml_t" uses, for compatibility of saved files
+		if(nullptr != TrustLevelSid)
+			TrustLevelSid->Write(xml, "CapabilitiesHash");
+
+		xml.End();
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Class for working with TOKEN_SOURCE structure
@@ -504,9 +686,11 @@ namespace XSEC
 
 		XTOKEN_SOURCE(const TOKEN_SOURCE&);
 		XTOKEN_SOURCE(const msxml_et&);
+		XTOKEN_SOURCE(XXML_READER&);
 
 		explicit operator TOKEN_SOURCE() const;
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::string SourceName;
 		std::shared_ptr<XLUID> Luid;
@@ -548,6 +732,29 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XTOKEN_SOURCE::XTOKEN_SOURCE(XXML_READER& xml)
+	{
+		bool sourceName = false;
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			if("SourceName" == xml.Name())
+			{
+				SourceName = xml.Text();
+				sourceName = true;
+			}
+			else if("LUID" == xml.Name())
+				Luid = std::make_shared<XLUID>(xml);
+		}
+
+		if(false == sourceName)
+			throw std::exception("TOKEN_SOURCE: cannot find 'SourceName' XML node");
+
+		if(nullptr == Luid)
+			throw std::exception("TOKEN_SOURCE: cannot find 'LUID' XML node");
+	}
+	//****************************************************************************************
 	XTOKEN_SOURCE::operator TOKEN_SOURCE() const
 	{
 		TOKEN_SOURCE result{};
@@ -594,6 +801,19 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XTOKEN_SOURCE::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if(nullptr == Luid)
+			throw std::exception("TOKEN_SOURCE: initialize data first");
+
+		xml.Start(root.value_or("TOKEN_SOURCE"));
+
+		xml.Element("SourceName", SourceName);
+		Luid->Write(xml, "LUID");
+
+		xml.End();
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Class for working with TOKEN_STATISTICS structure
@@ -618,8 +838,10 @@ namespace XSEC
 
 		XTOKEN_STATISTICS(const TOKEN_STATISTICS&);
 		XTOKEN_STATISTICS(const msxml_et&);
+		XTOKEN_STATISTICS(XXML_READER&);
 
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 
 		std::shared_ptr<XLUID> TokenId;
 		std::shared_ptr<XLUID> AuthenticationId; // Logon session LUID
@@ -762,6 +984,47 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XTOKEN_STATISTICS::XTOKEN_STATISTICS(XXML_READER& xml)
+	{
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+
+			if("TokenId" == name)
+				TokenId = std::make_shared<XLUID>(xml);
+			else if("AuthenticationId" == name)
+				AuthenticationId = std::make_shared<XLUID>(xml);
+			else if("ExpirationTime" == name)
+				ExpirationTime = xml.Number<__int64>();
+			else if("TokenType" == name)
+				TokenType = (TOKEN_TYPE)xml.Number<BYTE>();
+			else if("ImpersonationLevel" == name)
+				ImpersonationLevel = (SECURITY_IMPERSONATION_LEVEL)xml.Number<BYTE>();
+			else if("DynamicCharged" == name)
+				DynamicCharged = xml.Number<DWORD>();
+			else if("DynamicAvailable" == name)
+				DynamicAvailable = xml.Number<DWORD>();
+			else if("GroupCount" == name)
+				GroupCount = xml.Number<DWORD>();
+			else if("PrivilegeCount" == name)
+				PrivilegeCount = xml.Number<DWORD>();
+			else if("ModifiedId" == name)
+				ModifiedId = std::make_shared<XLUID>(xml);
+		}
+
+		#pragma region Additional check
+		if(nullptr == TokenId)
+			throw std::exception("TOKEN_STATISTICS: cannot find 'TokenId' XML node");
+
+		if(nullptr == AuthenticationId)
+			throw std::exception("TOKEN_STATISTICS: cannot find 'AuthenticationId' XML node");
+
+		if(nullptr == ModifiedId)
+			throw std::exception("TOKEN_STATISTICS: cannot find 'ModifiedId' XML node");
+		#pragma endregion
+	}
+	//****************************************************************************************
 	XTOKEN_STATISTICS::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -872,6 +1135,29 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XTOKEN_STATISTICS::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		if((nullptr == TokenId) || (nullptr == AuthenticationId) || (nullptr == ModifiedId))
+			throw std::exception("TOKEN_STATISTICS: initialize data first");
+
+		xml.Start(root.value_or("TOKEN_STATISTICS"));
+
+		TokenId->Write(xml, "TokenId");
+		AuthenticationId->Write(xml, "AuthenticationId");
+
+		xml.Element("ExpirationTime", ExpirationTime);
+		xml.Element("TokenType", (DWORD)TokenType);
+		xml.Element("ImpersonationLevel", (DWORD)ImpersonationLevel);
+		xml.Element("DynamicCharged", DynamicCharged);
+		xml.Element("DynamicAvailable", DynamicAvailable);
+		xml.Element("GroupCount", GroupCount);
+		xml.Element("PrivilegeCount", PrivilegeCount);
+
+		ModifiedId->Write(xml, "ModifiedId");
+
+		xml.End();
+	}
+	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
 	#pragma region Additional definitions
@@ -1281,6 +1567,84 @@ namespace XSEC
 	//****************************************************************************************
 	#pragma endregion
 	//****************************************************************************************
+	#pragma region Providers of raw token information
+	//****************************************************************************************
+	struct XTOKEN_INFO_PROVIDER
+	{
+		virtual ~XTOKEN_INFO_PROVIDER() = default;
+
+		// Buffer with the same layout as from "GetTokenInformation" (either "buffer" or memory owned by the provider),
+		// empty if the information is not available
+		virtual std::span<const unsigned char> Query(const HANDLE, const TOKEN_INFORMATION_CLASS&, bin_t& /*buffer*/) const = 0;
+		virtual std::shared_ptr<XSD> SecurityDescriptor(const HANDLE) const = 0;
+
+		static std::shared_ptr<const XTOKEN_INFO_PROVIDER> System(); // Information from real tokens
+	};
+	//****************************************************************************************
+	struct XTOKEN_INFO_SYSTEM : XTOKEN_INFO_PROVIDER
+	{
+		std::span<const unsigned char> Query(const HANDLE, const TOKEN_INFORMATION_CLASS&, bin_t&) const override;
+		std::shared_ptr<XSD> SecurityDescriptor(const HANDLE) const override;
+	};
+	//****************************************************************************************
+	std::shared_ptr<const XTOKEN_INFO_PROVIDER> XTOKEN_INFO_PROVIDER::System()
+	{
+		static std::shared_ptr<const XTOKEN_INFO_PROVIDER> result = std::make_shared<const XTOKEN_INFO_SYSTEM>();
+		return result;
+	}
+	//****************************************************************************************
+	std::span<const unsigned char> XTOKEN_INFO_SYSTEM::Query(const HANDLE token, const TOKEN_INFORMATION_CLASS& variant, bin_t& buffer) const
+	{
+		DWORD size = 0;
+
+		if(!GetTokenInformation(token, variant, nullptr, size, &size))
+		{
+			DWORD error = GetLastError();
+			if((ERROR_INSUFFICIENT_BUFFER != error) && (ERROR_BAD_LENGTH != error))
+				return {};
+		}
+
+		if(0 == size)
+			return {};
+
+		buffer.resize(size);
+
+		if(!GetTokenInformation(token, variant, buffer.data(), size, &size))
+			return {};
+
+		return std::span<const unsigned char>(buffer.data(), size);
+	}
+	//****************************************************************************************
+	std::shared_ptr<XSD> XTOKEN_INFO_SYSTEM::SecurityDescriptor(const HANDLE token) const
+	{
+		return std::make_shared<XSD>(XSD::GetFromKernelObject(token));
+	}
+	//****************************************************************************************
+	// Information stored in memory, for replaying captured tokens or for checking XTOKEN logic without real tokens.
+	// Buffers are set by "Allocate" and "Set" from "XTOKEN_INFO_STORE" (token_info.h).
+	struct XTOKEN_INFO_MEMORY : XTOKEN_INFO_PROVIDER, XTOKEN_INFO_STORE
+	{
+		XTOKEN_INFO_MEMORY() = default;
+		~XTOKEN_INFO_MEMORY() = default;
+
+		std::span<const unsigned char> Query(const HANDLE, const TOKEN_INFORMATION_CLASS&, bin_t&) const override;
+		std::shared_ptr<XSD> SecurityDescriptor(const HANDLE) const override;
+
+		std::shared_ptr<XSD> Descriptor;
+	};
+	//****************************************************************************************
+	std::span<const unsigned char> XTOKEN_INFO_MEMORY::Query(const HANDLE, const TOKEN_INFORMATION_CLASS& variant, bin_t&) const
+	{
+		return Find(variant);
+	}
+	//****************************************************************************************
+	std::shared_ptr<XSD> XTOKEN_INFO_MEMORY::SecurityDescriptor(const HANDLE) const
+	{
+		return Descriptor;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
 	#pragma region Major class for working with security tokens
 	//****************************************************************************************
 	struct XTOKEN
@@ -1289,11 +1653,34 @@ namespace XSEC
 		~XTOKEN() = default;
 
 		XTOKEN(const HANDLE, bool = false);
+		XTOKEN(const HANDLE, const DWORD64& /*Classes*/, const std::shared_ptr<const XTOKEN_INFO_PROVIDER>& = XTOKEN_INFO_PROVIDER::System(), bool = false);
 		XTOKEN(const msxml_et&);
+		XTOKEN(XXML_READER&, const DWORD64& /*Classes*/ = ClassAll); // Classes from "ClassXml" are always read
 
 		explicit operator xml_t() const;
+		void Write(XXML_WRITER&, std::optional<std::string_view> = std::nullopt) const;
 		explicit operator HANDLE() const;
 
+		#pragma region Selective loading of information
+		static constexpr DWORD64 Class(const TOKEN_INFORMATION_CLASS& value) { return token_class(value); }
+
+		static constexpr DWORD64 ClassSecurityDescriptor = 1; // Bit 0 is not used by TOKEN_INFORMATION_CLASS
+		static constexpr DWORD64 ClassAll = ~(DWORD64)0;
+
+		// Classes used by access check, the forward-only XML reader could skip all others
+		static constexpr DWORD64 ClassXml = ClassAll & ~(ClassSecurityDescriptor | Class(TokenDefaultDacl) | Class(TokenSource) | Class(TokenStatistics) | Class(TokenOrigin) | Class(TokenAccessInformation) | Class(TokenGroupsAndPrivileges));
+
+		// Classes used by "XACCESS_TOKEN", "XTOKEN_FINGERPRINT" and "XTOKEN_DIFF"
+		static constexpr DWORD64 ClassAccess = Class(TokenUser) | Class(TokenGroups) | Class(TokenDeviceGroups) | Class(TokenRestrictedSids) | Class(TokenRestrictedDeviceGroups);
+		static constexpr DWORD64 ClassFingerprint = ClassAccess | Class(TokenCapabilities) | Class(TokenPrivileges) | Class(TokenIntegrityLevel) | Class(TokenMandatoryPolicy) | Class(TokenUserClaimAttributes) | Class(TokenDeviceClaimAttributes) | Class(TokenSecurityAttributes);
+		static constexpr DWORD64 ClassDiff = ClassFingerprint | Class(TokenOwner) | Class(TokenPrimaryGroup) | Class(TokenElevationType);
+
+		XTOKEN& Load(const DWORD64& /*Classes*/); // Load only classes which were not loaded yet, does nothing for tokens from XML
+		void Require(const DWORD64& /*Classes*/, const char* /*consumer*/) const; // Throws if some of classes were not loaded
+
+		DWORD64 Loaded = 0;
+		#pragma endregion
+
 		template<TOKEN_INFORMATION_CLASS variant, typename is_variant_integral<token_info<variant>::variant>::type = VariantIntegral>
 		static typename token_info<variant>::type GetTokenInfo(const HANDLE token);
 
@@ -1303,6 +1690,15 @@ namespace XSEC
 		template<TOKEN_INFORMATION_CLASS variant, typename... Types, typename is_variant_vector<token_info<variant>::variant>::type = VariantVector>
 		static std::vector<typename token_info<variant>::type> GetTokenInfo(const HANDLE token, Types&&... args);
 
+		template<TOKEN_INFORMATION_CLASS variant, typename is_variant_integral<token_info<variant>::variant>::type = VariantIntegral>
+		static typename token_info<variant>::type GetTokenInfo(const XTOKEN_INFO_PROVIDER&, const HANDLE token);
+
+		template<TOKEN_INFORMATION_CLASS variant, typename... Types, typename is_variant_pointer<token_info<variant>::variant>::type = VariantPointer>
+		static std::shared_ptr<typename token_info<variant>::type> GetTokenInfo(const XTOKEN_INFO_PROVIDER&, const HANDLE token, Types&&... args);
+
+		template<TOKEN_INFORMATION_CLASS variant, typename... Types, typename is_variant_vector<token_info<variant>::variant>::type = VariantVector>
+		static std::vector<typename token_info<variant>::type> GetTokenInfo(const XTOKEN_INFO_PROVIDER&, const HANDLE token, Types&&... args);
+
 		static BOOL ChangePrivileges(const HANDLE, const std::vector<XLUID>&, const DWORD& = SE_PRIVILEGE_ENABLED);
 		static BOOL ChangePrivileges(const std::vector<std::wstring>&, const HANDLE, const DWORD& = SE_PRIVILEGE_ENABLED);
 
@@ -1374,46 +1770,54 @@ namespace XSEC
 		// This structure participates only in case of call to "operator HANDLE"
 		CREATE_PARAMETERS CreateParameters{};
 		#pragma endregion
+
+	private:
+		std::shared_ptr<const XTOKEN_INFO_PROVIDER> provider; // Empty for tokens made from XML
 	};
 	//****************************************************************************************
 	template<TOKEN_INFORMATION_CLASS variant, typename is_variant_integral<token_info<variant>::variant>::type>
 	typename token_info<variant>::type XTOKEN::GetTokenInfo(const HANDLE token)
 	{
-		DWORD size = 0;
+		return GetTokenInfo<variant>(*XTOKEN_INFO_PROVIDER::System(), token);
+	};
+	//****************************************************************************************
+	template<TOKEN_INFORMATION_CLASS variant, typename... Types, typename is_variant_pointer<token_info<variant>::variant>::type>
+	std::shared_ptr<typename token_info<variant>::type> XTOKEN::GetTokenInfo(const HANDLE token, Types&&... args)
+	{
+		return GetTokenInfo<variant>(*XTOKEN_INFO_PROVIDER::System(), token, std::forward<Types>(args)...);
+	};
+	//****************************************************************************************
+	template<TOKEN_INFORMATION_CLASS variant, typename... Types, typename is_variant_vector<token_info<variant>::variant>::type>
+	std::vector<typename token_info<variant>::type> XTOKEN::GetTokenInfo(const HANDLE token, Types&&... args)
+	{
+		return GetTokenInfo<variant>(*XTOKEN_INFO_PROVIDER::System(), token, std::forward<Types>(args)...);
+	};
+	//****************************************************************************************
+	template<TOKEN_INFORMATION_CLASS variant, typename is_variant_integral<token_info<variant>::variant>::type>
+	typename token_info<variant>::type XTOKEN::GetTokenInfo(const XTOKEN_INFO_PROVIDER& provider, const HANDLE token)
+	{
+		bin_t buffer;
 
-		if(!GetTokenInformation(token, variant, nullptr, size, &size))
-		{
-			DWORD error = GetLastError();
-			if((ERROR_INSUFFICIENT_BUFFER != error) && (ERROR_BAD_LENGTH != error))
-				return typename token_info<variant>::type{};
-		}
+		auto data = provider.Query(token, variant, buffer);
+		if(data.size() < sizeof(typename token_info<variant>::raw))
+			return typename token_info<variant>::type{};
 
 		typename token_info<variant>::raw result{};
-
-		if(!GetTokenInformation(token, variant, &result, size, &size))
-			return typename token_info<variant>::type{};
+		memcpy(&result, data.data(), sizeof(result));
 
 		return get_result<variant>(result);
 	};
 	//****************************************************************************************
 	template<TOKEN_INFORMATION_CLASS variant, typename... Types, typename is_variant_pointer<token_info<variant>::variant>::type>
-	std::shared_ptr<typename token_info<variant>::type> XTOKEN::GetTokenInfo(const HANDLE token, Types&&... args)
+	std::shared_ptr<typename token_info<variant>::type> XTOKEN::GetTokenInfo(const XTOKEN_INFO_PROVIDER& provider, const HANDLE token, Types&&... args)
 	{
-		DWORD size = 0;
-
-		if(!GetTokenInformation(token, variant, nullptr, size, &size))
-		{
-			DWORD error = GetLastError();
-			if((ERROR_INSUFFICIENT_BUFFER != error) && (ERROR_BAD_LENGTH != error))
-				return nullptr;
-		}
-
-		std::unique_ptr<typename token_info<variant>::raw> buffer{ static_cast<typename token_info<variant>::raw*>(::operator new(size)) };
+		bin_t buffer;
 
-		if(!GetTokenInformation(token, variant, buffer.get(), size, &size))
+		auto data = provider.Query(token, variant, buffer);
+		if(data.size() < sizeof(typename token_info<variant>::raw))
 			return nullptr;
 
-		auto element = get_element<variant>(buffer.get());
+		auto element = get_element<variant>((typename token_info<variant>::raw*)data.data());
 		if(false == check_pointer(element))
 		{
 			auto result = std::make_shared<typename token_info<variant>::type>(element, std::forward<Types>(args)...);
@@ -1424,27 +1828,21 @@ namespace XSEC
 	};
 	//****************************************************************************************
 	template<TOKEN_INFORMATION_CLASS variant, typename... Types, typename is_variant_vector<token_info<variant>::variant>::type>
-	std::vector<typename token_info<variant>::type> XTOKEN::GetTokenInfo(const HANDLE token, Types&&... args)
+	std::vector<typename token_info<variant>::type> XTOKEN::GetTokenInfo(const XTOKEN_INFO_PROVIDER& provider, const HANDLE token, Types&&... args)
 	{
-		DWORD size = 0;
+		bin_t buffer;
 
-		if(!GetTokenInformation(token, variant, nullptr, size, &size))
-		{
-			DWORD error = GetLastError();
-			if((ERROR_INSUFFICIENT_BUFFER != error) && (ERROR_BAD_LENGTH != error))
-				return std::vector<typename token_info<variant>::type>{};
-		}
+		auto data = provider.Query(token, variant, buffer);
+		if(data.size() < sizeof(typename token_info<variant>::raw))
+			return std::vector<typename token_info<variant>::type>{};
 
-		std::unique_ptr<typename token_info<variant>::raw> buffer{ static_cast<typename token_info<variant>::raw*>(::operator new(size)) };
-
-		if(!GetTokenInformation(token, variant, buffer.get(), size, &size))
-			std::vector<typename token_info<variant>::type>{};
+		auto raw = (typename token_info<variant>::raw*)data.data();
 
 		std::vector<typename token_info<variant>::type> result;
 
-		for(typename token_info<variant>::count_type i = 0; i < std::invoke(token_info<variant>::count, buffer.get()); i++)
+		for(typename token_info<variant>::count_type i = 0; i < std::invoke(token_info<variant>::count, raw); i++)
 		{
-			auto element = get_element<variant>(buffer.get(), i);
+			auto element = get_element<variant>(raw, i);
 			if(!check_pointer(element))
 				result.push_back(typename token_info<variant>::type{ element, std::forward<Types>(args)... });
 		}
@@ -1452,61 +1850,124 @@ namespace XSEC
 		return result;
 	};
 	//****************************************************************************************
-	XTOKEN::XTOKEN(const HANDLE token, bool isLinkedToken) : Token(token), IsLinkedToken(isLinkedToken)
-	{
-		SecurityDescriptor = std::make_shared<XSD>(XSD::GetFromKernelObject(token));
-
-		User = XTOKEN::GetTokenInfo<TokenUser>(token);
-		Groups = XTOKEN::GetTokenInfo<TokenGroups>(token);
-		Privileges = XTOKEN::GetTokenInfo<TokenPrivileges>(token);
-		Owner = XTOKEN::GetTokenInfo<TokenOwner>(token);
-		PrimaryGroup = XTOKEN::GetTokenInfo<TokenPrimaryGroup>(token);
-		DefaultDacl = XTOKEN::GetTokenInfo<TokenDefaultDacl>(token, DwordMeaningToken);
-		Source = XTOKEN::GetTokenInfo<TokenSource>(token);
-		Type = XTOKEN::GetTokenInfo<TokenType>(token);
-		ImpersonationLevel = XTOKEN::GetTokenInfo<TokenImpersonationLevel>(token);
-		Statistics = XTOKEN::GetTokenInfo<TokenStatistics>(token);
-		RestrictedSids = XTOKEN::GetTokenInfo<TokenRestrictedSids>(token);
-		SessionId = XTOKEN::GetTokenInfo<TokenSessionId>(token);
-		GroupsAndPrivileges = XTOKEN::GetTokenInfo<TokenGroupsAndPrivileges>(token);
-		// TokenSessionReference - Reserved
-		SandBoxInert = XTOKEN::GetTokenInfo<TokenSandBoxInert>(token);
-		// TokenAuditPolicy - Reserved
-		Origin = XTOKEN::GetTokenInfo<TokenOrigin>(token);
-		ElevationType = XTOKEN::GetTokenInfo<TokenElevationType>(token);
-		LinkedToken = (isLinkedToken) ? nullptr : XTOKEN::GetTokenInfo<TokenLinkedToken>(token, true);
-		Elevation = XTOKEN::GetTokenInfo<TokenElevation>(token);
-		HasRestrictions = XTOKEN::GetTokenInfo<TokenHasRestrictions>(token);
-		AccessInformation = XTOKEN::GetTokenInfo<TokenAccessInformation>(token);
-		VirtualizationAllowed = XTOKEN::GetTokenInfo<TokenVirtualizationAllowed>(token);
-		VirtualizationEnabled = XTOKEN::GetTokenInfo<TokenVirtualizationEnabled>(token);
-		IntegrityLevel = XTOKEN::GetTokenInfo<TokenIntegrityLevel>(token);
-		UIAccess = XTOKEN::GetTokenInfo<TokenUIAccess>(token);
-		MandatoryPolicy = XTOKEN::GetTokenInfo<TokenMandatoryPolicy>(token, DwordMeaningMandatoryPolicy);
-		LogonSid = XTOKEN::GetTokenInfo<TokenLogonSid>(token);
-		IsAppContainer = XTOKEN::GetTokenInfo<TokenIsAppContainer>(token);
-		Capabilities = XTOKEN::GetTokenInfo<TokenCapabilities>(token);
-		AppContainerSid = XTOKEN::GetTokenInfo<TokenAppContainerSid>(token);
-		AppContainerNumber = XTOKEN::GetTokenInfo<TokenAppContainerNumber>(token);
-		UserClaimAttributes = XTOKEN::GetTokenInfo<TokenUserClaimAttributes>(token);
-		DeviceClaimAttributes = XTOKEN::GetTokenInfo<TokenDeviceClaimAttributes>(token);
-		// TokenRestrictedUserClaimAttributes - Reserved
-		// TokenRestrictedDeviceClaimAttributes - Reserved
-		DeviceGroups = XTOKEN::GetTokenInfo<TokenDeviceGroups>(token);
-		RestrictedDeviceGroups = XTOKEN::GetTokenInfo<TokenRestrictedDeviceGroups>(token);
-		SecurityAttributes = XTOKEN::GetTokenInfo<TokenSecurityAttributes>(token);
-		// TokenIsRestricted - Reserved
-		// TokenProcessTrustLevel - Reserved (?)
-		// TokenPrivateNameSpace - Reserved (?)
-		SingletonAttributes = XTOKEN::GetTokenInfo<TokenSingletonAttributes>(token);
-		// TokenBnoIsolation - Reserved (?)
-		// TokenChildProcessFlags - Reserved
-		// TokenIsLessPrivilegedAppContainer - Reserved
-		// TokenIsSandboxed - Reserved
-		// TokenOriginatingProcessTrustLevel - Reserved
+	XTOKEN::XTOKEN(const HANDLE token, bool isLinkedToken) : XTOKEN(token, ClassAll, XTOKEN_INFO_PROVIDER::System(), isLinkedToken)
+	{
+	}
+	//****************************************************************************************
+	XTOKEN::XTOKEN(const HANDLE token, const DWORD64& classes, const std::shared_ptr<const XTOKEN_INFO_PROVIDER>& _provider, bool isLinkedToken) : Token(token), IsLinkedToken(isLinkedToken), provider(_provider)
+	{
+		if(nullptr == provider)
+			throw std::exception("XTOKEN: invalid provider of token information");
+
+		Load(classes);
+	}
+	//****************************************************************************************
+	void XTOKEN::Require(const DWORD64& classes, const char* consumer) const
+	{
+		require_classes(Loaded, classes, consumer);
 	}
 	//****************************************************************************************
-	XTOKEN::XTOKEN(const msxml_et& xml)
+	XTOKEN& XTOKEN::Load(const DWORD64& classes)
+	{
+		// Linked token always has at least the same classes as the current one, see "load_classes"
+		return load_classes(*this, classes, (nullptr != provider), [this](const DWORD64& required, const DWORD64& linked)
+		{
+			const XTOKEN_INFO_PROVIDER& source = *provider;
+			HANDLE token = Token;
+
+			auto needed = [required](const TOKEN_INFORMATION_CLASS& value){ return (0 != (required & Class(value))); };
+
+			if(required & ClassSecurityDescriptor)
+				SecurityDescriptor = source.SecurityDescriptor(token);
+
+			if(needed(TokenUser))
+				User = XTOKEN::GetTokenInfo<TokenUser>(source, token);
+			if(needed(TokenGroups))
+				Groups = XTOKEN::GetTokenInfo<TokenGroups>(source, token);
+			if(needed(TokenPrivileges))
+				Privileges = XTOKEN::GetTokenInfo<TokenPrivileges>(source, token);
+			if(needed(TokenOwner))
+				Owner = XTOKEN::GetTokenInfo<TokenOwner>(source, token);
+			if(needed(TokenPrimaryGroup))
+				PrimaryGroup = XTOKEN::GetTokenInfo<TokenPrimaryGroup>(source, token);
+			if(needed(TokenDefaultDacl))
+				DefaultDacl = XTOKEN::GetTokenInfo<TokenDefaultDacl>(source, token, DwordMeaningToken);
+			if(needed(TokenSource))
+				Source = XTOKEN::GetTokenInfo<TokenSource>(source, token);
+			if(needed(TokenType))
+				Type = XTOKEN::GetTokenInfo<TokenType>(source, token);
+			if(needed(TokenImpersonationLevel))
+				ImpersonationLevel = XTOKEN::GetTokenInfo<TokenImpersonationLevel>(source, token);
+			if(needed(TokenStatistics))
+				Statistics = XTOKEN::GetTokenInfo<TokenStatistics>(source, token);
+			if(needed(TokenRestrictedSids))
+				RestrictedSids = XTOKEN::GetTokenInfo<TokenRestrictedSids>(source, token);
+			if(needed(TokenSessionId))
+				SessionId = XTOKEN::GetTokenInfo<TokenSessionId>(source, token);
+			if(needed(TokenGroupsAndPrivileges))
+				GroupsAndPrivileges = XTOKEN::GetTokenInfo<TokenGroupsAndPrivileges>(source, token);
+			// TokenSessionReference - Reserved
+			if(needed(TokenSandBoxInert))
+				SandBoxInert = XTOKEN::GetTokenInfo<TokenSandBoxInert>(source, token);
+			// TokenAuditPolicy - Reserved
+			if(needed(TokenOrigin))
+				Origin = XTOKEN::GetTokenInfo<TokenOrigin>(source, token);
+			if(needed(TokenElevationType))
+				ElevationType = XTOKEN::GetTokenInfo<TokenElevationType>(source, token);
+			if(needed(TokenLinkedToken)) // Linked token is loaded with all classes of the current one
+				LinkedToken = (IsLinkedToken) ? nullptr : XTOKEN::GetTokenInfo<TokenLinkedToken>(source, token, linked, provider, true);
+			if(needed(TokenElevation))
+				Elevation = XTOKEN::GetTokenInfo<TokenElevation>(source, token);
+			if(needed(TokenHasRestrictions))
+				HasRestrictions = XTOKEN::GetTokenInfo<TokenHasRestrictions>(source, token);
+			if(needed(TokenAccessInformation))
+				AccessInformation = XTOKEN::GetTokenInfo<TokenAccessInformation>(source, token);
+			if(needed(TokenVirtualizationAllowed))
+				VirtualizationAllowed = XTOKEN::GetTokenInfo<TokenVirtualizationAllowed>(source, token);
+			if(needed(TokenVirtualizationEnabled))
+				VirtualizationEnabled = XTOKEN::GetTokenInfo<TokenVirtualizationEnabled>(source, token);
+			if(needed(TokenIntegrityLevel))
+				IntegrityLevel = XTOKEN::GetTokenInfo<TokenIntegrityLevel>(source, token);
+			if(needed(TokenUIAccess))
+				UIAccess = XTOKEN::GetTokenInfo<TokenUIAccess>(source, token);
+			if(needed(TokenMandatoryPolicy))
+				MandatoryPolicy = XTOKEN::GetTokenInfo<TokenMandatoryPolicy>(source, token, DwordMeaningMandatoryPolicy);
+			if(needed(TokenLogonSid))
+				LogonSid = XTOKEN::GetTokenInfo<TokenLogonSid>(source, token);
+			if(needed(TokenIsAppContainer))
+				IsAppContainer = XTOKEN::GetTokenInfo<TokenIsAppContainer>(source, token);
+			if(needed(TokenCapabilities))
+				Capabilities = XTOKEN::GetTokenInfo<TokenCapabilities>(source, token);
+			if(needed(TokenAppContainerSid))
+				AppContainerSid = XTOKEN::GetTokenInfo<TokenAppContainerSid>(source, token);
+			if(needed(TokenAppContainerNumber))
+				AppContainerNumber = XTOKEN::GetTokenInfo<TokenAppContainerNumber>(source, token);
+			if(needed(TokenUserClaimAttributes))
+				UserClaimAttributes = XTOKEN::GetTokenInfo<TokenUserClaimAttributes>(source, token);
+			if(needed(TokenDeviceClaimAttributes))
+				DeviceClaimAttributes = XTOKEN::GetTokenInfo<TokenDeviceClaimAttributes>(source, token);
+			// TokenRestrictedUserClaimAttributes - Reserved
+			// TokenRestrictedDeviceClaimAttributes - Reserved
+			if(needed(TokenDeviceGroups))
+				DeviceGroups = XTOKEN::GetTokenInfo<TokenDeviceGroups>(source, token);
+			if(needed(TokenRestrictedDeviceGroups))
+				RestrictedDeviceGroups = XTOKEN::GetTokenInfo<TokenRestrictedDeviceGroups>(source, token);
+			if(needed(TokenSecurityAttributes))
+				SecurityAttributes = XTOKEN::GetTokenInfo<TokenSecurityAttributes>(source, token);
+			// TokenIsRestricted - Reserved
+			// TokenProcessTrustLevel - Reserved (?)
+			// TokenPrivateNameSpace - Reserved (?)
+			if(needed(TokenSingletonAttributes))
+				SingletonAttributes = XTOKEN::GetTokenInfo<TokenSingletonAttributes>(source, token);
+			// TokenBnoIsolation - Reserved (?)
+			// TokenChildProcessFlags - Reserved
+			// TokenIsLessPrivilegedAppContainer - Reserved
+			// TokenIsSandboxed - Reserved
+			// TokenOriginatingProcessTrustLevel - Reserved
+		});
+	}
+	//****************************************************************************************
+	XTOKEN::XTOKEN(const msxml_et& xml) : Loaded(ClassAll)
 	{
 		#pragma region Additional check
 		if(nullptr == xml)
@@ -1792,6 +2253,146 @@ namespace XSEC
 		#pragma endregion
 	}
 	//****************************************************************************************
+	XTOKEN::XTOKEN(XXML_READER& xml, const DWORD64& classes) : Loaded(classes | ClassXml), ImpersonationLevel(SecurityAnonymous)
+	{
+		// Elements of classes which were not requested are skipped without parsing
+		auto list = [&xml](std::vector<XSID_AND_ATTRIBUTES>& values)
+		{
+			size_t level = xml.Depth();
+			while(xml.Child(level))
+				values.emplace_back(xml);
+		};
+
+		size_t depth = xml.Depth();
+		while(xml.Child(depth))
+		{
+			std::string_view name = xml.Name();
+
+			#pragma region SIDs and lists
+			if("User" == name)
+				User = std::make_shared<XSID_AND_ATTRIBUTES>(xml);
+			else if("Groups" == name)
+				list(Groups);
+			else if("Privileges" == name)
+			{
+				size_t level = xml.Depth();
+				while(xml.Child(level))
+					Privileges.emplace_back(xml);
+			}
+			else if("Owner" == name)
+				Owner = std::make_shared<XSID>(xml);
+			else if("AppContainerSid" == name)
+				AppContainerSid = std::make_shared<XSID>(xml);
+			else if("PrimaryGroup" == name)
+				PrimaryGroup = std::make_shared<XSID>(xml);
+			else if("LinkedToken" == name)
+				LinkedToken = std::make_shared<XTOKEN>(xml, classes);
+			else if("RestrictedSids" == name)
+				list(RestrictedSids);
+			else if("IntegrityLevel" == name)
+				IntegrityLevel = std::make_shared<XSID_AND_ATTRIBUTES>(xml);
+			else if("LogonSids" == name)
+				list(LogonSid);
+			else if("Capabilities" == name)
+				list(Capabilities);
+			else if("DeviceGroups" == name)
+				list(DeviceGroups);
+			else if("RestrictedDeviceGroups" == name)
+				list(RestrictedDeviceGroups);
+			else if("MandatoryPolicy" == name)
+				MandatoryPolicy = std::make_shared<XBITSET<32>>(xml, DwordMeaningMandatoryPolicy);
+			#pragma endregion
+			#pragma region Information classes not used by access check
+			else if("SecurityDescriptor" == name)
+			{
+				if(Loaded & ClassSecurityDescriptor)
+					SecurityDescriptor = std::make_shared<XSD>(xml, DwordMeaningToken);
+			}
+			else if("DefaultDacl" == name)
+			{
+				if(Loaded & Class(TokenDefaultDacl))
+					DefaultDacl = std::make_shared<XACL>(xml, DwordMeaningToken);
+			}
+			else if("Source" == name)
+			{
+				if(Loaded & Class(TokenSource))
+					Source = std::make_shared<XTOKEN_SOURCE>(xml);
+			}
+			else if("Origin" == name)
+			{
+				if(Loaded & Class(TokenOrigin))
+					Origin = std::make_shared<XLUID>(xml);
+			}
+			else if("Statistics" == name)
+			{
+				if(Loaded & Class(TokenStatistics))
+					Statistics = std::make_shared<XTOKEN_STATISTICS>(xml);
+			}
+			else if("AccessInformation" == name)
+			{
+				if(Loaded & Class(TokenAccessInformation))
+					AccessInformation = std::make_shared<XTOKEN_ACCESS_INFORMATION>(xml);
+			}
+			else if("GroupsAndPrivileges" == name)
+			{
+				if(Loaded & Class(TokenGroupsAndPrivileges))
+					GroupsAndPrivileges = std::make_shared<XTOKEN_GROUPS_AND_PRIVILEGES>(xml);
+			}
+			#pragma endregion
+			#pragma region Claims
+			else if("SecurityAttributes" == name)
+				SecurityAttributes = std::make_shared<XSECURITY_ATTRIBUTES_INFORMATION>(xml);
+			else if("UserClaimAttributes" == name)
+				UserClaimAttributes = std::make_shared<XSECURITY_ATTRIBUTES_INFORMATION>(xml);
+			else if("DeviceClaimAttributes" == name)
+				DeviceClaimAttributes = std::make_shared<XSECURITY_ATTRIBUTES_INFORMATION>(xml);
+			#pragma endregion
+			#pragma region Scalars
+			else if("Type" == name)
+				Type = xml.Number<BYTE>();
+			else if("ImpersonationLevel" == name)
+				ImpersonationLevel = (SECURITY_IMPERSONATION_LEVEL)xml.Number<BYTE>();
+			else if("SessionId" == name)
+				SessionId = xml.Number<DWORD>();
+			else if("Elevation" == name)
+				Elevation = xml.Number<DWORD>();
+			else if("HasRestrictions" == name)
+				HasRestrictions = xml.Number<DWORD>();
+			else if("ElevationType" == name)
+				ElevationType = (TOKEN_ELEVATION_TYPE)xml.Number<BYTE>();
+			else if("UIAccess" == name)
+				UIAccess = xml.Number<DWORD>();
+			else if("AppContainerNumber" == name)
+				AppContainerNumber = xml.Number<DWORD>();
+			else if("IsAppContainer" == name)
+				IsAppContainer = xml.Number<DWORD>();
+			else if("SandBoxInert" == name)
+				SandBoxInert = xml.Number<DWORD>();
+			else if("VirtualizationAllowed" == name)
+				VirtualizationAllowed = xml.Number<DWORD>();
+			else if("VirtualizationEnabled" == name)
+				VirtualizationEnabled = xml.Number<DWORD>();
+			#pragma endregion
+		}
+
+		#pragma region Additional check
+		if(nullptr == User)
+			throw std::exception("XTOKEN: cannot find 'User' XML node");
+
+		if(nullptr == Owner)
+			throw std::exception("XTOKEN: cannot find 'Owner' XML node");
+
+		if(nullptr == PrimaryGroup)
+			throw std::exception("XTOKEN: cannot find 'PrimaryGroup' XML node");
+
+		if(nullptr == IntegrityLevel)
+			throw std::exception("XTOKEN: cannot find 'IntegrityLevel' XML node");
+
+		if(nullptr == MandatoryPolicy)
+			throw std::exception("XTOKEN: cannot find 'MandatoryPolicy' XML node");
+		#pragma endregion
+	}
+	//****************************************************************************************
 	XTOKEN::operator xml_t() const
 	{
 		return[&](msxml_dt xml, std::optional<const wchar_t*> root)->msxml_et
@@ -2105,6 +2706,122 @@ namespace XSEC
 		};
 	}
 	//****************************************************************************************
+	void XTOKEN::Write(XXML_WRITER& xml, std::optional<std::string_view> root) const
+	{
+		#pragma region Additional check
+		if((nullptr == Owner) || (nullptr == User) || (nullptr == PrimaryGroup))
+			throw std::exception("XTOKEN: initialize data first");
+		#pragma endregion
+
+		auto list = [&xml](std::string_view name, std::string_view item, const std::vector<XSID_AND_ATTRIBUTES>& values)
+		{
+			xml.Start(name);
+
+			for(auto&& element : values)
+				element.Write(xml, item);
+
+			xml.End();
+		};
+
+		xml.Start(root.value_or("Token"));
+
+		#pragma region SIDs and lists
+		if(SecurityDescriptor)
+			SecurityDescriptor->Write(xml, "SecurityDescriptor");
+
+		if(SecurityAttributes)
+			SecurityAttributes->Write(xml, "SecurityAttributes");
+
+		User->Write(xml, "User");
+
+		list("Groups", "Group", Groups);
+
+		xml.Start("Privileges");
+
+		for(auto&& element : Privileges)
+			element.Write(xml, "Privilege");
+
+		xml.End();
+
+		Owner->Write(xml, "Owner");
+
+		if(nullptr != AppContainerSid)
+			AppContainerSid->Write(xml, "AppContainerSid");
+
+		PrimaryGroup->Write(xml, "PrimaryGroup");
+
+		if(nullptr != LinkedToken) // The LinkedToken could be achived only if user is in admin group
+			LinkedToken->Write(xml, "LinkedToken");
+
+		if(nullptr != DefaultDacl)
+			DefaultDacl->Write(xml, "DefaultDacl");
+
+		if(nullptr != Source)
+			Source->Write(xml, "Source");
+		#pragma endregion
+
+		#pragma region Scalars and lists in the same order as "operator xml_t" has
+		xml.Element("Type", Type);
+		xml.Element("ImpersonationLevel", (DWORD)ImpersonationLevel);
+
+		list("RestrictedSids", "RestrictedSid", RestrictedSids);
+
+		xml.Element("SessionId", SessionId);
+
+		if(nullptr != Origin)
+			Origin->Write(xml, "Origin");
+
+		xml.Element("Elevation", Elevation);
+		xml.Element("HasRestrictions", HasRestrictions);
+		xml.Element("ElevationType", (DWORD)ElevationType);
+
+		if(nullptr != IntegrityLevel)
+			IntegrityLevel->Write(xml, "IntegrityLevel");
+
+		xml.Element("UIAccess", UIAccess);
+
+		if(LogonSid.empty() == false) // Could be a situation when token is from SYSTEM account and has no LogonSID
+			list("LogonSids", "LogonSid", LogonSid);
+
+		if(Capabilities.empty() == false)
+			list("Capabilities", "Capability", Capabilities);
+
+		if(DeviceGroups.empty() == false)
+			list("DeviceGroups", "DeviceGroup", DeviceGroups);
+
+		if(RestrictedDeviceGroups.empty() == false)
+			list("RestrictedDeviceGroups", "RestrictedDeviceGroup", RestrictedDeviceGroups);
+
+		if(nullptr != Statistics)
+			Statistics->Write(xml, "Statistics");
+
+		if(nullptr != MandatoryPolicy)
+			MandatoryPolicy->Write(xml, "MandatoryPolicy");
+
+		xml.Element("AppContainerNumber", AppContainerNumber);
+		xml.Element("IsAppContainer", IsAppContainer);
+		xml.Element("SandBoxInert", SandBoxInert);
+		xml.Element("VirtualizationAllowed", VirtualizationAllowed);
+		xml.Element("VirtualizationEnabled", VirtualizationEnabled);
+		#pragma endregion
+
+		#pragma region Information classes
+		if(nullptr != AccessInformation)
+			AccessInformation->Write(xml, "AccessInformation");
+
+		if(nullptr != GroupsAndPrivileges)
+			GroupsAndPrivileges->Write(xml, "GroupsAndPrivileges");
+
+		if(nullptr != UserClaimAttributes)
+			UserClaimAttributes->Write(xml, "UserClaimAttributes");
+
+		if(nullptr != DeviceClaimAttributes)
+			DeviceClaimAttributes->Write(xml, "DeviceClaimAttributes");
+		#pragma endregion
+
+		xml.End();
+	}
+	//****************************************************************************************
 	XTOKEN::operator HANDLE() const
 	{
 		return XTOKEN::Create(
@@ -0,0 +1,128 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+
+#pragma once
+//********************************************************************************************
+// Selective loading of token information classes and the in-memory store of raw information.
+// Only the standard library is used, so the same logic is checked on any platform
+// (bench/token_info_check.cpp). "XTOKEN" and "XTOKEN_INFO_MEMORY" (token.h) are the Windows
+// adapters: class "n" is TOKEN_INFORMATION_CLASS "n", buffers have "GetTokenInformation" layout.
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <map>
+#include <string>
+#include <stdexcept>
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Masks of information classes
+	//****************************************************************************************
+	// Bit 0 is not used by TOKEN_INFORMATION_CLASS, so it is used for the security descriptor of a token
+	constexpr uint64_t token_class(const uint32_t& value) { return ((uint64_t)1 << value); }
+	//****************************************************************************************
+	// Loads classes not loaded yet. The linked token (if any) always gets at least the same
+	// classes as "token", so a partial linked token is never mixed with a full one.
+	// "T" has "Loaded" mask and "LinkedToken" pointer; "query(required, linked)" reads "required"
+	// classes, a linked token created there must be loaded with "linked" classes.
+	template<typename T, typename F>
+	T& load_classes(T& token, const uint64_t& classes, const bool& available, F&& query)
+	{
+		if(nullptr != token.LinkedToken)
+			token.LinkedToken->Load(classes);
+
+		uint64_t required = classes & ~token.Loaded;
+
+		// Tokens without a source (from XML or snapshots) have all the information they could have
+		if((0 == required) || (false == available))
+			return token;
+
+		query(required, token.Loaded | classes);
+		token.Loaded |= required;
+
+		return token;
+	}
+	//****************************************************************************************
+	// For consumers taking a constant token, which could not load missing classes by themselves
+	void require_classes(const uint64_t& loaded, const uint64_t& classes, const char* consumer)
+	{
+		uint64_t missing = classes & ~loaded;
+		if(0 == missing)
+			return;
+
+		char mask[17] = {};
+		for(size_t i = 0; i < 16; i++)
+			mask[i] = "0123456789ABCDEF"[(missing >> (60 - 4 * i)) & 0x0F];
+
+		throw std::invalid_argument(std::string(consumer) + ": token information classes are not loaded (mask " + mask + ")");
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Raw information stored in memory
+	//****************************************************************************************
+	// Pointers inside a buffer (for example SIDs in TOKEN_GROUPS) must point into the same buffer
+	struct XTOKEN_INFO_STORE
+	{
+		XTOKEN_INFO_STORE() = default;
+		~XTOKEN_INFO_STORE() = default;
+
+		unsigned char* Allocate(const uint32_t&, const size_t&); // Memory keeps its address while the store exists
+
+		template<typename T>
+		void Set(const uint32_t&, const T&); // For information without pointers inside
+
+		std::span<const unsigned char> Find(const uint32_t&) const; // Empty if the information is not available
+
+	private:
+		std::map<uint32_t, std::vector<unsigned char>> buffers;
+	};
+	//****************************************************************************************
+	unsigned char* XTOKEN_INFO_STORE::Allocate(const uint32_t& variant, const size_t& size)
+	{
+		std::vector<unsigned char>& result = buffers[variant];
+		result.assign(size, 0);
+
+		return result.data();
+	}
+	//****************************************************************************************
+	template<typename T>
+	void XTOKEN_INFO_STORE::Set(const uint32_t& variant, const T& value)
+	{
+		memcpy(Allocate(variant, sizeof(T)), &value, sizeof(T));
+	}
+	//****************************************************************************************
+	std::span<const unsigned char> XTOKEN_INFO_STORE::Find(const uint32_t& variant) const
+	{
+		auto find = buffers.find(variant);
+		if(buffers.end() == find)
+			return {};
+
+		return find->second;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -0,0 +1,804 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Claims transformation rules ([MS-CTA])
+	//****************************************************************************************
+	// Supported grammar (keywords are case-insensitive):
+	//   Rule      = [Condition *("&&" Condition)] "=>" "Issue" "(" Issue ")" ";"
+	//   Condition = [Identifier ":"] "[" [Test *("," Test)] "]"
+	//   Test      = ("Type" / "Value" / "ValueType") ("==" / "!=" / "=~" / "!~") String
+	//   Issue     = "Claim" "=" Identifier
+	//             / "Type" "=" Expr "," "Value" "=" Expr ["," "ValueType" "=" (String / Identifier "." "ValueType")]
+	//   Expr      = String / Identifier "." ("Type" / "Value")
+	//             / "RegExReplace" "(" Identifier "." ("Type" / "Value") "," String "," String ")"
+	//
+	// Claims are processed in the [MS-CTA] form: one claim for each value of INT64, UINT64, STRING and BOOLEAN attributes,
+	// with values as strings. Rules are applied in order, claims issued by a rule are visible to all following rules.
+	// All comparisons (including regular expressions) ignore case. Issued claims with the same type are merged
+	// into one attribute, values with a type different from the first issued claim are dropped.
+	struct XCLAIMS_TRANSFORMATION
+	{
+		XCLAIMS_TRANSFORMATION() = delete;
+		~XCLAIMS_TRANSFORMATION() = default;
+
+		XCLAIMS_TRANSFORMATION(std::wstring_view); // Compile rules
+
+		XSECURITY_ATTRIBUTES_INFORMATION Apply(const XSECURITY_ATTRIBUTES_INFORMATION&) const;
+
+		// Each claims set is transformed independently, "0" threads means number of logical processors
+		std::vector<XSECURITY_ATTRIBUTES_INFORMATION> Apply(std::span<const XSECURITY_ATTRIBUTES_INFORMATION* const>, const size_t& /*Threads*/ = 0) const;
+
+	private:
+		#pragma region Compiled rules
+		enum class property_t : unsigned char
+		{
+			Type,
+			Value,
+			ValueType
+		};
+
+		struct test_t
+		{
+			property_t Property = property_t::Type;
+			unsigned char Code = 0; // 0 - "==", 1 - "!=", 2 - "=~", 3 - "!~"
+			std::wstring Literal;
+			std::optional<std::wregex> Regex;
+		};
+
+		struct condition_t
+		{
+			std::vector<test_t> Tests;
+		};
+
+		struct expression_t
+		{
+			std::wstring Literal; // Used if "Condition" is not set
+			std::optional<size_t> Condition; // Index of condition inside the rule
+			property_t Property = property_t::Value;
+			std::optional<std::wregex> Regex; // For "RegExReplace"
+			std::wstring Replacement;
+		};
+
+		struct rule_t
+		{
+			std::vector<size_t> Conditions; // Indexes in the matcher table
+
+			std::optional<size_t> Claim; // "Issue(Claim = C1)"
+			expression_t Type;
+			expression_t Value;
+			std::optional<WORD> ValueType; // Literal value type
+			std::optional<size_t> ValueTypeCondition; // "ValueType = C1.ValueType"
+		};
+		#pragma endregion
+
+		#pragma region Matcher table
+		std::vector<condition_t> conditions;
+
+		std::unordered_map<std::wstring, std::vector<size_t>> typed; // Conditions having "Type ==" test, by folded type
+		std::vector<size_t> untyped; // All other conditions
+		#pragma endregion
+
+		std::vector<rule_t> rules;
+
+		#pragma region Internal types for parsing and processing
+		struct token_t
+		{
+			enum class kind_t : unsigned char
+			{
+				Identifier,
+				String,
+				Punctuator,
+				End
+			};
+
+			kind_t Kind = kind_t::End;
+			std::wstring Text;
+		};
+
+		struct parser_t
+		{
+			std::vector<token_t> Tokens;
+			size_t Position = 0;
+
+			const token_t& Peek() const;
+			bool Accept(std::wstring_view /*Punctuator*/);
+			bool AcceptKeyword(std::wstring_view);
+			void Expect(std::wstring_view /*Punctuator*/);
+			void ExpectKeyword(std::wstring_view);
+			std::wstring Identifier();
+			std::wstring String();
+		};
+
+		struct claim_t
+		{
+			std::wstring Type;
+			WORD ValueType = 0;
+			std::wstring Value;
+			std::shared_ptr<XBITSET<32>> Flags;
+		};
+		#pragma endregion
+
+		static std::vector<token_t> tokenize(std::wstring_view);
+		static WORD value_type(std::wstring_view);
+		static std::wstring_view value_type_name(const WORD&);
+		static const std::wstring& property(const claim_t&, const property_t&, std::wstring&);
+
+		expression_t expression(parser_t&, const std::vector<std::wstring>&) const;
+		bool match(const claim_t&, const condition_t&) const;
+		void add(const claim_t&, const size_t&, std::vector<std::vector<size_t>>&) const;
+	};
+	//****************************************************************************************
+	#pragma region Parsing
+	//****************************************************************************************
+	std::vector<XCLAIMS_TRANSFORMATION::token_t> XCLAIMS_TRANSFORMATION::tokenize(std::wstring_view value)
+	{
+		std::vector<token_t> result;
+
+		for(size_t i = 0; i < value.size();)
+		{
+			wchar_t symbol = value[i];
+
+			#pragma region Spaces
+			if(iswspace(symbol))
+			{
+				i++;
+				continue;
+			}
+			#pragma endregion
+
+			#pragma region Identifiers and keywords
+			if(iswalpha(symbol) || (L'_' == symbol))
+			{
+				size_t start = i;
+
+				while((i < value.size()) && (iswalnum(value[i]) || (L'_' == value[i])))
+					i++;
+
+				result.push_back({ token_t::kind_t::Identifier, std::wstring(value.substr(start, i - start)) });
+				continue;
+			}
+			#pragma endregion
+
+			#pragma region String literals
+			if(L'"' == symbol)
+			{
+				std::wstring text;
+
+				for(i++; ; i++)
+				{
+					if(i >= value.size())
+						throw std::exception("XCLAIMS_TRANSFORMATION: unterminated string");
+
+					if(L'"' == value[i])
+						break;
+
+					if((L'\\' == value[i]) && ((i + 1) < value.size()) && ((L'"' == value[i + 1]) || (L'\\' == value[i + 1])))
+						i++;
+
+					text.push_back(value[i]);
+				}
+
+				i++;
+
+				result.push_back({ token_t::kind_t::String, text });
+				continue;
+			}
+			#pragma endregion
+
+			#pragma region Punctuators
+			static const std::array<std::wstring_view, 15> punctuators = { L"=>", L"==", L"!=", L"=~", L"!~", L"&&", L"=", L"[", L"]", L"(", L")", L",", L";", L":", L"." };
+
+			auto find = std::find_if(punctuators.begin(), punctuators.end(), [&](std::wstring_view element){ return (value.substr(i, element.size()) == element); });
+			if(punctuators.end() == find)
+				throw std::exception("XCLAIMS_TRANSFORMATION: unexpected character");
+
+			result.push_back({ token_t::kind_t::Punctuator, std::wstring(*find) });
+			i += find->size();
+			#pragma endregion
+		}
+
+		result.push_back({ token_t::kind_t::End, L"" });
+
+		return result;
+	}
+	//****************************************************************************************
+	const XCLAIMS_TRANSFORMATION::token_t& XCLAIMS_TRANSFORMATION::parser_t::Peek() const
+	{
+		return Tokens[Position];
+	}
+	//****************************************************************************************
+	bool XCLAIMS_TRANSFORMATION::parser_t::Accept(std::wstring_view punctuator)
+	{
+		if((token_t::kind_t::Punctuator == Peek().Kind) && (Peek().Text == punctuator))
+		{
+			Position++;
+			return true;
+		}
+
+		return false;
+	}
+	//****************************************************************************************
+	bool XCLAIMS_TRANSFORMATION::parser_t::AcceptKeyword(std::wstring_view keyword)
+	{
+		const token_t& token = Peek();
+
+		if((token_t::kind_t::Identifier == token.Kind) && (0 == compare_ordinal(token.Text, keyword, true)))
+		{
+			Position++;
+			return true;
+		}
+
+		return false;
+	}
+	//****************************************************************************************
+	void XCLAIMS_TRANSFORMATION::parser_t::Expect(std::wstring_view punctuator)
+	{
+		if(false == Accept(punctuator))
+			throw std::exception("XCLAIMS_TRANSFORMATION: unexpected token");
+	}
+	//****************************************************************************************
+	void XCLAIMS_TRANSFORMATION::parser_t::ExpectKeyword(std::wstring_view keyword)
+	{
+		if(false == AcceptKeyword(keyword))
+			throw std::exception("XCLAIMS_TRANSFORMATION: unexpected token");
+	}
+	//****************************************************************************************
+	std::wstring XCLAIMS_TRANSFORMATION::parser_t::Identifier()
+	{
+		if(token_t::kind_t::Identifier != Peek().Kind)
+			throw std::exception("XCLAIMS_TRANSFORMATION: identifier expected");
+
+		return Tokens[Position++].Text;
+	}
+	//****************************************************************************************
+	std::wstring XCLAIMS_TRANSFORMATION::parser_t::String()
+	{
+		if(token_t::kind_t::String != Peek().Kind)
+			throw std::exception("XCLAIMS_TRANSFORMATION: string expected");
+
+		return Tokens[Position++].Text;
+	}
+	//****************************************************************************************
+	WORD XCLAIMS_TRANSFORMATION::value_type(std::wstring_view value)
+	{
+		static const std::array<std::pair<std::wstring_view, WORD>, 4> types = { {
+			{ L"int64", CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64 },
+			{ L"uint64", CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64 },
+			{ L"string", CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING },
+			{ L"boolean", CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN }
+		} };
+
+		for(auto&& [name, type] : types)
+		{
+			if(0 == compare_ordinal(name, value, true))
+				return type;
+		}
+
+		return 0;
+	}
+	//****************************************************************************************
+	std::wstring_view XCLAIMS_TRANSFORMATION::value_type_name(const WORD& value)
+	{
+		switch(value)
+		{
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+				return L"int64";
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+				return L"uint64";
+			case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+				return L"boolean";
+			default:
+				return L"string";
+		}
+	}
+	//****************************************************************************************
+	XCLAIMS_TRANSFORMATION::expression_t XCLAIMS_TRANSFORMATION::expression(parser_t& parser, const std::vector<std::wstring>& names) const
+	{
+		expression_t result;
+
+		#pragma region String literal
+		if(token_t::kind_t::String == parser.Peek().Kind)
+		{
+			result.Literal = parser.String();
+			return result;
+		}
+		#pragma endregion
+
+		bool replace = parser.AcceptKeyword(L"RegExReplace");
+		if(replace)
+			parser.Expect(L"(");
+
+		#pragma region Reference to a property of a matched claim
+		std::wstring name = fold_case(parser.Identifier());
+
+		auto find = std::find(names.begin(), names.end(), name);
+		if(names.end() == find)
+			throw std::exception("XCLAIMS_TRANSFORMATION: unknown condition identifier");
+
+		result.Condition = find - names.begin();
+
+		parser.Expect(L".");
+
+		if(parser.AcceptKeyword(L"Type"))
+			result.Property = property_t::Type;
+		else
+		{
+			parser.ExpectKeyword(L"Value");
+			result.Property = property_t::Value;
+		}
+		#pragma endregion
+
+		if(replace)
+		{
+			parser.Expect(L",");
+			result.Regex.emplace(parser.String(), std::regex_constants::ECMAScript | std::regex_constants::icase);
+
+			parser.Expect(L",");
+			result.Replacement = parser.String();
+
+			parser.Expect(L")");
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	XCLAIMS_TRANSFORMATION::XCLAIMS_TRANSFORMATION(std::wstring_view value)
+	{
+		parser_t parser{ tokenize(value) };
+
+		while(token_t::kind_t::End != parser.Peek().Kind)
+		{
+			rule_t rule;
+			std::vector<std::wstring> names; // Folded identifiers of conditions, empty for anonymous ones
+
+			#pragma region Conditions
+			if(false == parser.Accept(L"=>"))
+			{
+				do
+				{
+					#pragma region Optional identifier
+					std::wstring name;
+
+					if(token_t::kind_t::Identifier == parser.Peek().Kind)
+					{
+						name = fold_case(parser.Identifier());
+						parser.Expect(L":");
+
+						if(names.end() != std::find(names.begin(), names.end(), name))
+							throw std::exception("XCLAIMS_TRANSFORMATION: duplicate condition identifier");
+					}
+
+					names.push_back(name);
+					#pragma endregion
+
+					#pragma region Tests
+					condition_t condition;
+					std::optional<std::wstring> type; // Value of the first "Type ==" test, used as a key in matcher table
+
+					parser.Expect(L"[");
+
+					if(false == parser.Accept(L"]"))
+					{
+						do
+						{
+							test_t test;
+
+							if(parser.AcceptKeyword(L"ValueType"))
+								test.Property = property_t::ValueType;
+							else
+							{
+								if(parser.AcceptKeyword(L"Value"))
+									test.Property = property_t::Value;
+								else
+								{
+									parser.ExpectKeyword(L"Type");
+									test.Property = property_t::Type;
+								}
+							}
+
+							if(parser.Accept(L"=="))
+								test.Code = 0;
+							else
+							{
+								if(parser.Accept(L"!="))
+									test.Code = 1;
+								else
+								{
+									if(parser.Accept(L"=~"))
+										test.Code = 2;
+									else
+									{
+										parser.Expect(L"!~");
+										test.Code = 3;
+									}
+								}
+							}
+
+							test.Literal = parser.String();
+
+							if(test.Code > 1)
+								test.Regex.emplace(test.Literal, std::regex_constants::ECMAScript | std::regex_constants::icase);
+
+							if((property_t::Type == test.Property) && (0 == test.Code) && (false == type.has_value()))
+								type = fold_case(test.Literal);
+							else
+								condition.Tests.push_back(std::move(test)); // Test for the key is done by the matcher table lookup
+						} while(parser.Accept(L","));
+
+						parser.Expect(L"]");
+					}
+					#pragma endregion
+
+					#pragma region Put condition to the matcher table
+					rule.Conditions.push_back(conditions.size());
+
+					if(type.has_value())
+						typed[type.value()].push_back(conditions.size());
+					else
+						untyped.push_back(conditions.size());
+
+					conditions.push_back(std::move(condition));
+					#pragma endregion
+				} while(parser.Accept(L"&&"));
+
+				parser.Expect(L"=>");
+			}
+			#pragma endregion
+
+			#pragma region Issue statement
+			parser.ExpectKeyword(L"Issue");
+			parser.Expect(L"(");
+
+			if(parser.AcceptKeyword(L"Claim"))
+			{
+				parser.Expect(L"=");
+
+				std::wstring name = fold_case(parser.Identifier());
+
+				auto find = std::find(names.begin(), names.end(), name);
+				if(names.end() == find)
+					throw std::exception("XCLAIMS_TRANSFORMATION: unknown condition identifier");
+
+				rule.Claim = find - names.begin();
+			}
+			else
+			{
+				parser.ExpectKeyword(L"Type");
+				parser.Expect(L"=");
+				rule.Type = expression(parser, names);
+
+				parser.Expect(L",");
+
+				parser.ExpectKeyword(L"Value");
+				parser.Expect(L"=");
+				rule.Value = expression(parser, names);
+
+				if(parser.Accept(L","))
+				{
+					parser.ExpectKeyword(L"ValueType");
+					parser.Expect(L"=");
+
+					if(token_t::kind_t::String == parser.Peek().Kind)
+					{
+						rule.ValueType = value_type(parser.String());
+						if(0 == rule.ValueType.value())
+							throw std::exception("XCLAIMS_TRANSFORMATION: unknown value type");
+					}
+					else
+					{
+						std::wstring name = fold_case(parser.Identifier());
+
+						auto find = std::find(names.begin(), names.end(), name);
+						if(names.end() == find)
+							throw std::exception("XCLAIMS_TRANSFORMATION: unknown condition identifier");
+
+						rule.ValueTypeCondition = find - names.begin();
+
+						parser.Expect(L".");
+						parser.ExpectKeyword(L"ValueType");
+					}
+				}
+				else
+				{
+					// Value type of a referenced claim is used by default, "string" for literals
+					if(rule.Value.Condition.has_value() && (false == rule.Value.Regex.has_value()))
+						rule.ValueTypeCondition = rule.Value.Condition;
+					else
+						rule.ValueType = CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING;
+				}
+			}
+
+			parser.Expect(L")");
+			parser.Expect(L";");
+			#pragma endregion
+
+			rules.push_back(std::move(rule));
+		}
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Processing
+	//****************************************************************************************
+	const std::wstring& XCLAIMS_TRANSFORMATION::property(const claim_t& claim, const property_t& value, std::wstring& buffer)
+	{
+		switch(value)
+		{
+			case property_t::Type:
+				return claim.Type;
+			case property_t::Value:
+				return claim.Value;
+			default:
+				buffer = value_type_name(claim.ValueType);
+				return buffer;
+		}
+	}
+	//****************************************************************************************
+	bool XCLAIMS_TRANSFORMATION::match(const claim_t& claim, const condition_t& condition) const
+	{
+		std::wstring buffer;
+
+		for(auto&& test : condition.Tests)
+		{
+			const std::wstring& value = property(claim, test.Property, buffer);
+			bool result = false;
+
+			if(test.Regex.has_value())
+				result = std::regex_search(value, test.Regex.value());
+			else
+				result = (0 == compare_ordinal(value, test.Literal, true));
+
+			if(result != ((0 == test.Code) || (2 == test.Code)))
+				return false;
+		}
+
+		return true;
+	}
+	//****************************************************************************************
+	void XCLAIMS_TRANSFORMATION::add(const claim_t& claim, const size_t& index, std::vector<std::vector<size_t>>& matches) const
+	{
+		auto find = typed.find(fold_case(claim.Type));
+		if(typed.end() != find)
+		{
+			for(auto&& element : find->second)
+			{
+				if(match(claim, conditions[element]))
+					matches[element].push_back(index);
+			}
+		}
+
+		for(auto&& element : untyped)
+		{
+			if(match(claim, conditions[element]))
+				matches[element].push_back(index);
+		}
+	}
+	//****************************************************************************************
+	XSECURITY_ATTRIBUTES_INFORMATION XCLAIMS_TRANSFORMATION::Apply(const XSECURITY_ATTRIBUTES_INFORMATION& information) const
+	{
+		std::vector<claim_t> claims;
+		std::vector<std::vector<size_t>> matches(conditions.size()); // Indexes of claims matched each condition
+
+		#pragma region Input claims
+		for(auto&& attribute : information.Attributes)
+		{
+			for(size_t i = 0; i < attribute->GetValues().size(); i++)
+			{
+				claim_t claim{ attribute->Name, attribute->ValueType, L"", attribute->Flags };
+
+				switch(attribute->ValueType)
+				{
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+						claim.Value = std::to_wstring(attribute->GetValues().Integer(i));
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+						claim.Value = std::to_wstring(attribute->GetValues().Unsigned(i));
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+						claim.Value = (attribute->GetValues().Integer(i)) ? L"true" : L"false";
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+						claim.Value = attribute->GetValues().String(i);
+						break;
+					default:
+						continue; // Not representable in [MS-CTA]
+				}
+
+				add(claim, claims.size(), matches);
+				claims.push_back(std::move(claim));
+			}
+		}
+		#pragma endregion
+
+		#pragma region Apply all rules
+		std::vector<claim_t> issued;
+
+		for(auto&& rule : rules)
+		{
+			std::vector<claim_t> output;
+
+			#pragma region Enumerate all combinations of matched claims
+			std::vector<size_t> positions(rule.Conditions.size(), 0);
+
+			bool empty = std::any_of(rule.Conditions.begin(), rule.Conditions.end(), [&](const size_t& element){ return matches[element].empty(); });
+
+			while(false == empty)
+			{
+				auto matched = [&](const size_t& condition) -> const claim_t&
+				{
+					return claims[matches[rule.Conditions[condition]][positions[condition]]];
+				};
+
+				#pragma region Issue a claim
+				if(rule.Claim.has_value())
+					output.push_back(matched(rule.Claim.value()));
+				else
+				{
+					auto evaluate = [&](const expression_t& value) -> std::wstring
+					{
+						if(false == value.Condition.has_value())
+							return value.Literal;
+
+						std::wstring buffer;
+						const std::wstring& result = property(matched(value.Condition.value()), value.Property, buffer);
+
+						if(value.Regex.has_value())
+							return std::regex_replace(result, value.Regex.value(), value.Replacement);
+
+						return result;
+					};
+
+					claim_t claim{ evaluate(rule.Type), 0, evaluate(rule.Value), nullptr };
+					claim.ValueType = (rule.ValueType.has_value()) ? rule.ValueType.value() : matched(rule.ValueTypeCondition.value()).ValueType;
+					claim.Flags = std::make_shared<XBITSET<32>>((DWORD)0, SecurityAttributeV1Meaning);
+
+					output.push_back(std::move(claim));
+				}
+				#pragma endregion
+
+				#pragma region Next combination
+				size_t i = 0;
+
+				for(; i < positions.size(); i++)
+				{
+					if(++positions[i] < matches[rule.Conditions[i]].size())
+						break;
+
+					positions[i] = 0;
+				}
+
+				empty = (i == positions.size()); // All combinations were enumerated (or rule has no conditions)
+				#pragma endregion
+			}
+			#pragma endregion
+
+			#pragma region Issued claims are visible for following rules
+			for(auto&& element : output)
+			{
+				add(element, claims.size(), matches);
+				claims.push_back(element);
+			}
+
+			issued.insert(issued.end(), std::make_move_iterator(output.begin()), std::make_move_iterator(output.end()));
+			#pragma endregion
+		}
+		#pragma endregion
+
+		#pragma region Merge issued claims into attributes
+		std::vector<std::shared_ptr<XSECURITY_ATTRIBUTE_V1>> attributes;
+		std::unordered_map<std::wstring, size_t> types; // Folded type -> index in "attributes"
+		std::vector<std::set<std::wstring>> values; // Values already put into each attribute
+
+		for(auto&& element : issued)
+		{
+			auto [find, inserted] = types.try_emplace(fold_case(element.Type), attributes.size());
+			if(inserted)
+			{
+				attributes.push_back(std::make_shared<XSECURITY_ATTRIBUTE_V1>(element.Type, element.ValueType, *element.Flags, std::vector<std::variant<LONG64, DWORD64, std::wstring, XSECURITY_ATTRIBUTE_FQBN_VALUE, XSECURITY_ATTRIBUTE_OCTET_STRING_VALUE, XSID>>{}));
+				values.emplace_back();
+			}
+
+			XSECURITY_ATTRIBUTE_V1& attribute = *attributes[find->second];
+
+			if((attribute.ValueType != element.ValueType) || (false == values[find->second].insert(element.Value).second))
+				continue;
+
+			#pragma region Convert value from string
+			wchar_t* end = nullptr;
+			errno = 0;
+
+			switch(element.ValueType)
+			{
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+					{
+						LONG64 value = std::wcstoll(element.Value.c_str(), &end, 10);
+						if(element.Value.size() && (0 == errno) && (L'\0' == *end))
+							attribute.ChangeValues().Push(value);
+					}
+					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+					{
+						DWORD64 value = std::wcstoull(element.Value.c_str(), &end, 10);
+						if(element.Value.size() && (0 == errno) && (L'\0' == *end) && (L'-' != element.Value[0]))
+							attribute.ChangeValues().Push(value);
+					}
+					break;
+				case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+					if((0 == compare_ordinal(element.Value, L"true", true)) || (L"1" == element.Value))
+						attribute.ChangeValues().Push((DWORD64)1);
+					else
+					{
+						if((0 == compare_ordinal(element.Value, L"false", true)) || (L"0" == element.Value))
+							attribute.ChangeValues().Push((DWORD64)0);
+					}
+					break;
+				default:
+					attribute.ChangeValues().Push(std::wstring_view(element.Value));
+			}
+			#pragma endregion
+		}
+
+		#pragma endregion
+
+		XSECURITY_ATTRIBUTES_INFORMATION result(std::vector<XSECURITY_ATTRIBUTE_V1>{}, information.Version);
+
+		// Attributes without correct values are not issued
+		for(auto&& element : attributes)
+		{
+			if(element->GetValues().size())
+				result.Attributes.push_back(element);
+		}
+
+		result.Reindex();
+
+		return result;
+	}
+	//****************************************************************************************
+	std::vector<XSECURITY_ATTRIBUTES_INFORMATION> XCLAIMS_TRANSFORMATION::Apply(std::span<const XSECURITY_ATTRIBUTES_INFORMATION* const> values, const size_t& threads) const
+	{
+		std::vector<std::optional<XSECURITY_ATTRIBUTES_INFORMATION>> results(values.size());
+
+		#pragma region Process all claims sets in parallel
+		parallel(values.size(), threads, [&](const size_t& i)
+		{
+			results[i].emplace(Apply(*values[i]));
+		});
+		#pragma endregion
+
+		std::vector<XSECURITY_ATTRIBUTES_INFORMATION> result;
+		result.reserve(results.size());
+
+		for(auto&& element : results)
+			result.push_back(element.value());
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
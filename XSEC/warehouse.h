@@ -0,0 +1,718 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Predicate for selection of principals from warehouse
+	//****************************************************************************************
+	enum class XCLAIMS_SOURCE : unsigned char
+	{
+		User,
+		Device
+	};
+	//****************************************************************************************
+	// Codes are the same as for relational operators in conditional expressions (0x80 - 0x85).
+	// Integer values are used for INT64, UINT64 and BOOLEAN claims, strings for STRING and FQBN (name only) claims.
+	// Integers are compared by value, so a negative LONG64 is less than any UINT64 claim value and
+	// a DWORD64 above the LONG64 range is greater than any INT64 claim value.
+	struct XCLAIMS_PREDICATE
+	{
+		XCLAIMS_SOURCE Source = XCLAIMS_SOURCE::User;
+		std::wstring Name;
+		unsigned char Code = 0x80;
+		std::variant<LONG64, DWORD64, std::wstring> Value;
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Columnar store of user and device claims for many principals
+	//****************************************************************************************
+	// One row per principal, one column per claim name and source:
+	//   - INT64 claims are stored as packed LONG64 values;
+	//   - UINT64 claims are stored as packed LONG64 values with inverted sign bit, so signed
+	//     comparison of stored values gives the unsigned order of claim values;
+	//   - boolean claims are stored as one bit per value;
+	//   - string claims are stored as identifiers in per-column dictionary;
+	//   - all columns have offsets of values for each row, so multi-valued claims need no special handling.
+	// A row is selected by a predicate if at least one value of the claim satisfies it.
+	// Claims with SID and octet string values are not stored.
+	struct XCLAIMS_WAREHOUSE
+	{
+		XCLAIMS_WAREHOUSE() = default;
+		~XCLAIMS_WAREHOUSE() = default;
+
+		XCLAIMS_WAREHOUSE(const std::wstring&); // Map a file made by "Save", columns are used in place and could not be appended
+
+		size_t Append(std::wstring_view /*Principal*/, const XSECURITY_ATTRIBUTES_INFORMATION* /*User*/, const XSECURITY_ATTRIBUTES_INFORMATION* /*Device*/ = nullptr);
+
+		bitmap_t Select(IL<XCLAIMS_PREDICATE>) const; // Conjunction of all predicates, bit is set for each selected row
+		std::vector<std::wstring_view> Principals(const bitmap_t&) const;
+
+		std::optional<size_t> Find(std::wstring_view) const; // Row of a principal
+		std::wstring_view Principal(const size_t&) const;
+
+		void Save(const std::wstring&) const;
+
+		size_t Rows = 0;
+
+	private:
+		#pragma region Internal types
+		// Values are either owned (while building) or point to the mapped file
+		template<typename T>
+		struct array_t
+		{
+			std::vector<T> Values;
+			std::span<const T> Mapped;
+
+			std::span<const T> View() const
+			{
+				return (nullptr == Mapped.data()) ? std::span<const T>(Values) : Mapped;
+			}
+		};
+
+		// All strings in one buffer, string "i" is from "Offsets[i]" till "Offsets[i + 1]"
+		struct dictionary_t
+		{
+			array_t<wchar_t> Chars;
+			array_t<DWORD64> Offsets;
+			std::unordered_map<std::wstring, DWORD> Index; // Identifiers of all strings
+
+			size_t size() const;
+			std::wstring_view operator[](const size_t&) const;
+
+			DWORD Put(std::wstring_view);
+		};
+
+		enum class kind_t : DWORD
+		{
+			Integer = 1,
+			Boolean = 2,
+			String = 3,
+			Unsigned = 4
+		};
+
+		struct column_t
+		{
+			XCLAIMS_SOURCE Source = XCLAIMS_SOURCE::User;
+			std::wstring Name;
+			kind_t Kind = kind_t::Integer;
+			bool CaseSensitive = true; // Cleared if at least one attribute is case-insensitive
+			DWORD Count = 0; // Number of values in all rows
+
+			array_t<DWORD> Offsets; // Values of row "i" are from "Offsets[i]" till "Offsets[i + 1]"
+
+			array_t<LONG64> Integers; // For "Integer" and "Unsigned" kinds
+			array_t<uint64_t> Booleans;
+			array_t<DWORD> Ids;
+			dictionary_t Dictionary;
+		};
+
+		struct reader_t
+		{
+			std::span<const unsigned char> Data;
+			size_t Position = 0;
+
+			template<typename T>
+			std::span<const T> Take(const size_t& count)
+			{
+				if(count > ((Data.size() - Position) / sizeof(T)))
+					throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+
+				std::span<const T> result((const T*)(Data.data() + Position), count);
+				Position = std::min(Data.size(), Position + ((count * sizeof(T) + 7) & ~(size_t)7));
+
+				return result;
+			}
+		};
+		#pragma endregion
+
+		std::vector<column_t> columns;
+		std::unordered_map<DWORD64, size_t> index; // Columns by source and identifier from "XCLAIM_NAMES"
+
+		dictionary_t principals;
+
+		std::optional<XMAPPED_FILE> file;
+
+		static constexpr DWORD64 sign = (DWORD64)1 << 63; // Inverted in stored UINT64 values
+
+		static DWORD64 key(const XCLAIMS_SOURCE&, const DWORD&);
+
+		column_t& column(const XCLAIMS_SOURCE&, const std::wstring&, const kind_t&);
+		bitmap_t select(const XCLAIMS_PREDICATE&) const;
+
+		static void read(reader_t&, dictionary_t&);
+		static void write(std::ofstream&, const dictionary_t&);
+	};
+	//****************************************************************************************
+	size_t XCLAIMS_WAREHOUSE::dictionary_t::size() const
+	{
+		size_t count = Offsets.View().size();
+		return (count) ? (count - 1) : 0;
+	}
+	//****************************************************************************************
+	std::wstring_view XCLAIMS_WAREHOUSE::dictionary_t::operator[](const size_t& i) const
+	{
+		auto offsets = Offsets.View();
+		return std::wstring_view(Chars.View().data() + offsets[i], (size_t)(offsets[i + 1] - offsets[i]));
+	}
+	//****************************************************************************************
+	DWORD XCLAIMS_WAREHOUSE::dictionary_t::Put(std::wstring_view value)
+	{
+		auto [element, inserted] = Index.try_emplace(std::wstring(value), (DWORD)size());
+		if(inserted)
+		{
+			if(Offsets.Values.empty())
+				Offsets.Values.push_back(0);
+
+			Chars.Values.insert(Chars.Values.end(), value.begin(), value.end());
+			Offsets.Values.push_back(Chars.Values.size());
+		}
+
+		return element->second;
+	}
+	//****************************************************************************************
+	DWORD64 XCLAIMS_WAREHOUSE::key(const XCLAIMS_SOURCE& source, const DWORD& id)
+	{
+		return (((DWORD64)source << 32) | id);
+	}
+	//****************************************************************************************
+	XCLAIMS_WAREHOUSE::column_t& XCLAIMS_WAREHOUSE::column(const XCLAIMS_SOURCE& source, const std::wstring& name, const kind_t& kind)
+	{
+		auto [element, inserted] = index.try_emplace(key(source, XCLAIM_NAMES::Intern(name)), columns.size());
+		if(inserted)
+		{
+			column_t& result = columns.emplace_back();
+
+			result.Source = source;
+			result.Name = name;
+			result.Kind = kind;
+			result.Offsets.Values.assign(Rows + 1, 0); // All previous rows have no values
+
+			return result;
+		}
+
+		return columns[element->second];
+	}
+	//****************************************************************************************
+	size_t XCLAIMS_WAREHOUSE::Append(std::wstring_view principal, const XSECURITY_ATTRIBUTES_INFORMATION* user, const XSECURITY_ATTRIBUTES_INFORMATION* device)
+	{
+		#pragma region Initial check
+		if(file.has_value())
+			throw std::exception("XCLAIMS_WAREHOUSE: warehouse mapped from file is read-only");
+
+		if(principals.Index.contains(std::wstring(principal)))
+			throw std::exception("XCLAIMS_WAREHOUSE: principal was already appended");
+		#pragma endregion
+
+		principals.Put(principal);
+
+		#pragma region Put values of all attributes
+		auto append = [this](const XCLAIMS_SOURCE& source, const XSECURITY_ATTRIBUTES_INFORMATION* information)
+		{
+			if(nullptr == information)
+				return;
+
+			for(auto&& attribute : information->Attributes)
+			{
+				kind_t kind;
+
+				switch(attribute->ValueType)
+				{
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_INT64:
+						kind = kind_t::Integer;
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_UINT64:
+						kind = kind_t::Unsigned;
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_BOOLEAN:
+						kind = kind_t::Boolean;
+						break;
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_STRING:
+					case CLAIM_SECURITY_ATTRIBUTE_TYPE_FQBN:
+						kind = kind_t::String;
+						break;
+					default:
+						continue;
+				}
+
+				column_t& target = column(source, attribute->Name, kind);
+				if(target.Kind != kind) // Values with a type different from the first appended attribute are stored as missing
+					continue;
+
+				if(false == attribute->Flags->get(L"CLAIM_SECURITY_ATTRIBUTE_VALUE_CASE_SENSITIVE"))
+					target.CaseSensitive = false;
+
+				for(size_t i = 0; i < attribute->GetValues().size(); i++, target.Count++)
+				{
+					switch(kind)
+					{
+						case kind_t::Integer:
+							target.Integers.Values.push_back(attribute->GetValues().Integer(i));
+							break;
+						case kind_t::Unsigned:
+							target.Integers.Values.push_back((LONG64)(attribute->GetValues().Unsigned(i) ^ sign));
+							break;
+						case kind_t::Boolean:
+							if(0 == (target.Count & 63))
+								target.Booleans.Values.push_back(0);
+
+							if(attribute->GetValues().Integer(i))
+								target.Booleans.Values.back() |= ((uint64_t)1 << (target.Count & 63));
+
+							break;
+						default:
+							target.Ids.Values.push_back(target.Dictionary.Put(attribute->GetValues().String(i)));
+					}
+				}
+			}
+		};
+
+		append(XCLAIMS_SOURCE::User, user);
+		append(XCLAIMS_SOURCE::Device, device);
+
+		for(auto&& element : columns)
+			element.Offsets.Values.push_back(element.Count);
+		#pragma endregion
+
+		return Rows++;
+	}
+	//****************************************************************************************
+	bitmap_t XCLAIMS_WAREHOUSE::select(const XCLAIMS_PREDICATE& predicate) const
+	{
+		#pragma region Initial variables
+		bitmap_t result((Rows + 63) >> 6, 0);
+
+		if((predicate.Code < 0x80) || (predicate.Code > 0x85))
+			throw std::exception("XCLAIMS_WAREHOUSE: unsupported relational operator");
+
+		DWORD id = XCLAIM_NAMES::Find(predicate.Name);
+		if(0 == id)
+			return result;
+
+		auto find = index.find(key(predicate.Source, id));
+		if(index.end() == find)
+			return result;
+
+		const column_t& source = columns[find->second];
+		#pragma endregion
+
+		#pragma region Integer value in order of stored values
+		// Value outside of the range of column type is above or below all stored values
+		LONG64 constant = 0;
+		std::optional<bool> above;
+
+		if(kind_t::String != source.Kind)
+		{
+			if(std::holds_alternative<std::wstring>(predicate.Value))
+				return result;
+
+			if(kind_t::Unsigned == source.Kind)
+			{
+				if(std::holds_alternative<LONG64>(predicate.Value) && (std::get<LONG64>(predicate.Value) < 0))
+					above = false;
+				else
+					constant = (LONG64)((std::holds_alternative<DWORD64>(predicate.Value) ? std::get<DWORD64>(predicate.Value) : (DWORD64)std::get<LONG64>(predicate.Value)) ^ sign);
+			}
+			else
+			{
+				if(std::holds_alternative<DWORD64>(predicate.Value) && (std::get<DWORD64>(predicate.Value) > (DWORD64)MAXLONG64))
+					above = true;
+				else
+					constant = std::holds_alternative<DWORD64>(predicate.Value) ? (LONG64)std::get<DWORD64>(predicate.Value) : std::get<LONG64>(predicate.Value);
+			}
+		}
+
+		// All stored values are "less than" (or "greater than") the value
+		bool all = false;
+
+		if(above.has_value())
+		{
+			switch(predicate.Code)
+			{
+				case 0x81: // !=
+					all = true;
+					break;
+				case 0x82: // <
+				case 0x83: // <=
+					all = above.value();
+					break;
+				case 0x84: // >
+				case 0x85: // >=
+					all = (false == above.value());
+					break;
+				default:
+					break;
+			}
+		}
+		#pragma endregion
+
+		#pragma region Check each value of the column
+		bitmap_t matches(((size_t)source.Count + 63) >> 6, 0);
+
+		switch(source.Kind)
+		{
+			case kind_t::Integer:
+			case kind_t::Unsigned:
+				{
+					auto integers = source.Integers.View();
+
+					for(size_t i = 0; i < source.Count; i += 64)
+					{
+						if(above.has_value())
+							matches[i >> 6] = (all) ? ~(uint64_t)0 : 0;
+						else
+							matches[i >> 6] = compare_block(integers.data() + i, std::min<size_t>(64, source.Count - i), constant, predicate.Code);
+					}
+				}
+				break;
+			case kind_t::Boolean:
+				{
+					// Only two possible values, so the predicate is evaluated once for each
+					const LONG64 values[2] = { 0, 1 };
+					uint64_t satisfies = (above.has_value()) ? ((all) ? 3 : 0) : compare_block(values, 2, constant, predicate.Code);
+
+					auto booleans = source.Booleans.View();
+
+					for(size_t i = 0; i < matches.size(); i++)
+						matches[i] = ((satisfies & 1) ? ~booleans[i] : 0) | ((satisfies & 2) ? booleans[i] : 0);
+				}
+				break;
+			default:
+				{
+					if(false == std::holds_alternative<std::wstring>(predicate.Value))
+						return result;
+
+					const std::wstring& value = std::get<std::wstring>(predicate.Value);
+
+					#pragma region Evaluate the predicate for each string in dictionary
+					std::vector<unsigned char> accepted(source.Dictionary.size(), 0);
+
+					for(size_t i = 0; i < accepted.size(); i++)
+					{
+						auto element = source.Dictionary[i];
+						int compare = compare_ordinal(element, value, (false == source.CaseSensitive));
+
+						switch(predicate.Code)
+						{
+							case 0x80: // ==
+								accepted[i] = (0 == compare);
+								break;
+							case 0x81: // !=
+								accepted[i] = (0 != compare);
+								break;
+							case 0x82: // <
+								accepted[i] = (compare < 0);
+								break;
+							case 0x83: // <=
+								accepted[i] = (compare <= 0);
+								break;
+							case 0x84: // >
+								accepted[i] = (compare > 0);
+								break;
+							default: // >=
+								accepted[i] = (compare >= 0);
+						}
+					}
+					#pragma endregion
+
+					auto ids = source.Ids.View();
+
+					for(size_t i = 0; i < source.Count; i++)
+						matches[i >> 6] |= ((uint64_t)accepted[ids[i]] << (i & 63));
+				}
+		}
+		#pragma endregion
+
+		#pragma region Select rows having at least one matched value
+		auto offsets = source.Offsets.View();
+
+		for(size_t row = 0; row < Rows; row++)
+		{
+			for(size_t i = offsets[row]; i < offsets[row + 1]; i++)
+			{
+				if(matches[i >> 6] & ((uint64_t)1 << (i & 63)))
+				{
+					result[row >> 6] |= ((uint64_t)1 << (row & 63));
+					break;
+				}
+			}
+		}
+		#pragma endregion
+
+		return result;
+	}
+	//****************************************************************************************
+	bitmap_t XCLAIMS_WAREHOUSE::Select(IL<XCLAIMS_PREDICATE> predicates) const
+	{
+		bitmap_t result((Rows + 63) >> 6, ~(uint64_t)0);
+
+		if(Rows & 63)
+			result.back() = ((uint64_t)1 << (Rows & 63)) - 1;
+
+		for(auto&& element : predicates)
+		{
+			bitmap_t selected = select(element);
+
+			for(size_t i = 0; i < result.size(); i++)
+				result[i] &= selected[i];
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	std::vector<std::wstring_view> XCLAIMS_WAREHOUSE::Principals(const bitmap_t& rows) const
+	{
+		std::vector<std::wstring_view> result;
+
+		for(size_t i = 0; i < rows.size(); i++)
+		{
+			for(uint64_t bits = rows[i]; bits; bits &= (bits - 1))
+			{
+				result.push_back(principals[(i << 6) + std::countr_zero(bits)]);
+			}
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	std::optional<size_t> XCLAIMS_WAREHOUSE::Find(std::wstring_view principal) const
+	{
+		auto find = principals.Index.find(std::wstring(principal));
+		if(principals.Index.end() == find)
+			return std::nullopt;
+
+		return find->second;
+	}
+	//****************************************************************************************
+	std::wstring_view XCLAIMS_WAREHOUSE::Principal(const size_t& row) const
+	{
+		if(row >= Rows)
+			throw std::exception("XCLAIMS_WAREHOUSE: invalid row");
+
+		return principals[row];
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Persistence
+	//****************************************************************************************
+	// File layout (little-endian, each block is padded to 8 bytes):
+	//   DWORD "XCWH", DWORD version, DWORD64 rows, DWORD64 number of columns;
+	//   dictionary with names of principals;
+	//   for each column: DWORD source, DWORD kind, DWORD case-sensitive, DWORD number of values,
+	//   DWORD64 length of name, name, DWORD offsets[rows + 1], and then values depending on kind:
+	//   LONG64[values] for integers (unsigned with inverted sign bit), uint64_t[(values + 63) / 64] for booleans,
+	//   DWORD[values] and dictionary for strings.
+	// Version 2 stores UINT64 claims in "unsigned" columns, version 1 files are not supported.
+	// Dictionary: DWORD64 number of strings, DWORD64 offsets[strings + 1], all characters.
+	constexpr DWORD XCLAIMS_WAREHOUSE_MAGIC = 0x48574358; // "XCWH"
+	constexpr DWORD XCLAIMS_WAREHOUSE_VERSION = 2;
+	//****************************************************************************************
+	void XCLAIMS_WAREHOUSE::write(std::ofstream& stream, const dictionary_t& dictionary)
+	{
+		static const char padding[8] = {};
+
+		DWORD64 count = dictionary.size();
+		stream.write((const char*)&count, sizeof(count));
+
+		auto offsets = dictionary.Offsets.View();
+		auto chars = dictionary.Chars.View();
+
+		if(count)
+		{
+			stream.write((const char*)offsets.data(), offsets.size_bytes());
+
+			stream.write((const char*)chars.data(), chars.size_bytes());
+			stream.write(padding, (8 - (chars.size_bytes() & 7)) & 7);
+		}
+	}
+	//****************************************************************************************
+	void XCLAIMS_WAREHOUSE::read(reader_t& reader, dictionary_t& dictionary)
+	{
+		DWORD64 count = reader.Take<DWORD64>(1)[0];
+		if(0 == count)
+			return;
+
+		if(count >= (reader.Data.size() / sizeof(DWORD64)))
+			throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+
+		dictionary.Offsets.Mapped = reader.Take<DWORD64>((size_t)count + 1);
+
+		auto offsets = dictionary.Offsets.Mapped;
+		if(0 != offsets[0])
+			throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+
+		for(size_t i = 1; i < offsets.size(); i++)
+		{
+			if(offsets[i] < offsets[i - 1])
+				throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+		}
+
+		dictionary.Chars.Mapped = reader.Take<wchar_t>((size_t)offsets.back());
+	}
+	//****************************************************************************************
+	void XCLAIMS_WAREHOUSE::Save(const std::wstring& path) const
+	{
+		static const char padding[8] = {};
+
+		std::ofstream stream(path, std::ios_base::binary | std::ios_base::trunc);
+		if(false == stream.is_open())
+			throw std::exception("XCLAIMS_WAREHOUSE: cannot open file for writing");
+
+		auto block = [&stream](const void* data, const size_t& size)
+		{
+			stream.write((const char*)data, size);
+			stream.write(padding, (8 - (size & 7)) & 7);
+		};
+
+		#pragma region Header
+		DWORD header[2] = { XCLAIMS_WAREHOUSE_MAGIC, XCLAIMS_WAREHOUSE_VERSION };
+		block(header, sizeof(header));
+
+		DWORD64 counts[2] = { Rows, columns.size() };
+		block(counts, sizeof(counts));
+
+		write(stream, principals);
+		#pragma endregion
+
+		#pragma region Columns
+		for(auto&& element : columns)
+		{
+			DWORD description[4] = { (DWORD)element.Source, (DWORD)element.Kind, (DWORD)element.CaseSensitive, element.Count };
+			block(description, sizeof(description));
+
+			DWORD64 length = element.Name.size();
+			block(&length, sizeof(length));
+			block(element.Name.data(), element.Name.size() * sizeof(wchar_t));
+
+			auto offsets = element.Offsets.View();
+			block(offsets.data(), offsets.size_bytes());
+
+			switch(element.Kind)
+			{
+				case kind_t::Integer:
+				case kind_t::Unsigned:
+					block(element.Integers.View().data(), element.Integers.View().size_bytes());
+					break;
+				case kind_t::Boolean:
+					block(element.Booleans.View().data(), element.Booleans.View().size_bytes());
+					break;
+				default:
+					block(element.Ids.View().data(), element.Ids.View().size_bytes());
+					write(stream, element.Dictionary);
+			}
+		}
+		#pragma endregion
+
+		stream.flush();
+		if(stream.fail())
+			throw std::exception("XCLAIMS_WAREHOUSE: cannot write to file");
+	}
+	//****************************************************************************************
+	XCLAIMS_WAREHOUSE::XCLAIMS_WAREHOUSE(const std::wstring& path) : file(std::in_place, path)
+	{
+		reader_t reader{ file->Data };
+
+		#pragma region Header
+		auto header = reader.Take<DWORD>(2);
+		if((XCLAIMS_WAREHOUSE_MAGIC != header[0]) || (XCLAIMS_WAREHOUSE_VERSION != header[1]))
+			throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+
+		auto counts = reader.Take<DWORD64>(2);
+
+		if(counts[0] >= (reader.Data.size() / sizeof(DWORD)))
+			throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+
+		Rows = (size_t)counts[0];
+
+		read(reader, principals);
+		if(principals.size() != Rows)
+			throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+
+		for(size_t i = 0; i < Rows; i++)
+			principals.Index.emplace(principals[i], (DWORD)i);
+		#pragma endregion
+
+		#pragma region Columns
+		for(DWORD64 i = 0; i < counts[1]; i++)
+		{
+			column_t& element = columns.emplace_back();
+
+			auto description = reader.Take<DWORD>(4);
+			if((description[0] > (DWORD)XCLAIMS_SOURCE::Device) || (description[1] < (DWORD)kind_t::Integer) || (description[1] > (DWORD)kind_t::Unsigned))
+				throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+
+			element.Source = (XCLAIMS_SOURCE)description[0];
+			element.Kind = (kind_t)description[1];
+			element.CaseSensitive = (0 != description[2]);
+			element.Count = description[3];
+
+			auto name = reader.Take<wchar_t>((size_t)reader.Take<DWORD64>(1)[0]);
+			element.Name.assign(name.begin(), name.end());
+
+			#pragma region Offsets of values
+			element.Offsets.Mapped = reader.Take<DWORD>(Rows + 1);
+
+			auto offsets = element.Offsets.Mapped;
+			if((0 != offsets[0]) || (element.Count != offsets[Rows]))
+				throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+
+			for(size_t j = 1; j <= Rows; j++)
+			{
+				if(offsets[j] < offsets[j - 1])
+					throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+			}
+			#pragma endregion
+
+			#pragma region Values
+			switch(element.Kind)
+			{
+				case kind_t::Integer:
+				case kind_t::Unsigned:
+					element.Integers.Mapped = reader.Take<LONG64>(element.Count);
+					break;
+				case kind_t::Boolean:
+					element.Booleans.Mapped = reader.Take<uint64_t>(((size_t)element.Count + 63) >> 6);
+					break;
+				default:
+					element.Ids.Mapped = reader.Take<DWORD>(element.Count);
+					read(reader, element.Dictionary);
+
+					for(auto&& id : element.Ids.Mapped)
+					{
+						if(id >= element.Dictionary.size())
+							throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+					}
+			}
+			#pragma endregion
+
+			if(false == index.try_emplace(key(element.Source, XCLAIM_NAMES::Intern(element.Name)), columns.size() - 1).second)
+				throw std::exception("XCLAIMS_WAREHOUSE: invalid file format");
+		}
+		#pragma endregion
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -0,0 +1,93 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#pragma once
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Saving and loading of XSEC types
+	//****************************************************************************************
+	template<typename T>
+	void XSave(const T& element, const std::wstring& path)
+	{
+		if constexpr(requires(XXML_WRITER& xml) { element.Write(xml); })
+		{
+			std::ofstream file(path, std::ios_base::binary | std::ios_base::trunc);
+			if(false == file.is_open())
+				throw std::exception("XSave: cannot open file for writing");
+
+			XXML_WRITER xml(file);
+
+			xml.Declaration();
+			element.Write(xml);
+			xml.Flush();
+
+			file.flush();
+			if(file.fail())
+				throw std::exception("XSave: cannot write to file");
+		}
+		else
+		{
+			// Types without streaming serialization are saved through DOM
+			MSXML2::IXMLDOMDocument2Ptr xml;
+			xml.CreateInstance(__uuidof(MSXML2::DOMDocument60), NULL, CLSCTX_INPROC_SERVER);
+
+			xml->documentElement = ((xml_t)element)(xml, std::nullopt);
+			xml->save(path.c_str());
+		}
+	}
+	//****************************************************************************************
+	template<typename T, typename... Types>
+	T XLoad(const std::wstring& path, Types&&... args)
+	{
+		if constexpr(std::is_constructible_v<T, XXML_READER&, Types...>)
+		{
+			// Single forward pass over mapped file, without DOM and XPath
+			XMAPPED_FILE file(path);
+
+			XXML_READER xml(file.Data);
+			xml.Root();
+
+			return T(xml, std::forward<Types>(args)...);
+		}
+		else
+		{
+			// Types without a constructor from XXML_READER are loaded through DOM
+			MSXML2::IXMLDOMDocument2Ptr xml;
+			xml.CreateInstance(__uuidof(MSXML2::DOMDocument60), NULL, CLSCTX_INPROC_SERVER);
+
+			xml->async = VARIANT_FALSE;
+			xml->validateOnParse = VARIANT_FALSE;
+
+			VARIANT_BOOL result = xml->load(path.c_str());
+			if(VARIANT_FALSE == result)
+				throw std::exception("XLoad: cannot load from XML");
+
+			// There is a compiler error, at least in VS 16.9.4, and in order to have
+			// correct type user needs to pass all default parameters here
+			return T(xml->documentElement, std::forward<Types>(args)...);
+		}
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -0,0 +1,847 @@
+/*
+
+XSEC library
+
+Copyright (c) 2021 Yury Strozhevsky <yury@strozhevsky.com>
+
+Permission to use, copy, modify, and distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+
+#pragma once
+//********************************************************************************************
+// Forward-only reader and streaming writer of XML with XSEC schema. Only the standard library is
+// used, so both are checked and measured on any platform (bench/xml_writer_bench.cpp). "XSave"
+// and "XLoad" (xml.h) use them for all types having "Write" and a constructor from the reader.
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+//********************************************************************************************
+namespace XSEC
+{
+	//****************************************************************************************
+	#pragma region Forward-only reader of XML made by XSEC
+	//****************************************************************************************
+	// Pull parser for documents with XSEC schema, without DOM and without MSXML. Only elements
+	// and text are reported: attributes (CommonName, Meaning etc.) are derived data and skipped,
+	// as well as declarations, processing instructions, comments and DOCTYPE. Usage pattern:
+	//
+	//     size_t depth = reader.Depth(); // Reader is on the start of element
+	//     while(reader.Child(depth))
+	//     {
+	//         if("Name" == reader.Name())
+	//             name = reader.WText(); // Consumes the child element
+	//     }                              // Not consumed children are skipped by "Child"
+	//
+	// Input is UTF-8 (with or without BOM) or UTF-16LE with BOM (converted to UTF-8 once).
+	struct XXML_READER
+	{
+		XXML_READER() = delete;
+		~XXML_READER() = default;
+
+		XXML_READER(const XXML_READER&) = delete; // "data" could point to "converted"
+		XXML_READER(std::span<const unsigned char>); // Data must outlive the reader
+
+		void Root(); // Move to the root element, must be called first
+		bool Child(const size_t& /*depth of parent*/); // Move to the next child element of parent
+
+		std::string_view Name() const { return name; } // Name of the current element
+		size_t Depth() const { return depth; } // Root element has depth 1
+
+		#pragma region Content of the current element (all these functions consume the element)
+		std::string Text(); // All text inside, as "text" property of DOM node
+		std::wstring WText();
+		void Skip();
+
+		template<typename T>
+		T Number(); // Decimal integer, as written by "_variant_t"
+
+		std::vector<unsigned char> Hex(); // Bytes written by "hex_codes"
+		#pragma endregion
+
+		static std::wstring wide(std::string_view); // UTF-8 into UTF-16
+		static void utf8(std::string&, const uint32_t&); // Append one code point in UTF-8
+
+	private:
+		enum class token_t
+		{
+			Start,
+			End,
+			Text,
+			End_of_data
+		};
+
+		std::string_view data;
+		size_t position = 0;
+
+		std::string converted; // UTF-8 copy of UTF-16 input
+
+		std::string_view name;
+		std::string text; // Text of the last "Text" token, with resolved references
+		size_t depth = 0;
+		bool empty = false; // Current start tag is "<name/>", end is not read yet
+
+		token_t next();
+
+		size_t find(std::string_view);
+		void reference(std::string&, std::string_view);
+
+		static std::string_view trim(std::string_view);
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Tokenizer
+	//****************************************************************************************
+	XXML_READER::XXML_READER(std::span<const unsigned char> value)
+	{
+		if((value.size() >= 2) && (0xFF == value[0]) && (0xFE == value[1]))
+		{
+			#pragma region UTF-16LE into UTF-8
+			converted.reserve(value.size() / 2);
+
+			for(size_t i = 2; i + 1 < value.size(); i += 2)
+			{
+				uint32_t code = value[i] | ((uint32_t)value[i + 1] << 8);
+
+				if((code >= 0xD800) && (code < 0xDC00) && (i + 3 < value.size()))
+				{
+					uint32_t low = value[i + 2] | ((uint32_t)value[i + 3] << 8);
+					if((low >= 0xDC00) && (low < 0xE000))
+					{
+						code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+						i += 2;
+					}
+				}
+
+				utf8(converted, code);
+			}
+
+			data = converted;
+			#pragma endregion
+		}
+		else
+		{
+			data = std::string_view((const char*)value.data(), value.size());
+
+			if((data.size() >= 3) && ("\xEF\xBB\xBF" == data.substr(0, 3)))
+				position = 3;
+		}
+	}
+	//****************************************************************************************
+	void XXML_READER::utf8(std::string& result, const uint32_t& code)
+	{
+		if(code < 0x80)
+			result.push_back((char)code);
+		else if(code < 0x800)
+		{
+			result.push_back((char)(0xC0 | (code >> 6)));
+			result.push_back((char)(0x80 | (code & 0x3F)));
+		}
+		else if(code < 0x10000)
+		{
+			result.push_back((char)(0xE0 | (code >> 12)));
+			result.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+			result.push_back((char)(0x80 | (code & 0x3F)));
+		}
+		else
+		{
+			result.push_back((char)(0xF0 | (code >> 18)));
+			result.push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+			result.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+			result.push_back((char)(0x80 | (code & 0x3F)));
+		}
+	}
+	//****************************************************************************************
+	std::wstring XXML_READER::wide(std::string_view value)
+	{
+		std::wstring result;
+		result.reserve(value.size());
+
+		for(size_t i = 0; i < value.size();)
+		{
+			unsigned char first = (unsigned char)value[i];
+
+			uint32_t code = first;
+			size_t length = 1;
+
+			if(first >= 0xF0)
+			{
+				code = first & 0x07;
+				length = 4;
+			}
+			else if(first >= 0xE0)
+			{
+				code = first & 0x0F;
+				length = 3;
+			}
+			else if(first >= 0xC0)
+			{
+				code = first & 0x1F;
+				length = 2;
+			}
+
+			if(i + length > value.size())
+				throw std::runtime_error("XXML_READER: invalid UTF-8 sequence");
+
+			for(size_t j = 1; j < length; j++)
+				code = (code << 6) | ((unsigned char)value[i + j] & 0x3F);
+
+			// Surrogate pairs only where "wchar_t" is UTF-16 (Windows)
+			if((code >= 0x10000) && (2 == sizeof(wchar_t)))
+			{
+				code -= 0x10000;
+				result.push_back((wchar_t)(0xD800 + (code >> 10)));
+				result.push_back((wchar_t)(0xDC00 + (code & 0x3FF)));
+			}
+			else
+				result.push_back((wchar_t)code);
+
+			i += length;
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	size_t XXML_READER::find(std::string_view value)
+	{
+		size_t result = data.find(value, position);
+		if(std::string_view::npos == result)
+			throw std::runtime_error("XXML_READER: unexpected end of data");
+
+		return result;
+	}
+	//****************************************************************************************
+	void XXML_READER::reference(std::string& result, std::string_view value)
+	{
+		// "value" is between '&' and ';'
+		if(value.size() && ('#' == value[0]))
+		{
+			uint32_t code = 0;
+			std::from_chars_result parsed{};
+
+			if((value.size() > 1) && (('x' == value[1]) || ('X' == value[1])))
+				parsed = std::from_chars(value.data() + 2, value.data() + value.size(), code, 16);
+			else
+				parsed = std::from_chars(value.data() + 1, value.data() + value.size(), code, 10);
+
+			if((std::errc() != parsed.ec) || (parsed.ptr != value.data() + value.size()))
+				throw std::runtime_error("XXML_READER: invalid character reference");
+
+			utf8(result, code);
+		}
+		else if("lt" == value)
+			result.push_back('<');
+		else if("gt" == value)
+			result.push_back('>');
+		else if("amp" == value)
+			result.push_back('&');
+		else if("quot" == value)
+			result.push_back('"');
+		else if("apos" == value)
+			result.push_back('\'');
+		else
+			throw std::runtime_error("XXML_READER: unknown entity reference");
+	}
+	//****************************************************************************************
+	XXML_READER::token_t XXML_READER::next()
+	{
+		if(empty)
+		{
+			empty = false;
+			depth--;
+
+			return token_t::End;
+		}
+
+		for(;;)
+		{
+			if(position >= data.size())
+				return token_t::End_of_data;
+
+			if('<' != data[position])
+			{
+				#pragma region Text till the next markup, references are resolved
+				size_t end = data.find('<', position);
+				if(std::string_view::npos == end)
+					end = data.size();
+
+				std::string_view value = data.substr(position, end - position);
+				position = end;
+
+				text.clear();
+
+				for(size_t i = 0; i < value.size();)
+				{
+					size_t amp = value.find('&', i);
+					if(std::string_view::npos == amp)
+					{
+						text.append(value.substr(i));
+						break;
+					}
+
+					text.append(value.substr(i, amp - i));
+
+					size_t semicolon = value.find(';', amp);
+					if(std::string_view::npos == semicolon)
+						throw std::runtime_error("XXML_READER: invalid reference");
+
+					reference(text, value.substr(amp + 1, semicolon - amp - 1));
+					i = semicolon + 1;
+				}
+
+				return token_t::Text;
+				#pragma endregion
+			}
+
+			std::string_view rest = data.substr(position);
+
+			if(rest.starts_with("<?"))
+			{
+				position = find("?>") + 2;
+				continue;
+			}
+
+			if(rest.starts_with("<!--"))
+			{
+				position = find("-->") + 3;
+				continue;
+			}
+
+			if(rest.starts_with("<![CDATA["))
+			{
+				size_t end = find("]]>");
+
+				text.assign(data.substr(position + 9, end - position - 9));
+				position = end + 3;
+
+				return token_t::Text;
+			}
+
+			if(rest.starts_with("<!"))
+			{
+				position = find(">") + 1;
+				continue;
+			}
+
+			#pragma region Start or end tag
+			const bool closing = rest.starts_with("</");
+
+			size_t begin = position + (closing ? 2 : 1);
+			size_t end = begin;
+
+			while((end < data.size()) && (nullptr == strchr(" \t\r\n/>", data[end])))
+				end++;
+
+			name = data.substr(begin, end - begin);
+
+			#pragma region Skip attributes (values could contain '>')
+			char quote = 0;
+
+			for(; end < data.size(); end++)
+			{
+				if(quote)
+				{
+					if(data[end] == quote)
+						quote = 0;
+				}
+				else if(('"' == data[end]) || ('\'' == data[end]))
+					quote = data[end];
+				else if('>' == data[end])
+					break;
+			}
+
+			if(end >= data.size())
+				throw std::runtime_error("XXML_READER: unexpected end of data");
+			#pragma endregion
+
+			position = end + 1;
+
+			if(closing)
+			{
+				if(0 == depth)
+					throw std::runtime_error("XXML_READER: unexpected end tag");
+
+				depth--;
+				return token_t::End;
+			}
+
+			depth++;
+			empty = ('/' == data[end - 1]);
+
+			return token_t::Start;
+			#pragma endregion
+		}
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Navigation and content
+	//****************************************************************************************
+	void XXML_READER::Root()
+	{
+		if(depth)
+			throw std::runtime_error("XXML_READER: root element was already read");
+
+		for(;;)
+		{
+			switch(next())
+			{
+				case token_t::Start:
+					return;
+				case token_t::Text:
+					continue;
+				default:
+					throw std::runtime_error("XXML_READER: cannot find root element");
+			}
+		}
+	}
+	//****************************************************************************************
+	bool XXML_READER::Child(const size_t& parent)
+	{
+		// Parent was consumed by a previous call
+		if(depth < parent)
+			return false;
+
+		for(;;)
+		{
+			switch(next())
+			{
+				case token_t::Start:
+					if((parent + 1) == depth)
+						return true;
+
+					break;
+				case token_t::End:
+					if(depth < parent)
+						return false;
+
+					break;
+				case token_t::Text:
+					break;
+				default:
+					throw std::runtime_error("XXML_READER: unexpected end of data");
+			}
+		}
+	}
+	//****************************************************************************************
+	std::string XXML_READER::Text()
+	{
+		std::string result;
+		const size_t level = depth;
+
+		for(;;)
+		{
+			switch(next())
+			{
+				case token_t::Text:
+					result.append(text);
+					break;
+				case token_t::End:
+					if(depth < level)
+						return result;
+
+					break;
+				case token_t::Start:
+					break;
+				default:
+					throw std::runtime_error("XXML_READER: unexpected end of data");
+			}
+		}
+	}
+	//****************************************************************************************
+	std::wstring XXML_READER::WText()
+	{
+		return wide(Text());
+	}
+	//****************************************************************************************
+	void XXML_READER::Skip()
+	{
+		const size_t level = depth;
+
+		for(;;)
+		{
+			switch(next())
+			{
+				case token_t::End:
+					if(depth < level)
+						return;
+
+					break;
+				case token_t::End_of_data:
+					throw std::runtime_error("XXML_READER: unexpected end of data");
+				default:
+					break;
+			}
+		}
+	}
+	//****************************************************************************************
+	std::string_view XXML_READER::trim(std::string_view value)
+	{
+		while(value.size() && strchr(" \t\r\n", value.front()))
+			value.remove_prefix(1);
+
+		while(value.size() && strchr(" \t\r\n", value.back()))
+			value.remove_suffix(1);
+
+		return value;
+	}
+	//****************************************************************************************
+	template<typename T>
+	T XXML_READER::Number()
+	{
+		std::string value = Text();
+		std::string_view digits = trim(value);
+
+		T result = 0;
+
+		auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), result);
+		if((std::errc() != error) || (end != digits.data() + digits.size()))
+			throw std::runtime_error("XXML_READER: invalid number");
+
+		return result;
+	}
+	//****************************************************************************************
+	std::vector<unsigned char> XXML_READER::Hex()
+	{
+		std::string value = Text();
+		std::string_view codes = trim(value);
+
+		std::vector<unsigned char> result;
+		result.reserve((codes.size() + 1) / 3);
+
+		while(codes.size())
+		{
+			size_t length = codes.find_first_of(" \t\r\n");
+			if(std::string_view::npos == length)
+				length = codes.size();
+
+			unsigned char code = 0;
+
+			auto [end, error] = std::from_chars(codes.data(), codes.data() + length, code, 16);
+			if((std::errc() != error) || (end != codes.data() + length))
+				throw std::runtime_error("XXML_READER: invalid hexadecimal code");
+
+			result.push_back(code);
+
+			codes = trim(codes.substr(length));
+		}
+
+		return result;
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Streaming writer of XML with XSEC schema
+	//****************************************************************************************
+	// Writes the same elements and attributes as "operator xml_t" does, but directly into a
+	// buffer without DOM and without MSXML. Usage pattern (from "Write" functions):
+	//
+	//     xml.Start(root.value_or("SID"));
+	//     xml.Attribute("CommonName", commonName());
+	//     xml.Element("Revision", Revision);
+	//     xml.End();
+	//
+	// Output is UTF-8, buffer is written into the stream each time it reaches "capacity".
+	struct XXML_WRITER
+	{
+		XXML_WRITER() = delete;
+		~XXML_WRITER();
+
+		XXML_WRITER(const XXML_WRITER&) = delete;
+		XXML_WRITER(std::ostream&, const size_t& /*capacity*/ = 0x10000);
+
+		void Declaration(); // "<?xml ...?>", must be called before the root element
+
+		void Start(std::string_view); // Open new element, attributes could be added until any content
+		void Start(std::wstring_view);
+		void Attribute(std::string_view, std::string_view);
+		void Attribute(std::string_view, std::wstring_view);
+		void End(); // Close the last open element
+
+		#pragma region Content of the current element
+		void Text(std::string_view);
+		void Text(std::wstring_view);
+
+		template<typename T>
+		void Number(const T&); // Decimal, as "_variant_t" makes
+
+		void Hex(std::span<const unsigned char>); // Same as "hex_codes"
+		#pragma endregion
+
+		template<typename T>
+		void Element(std::string_view, const T&); // Element with a single text or number
+
+		void Flush(); // Write buffer into the stream
+
+		uint64_t Written = 0; // Number of bytes passed to the stream
+
+	private:
+		std::ostream& stream;
+
+		std::string buffer;
+		size_t capacity = 0;
+
+		std::string names; // Names of all open elements, one after another
+		std::vector<size_t> offsets; // Start of each name in "names"
+		bool open = false; // Start tag of the last element is not finished by ">" yet
+
+		std::string converted; // UTF-8 copy of the last wide string
+
+		void content();
+		void escape(std::string_view, const bool& /*attribute*/);
+		std::string_view narrow(std::wstring_view);
+		void check();
+	};
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+	#pragma region Writer
+	//****************************************************************************************
+	XXML_WRITER::XXML_WRITER(std::ostream& value, const size_t& size) : stream(value), capacity(size)
+	{
+		buffer.reserve(capacity + 0x1000);
+	}
+	//****************************************************************************************
+	XXML_WRITER::~XXML_WRITER()
+	{
+		try
+		{
+			Flush();
+		}
+		catch(...)
+		{
+		}
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Flush()
+	{
+		if(buffer.empty())
+			return;
+
+		stream.write(buffer.data(), buffer.size());
+		if(stream.fail())
+			throw std::runtime_error("XXML_WRITER: cannot write to stream");
+
+		Written += buffer.size();
+		buffer.clear();
+	}
+	//****************************************************************************************
+	void XXML_WRITER::check()
+	{
+		if(buffer.size() >= capacity)
+			Flush();
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Declaration()
+	{
+		if(Written || buffer.size())
+			throw std::runtime_error("XXML_WRITER: declaration must be the first");
+
+		buffer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n");
+	}
+	//****************************************************************************************
+	void XXML_WRITER::content()
+	{
+		if(open)
+		{
+			buffer.push_back('>');
+			open = false;
+		}
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Start(std::string_view name)
+	{
+		content();
+
+		buffer.push_back('<');
+		buffer.append(name);
+
+		offsets.push_back(names.size());
+		names.append(name);
+
+		open = true;
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Start(std::wstring_view name)
+	{
+		Start(narrow(name));
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Attribute(std::string_view name, std::string_view value)
+	{
+		if(false == open)
+			throw std::runtime_error("XXML_WRITER: attributes are allowed only before content");
+
+		buffer.push_back(' ');
+		buffer.append(name);
+		buffer.append("=\"");
+		escape(value, true);
+		buffer.push_back('"');
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Attribute(std::string_view name, std::wstring_view value)
+	{
+		Attribute(name, narrow(value));
+	}
+	//****************************************************************************************
+	void XXML_WRITER::End()
+	{
+		if(offsets.empty())
+			throw std::runtime_error("XXML_WRITER: there is no open element");
+
+		std::string_view name = std::string_view(names).substr(offsets.back());
+
+		if(open)
+		{
+			buffer.append("/>");
+			open = false;
+		}
+		else
+		{
+			buffer.append("</");
+			buffer.append(name);
+			buffer.push_back('>');
+		}
+
+		names.resize(offsets.back());
+		offsets.pop_back();
+
+		check();
+	}
+	//****************************************************************************************
+	void XXML_WRITER::escape(std::string_view value, const bool& attribute)
+	{
+		// Runs without special characters are copied at once
+		const char* special = attribute ? "<>&\"" : "<>&";
+
+		for(size_t start = 0; start < value.size();)
+		{
+			size_t end = value.find_first_of(special, start);
+			if(std::string_view::npos == end)
+			{
+				buffer.append(value.substr(start));
+				break;
+			}
+
+			buffer.append(value.substr(start, end - start));
+
+			switch(value[end])
+			{
+				case '<':
+					buffer.append("&lt;");
+					break;
+				case '>':
+					buffer.append("&gt;");
+					break;
+				case '&':
+					buffer.append("&amp;");
+					break;
+				default:
+					buffer.append("&quot;");
+			}
+
+			start = end + 1;
+		}
+	}
+	//****************************************************************************************
+	std::string_view XXML_WRITER::narrow(std::wstring_view value)
+	{
+		converted.clear();
+
+		for(size_t i = 0; i < value.size(); i++)
+		{
+			uint32_t code = (std::make_unsigned_t<wchar_t>)value[i];
+
+			if((code >= 0xD800) && (code < 0xDC00) && (i + 1 < value.size()))
+			{
+				uint32_t low = (std::make_unsigned_t<wchar_t>)value[i + 1];
+				if((low >= 0xDC00) && (low < 0xE000))
+				{
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					i++;
+				}
+			}
+
+			XXML_READER::utf8(converted, code);
+		}
+
+		return converted;
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Text(std::string_view value)
+	{
+		content();
+		escape(value, false);
+		check();
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Text(std::wstring_view value)
+	{
+		Text(narrow(value));
+	}
+	//****************************************************************************************
+	template<typename T>
+	void XXML_WRITER::Number(const T& value)
+	{
+		content();
+
+		char data[24];
+		auto [end, error] = std::to_chars(data, data + sizeof(data), value);
+
+		buffer.append(data, end);
+	}
+	//****************************************************************************************
+	void XXML_WRITER::Hex(std::span<const unsigned char> value)
+	{
+		static constexpr char codes[] = "0123456789ABCDEF";
+
+		content();
+
+		for(size_t i = 0; i < value.size(); i++)
+		{
+			if(i)
+				buffer.push_back(' ');
+
+			buffer.push_back(codes[value[i] >> 4]);
+			buffer.push_back(codes[value[i] & 0x0F]);
+		}
+
+		check();
+	}
+	//****************************************************************************************
+	template<typename T>
+	void XXML_WRITER::Element(std::string_view name, const T& value)
+	{
+		Start(name);
+
+		if constexpr(std::is_integral_v<T>)
+			Number(value);
+		else
+			Text(value);
+
+		End();
+	}
+	//****************************************************************************************
+	#pragma endregion
+	//****************************************************************************************
+};
+//********************************************************************************************
@@ -0,0 +1,45 @@
+#pragma once
+//********************************************************************************************
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BENCH_BARRIER() _ReadWriteBarrier()
+#else
+#define BENCH_BARRIER() asm volatile("" ::: "memory")
+#endif
+//********************************************************************************************
+// Checks stay active in Release builds, a failed one stops the whole program
+#define BENCH_CHECK(condition) ((condition) ? (void)0 : bench_fail(#condition, __FILE__, __LINE__))
+//********************************************************************************************
+[[noreturn]] inline void bench_fail(const char* condition, const char* file, const int& line)
+{
+	fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+	exit(1);
+}
+//********************************************************************************************
+// Nanoseconds per call, result of each call is kept so the call could not be optimized away
+template<typename F>
+double bench_ns(F&& function, const size_t& iterations)
+{
+	volatile size_t sink = 0;
+	size_t accumulator = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for(size_t i = 0; i < iterations; i++)
+	{
+		BENCH_BARRIER(); // Inputs are treated as changed, so calls are not merged
+		accumulator += (size_t)function();
+	}
+
+	auto stop = std::chrono::steady_clock::now();
+
+	sink = accumulator;
+	(void)sink;
+
+	return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+}
+//********************************************************************************************
@@ -0,0 +1,377 @@
+// Memory per claim for three layouts of XSECURITY_ATTRIBUTE_V1 data members: "variant" (one heap
+// object per value), "compact" (typed tables of XSECURITY_ATTRIBUTE_VALUES with a private copy of
+// meanings in each XBITSET) and "shared" (meanings interned by intern.h, FQBN versions in
+// "Integers", one block for both conversion buffers). std::u16string stands in for the 2-byte
+// Windows std::wstring. Argument "quick" only checks interning and that "shared" is the smallest.
+#include "intern.h"
+#include "bench.h"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace XSEC;
+//********************************************************************************************
+#pragma region Heap accounting for all allocations of the program
+size_t heap_current = 0;
+size_t heap_blocks = 0;
+//********************************************************************************************
+// Size is kept in front of each block, 16 bytes keep the alignment of "malloc"
+void* operator new(size_t size)
+{
+	unsigned char* block = (unsigned char*)malloc(size + 16);
+	if(nullptr == block)
+		throw std::bad_alloc();
+
+	memcpy(block, &size, sizeof(size));
+
+	heap_current += size;
+	heap_blocks++;
+
+	return block + 16;
+}
+//********************************************************************************************
+void operator delete(void* value) noexcept
+{
+	if(nullptr == value)
+		return;
+
+	unsigned char* block = (unsigned char*)value - 16;
+
+	size_t size = 0;
+	memcpy(&size, block, sizeof(size));
+
+	heap_current -= size;
+	heap_blocks--;
+	free(block);
+}
+//********************************************************************************************
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+//********************************************************************************************
+void operator delete[](void* value) noexcept
+{
+	operator delete(value);
+}
+//********************************************************************************************
+void operator delete(void* value, size_t) noexcept
+{
+	operator delete(value);
+}
+//********************************************************************************************
+void operator delete[](void* value, size_t) noexcept
+{
+	operator delete(value);
+}
+#pragma endregion
+//********************************************************************************************
+#pragma region Data members of the layouts
+typedef std::vector<unsigned char> bin_t;
+typedef std::array<std::array<std::u16string, 2>, 32> meaning_t;
+//********************************************************************************************
+// The same strings as SecurityAttributeV1Meaning in bitset.h
+const meaning_t SecurityAttributeV1Meaning = { {
+	{ u"CLAIM_SECURITY_ATTRIBUTE_NON_INHERITABLE", u"Attribute must not be inherited across process spawns" },
+	{ u"CLAIM_SECURITY_ATTRIBUTE_VALUE_CASE_SENSITIVE", u"Attribute value is compared in a case sensitive way. It is valid with string value or composite type containing string value" },
+	{ u"CLAIM_SECURITY_ATTRIBUTE_USE_FOR_DENY_ONLY", u"Attribute is considered only for Deny access" },
+	{ u"CLAIM_SECURITY_ATTRIBUTE_DISABLED_BY_DEFAULT", u"Attribute is disabled by default" },
+	{ u"CLAIM_SECURITY_ATTRIBUTE_DISABLED", u"Attribute is disabled" },
+	{ u"CLAIM_SECURITY_ATTRIBUTE_MANDATORY", u"Attribute is mandatory" },
+	{}, {}, {}, {}, {}, {}, {}, {}, {}, {},
+	{ u"FCI_CLAIM_SECURITY_ATTRIBUTE_MANUAL", u"The CLAIM_SECURITY_ATTRIBUTE has been manually assigned" },
+	{ u"FCI_CLAIM_SECURITY_ATTRIBUTE_POLICY_DERIVED", u"The CLAIM_SECURITY_ATTRIBUTE has been determined by a central policy" },
+	{}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}
+} };
+//********************************************************************************************
+// XBITSET<32> with a private copy of meanings
+struct COPIED_BITSET
+{
+	COPIED_BITSET(const uint32_t& bits, const meaning_t& meaning) : Bits(bits), Meaning(meaning) {}
+
+	std::bitset<32> Bits;
+	const meaning_t Meaning;
+	const size_t Length = 4;
+};
+//********************************************************************************************
+// XBITSET<32> as in bitset.h now
+struct SHARED_BITSET
+{
+	SHARED_BITSET(const uint32_t& bits, const meaning_t& meaning) : Bits(bits), table(intern(meaning, meaning_hash(meaning))) {}
+
+	std::bitset<32> Bits;
+
+private:
+	std::shared_ptr<const meaning_t> table;
+
+public:
+	const meaning_t& Meaning = *table;
+	const size_t Length = 4;
+};
+//********************************************************************************************
+struct SID_VALUE
+{
+	uint8_t Revision = 1;
+	uint32_t IdentifierAuthority = 5;
+	std::vector<uint32_t> SubAuthority;
+	size_t Length = 0;
+};
+//********************************************************************************************
+struct FQBN_VALUE
+{
+	uint64_t Version = 1;
+	std::u16string Name;
+};
+//********************************************************************************************
+struct OCTET_VALUE
+{
+	bin_t Value;
+};
+//********************************************************************************************
+struct VARIANT_LAYOUT
+{
+	std::u16string Name;
+	uint16_t ValueType = 0;
+	std::shared_ptr<COPIED_BITSET> Flags;
+	std::vector<std::variant<int64_t, uint64_t, std::shared_ptr<std::u16string>, std::shared_ptr<FQBN_VALUE>, std::shared_ptr<OCTET_VALUE>, std::shared_ptr<SID_VALUE>>> Values;
+	std::unique_ptr<bin_t> buffer_claim = std::make_unique<bin_t>();
+	std::unique_ptr<bin_t> buffer_token = std::make_unique<bin_t>();
+	std::unique_ptr<std::vector<bin_t>> bins = std::make_unique<std::vector<bin_t>>();
+};
+//********************************************************************************************
+struct COMPACT_LAYOUT
+{
+	std::u16string Name;
+	uint16_t ValueType = 0;
+	std::shared_ptr<COPIED_BITSET> Flags;
+
+	struct
+	{
+		std::vector<int64_t> Integers;
+		std::vector<uint64_t> Versions;
+		std::u16string Strings;
+		bin_t Binaries;
+		std::vector<uint32_t> Offsets;
+	} Values;
+
+	std::shared_ptr<const void> ValueSet;
+	std::unique_ptr<bin_t> buffer_claim;
+	std::unique_ptr<bin_t> buffer_token;
+};
+//********************************************************************************************
+struct SHARED_LAYOUT
+{
+	std::u16string Name;
+	uint16_t ValueType = 0;
+	std::shared_ptr<SHARED_BITSET> Flags;
+
+	struct
+	{
+		std::vector<int64_t> Integers;
+		std::u16string Strings;
+		bin_t Binaries;
+		std::vector<uint32_t> Offsets;
+	} Values;
+
+	std::shared_ptr<const void> ValueSet;
+	std::unique_ptr<std::array<bin_t, 2>> buffers;
+};
+#pragma endregion
+//********************************************************************************************
+#pragma region Filling of the layouts
+// Input of the constructor from CLAIM_SECURITY_ATTRIBUTE_V1, values are pushed one by one as all layouts do
+struct CLAIM_INPUT
+{
+	const char* Title;
+	std::u16string Name;
+	uint16_t ValueType;
+	std::vector<int64_t> Integers;
+	std::vector<std::u16string> Strings;
+	std::vector<std::vector<uint32_t>> Sids;
+};
+//********************************************************************************************
+bin_t sid_bin(const std::vector<uint32_t>& subAuthority)
+{
+	bin_t result = { 1, (unsigned char)subAuthority.size(), 0, 0, 0, 0, 0, 5 };
+
+	for(uint32_t element : subAuthority)
+	{
+		for(size_t i = 0; i < 4; i++)
+			result.push_back((unsigned char)(element >> (8 * i)));
+	}
+
+	return result;
+}
+//********************************************************************************************
+void fill(VARIANT_LAYOUT& result, const CLAIM_INPUT& input)
+{
+	result.Name = input.Name;
+	result.ValueType = input.ValueType;
+	result.Flags = std::make_shared<COPIED_BITSET>(0x10000, SecurityAttributeV1Meaning);
+
+	for(int64_t element : input.Integers)
+		result.Values.push_back(element);
+
+	for(auto&& element : input.Strings)
+		result.Values.push_back(std::make_shared<std::u16string>(element));
+
+	for(auto&& element : input.Sids)
+	{
+		auto sid = std::make_shared<SID_VALUE>();
+		sid->SubAuthority = element;
+		sid->Length = 8 + 4 * element.size();
+
+		result.Values.push_back(sid);
+	}
+}
+//********************************************************************************************
+template<typename T>
+void fill_values(T& result, const CLAIM_INPUT& input)
+{
+	if(input.Integers.size())
+		result.Values.Integers.assign(input.Integers.begin(), input.Integers.end());
+
+	for(auto&& element : input.Strings)
+	{
+		result.Values.Strings.append(element);
+		result.Values.Strings.push_back(0);
+		result.Values.Offsets.push_back((uint32_t)result.Values.Strings.size());
+	}
+
+	for(auto&& element : input.Sids)
+	{
+		bin_t sid = sid_bin(element);
+		result.Values.Binaries.insert(result.Values.Binaries.end(), sid.begin(), sid.end());
+		result.Values.Offsets.push_back((uint32_t)result.Values.Binaries.size());
+	}
+}
+//********************************************************************************************
+void fill(COMPACT_LAYOUT& result, const CLAIM_INPUT& input)
+{
+	result.Name = input.Name;
+	result.ValueType = input.ValueType;
+	result.Flags = std::make_shared<COPIED_BITSET>(0x10000, SecurityAttributeV1Meaning);
+
+	fill_values(result, input);
+}
+//********************************************************************************************
+void fill(SHARED_LAYOUT& result, const CLAIM_INPUT& input)
+{
+	result.Name = input.Name;
+	result.ValueType = input.ValueType;
+	result.Flags = std::make_shared<SHARED_BITSET>(0x10000, SecurityAttributeV1Meaning);
+
+	fill_values(result, input);
+}
+//********************************************************************************************
+struct HEAP_USAGE
+{
+	size_t Bytes = 0;
+	size_t Blocks = 0;
+};
+//********************************************************************************************
+// Heap used by one claim, the first interned table is made before measurements
+template<typename T>
+HEAP_USAGE measure(const CLAIM_INPUT& input)
+{
+	size_t bytes = heap_current;
+	size_t blocks = heap_blocks;
+
+	T* claim = new T();
+	fill(*claim, input);
+
+	HEAP_USAGE result{ heap_current - bytes, heap_blocks - blocks };
+
+	delete claim;
+
+	return result;
+}
+#pragma endregion
+//********************************************************************************************
+int main(int argc, char** argv)
+{
+	const bool quick = (argc > 1) && (std::string_view(argv[1]) == "quick");
+
+	#pragma region Interning
+	{
+		meaning_t copy = SecurityAttributeV1Meaning;
+		meaning_t other = SecurityAttributeV1Meaning;
+		other[31][0] = u"OTHER";
+
+		auto first = intern(SecurityAttributeV1Meaning, meaning_hash(SecurityAttributeV1Meaning));
+
+		BENCH_CHECK(first == intern(copy, meaning_hash(copy)));
+		BENCH_CHECK(*first == SecurityAttributeV1Meaning);
+		BENCH_CHECK(first != intern(other, meaning_hash(other)));
+
+		// Equal hashes of different tables are resolved by comparison
+		BENCH_CHECK(first != intern(other, meaning_hash(SecurityAttributeV1Meaning)));
+		BENCH_CHECK(*intern(other, meaning_hash(SecurityAttributeV1Meaning)) == other);
+
+		// Many threads asking for a new table get the same copy
+		meaning_t fresh = SecurityAttributeV1Meaning;
+		fresh[30][0] = u"FRESH";
+
+		std::array<std::shared_ptr<const meaning_t>, 8> results;
+		std::vector<std::thread> threads;
+
+		for(size_t i = 0; i < results.size(); i++)
+			threads.emplace_back([&, i]{ results[i] = intern(fresh, meaning_hash(fresh)); });
+
+		for(auto&& element : threads)
+			element.join();
+
+		for(auto&& element : results)
+			BENCH_CHECK(element == results[0]);
+
+		SHARED_BITSET a(1, SecurityAttributeV1Meaning);
+		SHARED_BITSET b(a);
+
+		BENCH_CHECK(&a.Meaning == first.get());
+		BENCH_CHECK(&b.Meaning == first.get());
+	}
+	#pragma endregion
+
+	#pragma region Memory per claim
+	const CLAIM_INPUT inputs[] = {
+		{ "one INT64", u"ad://ext/department", 1, { 42 }, {}, {} },
+		{ "five INT64", u"ad://ext/department", 1, { 1, 2, 3, 4, 5 }, {}, {} },
+		{ "one 10-char string", u"ad://ext/country", 3, {}, { u"Department" }, {} },
+		{ "five 10-char strings", u"ad://ext/country", 3, {}, { u"Department", u"Accounting", u"Operations", u"Production", u"Compliance" }, {} },
+		{ "three domain SIDs", u"ad://ext/groups", 5, {}, {}, { { 21, 1, 2, 3, 1001 }, { 21, 1, 2, 3, 1002 }, { 21, 1, 2, 3, 1003 } } }
+	};
+
+	if(false == quick)
+	{
+		printf("sizeof: variant %zu, compact %zu, shared %zu | XBITSET<32>: copied %zu, shared %zu\n",
+			sizeof(VARIANT_LAYOUT), sizeof(COMPACT_LAYOUT), sizeof(SHARED_LAYOUT), sizeof(COPIED_BITSET), sizeof(SHARED_BITSET));
+		printf("%-22s | %14s | %14s | %14s\n", "bytes / blocks", "variant", "compact", "shared");
+	}
+
+	for(auto&& input : inputs)
+	{
+		HEAP_USAGE variant = measure<VARIANT_LAYOUT>(input);
+		HEAP_USAGE compact = measure<COMPACT_LAYOUT>(input);
+		HEAP_USAGE shared = measure<SHARED_LAYOUT>(input);
+
+		BENCH_CHECK((shared.Bytes < compact.Bytes) && (shared.Blocks < compact.Blocks));
+		BENCH_CHECK((shared.Bytes < variant.Bytes) && (shared.Blocks < variant.Blocks));
+		BENCH_CHECK(sizeof(SHARED_LAYOUT) < sizeof(COMPACT_LAYOUT));
+
+		if(false == quick)
+			printf("%-22s | %7zu / %4zu | %7zu / %4zu | %7zu / %4zu\n", input.Title, variant.Bytes, variant.Blocks, compact.Bytes, compact.Blocks, shared.Bytes, shared.Blocks);
+	}
+	#pragma endregion
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+// Column-at-a-time integer comparison (compare.h, used by batch evaluation and warehouse scans):
+// scalar, SSE 4.2 and AVX2 versions must give the same masks for all codes, block sizes and
+// edge values. Without arguments also prints time per block of 64 values for each version.
+#include "compare.h"
+#include "bench.h"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <vector>
+
+using namespace XSEC;
+//********************************************************************************************
+int main(int argc, char** argv)
+{
+	const bool quick = (argc > 1) && (std::string_view(argv[1]) == "quick");
+
+	const XCOMPARE_ISA isa = compare_isa();
+	printf("detected: %s\n", (XCOMPARE_ISA::AVX2 == isa) ? "AVX2" : ((XCOMPARE_ISA::SSE42 == isa) ? "SSE 4.2" : "scalar"));
+
+	std::mt19937_64 random(42);
+
+	#pragma region Values around constants, including both ends of signed range
+	const int64_t minimum = std::numeric_limits<int64_t>::min();
+	const int64_t maximum = std::numeric_limits<int64_t>::max();
+	const std::vector<int64_t> constants = { 0, 1, -1, minimum, maximum, 1000 };
+
+	std::vector<int64_t> values(64 * 1024);
+	for(auto&& element : values)
+	{
+		switch(random() % 4)
+		{
+			case 0:
+				element = constants[random() % constants.size()];
+				break;
+			case 1:
+				element = constants[random() % constants.size()] + 1;
+				break;
+			case 2:
+				element = constants[random() % constants.size()] - 1;
+				break;
+			default:
+				element = (int64_t)random();
+		}
+	}
+	#pragma endregion
+
+	#pragma region All versions give the same masks
+	for(const unsigned char code : { 0x80, 0x81, 0x82, 0x83, 0x84, 0x85 })
+	{
+		for(const int64_t constant : constants)
+		{
+			for(size_t offset = 0; offset < 4096; offset += 61)
+			{
+				for(size_t count = 0; count <= 64; count++)
+				{
+					const int64_t* block = values.data() + offset;
+					const uint64_t expected = compare_block_scalar(block, count, constant, code);
+
+					#if defined(XSEC_COMPARE_X86)
+					if(XCOMPARE_ISA::SSE42 <= isa)
+						BENCH_CHECK(expected == compare_block_sse42(block, count, constant, code));
+
+					if(XCOMPARE_ISA::AVX2 <= isa)
+						BENCH_CHECK(expected == compare_block_avx2(block, count, constant, code));
+					#endif
+
+					BENCH_CHECK(expected == compare_block(block, count, constant, code));
+				}
+			}
+		}
+	}
+	#pragma endregion
+
+	if(quick)
+		return 0;
+
+	#pragma region Time per block of 64 values
+	const size_t blocks = values.size() / 64;
+	const size_t iterations = 2000;
+
+	auto measure = [&](auto&& function)
+	{
+		return bench_ns([&]
+		{
+			uint64_t result = 0;
+
+			for(size_t i = 0; i < blocks; i++)
+				result += function(values.data() + (i << 6), (size_t)64, (int64_t)1000, (unsigned char)0x82);
+
+			return result;
+		}, iterations) / blocks;
+	};
+
+	const double scalar = measure([](const int64_t* block, const size_t& count, const int64_t& constant, const unsigned char& code){ return compare_block_scalar(block, count, constant, code); });
+	printf("scalar   %6.2f ns per 64 values\n", scalar);
+
+	#if defined(XSEC_COMPARE_X86)
+	if(XCOMPARE_ISA::SSE42 <= isa)
+	{
+		const double sse42 = measure(compare_block_sse42);
+		printf("SSE 4.2  %6.2f ns per 64 values (%4.1fx)\n", sse42, scalar / sse42);
+	}
+
+	if(XCOMPARE_ISA::AVX2 <= isa)
+	{
+		const double avx2 = measure(compare_block_avx2);
+		printf("AVX2     %6.2f ns per 64 values (%4.1fx)\n", avx2, scalar / avx2);
+	}
+	#endif
+
+	const double dispatched = measure(compare_block);
+	printf("dispatch %6.2f ns per 64 values (%4.1fx)\n", dispatched, scalar / dispatched);
+	#pragma endregion
+
+	return 0;
+}
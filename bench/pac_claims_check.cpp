@@ -0,0 +1,232 @@
+// Decoding of PAC claims (pac_format.h, used by XPAC_CLAIMS): known-answer CLAIMS_SET_METADATA
+// blobs with and without XPRESS Huffman compression, round trips through the test encoder for
+// one and several blocks, and truncated input.
+#include "pac_format.h"
+#include "xpress_encoder.h"
+#include "bench.h"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+using namespace XSEC;
+//********************************************************************************************
+// Known answer: serialized CLAIMS_SET_METADATA, no compression. Generated independently of the decoder
+// by following [MS-RPCE] 2.2.6 and the IDL from [MS-ADTS] 2.2.18:
+//   source 1 (AD): "ad://ext/department" STRING { "Sales", "" }, "ad://ext/clearance" INT64 { 3, -1 }
+//   source 2 (certificate): "cert://flag" BOOLEAN { 1 }, "cert://serial" UINT64 { 0xFFFFFFFFFFFFFFFF }
+const unsigned char plain[] =
+{
+	0x01, 0x10, 0x08, 0x00, 0xCC, 0xCC, 0xCC, 0xCC, 0xE0, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x3C, 0x00, 0x02, 0x00, 0xB8, 0x01, 0x00, 0x00, 0x40, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xB8, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xB8, 0x01, 0x00, 0x00, 0x01, 0x10, 0x08, 0x00, 0xCC, 0xCC, 0xCC, 0xCC, 0xA8, 0x01, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x08, 0x00, 0x02, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+	0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00,
+	0x02, 0x00, 0x00, 0x00, 0x10, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x14, 0x00, 0x02, 0x00,
+	0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x18, 0x00, 0x02, 0x00,
+	0x1C, 0x00, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+	0x20, 0x00, 0x02, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+	0x61, 0x00, 0x64, 0x00, 0x3A, 0x00, 0x2F, 0x00, 0x2F, 0x00, 0x65, 0x00, 0x78, 0x00, 0x74, 0x00,
+	0x2F, 0x00, 0x64, 0x00, 0x65, 0x00, 0x70, 0x00, 0x61, 0x00, 0x72, 0x00, 0x74, 0x00, 0x6D, 0x00,
+	0x65, 0x00, 0x6E, 0x00, 0x74, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x24, 0x00, 0x02, 0x00,
+	0x28, 0x00, 0x02, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
+	0x53, 0x00, 0x61, 0x00, 0x6C, 0x00, 0x65, 0x00, 0x73, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x61, 0x00, 0x64, 0x00, 0x3A, 0x00, 0x2F, 0x00,
+	0x2F, 0x00, 0x65, 0x00, 0x78, 0x00, 0x74, 0x00, 0x2F, 0x00, 0x63, 0x00, 0x6C, 0x00, 0x65, 0x00,
+	0x61, 0x00, 0x72, 0x00, 0x61, 0x00, 0x6E, 0x00, 0x63, 0x00, 0x65, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x02, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x02, 0x00, 0x06, 0x00, 0x00, 0x00,
+	0x06, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x30, 0x00, 0x02, 0x00, 0x34, 0x00, 0x02, 0x00,
+	0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x38, 0x00, 0x02, 0x00,
+	0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x63, 0x00, 0x65, 0x00,
+	0x72, 0x00, 0x74, 0x00, 0x3A, 0x00, 0x2F, 0x00, 0x2F, 0x00, 0x66, 0x00, 0x6C, 0x00, 0x61, 0x00,
+	0x67, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x00,
+	0x63, 0x00, 0x65, 0x00, 0x72, 0x00, 0x74, 0x00, 0x3A, 0x00, 0x2F, 0x00, 0x2F, 0x00, 0x73, 0x00,
+	0x65, 0x00, 0x72, 0x00, 0x69, 0x00, 0x61, 0x00, 0x6C, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+};
+//********************************************************************************************
+// Same CLAIMS_SET compressed with COMPRESSION_FORMAT_XPRESS_HUFF by a separate encoder that gives
+// every symbol a code of 9 bits (table of 0x99 bytes), so codes are the symbols themselves
+const unsigned char packed[] =
+{
+	0x01, 0x10, 0x08, 0x00, 0xCC, 0xCC, 0xCC, 0xCC, 0xE0, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x44, 0x00, 0x02, 0x00, 0xBC, 0x01, 0x00, 0x00, 0x48, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00,
+	0xB8, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xBC, 0x01, 0x00, 0x00, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	0x99, 0x99, 0x99, 0x99, 0x84, 0x00, 0x00, 0x01, 0x64, 0x06, 0x50, 0x01, 0x00, 0x01, 0x80, 0x40,
+	0x00, 0x80, 0x40, 0x14, 0x00, 0x00, 0x24, 0x02, 0x1E, 0x54, 0xAA, 0x63, 0x98, 0x23, 0x65, 0x80,
+	0x92, 0x50, 0x21, 0x10, 0x81, 0x34, 0x04, 0x49, 0x98, 0x03, 0x09, 0x09, 0x00, 0x41, 0x82, 0xC4,
+	0x48, 0x0E, 0x8D, 0x0A, 0xB8, 0x2A, 0x48, 0x10, 0xA5, 0x20, 0x09, 0x91, 0x30, 0x88, 0x0C, 0x80,
+	0x01, 0x80, 0x00, 0xD0, 0x10, 0x5F, 0x40, 0x19, 0x80, 0x07, 0xD2, 0x01, 0x0C, 0x60, 0x04, 0x93,
+	0xA0, 0x70, 0xCA, 0x41, 0x8D, 0x61, 0x08, 0xB3, 0x98, 0x6E, 0x9F, 0x0A, 0x92, 0x04, 0x51, 0x08,
+	0x00, 0x20, 0x40, 0xD6, 0x20, 0x26, 0x50, 0xA7, 0xB2, 0x51, 0x63, 0xA0, 0x92, 0x9D, 0x0C, 0x48,
+	0x04, 0xD4, 0x02, 0xE7, 0x41, 0xDF, 0xA5, 0x8E, 0x00, 0x0D, 0x8B, 0x1B, 0x06, 0x86, 0x04, 0x84,
+	0x39, 0xE4, 0xBA, 0xC0, 0xB8, 0xBF, 0x80, 0x94, 0xE0, 0x16, 0x14, 0x38, 0x59, 0x96, 0x90, 0x06,
+	0x18, 0x00, 0x14, 0x62, 0x1A, 0x28, 0x01, 0x38, 0x28, 0x20, 0x98, 0x53, 0x65, 0x11, 0x93, 0x52,
+	0x61, 0x1A, 0xE3, 0xC1, 0xC7, 0xC1, 0x9A, 0x84, 0x81, 0x67, 0x00, 0xA8, 0xBF, 0x4E, 0x07, 0x01,
+	0x6E, 0x05, 0x39, 0x87, 0x34, 0x96, 0xB2, 0xDC, 0xE1, 0x55, 0x31, 0x75, 0x00, 0x00, 0x00, 0x00,
+};
+//********************************************************************************************
+void check_claims(const XPAC_CLAIMS_SET& set)
+{
+	BENCH_CHECK(4 == set.Claims.size());
+
+	const XPAC_CLAIM& department = set.Claims[0];
+	BENCH_CHECK((1 == department.Source) && (u"ad://ext/department" == department.Name) && (XPAC_CLAIM_TYPE_STRING == department.Type));
+	BENCH_CHECK((2 == department.Strings.size()) && (u"Sales" == department.Strings[0]) && department.Strings[1].empty());
+	BENCH_CHECK(department.Integers.empty());
+
+	const XPAC_CLAIM& clearance = set.Claims[1];
+	BENCH_CHECK((1 == clearance.Source) && (u"ad://ext/clearance" == clearance.Name) && (XPAC_CLAIM_TYPE_INT64 == clearance.Type));
+	BENCH_CHECK((2 == clearance.Integers.size()) && (3 == (int64_t)clearance.Integers[0]) && (-1 == (int64_t)clearance.Integers[1]));
+
+	const XPAC_CLAIM& flag = set.Claims[2];
+	BENCH_CHECK((2 == flag.Source) && (u"cert://flag" == flag.Name) && (XPAC_CLAIM_TYPE_BOOLEAN == flag.Type));
+	BENCH_CHECK((1 == flag.Integers.size()) && (1 == flag.Integers[0]));
+
+	const XPAC_CLAIM& serial = set.Claims[3];
+	BENCH_CHECK((2 == serial.Source) && (u"cert://serial" == serial.Name) && (XPAC_CLAIM_TYPE_UINT64 == serial.Type));
+	BENCH_CHECK((1 == serial.Integers.size()) && (0xFFFFFFFFFFFFFFFF == serial.Integers[0]));
+}
+//********************************************************************************************
+template<typename F>
+bool throws(F&& function)
+{
+	try
+	{
+		function();
+	}
+	catch(const std::runtime_error&)
+	{
+		return true;
+	}
+
+	return false;
+}
+//********************************************************************************************
+int main()
+{
+	#pragma region Known answers
+	{
+		XPAC_CLAIMS_SET set(plain);
+		BENCH_CHECK(XPAC_COMPRESSION_NONE == set.CompressionFormat);
+		check_claims(set);
+	}
+
+	{
+		XPAC_CLAIMS_SET set(packed);
+		BENCH_CHECK(XPAC_COMPRESSION_XPRESS_HUFF == set.CompressionFormat);
+		BENCH_CHECK(440 == set.UncompressedSize);
+		check_claims(set);
+	}
+	#pragma endregion
+
+	#pragma region Same CLAIMS_SET through the test encoder
+	{
+		// CLAIMS_SET starts after the metadata: 16 bytes of headers, 32 bytes of scalars and 4 bytes of count
+		std::span<const unsigned char> inner = std::span(plain).subspan(52, 440);
+
+		std::vector<unsigned char> compressed = xpress_huffman_compress(inner);
+		BENCH_CHECK(compressed.size() < inner.size());
+
+		std::vector<unsigned char> decompressed = xpress_huffman_decompress(compressed, inner.size());
+		BENCH_CHECK(std::equal(decompressed.begin(), decompressed.end(), inner.begin(), inner.end()));
+	}
+	#pragma endregion
+
+	#pragma region Round trips for one and several blocks
+	{
+		std::mt19937 random(17);
+
+		for(size_t size : { 0, 1, 3, 100, 65535, 65536, 65537, 200000 })
+		{
+			// Runs of repeated phrases mixed with random bytes: literals, short and long matches
+			std::vector<unsigned char> data;
+
+			while(data.size() < size)
+			{
+				if((data.size() > 16) && (random() % 3))
+				{
+					size_t offset = 1 + random() % std::min(data.size(), (size_t)70000);
+					size_t length = (random() % 4) ? (3 + random() % 20) : (random() % 2000);
+
+					for(size_t i = 0; (i < length) && (data.size() < size); i++)
+						data.push_back(data[data.size() - offset]);
+				}
+				else
+					data.push_back((unsigned char)random());
+			}
+
+			std::vector<unsigned char> compressed = xpress_huffman_compress(data);
+			BENCH_CHECK(xpress_huffman_decompress(compressed, data.size()) == data);
+		}
+
+		// One byte repeated: matches longer than 270 bytes use the 16-bit length
+		std::vector<unsigned char> zeros(150000, 0);
+		BENCH_CHECK(xpress_huffman_decompress(xpress_huffman_compress(zeros), zeros.size()) == zeros);
+	}
+	#pragma endregion
+
+	#pragma region Truncated input
+	{
+		for(size_t size = 0; size < sizeof(plain); size++)
+			BENCH_CHECK(throws([&]{ XPAC_CLAIMS_SET set(std::span(plain, size)); }));
+
+		for(size_t size = 0; size < sizeof(packed); size++)
+			BENCH_CHECK(throws([&]{ XPAC_CLAIMS_SET set(std::span(packed, size)); }));
+
+		// Missing bits of a compressed stream are zeros, such streams could decode without errors,
+		// but must never read outside of the input
+		std::span<const unsigned char> stream = std::span(packed).subspan(52, 444);
+
+		for(size_t size = 0; size < stream.size(); size++)
+		{
+			try
+			{
+				xpress_huffman_decompress(stream.first(size), 440);
+			}
+			catch(const std::runtime_error&)
+			{
+			}
+		}
+
+		BENCH_CHECK(throws([]{ xpress_huffman_decompress(std::span(packed).subspan(52, 200), 440); }));
+	}
+	#pragma endregion
+
+	#pragma region Invalid content
+	{
+		std::vector<unsigned char> data(std::begin(plain), std::end(plain));
+
+		data[52 + 16 + 24] ^= 0xFF; // Maximum count of CLAIMS_ARRAY does not match ulClaimsArrayCount
+		BENCH_CHECK(throws([&]{ XPAC_CLAIMS_SET set(data); }));
+
+		data.assign(std::begin(packed), std::end(packed));
+		data[16 + 12] = 3; // COMPRESSION_FORMAT_XPRESS
+		BENCH_CHECK(throws([&]{ XPAC_CLAIMS_SET set(data); }));
+	}
+	#pragma endregion
+
+	return 0;
+}
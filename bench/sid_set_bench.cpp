@@ -0,0 +1,117 @@
+// Member_of / Member_of_Any over sorted SID sets (sorted.h, used by XSID_SET) against pairwise
+// comparison of every operand SID with every token SID. Argument "quick" only checks results.
+#include "sorted.h"
+#include "bench.h"
+
+#include <cstring>
+#include <cstdint>
+#include <random>
+#include <string_view>
+
+using namespace XSEC;
+using bin_t = std::vector<unsigned char>;
+//********************************************************************************************
+// Binary S-1-5-21-<domain>-<domain + 2000>-3000-<rid>
+bin_t sid(const uint32_t& rid, const uint32_t& domain = 1000)
+{
+	bin_t result = { 1, 5, 0, 0, 0, 0, 0, 5 };
+
+	for(const uint32_t& value : { (uint32_t)21, domain, 2000 + domain, (uint32_t)3000, rid })
+	{
+		for(size_t i = 0; i < 4; i++)
+			result.push_back((unsigned char)(value >> (8 * i)));
+	}
+
+	return result;
+}
+//********************************************************************************************
+bool equal(const bin_t& lhs, const bin_t& rhs)
+{
+	return (lhs.size() == rhs.size()) && (0 == memcmp(lhs.data(), rhs.data(), lhs.size()));
+}
+//********************************************************************************************
+bool naive_all(const std::vector<bin_t>& token, const std::vector<bin_t>& operand)
+{
+	for(auto&& element : operand)
+	{
+		if(std::none_of(token.begin(), token.end(), [&](const bin_t& value){ return equal(value, element); }))
+			return false;
+	}
+
+	return true;
+}
+//********************************************************************************************
+bool naive_any(const std::vector<bin_t>& token, const std::vector<bin_t>& operand)
+{
+	for(auto&& element : operand)
+	{
+		if(std::any_of(token.begin(), token.end(), [&](const bin_t& value){ return equal(value, element); }))
+			return true;
+	}
+
+	return false;
+}
+//********************************************************************************************
+int main(int argc, char** argv)
+{
+	const bool quick = (argc > 1) && (std::string_view(argv[1]) == "quick");
+
+	std::mt19937 random(42);
+
+	for(const size_t groups : { 50, 300, 1000 })
+	{
+		for(const size_t size : { 5, 10, 50, 100, 300 })
+		{
+			if(size > groups)
+				continue;
+
+			#pragma region Token groups in random order, operands picked at random
+			std::vector<bin_t> token;
+			for(size_t i = 0; i < groups; i++)
+				token.push_back(sid((uint32_t)(1000 + 3 * i)));
+
+			std::shuffle(token.begin(), token.end(), random);
+
+			// "all": operand is a subset of token groups, each SID is found (worst case)
+			std::vector<bin_t> all = token;
+			std::shuffle(all.begin(), all.end(), random);
+			all.resize(size);
+
+			// "any": operand has no common SIDs with token groups, nothing is found (worst case)
+			std::vector<bin_t> any;
+			for(size_t i = 0; i < size; i++)
+				any.push_back(sid((uint32_t)(1001 + 3 * i)));
+
+			std::vector<bin_t> sortedToken = token;
+			std::vector<bin_t> sortedAll = all;
+			std::vector<bin_t> sortedAny = any;
+
+			sort_unique(sortedToken);
+			sort_unique(sortedAll);
+			sort_unique(sortedAny);
+			#pragma endregion
+
+			#pragma region Both ways give the same results
+			BENCH_CHECK(naive_all(token, all) == sorted_includes(sortedToken, sortedAll));
+			BENCH_CHECK(naive_any(token, any) == sorted_intersects(sortedToken, sortedAny));
+			BENCH_CHECK(naive_any(token, all) == sorted_intersects(sortedAll, sortedToken));
+			BENCH_CHECK(naive_all(token, any) == sorted_includes(sortedToken, sortedAny));
+			#pragma endregion
+
+			if(quick)
+				continue;
+
+			const size_t iterations = 200000000 / (groups * size) + 1000;
+
+			double naiveAll = bench_ns([&]{ return naive_all(token, all); }, iterations);
+			double setAll = bench_ns([&]{ return sorted_includes(sortedToken, sortedAll); }, iterations);
+			double naiveAny = bench_ns([&]{ return naive_any(token, any); }, iterations);
+			double setAny = bench_ns([&]{ return sorted_intersects(sortedToken, sortedAny); }, iterations);
+
+			printf("groups %5zu operand %4zu | Member_of %9.0f ns -> %7.0f ns (%5.1fx) | Member_of_Any %9.0f ns -> %7.0f ns (%5.1fx)\n",
+				groups, size, naiveAll, setAll, naiveAll / setAll, naiveAny, setAny, naiveAny / setAny);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,138 @@
+// Round trip and validation of binary token snapshots (snapshot_format.h)
+#include "snapshot_format.h"
+#include "bench.h"
+
+using namespace XSEC;
+using bytes_t = std::vector<unsigned char>;
+//********************************************************************************************
+// S-1-5-<rid>: revision, count of sub-authorities, authority, one sub-authority
+bytes_t sid(const unsigned char& rid)
+{
+	return bytes_t{ 1, 1, 0, 0, 0, 0, 0, 5, rid, 0, 0, 0 };
+}
+//********************************************************************************************
+bytes_t make(const bool& linked, const bytes_t& inner)
+{
+	XTOKEN_SNAPSHOT_WRITER writer(std::set<bytes_t>{ sid(30), sid(10), sid(20) });
+
+	XTOKEN_SNAPSHOT_SCALARS scalars{};
+	scalars.User = writer.Sid(sid(20));
+	scalars.Owner = writer.Sid(sid(20));
+	scalars.PrimaryGroup = writer.Sid(sid(10));
+	scalars.IntegrityLevel = writer.Sid({});
+	scalars.AppContainerSid = XTOKEN_SNAPSHOT_NO_SID;
+	scalars.Present = PresentSource | (linked ? (uint32_t)PresentIsLinkedToken : 0);
+	memcpy(scalars.SourceName, "User32 ", 7);
+	writer.Scalars(scalars);
+
+	std::vector<XTOKEN_SNAPSHOT_GROUP> groups = { { writer.Sid(sid(10)), 7 }, { writer.Sid(sid(30)), 0x20 } };
+	writer.Groups(XTOKEN_SNAPSHOT_SECTION::Groups, groups);
+	writer.Groups(XTOKEN_SNAPSHOT_SECTION::Capabilities, {});
+
+	// Record of privilege has the same size as record of blob, attributes must not be read as blob size
+	std::vector<XTOKEN_SNAPSHOT_PRIVILEGE> privileges = { { 23, 0, 0x80000003, 0 }, { 0xFFFFFFFF, -1, 0, 0 } };
+	writer.Privileges(privileges);
+
+	writer.Blobs(XTOKEN_SNAPSHOT_SECTION::UserClaims, { bytes_t(13, 0xAB), bytes_t(8, 0xCD), bytes_t(1, 0xEF) });
+	writer.Bytes(XTOKEN_SNAPSHOT_SECTION::DefaultDacl, bytes_t{ 2, 0, 8, 0, 0, 0, 0, 0 });
+
+	if(false == inner.empty())
+		writer.Bytes(XTOKEN_SNAPSHOT_SECTION::LinkedToken, bytes_t(inner));
+
+	return writer.Data();
+}
+//********************************************************************************************
+bool rejected(std::span<const unsigned char> data)
+{
+	try
+	{
+		XTOKEN_SNAPSHOT_READER reader{ data };
+	}
+	catch(const std::runtime_error&)
+	{
+		return true;
+	}
+
+	return false;
+}
+//********************************************************************************************
+int main()
+{
+	bytes_t data = make(false, make(true, {}));
+
+	#pragma region Round trip through a mapped file
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "snapshot_format_check.snapshot";
+	XTOKEN_SNAPSHOT_WRITER::Save(data, path);
+
+	std::optional<XTOKEN_SNAPSHOT_READER> linked;
+
+	{
+		XTOKEN_SNAPSHOT_READER reader(path);
+
+		BENCH_CHECK(reader.Data.size() == data.size());
+		BENCH_CHECK(3 == reader.SidCount());
+		BENCH_CHECK(std::ranges::equal(reader.Sid(0), sid(10)) && std::ranges::equal(reader.Sid(2), sid(30)));
+		BENCH_CHECK(std::ranges::equal(reader.Sid(reader.Scalars().User), sid(20)));
+		BENCH_CHECK(XTOKEN_SNAPSHOT_NO_SID == reader.Scalars().IntegrityLevel);
+		BENCH_CHECK(0 == strcmp(reader.Scalars().SourceName, "User32 "));
+		BENCH_CHECK(reader.HasGroup(sid(10)) && (false == reader.HasGroup(sid(30))) && reader.HasGroup(sid(30), 0x20));
+		BENCH_CHECK((false == reader.FindSid(sid(99)).has_value()) && reader.Groups(XTOKEN_SNAPSHOT_SECTION::Capabilities).empty());
+		BENCH_CHECK((2 == reader.Privileges().size()) && (0x80000003 == reader.Privileges()[0].Attributes) && (-1 == reader.Privileges()[1].HighPart));
+
+		auto blobs = reader.Blobs();
+		BENCH_CHECK((3 == blobs.size()) && (13 == blobs[0].size()) && (0xCD == blobs[1][7]) && (1 == blobs[2].size()));
+		BENCH_CHECK((8 == reader.DefaultDacl().size()) && reader.SecurityDescriptor().empty() && (false == reader.GroupSet().has_value()));
+
+		linked = reader.LinkedToken();
+		BENCH_CHECK(linked.has_value());
+	}
+
+	// Mapping is kept by the linked snapshot after the parent is gone
+	BENCH_CHECK(linked->Scalars().Present & PresentIsLinkedToken);
+	BENCH_CHECK((2 == linked->Groups().size()) && (false == linked->LinkedToken().has_value()));
+
+	std::filesystem::remove(path);
+	#pragma endregion
+
+	#pragma region Truncated snapshots claiming their own size
+	size_t count = 0;
+
+	for(size_t size = 0; size < data.size(); size += 8, count++)
+	{
+		bytes_t part(data.begin(), data.begin() + size);
+		if(size >= sizeof(XTOKEN_SNAPSHOT_HEADER))
+		{
+			uint64_t value = size;
+			memcpy(part.data() + offsetof(XTOKEN_SNAPSHOT_HEADER, Size), &value, sizeof(value));
+		}
+
+		BENCH_CHECK(rejected(part));
+	}
+	#pragma endregion
+
+	#pragma region Declared size smaller than header or table of sections
+	for(const uint64_t& size : { (uint64_t)0, (uint64_t)8, (uint64_t)sizeof(XTOKEN_SNAPSHOT_HEADER), (uint64_t)(sizeof(XTOKEN_SNAPSHOT_HEADER) + 2 * sizeof(XTOKEN_SNAPSHOT_ENTRY)) })
+	{
+		bytes_t header(sizeof(XTOKEN_SNAPSHOT_HEADER) + 3 * sizeof(XTOKEN_SNAPSHOT_ENTRY), 0);
+		XTOKEN_SNAPSHOT_HEADER value{ XTOKEN_SNAPSHOT_MAGIC, XTOKEN_SNAPSHOT_VERSION, 3, size };
+		memcpy(header.data(), &value, sizeof(value));
+
+		// Buffer ends right after declared size, nothing after it could be read
+		bytes_t exact(header.begin(), header.begin() + std::max<size_t>(sizeof(value), (size_t)size));
+
+		BENCH_CHECK(rejected(exact));
+		BENCH_CHECK(rejected(header));
+	}
+	#pragma endregion
+
+	#pragma region Misaligned data
+	bytes_t shifted(data.size() + 1);
+	memcpy(shifted.data() + 1, data.data(), data.size());
+
+	BENCH_CHECK(rejected(std::span<const unsigned char>(shifted).subspan(1)));
+	#pragma endregion
+
+	printf("snapshot %zu bytes, %zu truncated prefixes rejected\n", data.size(), count);
+
+	return 0;
+}
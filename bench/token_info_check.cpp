@@ -0,0 +1,146 @@
+// Selective loading of token information classes (token_info.h, used by XTOKEN::Load) with
+// a fake token, the check of required classes and the in-memory store of raw information.
+#include "token_info.h"
+#include "bench.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace XSEC;
+//********************************************************************************************
+// Same values as TOKEN_INFORMATION_CLASS
+constexpr uint32_t TokenUser = 1;
+constexpr uint32_t TokenGroups = 2;
+constexpr uint32_t TokenLinkedToken = 19;
+constexpr uint64_t ClassAll = ~(uint64_t)0;
+//********************************************************************************************
+// Shape of XTOKEN used by "load_classes", "Queried" collects classes read from the provider
+struct FAKE_TOKEN
+{
+	FAKE_TOKEN(const uint64_t& classes, const bool& available, const bool& isLinkedToken) : Available(available), IsLinkedToken(isLinkedToken)
+	{
+		Load(classes);
+	}
+
+	FAKE_TOKEN& Load(const uint64_t& classes)
+	{
+		return load_classes(*this, classes, Available, [this](const uint64_t& required, const uint64_t& linked)
+		{
+			Queried |= required;
+			Queries++;
+
+			if(required & token_class(TokenLinkedToken))
+				LinkedToken = (IsLinkedToken) ? nullptr : std::make_shared<FAKE_TOKEN>(linked, Available, true);
+		});
+	}
+
+	bool Available;
+	bool IsLinkedToken;
+
+	uint64_t Loaded = 0;
+	uint64_t Queried = 0;
+	size_t Queries = 0;
+
+	std::shared_ptr<FAKE_TOKEN> LinkedToken;
+};
+//********************************************************************************************
+struct RAW
+{
+	uint32_t First;
+	uint64_t Second;
+};
+//********************************************************************************************
+int main()
+{
+	#pragma region Linked token is loaded with all classes of the token
+	{
+		FAKE_TOKEN token(token_class(TokenLinkedToken), true, false);
+		BENCH_CHECK(nullptr != token.LinkedToken);
+		BENCH_CHECK(token_class(TokenLinkedToken) == token.LinkedToken->Loaded);
+		BENCH_CHECK(nullptr == token.LinkedToken->LinkedToken); // Linked token of linked token is not read
+
+		token.Load(ClassAll);
+		BENCH_CHECK(ClassAll == token.Loaded);
+		BENCH_CHECK(ClassAll == token.LinkedToken->Loaded);
+	}
+
+	{
+		FAKE_TOKEN token(token_class(TokenUser), true, false);
+		token.Load(token_class(TokenLinkedToken));
+
+		BENCH_CHECK(nullptr != token.LinkedToken);
+		BENCH_CHECK(token.LinkedToken->Loaded == (token_class(TokenUser) | token_class(TokenLinkedToken)));
+	}
+	#pragma endregion
+
+	#pragma region Only missing classes are queried
+	{
+		FAKE_TOKEN token(token_class(TokenUser), true, false);
+		BENCH_CHECK(1 == token.Queries);
+
+		token.Load(token_class(TokenUser));
+		BENCH_CHECK(1 == token.Queries);
+
+		token.Load(token_class(TokenUser) | token_class(TokenGroups));
+		BENCH_CHECK(2 == token.Queries);
+		BENCH_CHECK(token.Queried == (token_class(TokenUser) | token_class(TokenGroups)));
+	}
+	#pragma endregion
+
+	#pragma region Token without a source is never queried
+	{
+		FAKE_TOKEN token(ClassAll, false, false);
+		BENCH_CHECK(0 == token.Queries);
+		BENCH_CHECK(0 == token.Loaded);
+	}
+	#pragma endregion
+
+	#pragma region Required classes
+	{
+		require_classes(ClassAll, token_class(TokenUser) | token_class(TokenGroups), "CHECK");
+		require_classes(token_class(TokenUser), 0, "CHECK");
+
+		bool thrown = false;
+
+		try
+		{
+			require_classes(token_class(TokenUser), token_class(TokenUser) | token_class(TokenGroups), "CHECK");
+		}
+		catch(const std::invalid_argument& error)
+		{
+			thrown = (std::string(error.what()) == "CHECK: token information classes are not loaded (mask 0000000000000004)");
+		}
+
+		BENCH_CHECK(thrown);
+	}
+	#pragma endregion
+
+	#pragma region Raw information in memory
+	{
+		XTOKEN_INFO_STORE store;
+		BENCH_CHECK(store.Find(TokenUser).empty());
+
+		unsigned char* buffer = store.Allocate(TokenGroups, 40);
+		buffer[39] = 0x5A;
+
+		store.Set(TokenUser, RAW{ 7, 0x1122334455667788 });
+
+		auto groups = store.Find(TokenGroups);
+		BENCH_CHECK((40 == groups.size()) && (buffer == groups.data()) && (0x5A == groups[39]));
+
+		auto user = store.Find(TokenUser);
+		BENCH_CHECK(sizeof(RAW) == user.size());
+
+		RAW value{};
+		memcpy(&value, user.data(), sizeof(value));
+		BENCH_CHECK((7 == value.First) && (0x1122334455667788 == value.Second));
+
+		store.Allocate(TokenGroups, 8); // Replaced with zeroed memory
+		BENCH_CHECK((8 == store.Find(TokenGroups).size()) && (0 == store.Find(TokenGroups)[0]));
+	}
+	#pragma endregion
+
+	return 0;
+}
@@ -0,0 +1,285 @@
+// Streaming XML writer (xml_stream.h, used by XSave): throughput and peak heap for a token-like
+// document with many groups, written into a stream that only counts bytes. Peak heap must stay
+// near the buffer capacity whatever the document size. Output is read back by XXML_READER.
+// Argument "quick" writes a small document and only checks results.
+#include "xml_stream.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+using namespace XSEC;
+//********************************************************************************************
+#pragma region Heap accounting for all allocations of the program
+size_t heap_current = 0;
+size_t heap_peak = 0;
+//********************************************************************************************
+// Size is kept in front of each block, 16 bytes keep the alignment of "malloc"
+void* operator new(size_t size)
+{
+	unsigned char* block = (unsigned char*)malloc(size + 16);
+	if(nullptr == block)
+		throw std::bad_alloc();
+
+	memcpy(block, &size, sizeof(size));
+
+	heap_current += size;
+	heap_peak = std::max(heap_peak, heap_current);
+
+	return block + 16;
+}
+//********************************************************************************************
+void operator delete(void* value) noexcept
+{
+	if(nullptr == value)
+		return;
+
+	unsigned char* block = (unsigned char*)value - 16;
+
+	size_t size = 0;
+	memcpy(&size, block, sizeof(size));
+
+	heap_current -= size;
+	free(block);
+}
+//********************************************************************************************
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+//********************************************************************************************
+void operator delete[](void* value) noexcept
+{
+	operator delete(value);
+}
+//********************************************************************************************
+void operator delete(void* value, size_t) noexcept
+{
+	operator delete(value);
+}
+//********************************************************************************************
+void operator delete[](void* value, size_t) noexcept
+{
+	operator delete(value);
+}
+#pragma endregion
+//********************************************************************************************
+// Discards output, so time and memory are of the writer only
+struct COUNTING_BUFFER : public std::streambuf
+{
+	size_t Size = 0;
+
+protected:
+	std::streamsize xsputn(const char*, std::streamsize count) override
+	{
+		Size += (size_t)count;
+		return count;
+	}
+
+	int_type overflow(int_type value) override
+	{
+		Size++;
+		return value;
+	}
+};
+//********************************************************************************************
+// The same elements as XSID::Write and XBITSET::Write make for a group
+void write_group(XXML_WRITER& xml, const uint32_t& rid)
+{
+	const std::wstring meanings[] = { L"SE_GROUP_MANDATORY", L"SE_GROUP_ENABLED_BY_DEFAULT", L"SE_GROUP_ENABLED" };
+
+	xml.Start("Group");
+
+	xml.Start("SID");
+	xml.Attribute("CommonName", L"CONTOSO\\Group & <" + std::to_wstring(rid) + L">");
+	xml.Attribute("StringRepresentation", "S-1-5-21-1-2-3-" + std::to_string(rid));
+	xml.Element("Revision", (uint8_t)1);
+	xml.Element("IdentifierAuthority", (uint32_t)5);
+
+	for(uint32_t element : { 21u, 1u, 2u, 3u, rid })
+		xml.Element("SubAuthority", element);
+
+	xml.End();
+
+	xml.Start("Attributes");
+
+	const unsigned char data[4] = { 0x07, 0x00, 0x00, 0x00 };
+	xml.Start("Data");
+	xml.Hex(data);
+	xml.End();
+
+	xml.Start("Bits");
+
+	for(size_t i = 0; i < 32; i++)
+	{
+		const char name[] = { 'b', (char)('0' + i / 10), (char)('0' + i % 10), 0 };
+
+		xml.Start(name);
+
+		if(i < 3)
+			xml.Attribute("Meaning", meanings[i]);
+
+		xml.Text((i < 3) ? "1" : "0");
+		xml.End();
+	}
+
+	xml.End();
+	xml.End();
+
+	xml.End();
+}
+//********************************************************************************************
+void write_token(XXML_WRITER& xml, const size_t& groups)
+{
+	xml.Declaration();
+	xml.Start("Token");
+
+	xml.Start("Groups");
+
+	for(size_t i = 0; i < groups; i++)
+		write_group(xml, 1000 + (uint32_t)i);
+
+	xml.End();
+
+	// Elements of XCONDITIONAL_EXPRESSION::Write for (Member_of {SID(BA)}) && (@User.dept == "a<b"),
+	// operator names are wide strings as in "Names" of the operators
+	xml.Start("ConditionalExpression");
+	xml.Start(L"LOGICAL_AND");
+	xml.Start("LHS");
+	xml.Start(L"MEMBER_OF");
+	xml.Start(L"COMPOSITE");
+	xml.Start("SID");
+	xml.Element("SubAuthority", (uint32_t)544);
+	xml.End();
+	xml.End();
+	xml.End();
+	xml.End();
+	xml.Start("RHS");
+	xml.Start(L"EQUAL");
+	xml.Start(L"USER_ATTRIBUTE");
+	xml.Text(L"dept");
+	xml.End();
+	xml.Start(L"XUnicode");
+	xml.Text(L"a<b");
+	xml.End();
+	xml.End();
+	xml.End();
+	xml.End();
+	xml.End();
+
+	xml.Element(std::string_view("Name"), std::wstring_view(L"a<b>&\"c\" é中"));
+
+	xml.End();
+}
+//********************************************************************************************
+int main(int argc, char** argv)
+{
+	const bool quick = (argc > 1) && (std::string_view(argv[1]) == "quick");
+
+	#pragma region Output is read back
+	{
+		std::ostringstream stream;
+
+		{
+			XXML_WRITER xml(stream, 256); // Small capacity: many flushes inside elements
+			write_token(xml, 100);
+			xml.Flush();
+
+			BENCH_CHECK(xml.Written == stream.str().size());
+		}
+
+		std::string data = stream.str();
+
+		XXML_READER reader(std::span<const unsigned char>((const unsigned char*)data.data(), data.size()));
+		reader.Root();
+		BENCH_CHECK("Token" == reader.Name());
+
+		size_t groups = 0;
+		bool expression = false;
+		std::string name;
+
+		size_t depth = reader.Depth();
+		while(reader.Child(depth))
+		{
+			if("Groups" == reader.Name())
+			{
+				size_t level = reader.Depth();
+				while(reader.Child(level))
+				{
+					size_t group = reader.Depth();
+					while(reader.Child(group))
+					{
+						if("SID" != reader.Name())
+							continue;
+
+						size_t sid = reader.Depth();
+						uint32_t last = 0;
+
+						while(reader.Child(sid))
+						{
+							if("SubAuthority" == reader.Name())
+								last = reader.Number<uint32_t>();
+						}
+
+						BENCH_CHECK((1000 + groups) == last);
+					}
+
+					groups++;
+				}
+			}
+			else if("ConditionalExpression" == reader.Name())
+			{
+				std::string text = reader.Text();
+				expression = (std::string_view(text).find("544") != std::string_view::npos) && (std::string_view(text).find("a<b") != std::string_view::npos);
+			}
+			else if("Name" == reader.Name())
+				name = reader.Text();
+		}
+
+		BENCH_CHECK(100 == groups);
+		BENCH_CHECK(expression);
+		BENCH_CHECK("a<b>&\"c\" \xC3\xA9\xE4\xB8\xAD" == name);
+	}
+	#pragma endregion
+
+	#pragma region Peak heap does not depend on size of the document
+	for(size_t groups : { (size_t)1000, (size_t)(quick ? 10000 : 200000) })
+	{
+		COUNTING_BUFFER buffer;
+		std::ostream stream(&buffer);
+
+		size_t before = heap_current;
+		heap_peak = heap_current;
+
+		auto start = std::chrono::steady_clock::now();
+
+		{
+			XXML_WRITER xml(stream);
+			write_token(xml, groups);
+			xml.Flush();
+		}
+
+		auto stop = std::chrono::steady_clock::now();
+
+		double seconds = std::chrono::duration<double>(stop - start).count();
+		size_t peak = heap_peak - before;
+
+		// 64 KiB buffer, 4 KiB of reserve and small strings of one group
+		BENCH_CHECK(peak < 128 * 1024);
+		BENCH_CHECK(buffer.Size > groups * 500);
+
+		if(false == quick)
+			printf("groups %7zu | %8.1f MB in %6.3f s | %6.1f MB/s | peak heap %6.1f KB\n", groups, buffer.Size / 1e6, seconds, buffer.Size / seconds / 1e6, peak / 1024.0);
+	}
+	#pragma endregion
+
+	return 0;
+}
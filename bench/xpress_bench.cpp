@@ -0,0 +1,92 @@
+// Throughput of XPRESS Huffman decompression (pac_format.h, used for compressed PAC claims) on
+// data compressed by the test encoder: claims-like records, text, random bytes and zeros, from
+// the size of one claims buffer to several blocks. Argument "quick" only checks round trips.
+#include "pac_format.h"
+#include "xpress_encoder.h"
+#include "bench.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace XSEC;
+//********************************************************************************************
+std::vector<unsigned char> make_input(const std::string_view& kind, const size_t& size, std::mt19937& random)
+{
+	std::vector<unsigned char> result;
+	result.reserve(size);
+
+	if("claims" == kind)
+	{
+		// UTF-16 names and values with NDR-like counters, as in a serialized CLAIMS_SET
+		const std::u16string names[] = { u"ad://ext/department", u"ad://ext/clearance", u"ad://ext/country", u"ad://ext/project" };
+		const std::u16string values[] = { u"Sales", u"Engineering", u"Finance", u"US", u"DE", u"Apollo", u"Gemini" };
+
+		while(result.size() < size)
+		{
+			for(const std::u16string& text : { names[random() % 4], values[random() % 7] })
+			{
+				uint32_t count = (uint32_t)text.size() + 1;
+
+				for(uint32_t value : { count, (uint32_t)0, count, (uint32_t)(0x20000 + 4 * (random() % 64)) })
+					result.insert(result.end(), (unsigned char*)&value, (unsigned char*)&value + sizeof(value));
+
+				result.insert(result.end(), (const unsigned char*)text.data(), (const unsigned char*)(text.data() + count));
+			}
+		}
+	}
+
+	if("text" == kind)
+	{
+		const char* words[] = { "security", "descriptor", "token", "claim", "group", "access", "mask", "the", "of", "and" };
+
+		while(result.size() < size)
+		{
+			std::string_view word = words[random() % 10];
+			result.insert(result.end(), word.begin(), word.end());
+			result.push_back((random() % 8) ? ' ' : '\n');
+		}
+	}
+
+	if("random" == kind)
+	{
+		while(result.size() < size)
+			result.push_back((unsigned char)random());
+	}
+
+	result.resize(size, 0); // Also makes "zeros"
+
+	return result;
+}
+//********************************************************************************************
+int main(int argc, char** argv)
+{
+	const bool quick = (argc > 1) && (std::string_view(argv[1]) == "quick");
+
+	std::mt19937 random(7);
+
+	for(std::string_view kind : { "claims", "text", "random", "zeros" })
+	{
+		for(size_t size : { 512, 4096, 65536, 1024 * 1024 })
+		{
+			std::vector<unsigned char> data = make_input(kind, size, random);
+			std::vector<unsigned char> compressed = xpress_huffman_compress(data);
+
+			BENCH_CHECK(xpress_huffman_decompress(compressed, data.size()) == data);
+
+			if(quick)
+				continue;
+
+			size_t iterations = std::max((size_t)20, (size_t)(64 * 1024 * 1024) / size);
+
+			double ns = bench_ns([&]{ return xpress_huffman_decompress(compressed, data.size()).size(); }, iterations);
+
+			printf("%-6s %8zu bytes | compressed %8zu (%5.1f%%) | %8.0f ns | %7.1f MB/s\n",
+				kind.data(), size, compressed.size(), 100.0 * compressed.size() / size, ns, (size / ns) * 1000.0);
+		}
+	}
+
+	return 0;
+}
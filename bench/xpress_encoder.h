@@ -0,0 +1,307 @@
+#pragma once
+//********************************************************************************************
+// XPRESS Huffman encoder ([MS-XCA] 2.2.4) for tests and benchmarks of "xpress_huffman_decompress":
+// greedy LZ77 with hash chains, a new Huffman table for each block of 65536 bytes, code lengths
+// limited to 15 bits. Compression ratio is not a goal, only a valid stream for any input.
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <array>
+#include <bit>
+#include <algorithm>
+//********************************************************************************************
+struct XPRESS_TOKEN
+{
+	uint32_t Length = 0; // 0 for a literal
+	uint32_t Offset = 0; // Literal byte for literals
+};
+//********************************************************************************************
+// Code lengths from frequencies, frequencies are halved until no code is longer than 15 bits
+inline std::array<unsigned char, 512> xpress_code_lengths(std::array<size_t, 512> frequencies)
+{
+	std::array<unsigned char, 512> result{};
+
+	while(true)
+	{
+		result.fill(0);
+
+		struct node_t
+		{
+			size_t Frequency = 0;
+			int Left = -1;
+			int Right = -1;
+		};
+
+		std::vector<node_t> nodes;
+
+		auto greater = [&](const int& a, const int& b){ return nodes[a].Frequency > nodes[b].Frequency; };
+		std::priority_queue<int, std::vector<int>, decltype(greater)> queue(greater);
+
+		for(size_t i = 0; i < 512; i++)
+		{
+			if(frequencies[i])
+			{
+				nodes.push_back({ frequencies[i], -1, (int)i });
+				queue.push((int)nodes.size() - 1);
+			}
+		}
+
+		if(queue.empty())
+			return result;
+
+		// The only used symbol still needs a code of one bit
+		if(1 == queue.size())
+		{
+			result[nodes[queue.top()].Right] = 1;
+			return result;
+		}
+
+		while(queue.size() > 1)
+		{
+			int a = queue.top(); queue.pop();
+			int b = queue.top(); queue.pop();
+
+			nodes.push_back({ nodes[a].Frequency + nodes[b].Frequency, a, b });
+			queue.push((int)nodes.size() - 1);
+		}
+
+		// Leaves have "Left == -1" and symbol in "Right"
+		bool fits = true;
+
+		std::vector<std::pair<int, unsigned char>> stack{ { queue.top(), 0 } };
+
+		while(stack.size())
+		{
+			auto [index, depth] = stack.back();
+			stack.pop_back();
+
+			if(-1 == nodes[index].Left)
+			{
+				result[nodes[index].Right] = depth;
+				fits = fits && (depth <= 15);
+
+				continue;
+			}
+
+			stack.push_back({ nodes[index].Left, (unsigned char)(depth + 1) });
+			stack.push_back({ nodes[index].Right, (unsigned char)(depth + 1) });
+		}
+
+		if(fits)
+			return result;
+
+		for(auto&& element : frequencies)
+		{
+			if(element)
+				element = (element + 1) / 2;
+		}
+	}
+}
+//********************************************************************************************
+// Greedy matching, matches never cross a block boundary so each block is decoded on its own
+inline std::vector<XPRESS_TOKEN> xpress_tokens(std::span<const unsigned char> input)
+{
+	std::vector<XPRESS_TOKEN> result;
+
+	const size_t depth = 16;
+
+	std::vector<int64_t> head(1 << 15, -1);
+	std::vector<int64_t> previous(input.size(), -1);
+
+	auto hash = [&](const size_t& i) -> size_t
+	{
+		return ((input[i] << 10) ^ (input[i + 1] << 5) ^ input[i + 2]) & 0x7FFF;
+	};
+
+	auto insert = [&](const size_t& i)
+	{
+		if((i + 3) > input.size())
+			return;
+
+		size_t h = hash(i);
+
+		previous[i] = head[h];
+		head[h] = (int64_t)i;
+	};
+
+	for(size_t i = 0; i < input.size();)
+	{
+		size_t end = std::min(input.size(), (i & ~(size_t)0xFFFF) + 0x10000);
+
+		size_t best_length = 0;
+		size_t best_offset = 0;
+
+		if((i + 3) <= end)
+		{
+			int64_t candidate = head[hash(i)];
+
+			for(size_t k = 0; (k < depth) && (-1 != candidate) && ((i - (size_t)candidate) <= 0xFFFF); k++, candidate = previous[candidate])
+			{
+				size_t length = 0;
+				while(((i + length) < end) && (input[candidate + length] == input[i + length]))
+					length++;
+
+				if(length > best_length)
+				{
+					best_length = length;
+					best_offset = i - (size_t)candidate;
+				}
+			}
+		}
+
+		if(best_length < 3)
+		{
+			result.push_back({ 0, input[i] });
+			insert(i++);
+
+			continue;
+		}
+
+		result.push_back({ (uint32_t)best_length, (uint32_t)best_offset });
+
+		for(size_t k = 0; k < best_length; k++)
+			insert(i++);
+	}
+
+	return result;
+}
+//********************************************************************************************
+inline std::vector<unsigned char> xpress_huffman_compress(std::span<const unsigned char> input)
+{
+	std::vector<unsigned char> result;
+
+	std::vector<XPRESS_TOKEN> tokens = xpress_tokens(input);
+
+	auto symbol_of = [](const XPRESS_TOKEN& token) -> uint16_t
+	{
+		if(0 == token.Length)
+			return (uint16_t)token.Offset;
+
+		uint32_t length = token.Length - 3;
+		uint32_t offset_length = std::bit_width(token.Offset) - 1;
+
+		return (uint16_t)(256 + (offset_length << 4) + std::min(length, (uint32_t)15));
+	};
+
+	size_t token = 0;
+	size_t out = 0;
+
+	do
+	{
+		#pragma region Tokens of the block
+		size_t first = token;
+		size_t end = out + 0x10000;
+
+		for(; (token < tokens.size()) && (out < end); token++)
+			out += (tokens[token].Length) ? tokens[token].Length : 1;
+
+		bool last = (token == tokens.size());
+		#pragma endregion
+
+		#pragma region Huffman table
+		std::array<size_t, 512> frequencies{};
+
+		for(size_t i = first; i < token; i++)
+			frequencies[symbol_of(tokens[i])]++;
+
+		if(last)
+			frequencies[256]++; // End of stream
+
+		std::array<unsigned char, 512> lengths = xpress_code_lengths(frequencies);
+
+		for(size_t i = 0; i < 512; i += 2)
+			result.push_back((unsigned char)(lengths[i] | (lengths[i + 1] << 4)));
+
+		// Canonical codes in the same order as the decoder fills its table
+		std::array<uint16_t, 512> codes{};
+		uint32_t code = 0;
+
+		for(unsigned char length = 1; length < 16; length++)
+		{
+			for(size_t symbol = 0; symbol < 512; symbol++)
+			{
+				if(length != lengths[symbol])
+					continue;
+
+				codes[symbol] = (uint16_t)(code >> (15 - length));
+				code += (uint32_t)1 << (15 - length);
+			}
+		}
+		#pragma endregion
+
+		#pragma region Bit stream
+		// Two 16-bit words are reserved ahead, extra length bytes go after them
+		std::deque<size_t> slots{ result.size(), result.size() + 2 };
+		result.resize(result.size() + 4);
+
+		uint32_t buffer = 0;
+		unsigned char count = 0;
+		size_t words = 0;
+
+		auto put = [&](const uint32_t& value, const unsigned char& size)
+		{
+			for(int i = size - 1; i >= 0; i--)
+			{
+				if((0 == count) && words)
+				{
+					slots.push_back(result.size());
+					result.resize(result.size() + 2);
+				}
+
+				buffer = (buffer << 1) | ((value >> i) & 1);
+
+				if(16 == ++count)
+				{
+					result[slots.front()] = (unsigned char)buffer;
+					result[slots.front() + 1] = (unsigned char)(buffer >> 8);
+					slots.pop_front();
+
+					buffer = 0;
+					count = 0;
+					words++;
+				}
+			}
+		};
+
+		for(size_t i = first; i < token; i++)
+		{
+			uint16_t symbol = symbol_of(tokens[i]);
+			put(codes[symbol], lengths[symbol]);
+
+			if(0 == tokens[i].Length)
+				continue;
+
+			uint32_t length = tokens[i].Length - 3;
+
+			if(length >= 15)
+			{
+				if((length - 15) < 255)
+					result.push_back((unsigned char)(length - 15));
+				else
+				{
+					result.push_back(255);
+					result.push_back((unsigned char)length);
+					result.push_back((unsigned char)(length >> 8));
+				}
+			}
+
+			unsigned char offset_length = (unsigned char)(std::bit_width(tokens[i].Offset) - 1);
+			if(offset_length)
+				put(tokens[i].Offset - ((uint32_t)1 << offset_length), offset_length);
+		}
+
+		if(last)
+			put(codes[256], lengths[256]);
+
+		if(count)
+			put(0, 16 - count);
+		#pragma endregion
+	}
+	while(token < tokens.size());
+
+	return result;
+}
+//********************************************************************************************
@@ -408,7 +408,11 @@ void whoami_x509(parameters&& params)
     if(SubStatus < 0)
         throw std::exception(status_to_string("LsaLogonUser SubStatus", SubStatus).c_str());
 
-    XSEC::XTOKEN token{ Token };
+    // Only information printed below is loaded here, everything else is loaded right before storing into XML
+    XSEC::XTOKEN token{
+        Token,
+        XSEC::XTOKEN::Class(TokenUser) | XSEC::XTOKEN::Class(TokenGroups) | XSEC::XTOKEN::Class(TokenPrivileges) | XSEC::XTOKEN::Class(TokenUserClaimAttributes) | XSEC::XTOKEN::Class(TokenDeviceClaimAttributes)
+    };
     #pragma endregion
 
     #pragma region Information about user
@@ -454,9 +458,9 @@ void whoami_x509(parameters&& params)
 
         size_t first_max = 0;
 
-        for(auto&& privilege : token.Privileges)
+        for(auto&& privilege : XSEC::XPRIVILEGE_SET(token.Privileges).Privileges())
         {
-            auto names = privilege.Luid->privilegeNames();
+            auto names = XSEC::XLUID(privilege.Luid).privilegeNames(); // Well-known privileges are taken from static table
 
             first_max = (names.first.size() > first_max) ? names.first.size() : first_max;
 
@@ -553,7 +557,7 @@ void whoami_x509(parameters&& params)
     std::replace(strTargetName.begin(), strTargetName.end(), L'\\', L'_');
     std::replace(strTargetName.begin(), strTargetName.end(), L'/', L'_');
 
-    XSEC::XSave(token, std::format(L"{}_token.xml", strTargetName));
+    XSEC::XSave(token.Load(XSEC::XTOKEN::ClassAll), std::format(L"{}_token.xml", strTargetName));
     #pragma endregion
 }
 //***************************************************************************************